@@ -0,0 +1,178 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements Clenshaw-Curtis and Fejer rules of any order
+// and a nested Clenshaw-Curtis integrator.
+
+#ifndef CLENSHAW_CURTIS_INTEGRAL_H
+#define CLENSHAW_CURTIS_INTEGRAL_H 1
+
+#include <cstddef>
+#include <memory>
+#include <new> // For std::nothrow
+#include <type_traits>
+#include <vector>
+
+#include <emsr/quadrature_point.h>
+#include <emsr/gauss_kronrod_integral.h>
+
+namespace emsr
+{
+
+  /**
+   * Return the Clenshaw-Curtis rule on [-1, 1] with the @c n + 1 points
+   * @f$ x_k = \cos(k\pi/n) @f$, @f$ k = 0, ..., n @f$.
+   *
+   * The weights are computed in @f$ O(n \log n) @f$ as the inverse
+   * discrete Fourier transform of the moments following
+   * J. Waldvogel, Fast Construction of the Fejer and Clenshaw-Curtis
+   * Quadrature Rules, BIT Numerical Mathematics 46 (2006), 195-202.
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    clenshaw_curtis_rule(std::size_t n);
+
+  /**
+   * Return the Fejer rule of the first kind on [-1, 1] with the @c n points
+   * @f$ x_k = \cos((k + 1/2)\pi/n) @f$, @f$ k = 0, ..., n - 1 @f$.
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    fejer_1_rule(std::size_t n);
+
+  /**
+   * Return the Fejer rule of the second kind on [-1, 1] with the @c n - 1
+   * interior points @f$ x_k = \cos(k\pi/n) @f$, @f$ k = 1, ..., n - 1 @f$.
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    fejer_2_rule(std::size_t n);
+
+  /**
+   * Return the weights of the Clenshaw-Curtis rule with @f$ 2^L + 1 @f$
+   * points in the order of clenshaw_curtis_rule.
+   * The weights are computed once per level and type and shared.
+   */
+  template<typename Tp>
+    std::shared_ptr<const std::vector<Tp>>
+    clenshaw_curtis_weights(int level);
+
+  /**
+   * Integrate with nested Clenshaw-Curtis rules of
+   * @f$ 2^L + 1 @f$ points, @f$ L = 1, 2, ... @f$.
+   *
+   * Doubling the number of intervals keeps every node of the rule below
+   * so each level costs only its new points and climbing to level @c L
+   * costs @f$ 2^L + 1 @f$ evaluations in all.  The weights come from
+   * the FFT so high levels are cheap to reach: smooth integrands that need
+   * thousands of points are integrated without subdivision.
+   *
+   * Used as the local rule of an adaptive bisection driver such as
+   * qag_integrate the integral climbs from @c min_level and stops
+   * as soon as the difference between successive levels has fallen
+   * to roundoff.  As a local rule the climb stops at @c max_local_level,
+   * by default s_max_local_level (257 points), so that an interval
+   * the driver is about to bisect anyway does not cost 65537 points.
+   */
+  template<typename Tp>
+    class clenshaw_curtis_integral
+    {
+    public:
+
+      /// The highest level available (1048577 points).
+      static constexpr int s_max_level = 20;
+
+      /// The highest level climbed as a local rule (257 points).
+      static constexpr int s_max_local_level = 8;
+
+      explicit clenshaw_curtis_integral(int max_level = 16,
+					int min_level = 3,
+					int max_local_level = s_max_local_level);
+
+      /**
+       * Integrate climbing levels until the error estimate from
+       * successive levels meets the tolerance.
+       * Throw integration_error if the highest level fails.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(FuncTp func, Tp lower, Tp upper,
+		  Tp max_abs_err, Tp max_rel_err) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      /**
+       * Integrate climbing levels until the error estimate from
+       * successive levels meets the tolerance without throwing
+       * if the highest level fails.  The error code, the result
+       * and error estimate of the highest level and the number
+       * of function evaluations are returned instead.
+       * Invalid tolerances still throw.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(std::nothrow_t, FuncTp func, Tp lower, Tp upper,
+		  Tp max_abs_err, Tp max_rel_err) const
+	-> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      /**
+       * Integrate as the local rule of an adaptive driver.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(FuncTp func, Tp lower, Tp upper) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      template<typename FuncTp>
+	auto
+	operator()(FuncTp func, Tp lower, Tp upper) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+	{ return this->integrate(func, lower, upper); }
+
+      /// Return the lowest level used.
+      int
+      min_level() const
+      { return this->m_min_level; }
+
+      /// Return the highest level used.
+      int
+      max_level() const
+      { return this->m_max_level; }
+
+      /// Return the highest level used as a local rule.
+      int
+      max_local_level() const
+      { return this->m_max_local_level; }
+
+    private:
+
+      static constexpr const char* s_tolerance_msg
+	= "clenshaw_curtis_integral: Failed to reach tolerance with highest-order rule";
+
+      template<typename FuncTp, typename Done>
+	auto
+	m_climb(FuncTp func, Tp lower, Tp upper, int top_level,
+		Done done) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      int m_min_level;
+      int m_max_level;
+      int m_max_local_level;
+    };
+
+} // namespace emsr
+
+#endif // CLENSHAW_CURTIS_INTEGRAL_H
@@ -0,0 +1,321 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef CLENSHAW_CURTIS_INTEGRAL_TCC
+#define CLENSHAW_CURTIS_INTEGRAL_TCC 1
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <emsr/fft_plan.h>
+#include <emsr/gauss_rule_registry.h>
+#include <emsr/integration_error.h>
+#include <emsr/nested_rule_integral.tcc>
+
+namespace emsr
+{
+
+namespace detail
+{
+
+  /**
+   * Return the inverse discrete Fourier transform (scaled by 1/n)
+   * of Hermitian data as a real vector.
+   */
+  template<typename Tp>
+    std::vector<Tp>
+    real_inverse_dft(std::vector<std::complex<Tp>>& v)
+    {
+      const auto n = v.size();
+      fft_plan<Tp>(n).inverse(v);
+      std::vector<Tp> w(n);
+      for (std::size_t k = 0; k < n; ++k)
+	w[k] = v[k].real() / Tp(n);
+      return w;
+    }
+
+  /**
+   * Return Waldvogel's vector whose inverse transform gives
+   * the Fejer weights of the second kind on the Clenshaw-Curtis nodes.
+   */
+  template<typename Tp>
+    std::vector<std::complex<Tp>>
+    fejer_2_moments(std::size_t n)
+    {
+      const auto l = n / 2;
+      std::vector<Tp> v0(n + 1, Tp{0});
+      for (std::size_t i = 0; i < l; ++i)
+	{
+	  const auto N = Tp(2 * i + 1);
+	  v0[i] = Tp{2} / N / (N - Tp{2});
+	}
+      v0[l] = Tp{1} / Tp(2 * l - 1);
+
+      std::vector<std::complex<Tp>> v2(n);
+      for (std::size_t k = 0; k < n; ++k)
+	v2[k] = -v0[k] - v0[n - k];
+      return v2;
+    }
+
+  /**
+   * Return @f$ \cos(k\pi/n) @f$ computed as a sine about the center
+   * so that the nodes are symmetric and accurate near zero.
+   */
+  template<typename Tp>
+    Tp
+    clenshaw_curtis_node(std::size_t k, std::size_t n)
+    {
+      const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+      return std::sin(s_pi * (Tp(n) - Tp(2 * k)) / Tp(2 * n));
+    }
+
+} // namespace detail
+
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    clenshaw_curtis_rule(std::size_t n)
+    {
+      if (n == 0)
+	throw std::domain_error("clenshaw_curtis_rule: "
+				"Number of intervals must be positive.");
+
+      std::vector<QuadraturePoint<Tp>> rule;
+      rule.reserve(n + 1);
+      if (n == 1)
+	{
+	  rule.emplace_back(Tp{+1}, Tp{1});
+	  rule.emplace_back(Tp{-1}, Tp{1});
+	  return rule;
+	}
+
+      const auto l = n / 2;
+      const auto m = n - l;
+      auto v = detail::fejer_2_moments<Tp>(n);
+      const auto norm = Tp(n * n - 1 + n % 2);
+      for (std::size_t k = 0; k < n; ++k)
+	v[k] -= Tp{1} / norm;
+      v[l] += Tp(n) / norm;
+      v[m] += Tp(n) / norm;
+      const auto w = detail::real_inverse_dft(v);
+
+      for (std::size_t k = 0; k < n; ++k)
+	rule.emplace_back(detail::clenshaw_curtis_node<Tp>(k, n), w[k]);
+      rule.emplace_back(Tp{-1}, w[0]);
+      return rule;
+    }
+
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    fejer_1_rule(std::size_t n)
+    {
+      if (n == 0)
+	throw std::domain_error("fejer_1_rule: "
+				"Number of points must be positive.");
+
+      const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+      const auto m = n - n / 2;
+      std::vector<std::complex<Tp>> v0(n + 1);
+      for (std::size_t k = 0; k < m; ++k)
+	v0[k] = Tp{2} * std::polar(Tp{1}, s_pi * Tp(k) / Tp(n))
+	      / (Tp{1} - Tp{4} * Tp(k) * Tp(k));
+      std::vector<std::complex<Tp>> v1(n);
+      for (std::size_t k = 0; k < n; ++k)
+	v1[k] = v0[k] + std::conj(v0[n - k]);
+      const auto w = detail::real_inverse_dft(v1);
+
+      std::vector<QuadraturePoint<Tp>> rule;
+      rule.reserve(n);
+      for (std::size_t k = 0; k < n; ++k)
+	rule.emplace_back(std::sin(s_pi * (Tp(n) - Tp(2 * k + 1)) / Tp(2 * n)),
+			  w[k]);
+      return rule;
+    }
+
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    fejer_2_rule(std::size_t n)
+    {
+      if (n < 2)
+	throw std::domain_error("fejer_2_rule: "
+				"Number of intervals must be at least two.");
+
+      auto v = detail::fejer_2_moments<Tp>(n);
+      const auto w = detail::real_inverse_dft(v);
+
+      std::vector<QuadraturePoint<Tp>> rule;
+      rule.reserve(n - 1);
+      for (std::size_t k = 1; k < n; ++k)
+	rule.emplace_back(detail::clenshaw_curtis_node<Tp>(k, n), w[k]);
+      return rule;
+    }
+
+  template<typename Tp>
+    std::shared_ptr<const std::vector<Tp>>
+    clenshaw_curtis_weights(int level)
+    {
+      using rule_t = std::vector<Tp>;
+      return gauss_rule_registry<Tp>::instance().template get<rule_t>
+	({Clenshaw_Curtis, level},
+	 [level]()
+	 {
+	   const auto rule = clenshaw_curtis_rule<Tp>(std::size_t{1} << level);
+	   rule_t w;
+	   w.reserve(rule.size());
+	   for (const auto& pt : rule)
+	     w.push_back(pt.weight);
+	   return w;
+	 });
+    }
+
+  template<typename Tp>
+    clenshaw_curtis_integral<Tp>::
+    clenshaw_curtis_integral(int max_level, int min_level,
+			     int max_local_level)
+    : m_min_level(min_level),
+      m_max_level(max_level),
+      m_max_local_level(std::min(max_level, max_local_level))
+    {
+      if (max_level < 1 || max_level > s_max_level)
+	throw std::domain_error("clenshaw_curtis_integral: "
+				"max_level out of range");
+      if (min_level < 1 || min_level > max_level)
+	throw std::domain_error("clenshaw_curtis_integral: "
+				"min_level out of range");
+      if (max_local_level < min_level)
+	throw std::domain_error("clenshaw_curtis_integral: "
+				"max_local_level out of range");
+    }
+
+  /**
+   * Climb the levels reusing all previous function values.
+   * The values are kept in node order; doubling interleaves the new
+   * values between the old ones.
+   */
+  template<typename Tp>
+    template<typename FuncTp, typename Done>
+      auto
+      clenshaw_curtis_integral<Tp>::
+      m_climb(FuncTp func, Tp lower, Tp upper, int top_level,
+	      Done done) const
+      -> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	using RetTp = std::invoke_result_t<FuncTp, Tp>;
+	using AreaTp = decltype(RetTp{} * Tp{});
+
+	const auto center = (lower + upper) / Tp{2};
+	const auto half_length = (upper - lower) / Tp{2};
+
+	std::vector<RetTp> fval{func(upper), func(center), func(lower)};
+	std::vector<RetTp> fnew;
+
+	auto level_sums = [&func, center, half_length, &fval, &fnew](int level)
+	  {
+	    const auto n = std::size_t{1} << level;
+	    if (level > 1)
+	      {
+		fnew.resize(n + 1);
+		for (std::size_t k = 0; k <= n; k += 2)
+		  fnew[k] = fval[k / 2];
+		for (std::size_t k = 1; k < n; k += 2)
+		  fnew[k] = func(center + half_length
+				 * detail::clenshaw_curtis_node<Tp>(k, n));
+		fval.swap(fnew);
+	      }
+
+	    const auto& w = *clenshaw_curtis_weights<Tp>(level);
+	    detail::nested_level_sums<Tp, AreaTp> sums{AreaTp{0}, Tp{0}, Tp{0}};
+	    for (std::size_t k = 0; k <= n; ++k)
+	      {
+		sums.res += w[k] * fval[k];
+		sums.resabs += w[k] * std::abs(fval[k]);
+	      }
+	    const auto mean = sums.res / Tp{2};
+	    for (std::size_t k = 0; k <= n; ++k)
+	      sums.resasc += w[k] * std::abs(fval[k] - mean);
+	    return sums;
+	  };
+
+	return detail::climb_nested_rules<Tp, RetTp>(1, this->m_min_level,
+						     top_level,
+						     half_length,
+						     level_sums, done);
+      }
+
+  template<typename Tp>
+    template<typename FuncTp>
+      auto
+      clenshaw_curtis_integral<Tp>::
+      integrate(FuncTp func, Tp lower, Tp upper,
+		Tp max_abs_err, Tp max_rel_err) const
+      -> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	const auto [out, ok] = detail::integrate_nested_rule("clenshaw_curtis_integral",
+		[this, &func, lower, upper](auto converged)
+		{
+		  return this->m_climb(func, lower, upper,
+				       this->m_max_level, converged);
+		},
+		max_abs_err, max_rel_err);
+	if (!ok)
+	  throw integration_error(s_tolerance_msg, TOLERANCE_ERROR,
+				  out.result, out.abserr);
+	return out;
+      }
+
+  template<typename Tp>
+    template<typename FuncTp>
+      auto
+      clenshaw_curtis_integral<Tp>::
+      integrate(std::nothrow_t, FuncTp func, Tp lower, Tp upper,
+		Tp max_abs_err, Tp max_rel_err) const
+      -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	std::size_t num_evals = 0;
+	auto counted_func = [&func, &num_evals](Tp x)
+			    { ++num_evals; return func(x); };
+	const auto [out, ok] = detail::integrate_nested_rule("clenshaw_curtis_integral",
+		[this, &counted_func, lower, upper](auto converged)
+		{
+		  return this->m_climb(counted_func, lower, upper,
+				       this->m_max_level, converged);
+		},
+		max_abs_err, max_rel_err);
+	if (ok)
+	  return {out.result, out.abserr, NO_ERROR, num_evals};
+	else
+	  return {out.result, out.abserr, TOLERANCE_ERROR, num_evals,
+		  s_tolerance_msg};
+      }
+
+  template<typename Tp>
+    template<typename FuncTp>
+      auto
+      clenshaw_curtis_integral<Tp>::
+      integrate(FuncTp func, Tp lower, Tp upper) const
+      -> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	return this->m_climb(func, lower, upper, this->m_max_local_level,
+			     detail::nested_rule_at_roundoff{});
+      }
+
+} // namespace emsr
+
+#endif // CLENSHAW_CURTIS_INTEGRAL_TCC
@@ -0,0 +1,280 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements compensated and exact running sums.
+
+#ifndef COMPENSATED_SUM_H
+#define COMPENSATED_SUM_H 1
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace emsr
+{
+
+  /**
+   * The summation used for the running totals of a workspace.
+   */
+  enum summation_mode : std::uint32_t
+  {
+    /// Neumaier compensated summation updated as intervals come and go.
+    Summation_Compensated,
+    /// Exact accumulation rounded once: the total depends only
+    /// on the intervals present, not on the order of the updates.
+    Summation_Reproducible
+  };
+
+  /**
+   * A running sum with Neumaier's compensation.
+   *
+   * The rounding error of each addition is accumulated separately
+   * and added back when the value is read, so the error of the sum
+   * is about one rounding of the result rather than one rounding
+   * per term.  Unlike Kahan's original scheme a term larger than
+   * the running sum is handled correctly, so terms may be removed
+   * again by subtraction.
+   */
+  template<typename Tp>
+    class compensated_sum
+    {
+    public:
+
+      compensated_sum() = default;
+
+      explicit
+      compensated_sum(Tp sum, Tp correction = Tp{0})
+      : m_sum(sum),
+	m_correction(correction)
+      { }
+
+      compensated_sum&
+      operator+=(Tp x)
+      {
+	const auto t = this->m_sum + x;
+	// Once infinite the correction would become NaN.
+	if (std::isfinite(t))
+	  {
+	    if (std::abs(this->m_sum) >= std::abs(x))
+	      this->m_correction += (this->m_sum - t) + x;
+	    else
+	      this->m_correction += (x - t) + this->m_sum;
+	  }
+	this->m_sum = t;
+	return *this;
+      }
+
+      compensated_sum&
+      operator-=(Tp x)
+      { return *this += -x; }
+
+      /// Return the compensated value of the sum.
+      Tp
+      value() const
+      { return this->m_sum + this->m_correction; }
+
+      /// Return the uncompensated running sum.
+      Tp
+      sum() const
+      { return this->m_sum; }
+
+      /// Return the accumulated rounding errors.
+      Tp
+      correction() const
+      { return this->m_correction; }
+
+    private:
+
+      Tp m_sum = Tp{0};
+      Tp m_correction = Tp{0};
+    };
+
+  /**
+   * A compensated sum of complex numbers: the real and imaginary parts
+   * are summed separately.
+   */
+  template<typename Tp>
+    class compensated_sum<std::complex<Tp>>
+    {
+    public:
+
+      compensated_sum() = default;
+
+      explicit
+      compensated_sum(std::complex<Tp> sum,
+		      std::complex<Tp> correction = std::complex<Tp>{})
+      : m_real(sum.real(), correction.real()),
+	m_imag(sum.imag(), correction.imag())
+      { }
+
+      compensated_sum&
+      operator+=(const std::complex<Tp>& x)
+      {
+	this->m_real += x.real();
+	this->m_imag += x.imag();
+	return *this;
+      }
+
+      compensated_sum&
+      operator-=(const std::complex<Tp>& x)
+      {
+	this->m_real -= x.real();
+	this->m_imag -= x.imag();
+	return *this;
+      }
+
+      std::complex<Tp>
+      value() const
+      { return {this->m_real.value(), this->m_imag.value()}; }
+
+      std::complex<Tp>
+      sum() const
+      { return {this->m_real.sum(), this->m_imag.sum()}; }
+
+      std::complex<Tp>
+      correction() const
+      { return {this->m_real.correction(), this->m_imag.correction()}; }
+
+    private:
+
+      compensated_sum<Tp> m_real;
+      compensated_sum<Tp> m_imag;
+    };
+
+  /**
+   * An exact running sum of floating point numbers.
+   *
+   * Every finite value of @c Tp is an integer multiple of the smallest
+   * subnormal so the terms are added exactly into a two's complement
+   * fixed point accumulator wide enough for the whole exponent range
+   * (a Kulisch accumulator).  The value is rounded to @c Tp only when read.
+   * The result is therefore independent of the order of the terms
+   * and a term may be removed exactly by subtracting it.
+   * Infinities and NaNs are counted and give the result
+   * that plain summation of the terms present would give.
+   *
+   * Each update touches three words of the accumulator plus carries.
+   * The accumulator is about 300 bytes for double and 4 kilobytes for
+   * an 80-bit long double; it is not allocated until the first update.
+   */
+  template<typename Tp>
+    class exact_sum
+    {
+    public:
+
+      exact_sum&
+      operator+=(Tp x)
+      {
+	this->m_update(x, false);
+	return *this;
+      }
+
+      exact_sum&
+      operator-=(Tp x)
+      {
+	this->m_update(x, true);
+	return *this;
+      }
+
+      /// Return the sum rounded to @c Tp.
+      Tp
+      value() const;
+
+      /// Reset the sum to zero.
+      void
+      clear()
+      {
+	this->m_limb.clear();
+	this->m_num_pos_inf = 0;
+	this->m_num_neg_inf = 0;
+	this->m_num_nan = 0;
+      }
+
+    private:
+
+      static constexpr int s_digits = std::numeric_limits<Tp>::digits;
+
+      /// The binary exponent of bit zero of the accumulator:
+      /// the exponent of the last mantissa bit of the smallest subnormal.
+      static constexpr int s_lsb
+	= std::numeric_limits<Tp>::min_exponent - 2 * s_digits + 1;
+
+      /// The value bits, a carry word for at least 2^63 updates
+      /// and room for the sign.
+      static constexpr std::size_t s_num_limbs
+	= (std::numeric_limits<Tp>::max_exponent - 1 - s_lsb) / 64 + 4;
+
+      void m_update(Tp x, bool subtract);
+
+      /// The little-endian words of the accumulator.
+      std::vector<std::uint64_t> m_limb;
+
+      std::ptrdiff_t m_num_pos_inf = 0;
+      std::ptrdiff_t m_num_neg_inf = 0;
+      std::ptrdiff_t m_num_nan = 0;
+    };
+
+  /**
+   * An exact sum of complex numbers: the real and imaginary parts
+   * are summed separately.
+   */
+  template<typename Tp>
+    class exact_sum<std::complex<Tp>>
+    {
+    public:
+
+      exact_sum&
+      operator+=(const std::complex<Tp>& x)
+      {
+	this->m_real += x.real();
+	this->m_imag += x.imag();
+	return *this;
+      }
+
+      exact_sum&
+      operator-=(const std::complex<Tp>& x)
+      {
+	this->m_real -= x.real();
+	this->m_imag -= x.imag();
+	return *this;
+      }
+
+      std::complex<Tp>
+      value() const
+      { return {this->m_real.value(), this->m_imag.value()}; }
+
+      void
+      clear()
+      {
+	this->m_real.clear();
+	this->m_imag.clear();
+      }
+
+    private:
+
+      exact_sum<Tp> m_real;
+      exact_sum<Tp> m_imag;
+    };
+
+} // namespace emsr
+
+#include <emsr/compensated_sum.tcc>
+
+#endif // COMPENSATED_SUM_H
@@ -0,0 +1,143 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements compensated and exact running sums.
+
+#ifndef COMPENSATED_SUM_TCC
+#define COMPENSATED_SUM_TCC 1
+
+#include <algorithm>
+
+namespace emsr
+{
+
+  /**
+   * Add or subtract a term in the accumulator.
+   */
+  template<typename Tp>
+    void
+    exact_sum<Tp>::m_update(Tp x, bool subtract)
+    {
+      const std::ptrdiff_t step = subtract ? -1 : +1;
+      if (std::isnan(x))
+	{
+	  this->m_num_nan += step;
+	  return;
+	}
+      else if (std::isinf(x))
+	{
+	  (x > Tp{0} ? this->m_num_pos_inf : this->m_num_neg_inf) += step;
+	  return;
+	}
+      else if (x == Tp{0})
+	return;
+
+      if (this->m_limb.empty())
+	this->m_limb.assign(s_num_limbs, 0);
+
+      // Split |x| = M 2^(e - digits) with the integer mantissa M
+      // in at most two words.
+      int e;
+      const auto mant = std::ldexp(std::frexp(std::abs(x), &e), s_digits);
+      const auto hi_mant = std::floor(std::ldexp(mant, -64));
+      const auto lo_mant = mant - std::ldexp(hi_mant, 64);
+      const auto hi = static_cast<std::uint64_t>(hi_mant);
+      const auto lo = static_cast<std::uint64_t>(lo_mant);
+
+      // Shift the mantissa into place over three words.
+      const auto pos = std::size_t(e - s_digits - s_lsb);
+      const auto shift = pos % 64;
+      std::uint64_t word[3];
+      word[0] = lo << shift;
+      word[1] = shift == 0 ? hi : (hi << shift) | (lo >> (64 - shift));
+      word[2] = shift == 0 ? 0 : hi >> (64 - shift);
+
+      const bool negate = (x < Tp{0}) != subtract;
+      std::uint64_t carry = 0;
+      for (auto k = pos / 64, i = std::size_t{0};
+	   k < s_num_limbs && (i < 3 || carry != 0); ++k, ++i)
+	{
+	  const auto w = i < 3 ? word[i] : std::uint64_t{0};
+	  auto& limb = this->m_limb[k];
+	  if (negate)
+	    {
+	      const auto diff = limb - w;
+	      const auto borrow = std::uint64_t(limb < w)
+				+ std::uint64_t(diff < carry);
+	      limb = diff - carry;
+	      carry = borrow;
+	    }
+	  else
+	    {
+	      const auto sum = limb + w;
+	      const auto carry1 = std::uint64_t(sum < w);
+	      limb = sum + carry;
+	      carry = carry1 + std::uint64_t(limb < carry);
+	    }
+	}
+    }
+
+  /**
+   * Return the sum rounded to @c Tp.
+   * The rounding depends only on the exact sum.
+   */
+  template<typename Tp>
+    Tp
+    exact_sum<Tp>::value() const
+    {
+      const bool pos_inf = this->m_num_pos_inf > 0 || this->m_num_neg_inf < 0;
+      const bool neg_inf = this->m_num_neg_inf > 0 || this->m_num_pos_inf < 0;
+      if (this->m_num_nan != 0 || (pos_inf && neg_inf))
+	return std::numeric_limits<Tp>::quiet_NaN();
+      else if (pos_inf)
+	return +std::numeric_limits<Tp>::infinity();
+      else if (neg_inf)
+	return -std::numeric_limits<Tp>::infinity();
+      else if (this->m_limb.empty())
+	return Tp{0};
+
+      // Take the magnitude of the two's complement accumulator.
+      auto limb = this->m_limb;
+      const bool negative = (limb.back() >> 63) != 0;
+      if (negative)
+	{
+	  std::uint64_t carry = 1;
+	  for (auto& w : limb)
+	    {
+	      w = ~w + carry;
+	      carry = carry != 0 && w == 0;
+	    }
+	}
+
+      auto top = limb.size();
+      while (top > 0 && limb[top - 1] == 0)
+	--top;
+      if (top == 0)
+	return Tp{0};
+
+      // Three words hold at least 129 bits: more than the mantissa.
+      compensated_sum<Tp> sum;
+      for (auto k = top > 3 ? top - 3 : std::size_t{0}; k < top; ++k)
+	sum += std::ldexp(Tp(limb[k]), int(64 * k) + s_lsb);
+      const auto result = sum.value();
+
+      return negative ? -result : result;
+    }
+
+} // namespace emsr
+
+#endif // COMPENSATED_SUM_TCC
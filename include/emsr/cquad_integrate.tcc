@@ -26,11 +26,16 @@
 #ifndef CQUAD_INTEGRATE_TCC
 #define CQUAD_INTEGRATE_TCC 1
 
+#include <algorithm>
+#include <cmath>
+#include <new>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 #include <emsr/cquad_const.tcc>
 #include <emsr/cquad_workspace.h>
+#include <emsr/integration_checkpoint.h>
 #include <emsr/complex_util.h> // isinf/isnan for complex
 
 namespace emsr
@@ -119,39 +124,32 @@ namespace emsr
     }
 
   /**
-   * CQUAD is a new doubly-adaptive general-purpose quadrature routine
-   * which can handle most types of singularities, non-numerical function
-   * values such as Inf or NaN, as well as some divergent integrals.
-   * It generally requires more function evaluations than
-   * the other integration routines in this library, yet fails
-   * less often for difficult integrands.
+   * CQUAD integration without throwing when the tolerance is not met,
+   * resuming from and checkpointing to a saved state.
+   * The error code, the result and error estimate and
+   * the number of function evaluations are returned.
+   * The error code is DIVERGENCE_ERROR if the integral was found
+   * to diverge and ROUNDOFF_ERROR if the tolerance was not met
+   * when all remaining intervals were too small to split.
+   * Invalid tolerances still throw.
    *
-   * The underlying algorithm uses a doubly-adaptive scheme
-   * in which Clenshaw-Curtis quadrature rules of increasing degree
-   * are used to compute the integral in each interval.
-   * The L_2-norm of the difference between the underlying interpolatory
-   * polynomials of two successive rules is used as an error estimate.
-   * The interval is subdivided if the difference between two successive
-   * rules is too large or a rule of maximum degree has been reached.
-   *
-   * The CQUAD algorithm divides the integration region into subintervals,
-   * and in each iteration, the subinterval with the largest estimated error
-   * is processed. The algorithm uses Clenshaw-Curtis quadrature rules
-   * of degree 4, 8, 16 and 32 over 5, 9, 17 and 33 nodes respectively.
-   * Each interval is initialized with the lowest-degree rule.
-   * When an interval is processed, the next-higher degree rule is evaluated
-   * and an error estimate is computed based on the L_2-norm of the difference
-   * between the underlying interpolating polynomials of both rules.
-   * If the highest-degree rule has already been used, or the interpolatory
-   * polynomials differ significantly, the interval is bisected. 
+   * Before each interval update the callback @c checkpoint is called
+   * with the workspace and the loop state.  Saving both there,
+   * with cquad_workspace::save() and cquad_state::save(),
+   * and restoring them later resumes the integration with the same
+   * result as an uninterrupted run.  A default-constructed state
+   * starts a new integration.
    */
-  template<typename Tp, typename FuncTp>
+  template<typename Tp, typename FuncTp, typename CheckpointFunc>
     auto
-    cquad_integrate(cquad_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>& ws,
+    cquad_integrate(std::nothrow_t,
+		    cquad_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>& ws,
 		    FuncTp func,
 		    Tp a, Tp b,
-		    Tp epsabs, Tp epsrel)
-    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+		    Tp epsabs, Tp epsrel,
+		    cquad_state<Tp, std::invoke_result_t<FuncTp, Tp>>& state,
+		    CheckpointFunc checkpoint)
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
       using RetTp = std::invoke_result_t<FuncTp, Tp>;
       using AreaTp = decltype(RetTp{} * Tp{});
@@ -180,65 +178,82 @@ namespace emsr
       if (epsabs <= Tp{0} && epsrel < s_eps)
 	throw std::domain_error("unreasonable accuracy requirement");
 
-      // Create the first interval.
-      ws.clear();
-      cquad_interval<Tp, RetTp> iv;
-      auto m = (a + b) / Tp{2};
-      auto h = (b - a) / Tp{2};
-      num_NaNs = 0;
-      for (std::ptrdiff_t i = 0; i <= n[3]; ++i)
+      auto& num_evals = state.num_evals;
+      auto counted_func = [&func, &num_evals](Tp x)
+			  { ++num_evals; return func(x); };
+
+      auto& igral = state.igral;
+      auto& igral_final = state.igral_final;
+      auto& err = state.err;
+      auto& err_final = state.err_final;
+
+      Tp m, h;
+      if (!state.started)
 	{
-	  iv.fx[i] = func(m + Tp(xi[i]) * h);
-	  if (std::isinf(iv.fx[i]) || std::isnan(iv.fx[i]))
+	  // Create the first interval.
+	  ws.clear();
+	  cquad_interval<Tp, RetTp> iv;
+	  m = (a + b) / Tp{2};
+	  h = (b - a) / Tp{2};
+	  num_NaNs = 0;
+	  for (std::ptrdiff_t i = 0; i <= n[3]; ++i)
 	    {
-	      NaN[num_NaNs++] = i;
-	      iv.fx[i] = RetTp{0};
+	      iv.fx[i] = counted_func(m + Tp(xi[i]) * h);
+	      if (std::isinf(iv.fx[i]) || std::isnan(iv.fx[i]))
+		{
+		  NaN[num_NaNs++] = i;
+		  iv.fx[i] = RetTp{0};
+		}
 	    }
+	  Vinvfx(iv.fx, &(iv.m_coeff[idx[0]]), 0);
+	  Vinvfx(iv.fx, &(iv.m_coeff[idx[3]]), 3);
+	  Vinvfx(iv.fx, &(iv.m_coeff[idx[2]]), 2);
+	  for (std::ptrdiff_t i = 0; i < num_NaNs; ++i)
+	    iv.fx[NaN[i]] = s_NaN;
+	  iv.m_lower_lim = a;
+	  iv.m_upper_lim = b;
+	  iv.depth = 3;
+	  iv.rdepth = 1;
+	  iv.ndiv = 0;
+	  iv.m_result = Tp{2} * h * iv.m_coeff[idx[3]] * w;
+	  nc = AbsRetTp{0};
+	  for (std::ptrdiff_t i = n[2] + 1; i <= n[3]; ++i)
+	    {
+	      const auto temp = std::abs(iv.m_coeff[idx[3] + i]);
+	      nc += temp * temp;
+	    }
+	  ncdiff = nc;
+	  for (std::ptrdiff_t i = 0; i <= n[2]; ++i)
+	    {
+	      const auto temp = std::abs(iv.m_coeff[idx[2] + i]
+					 - iv.m_coeff[idx[3] + i]);
+	      ncdiff += temp * temp;
+	      nc += std::abs(iv.m_coeff[idx[3] + i])
+		    * std::abs(iv.m_coeff[idx[3] + i]);
+	    }
+	  ncdiff = std::sqrt(ncdiff);
+	  nc = std::sqrt(nc);
+	  iv.m_abs_error = ncdiff * Tp{2} * h;
+	  if (ncdiff / nc > Tp{0.1} && iv.m_abs_error < Tp{2} * h * nc)
+	    iv.m_abs_error = Tp{2} * h * nc;
+	  ws.push(iv);
+
+	  igral = iv.m_result;
+	  igral_final = AreaTp{0};
+	  err = iv.m_abs_error;
+	  err_final = Tp{0};
+	  state.started = true;
 	}
-      Vinvfx(iv.fx, &(iv.m_coeff[idx[0]]), 0);
-      Vinvfx(iv.fx, &(iv.m_coeff[idx[3]]), 3);
-      Vinvfx(iv.fx, &(iv.m_coeff[idx[2]]), 2);
-      for (std::ptrdiff_t i = 0; i < num_NaNs; ++i)
-	iv.fx[NaN[i]] = s_NaN;
-      iv.m_lower_lim = a;
-      iv.m_upper_lim = b;
-      iv.depth = 3;
-      iv.rdepth = 1;
-      iv.ndiv = 0;
-      iv.m_result = Tp{2} * h * iv.m_coeff[idx[3]] * w;
-      nc = AbsRetTp{0};
-      for (std::ptrdiff_t i = n[2] + 1; i <= n[3]; ++i)
-	{
-	  const auto temp = std::abs(iv.m_coeff[idx[3] + i]);
-	  nc += temp * temp;
-	}
-      ncdiff = nc;
-      for (std::ptrdiff_t i = 0; i <= n[2]; ++i)
-	{
-	  const auto temp = std::abs(iv.m_coeff[idx[2] + i]
-				     - iv.m_coeff[idx[3] + i]);
-	  ncdiff += temp * temp;
-	  nc += std::abs(iv.m_coeff[idx[3] + i])
-		* std::abs(iv.m_coeff[idx[3] + i]);
-	}
-      ncdiff = std::sqrt(ncdiff);
-      nc = std::sqrt(nc);
-      iv.m_abs_error = ncdiff * Tp{2} * h;
-      if (ncdiff / nc > Tp{0.1} && iv.m_abs_error < Tp{2} * h * nc)
-	iv.m_abs_error = Tp{2} * h * nc;
-      ws.push(iv);
 
       // Main loop...
-      auto igral = iv.m_result;
-      auto igral_final = AreaTp{0};
-      auto err = iv.m_abs_error;
-      auto err_final = Tp{0};
       while (ws.size() > 0 && err > Tp{0} &&
 	     !(err <= std::abs(igral) * epsrel || err <= epsabs)
 	     && !(err_final > std::abs(igral) * epsrel
 		  && err - err_final < std::abs(igral) * epsrel)
 	     && !(err_final > epsabs && err - err_final < epsabs))
 	{
+	  checkpoint(std::as_const(ws), std::as_const(state));
+
 	  // Put our finger on the interval with the largest error.
 	  auto& iv = ws.top();
 	  m = (iv.m_lower_lim + iv.m_upper_lim) / Tp{2};
@@ -253,7 +268,7 @@ namespace emsr
 	      // Get the new (missing) function values.
 	      for (std::ptrdiff_t i = skip[depth];
 			i <= 32; i += 2 * skip[depth])
-		iv.fx[i] = func(m + Tp(xi[i]) * h);
+		iv.fx[i] = counted_func(m + Tp(xi[i]) * h);
 	      num_NaNs = 0;
 	      for (std::ptrdiff_t i = 0; i <= 32; i += skip[depth])
 		if (std::isinf(iv.fx[i]) || std::isnan(iv.fx[i]))
@@ -331,7 +346,7 @@ namespace emsr
 	      ivl.fx[0] = iv.fx[0];
 	      ivl.fx[32] = iv.fx[16];
 	      for (std::ptrdiff_t i = skip[0]; i < 32; i += skip[0])
-		ivl.fx[i] = func((ivl.m_lower_lim + ivl.m_upper_lim)
+		ivl.fx[i] = counted_func((ivl.m_lower_lim + ivl.m_upper_lim)
 			      / Tp{2} + Tp(xi[i]) * h / Tp{2});
 	      num_NaNs = 0;
 	      for (std::ptrdiff_t i = 0; i <= 32; i += skip[0])
@@ -381,7 +396,8 @@ namespace emsr
 	      if (ivl.ndiv > ndiv_max && 2 * ivl.ndiv > ivl.rdepth)
 		{
 		  //const auto result = std::copysign(s_inf, igral);
-		  return {AreaTp(s_inf), s_inf};
+		  return {AreaTp(s_inf), s_inf, DIVERGENCE_ERROR, num_evals,
+			  "cquad_integrate: The integral is divergent"};
 		}
 
 	      // Compute the local integral.
@@ -396,7 +412,7 @@ namespace emsr
 	      ivr.fx[0] = iv.fx[16];
 	      ivr.fx[32] = iv.fx[32];
 	      for (std::ptrdiff_t i = skip[0]; i < 32; i += skip[0])
-		ivr.fx[i] = func((ivr.m_lower_lim + ivr.m_upper_lim)
+		ivr.fx[i] = counted_func((ivr.m_lower_lim + ivr.m_upper_lim)
 			      / Tp{2} + Tp(xi[i]) * h / Tp{2});
 	      num_NaNs = 0;
 	      for (std::ptrdiff_t i = 0; i <= 32; i += skip[0])
@@ -446,7 +462,8 @@ namespace emsr
 	      if (ivr.ndiv > ndiv_max && 2 * ivr.ndiv > ivr.rdepth)
 		{
 		  //const auto result = std::copysign(s_inf, igral);
-		  return {AreaTp(s_inf), s_inf};
+		  return {AreaTp(s_inf), s_inf, DIVERGENCE_ERROR, num_evals,
+			  "cquad_integrate: The integral is divergent"};
 		}
 
 	      // Compute the local integral.
@@ -464,7 +481,101 @@ namespace emsr
 	  err = err_final + ws.total_error();
 	}
 
-      return {igral, err};
+      if (std::isinf(err))
+	return {igral, err, DIVERGENCE_ERROR, num_evals,
+		"cquad_integrate: The integral is divergent"};
+      else if (err > std::max(epsabs, epsrel * std::abs(igral)))
+	return {igral, err, ROUNDOFF_ERROR, num_evals,
+		"cquad_integrate: Cannot reach tolerance because "
+		"of roundoff error"};
+      else
+	return {igral, err, NO_ERROR, num_evals};
+    }
+
+  /**
+   * CQUAD is a new doubly-adaptive general-purpose quadrature routine
+   * which can handle most types of singularities, non-numerical function
+   * values such as Inf or NaN, as well as some divergent integrals.
+   * It generally requires more function evaluations than
+   * the other integration routines in this library, yet fails
+   * less often for difficult integrands.
+   *
+   * The underlying algorithm uses a doubly-adaptive scheme
+   * in which Clenshaw-Curtis quadrature rules of increasing degree
+   * are used to compute the integral in each interval.
+   * The L_2-norm of the difference between the underlying interpolatory
+   * polynomials of two successive rules is used as an error estimate.
+   * The interval is subdivided if the difference between two successive
+   * rules is too large or a rule of maximum degree has been reached.
+   *
+   * The CQUAD algorithm divides the integration region into subintervals,
+   * and in each iteration, the subinterval with the largest estimated error
+   * is processed. The algorithm uses Clenshaw-Curtis quadrature rules
+   * of degree 4, 8, 16 and 32 over 5, 9, 17 and 33 nodes respectively.
+   * Each interval is initialized with the lowest-degree rule.
+   * When an interval is processed, the next-higher degree rule is evaluated
+   * and an error estimate is computed based on the L_2-norm of the difference
+   * between the underlying interpolating polynomials of both rules.
+   * If the highest-degree rule has already been used, or the interpolatory
+   * polynomials differ significantly, the interval is bisected. 
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    cquad_integrate(cquad_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>& ws,
+		    FuncTp func,
+		    Tp a, Tp b,
+		    Tp epsabs, Tp epsrel)
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      cquad_state<Tp, std::invoke_result_t<FuncTp, Tp>> state;
+      const auto status = cquad_integrate(std::nothrow, ws, func, a, b,
+					  epsabs, epsrel, state,
+					  [](const auto&, const auto&){});
+      return {status.result, status.abserr};
+    }
+
+  /**
+   * CQUAD integration resuming from and checkpointing to a saved state.
+   * The callback @c checkpoint is called with the workspace and the state
+   * before each interval update.  See the non-throwing overload
+   * for details.
+   */
+  template<typename Tp, typename FuncTp, typename CheckpointFunc>
+    auto
+    cquad_integrate(cquad_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>& ws,
+		    FuncTp func,
+		    Tp a, Tp b,
+		    Tp epsabs, Tp epsrel,
+		    cquad_state<Tp, std::invoke_result_t<FuncTp, Tp>>& state,
+		    CheckpointFunc checkpoint)
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      const auto status = cquad_integrate(std::nothrow, ws, func, a, b,
+					  epsabs, epsrel, state, checkpoint);
+      return {status.result, status.abserr};
+    }
+
+  /**
+   * CQUAD integration without throwing when the tolerance is not met.
+   * The error code, the result and error estimate and
+   * the number of function evaluations are returned.
+   * The error code is DIVERGENCE_ERROR if the integral was found
+   * to diverge and ROUNDOFF_ERROR if the tolerance was not met
+   * when all remaining intervals were too small to split.
+   * Invalid tolerances still throw.
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    cquad_integrate(std::nothrow_t,
+		    cquad_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>& ws,
+		    FuncTp func,
+		    Tp a, Tp b,
+		    Tp epsabs, Tp epsrel)
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      cquad_state<Tp, std::invoke_result_t<FuncTp, Tp>> state;
+      return cquad_integrate(std::nothrow, ws, func, a, b, epsabs, epsrel,
+			     state, [](const auto&, const auto&){});
     }
 
 } // namespace emsr
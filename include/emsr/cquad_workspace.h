@@ -26,8 +26,16 @@
 #ifndef CQUAD_WORKSPACE_H
 #define CQUAD_WORKSPACE_H 1
 
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include <emsr/compensated_sum.h>
+#include <emsr/integration_snapshot.h>
+
 namespace emsr
 {
 
@@ -82,8 +90,16 @@ namespace emsr
 
       std::vector<cquad_interval<Tp, RetTp>> m_ival;
 
-      cquad_workspace(std::size_t len = 200)
-      : m_ival()
+      /// The summation of the totals over the intervals.
+      /// The intervals are updated in place so the totals are
+      /// recomputed when asked for; reproducible totals are exact sums
+      /// independent of the heap order.
+      summation_mode m_summation;
+
+      cquad_workspace(std::size_t len = 200,
+		      summation_mode mode = Summation_Compensated)
+      : m_ival(),
+	m_summation(mode)
       { this->m_ival.reserve(len); }
 
       std::size_t size() const
@@ -138,19 +154,107 @@ namespace emsr
       AreaTp
       total_integral() const
       {
-	auto tot_igral = AreaTp{0};
-	for (auto& iv : m_ival)
-	  tot_igral += iv.m_result;
-	return tot_igral;
+	if (this->m_summation == Summation_Reproducible)
+	  {
+	    exact_sum<AreaTp> tot_igral;
+	    for (auto& iv : m_ival)
+	      tot_igral += iv.m_result;
+	    return tot_igral.value();
+	  }
+	else
+	  {
+	    compensated_sum<AreaTp> tot_igral;
+	    for (auto& iv : m_ival)
+	      tot_igral += iv.m_result;
+	    return tot_igral.value();
+	  }
       }
 
       AbsAreaTp
       total_error() const
       {
-	auto tot_error = AbsAreaTp{0};
-	for (auto& iv : m_ival)
-	  tot_error += iv.m_abs_error;
-	return tot_error;
+	if (this->m_summation == Summation_Reproducible)
+	  {
+	    exact_sum<AbsAreaTp> tot_error;
+	    for (auto& iv : m_ival)
+	      tot_error += iv.m_abs_error;
+	    return tot_error.value();
+	  }
+	else
+	  {
+	    compensated_sum<AbsAreaTp> tot_error;
+	    for (auto& iv : m_ival)
+	      tot_error += iv.m_abs_error;
+	    return tot_error.value();
+	  }
+      }
+
+      /**
+       * Write the intervals in heap order with their function values
+       * and coefficients to a binary snapshot.
+       */
+      void
+      save(std::ostream& out) const
+      {
+	detail::write_snapshot_header<Tp, AreaTp>(out,
+					Snapshot_Cquad_Workspace);
+	detail::write_value(out, std::uint64_t(this->capacity()));
+	detail::write_value(out, std::uint32_t(this->m_summation));
+	detail::write_value(out, std::uint64_t(this->m_ival.size()));
+	for (const auto& iv : this->m_ival)
+	  {
+	    detail::write_value(out, iv.m_lower_lim);
+	    detail::write_value(out, iv.m_upper_lim);
+	    detail::write_value(out, iv.m_result);
+	    detail::write_value(out, iv.m_abs_error);
+	    detail::write_values(out, iv.m_coeff, 64);
+	    detail::write_values(out, iv.fx.data(), iv.fx.size());
+	    detail::write_value(out, std::uint64_t(iv.depth));
+	    detail::write_value(out, std::uint64_t(iv.rdepth));
+	    detail::write_value(out, std::uint64_t(iv.ndiv));
+	  }
+      }
+
+      /**
+       * Restore the intervals from a binary snapshot written by save().
+       * The capacity and summation mode become those of the saved
+       * workspace.
+       */
+      void
+      restore(std::istream& in)
+      {
+	detail::read_snapshot_header<Tp, AreaTp>(in,
+					Snapshot_Cquad_Workspace);
+	std::uint64_t cap, size;
+	std::uint32_t summation;
+	detail::read_value(in, cap);
+	detail::read_value(in, summation);
+	detail::read_value(in, size);
+	if (size > cap || summation > Summation_Reproducible)
+	  throw std::runtime_error("cquad_workspace: Inconsistent snapshot");
+
+	std::vector<cquad_interval<Tp, RetTp>> ival;
+	ival.reserve(cap);
+	for (std::uint64_t i = 0; i < size; ++i)
+	  {
+	    cquad_interval<Tp, RetTp> iv;
+	    std::uint64_t depth, rdepth, ndiv;
+	    detail::read_value(in, iv.m_lower_lim);
+	    detail::read_value(in, iv.m_upper_lim);
+	    detail::read_value(in, iv.m_result);
+	    detail::read_value(in, iv.m_abs_error);
+	    detail::read_values(in, iv.m_coeff, 64);
+	    detail::read_values(in, iv.fx.data(), iv.fx.size());
+	    detail::read_value(in, depth);
+	    detail::read_value(in, rdepth);
+	    detail::read_value(in, ndiv);
+	    iv.depth = depth;
+	    iv.rdepth = rdepth;
+	    iv.ndiv = ndiv;
+	    ival.push_back(iv);
+	  }
+	this->m_ival = std::move(ival);
+	this->m_summation = summation_mode(summation);
       }
     };
 
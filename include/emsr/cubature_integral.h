@@ -0,0 +1,202 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements adaptive cubature over hyper-rectangles.
+
+#ifndef CUBATURE_INTEGRAL_H
+#define CUBATURE_INTEGRAL_H 1
+
+#include <array>
+#include <cstddef>
+#include <new> // For std::nothrow
+#include <type_traits>
+
+#include <emsr/integration.h>
+#include <emsr/cubature_workspace.h>
+
+namespace emsr
+{
+
+  /**
+   * The return type of one application of the Genz-Malik rule.
+   */
+  template<typename Tp, typename RetTp>
+    struct genz_malik_integral_t
+    {
+      using AreaTp = decltype(RetTp{} * Tp{});
+      using AbsAreaTp = decltype(std::abs(AreaTp{}));
+
+      /// The result of the degree 7 rule.
+      AreaTp result;
+      /// The difference from the embedded degree 5 rule.
+      AbsAreaTp abserr;
+      /// The axis with the largest fourth divided difference.
+      std::size_t split_axis;
+    };
+
+  /**
+   * The embedded pair of fully symmetric rules of degree 7 and 5
+   * for the hyper-cube of
+   * A. C. Genz and A. A. Malik, Remarks on algorithm 006: An adaptive
+   * algorithm for numerical integration over an N-dimensional rectangular
+   * region, J. Comput. Appl. Math. 6 (1980), 295-302.
+   *
+   * The rule uses @f$ 2^d + 2d^2 + 2d + 1 @f$ points: 17 in two dimensions,
+   * 33 in three and 401 in eight.  Beyond a dozen or so dimensions
+   * the @f$ 2^d @f$ corner points dominate and sparse grids or
+   * quasi-Monte Carlo are better choices.
+   *
+   * Besides the error estimate the rule returns the axis along which
+   * the integrand has the largest fourth divided difference;
+   * adaptive integration bisects the region along that axis.
+   */
+  template<typename Tp, std::size_t Dim>
+    class genz_malik_integral
+    {
+      static_assert(Dim >= 2, "genz_malik_integral: Dimension must be"
+			      " at least two; use a one-dimensional rule.");
+
+    public:
+
+      genz_malik_integral();
+
+      /**
+       * Integrate over a hyper-rectangle returning the result of the higher
+       * rule, the difference with the lower rule as error estimate
+       * and the axis to split.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(FuncTp func, const hyper_rectangle<Tp, Dim>& box) const
+	-> genz_malik_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+      template<typename FuncTp>
+	auto
+	operator()(FuncTp func, const hyper_rectangle<Tp, Dim>& box) const
+	-> genz_malik_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+	{ return this->integrate(func, box); }
+
+      /// Return the number of points (function evaluations) of the pair.
+      static constexpr std::size_t
+      size()
+      { return (std::size_t{1} << Dim) + 2 * Dim * Dim + 2 * Dim + 1; }
+
+      /// Return the polynomial degree of the higher rule.
+      static constexpr int
+      degree()
+      { return 7; }
+
+      /// Return the polynomial degree of the embedded lower rule.
+      static constexpr int
+      embedded_degree()
+      { return 5; }
+
+    private:
+
+      Tp m_lambda2;
+      Tp m_lambda4;
+      Tp m_lambda5;
+
+      std::array<Tp, 5> m_weight;
+      std::array<Tp, 4> m_embedded_weight;
+    };
+
+  /**
+   * Adaptively integrate over a hyper-rectangle.
+   *
+   * The regions with the largest error estimates are taken from
+   * the workspace heap and bisected along the axis of largest fourth
+   * difference until the total error meets the tolerance
+   * or the workspace is full.
+   *
+   * Each step takes regions off the heap, largest errors first,
+   * until the error removed covers the excess over the tolerance
+   * or max_batch regions have been taken.  The children of all the regions
+   * of a step are evaluated together on @c num_threads threads
+   * (0 means hardware concurrency).  The choice of regions does not depend
+   * on the number of threads and neither do the results.
+   *
+   * This overload does not throw when the tolerance is not met;
+   * the error code, the best result and error estimate found and
+   * the number of function evaluations are returned instead.
+   * Invalid tolerances still throw.
+   *
+   * @param workspace The workspace that manages the region heap.
+   * @param func The function of a point to be integrated.
+   * @param lower The lower limits of integration.
+   * @param upper The upper limits of integration.
+   * @param max_abs_err The limit on absolute error.
+   * @param max_rel_err The limit on relative error.
+   * @param num_threads The number of threads.
+   * @param max_batch The maximum number of regions bisected per step.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    adaptive_cubature_integrate(std::nothrow_t,
+		cubature_workspace<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>, Dim>&
+		  workspace,
+		FuncTp func,
+		const std::array<Tp, Dim>& lower,
+		const std::array<Tp, Dim>& upper,
+		Tp max_abs_err, Tp max_rel_err,
+		unsigned int num_threads = 1,
+		std::size_t max_batch = 64)
+    -> adaptive_status_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+  /**
+   * Adaptively integrate over a hyper-rectangle.
+   * An integration_error is thrown if the tolerance is not met.
+   * The arguments are those of the non-throwing overload.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    adaptive_cubature_integrate(cubature_workspace<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>, Dim>&
+		  workspace,
+		FuncTp func,
+		const std::array<Tp, Dim>& lower,
+		const std::array<Tp, Dim>& upper,
+		Tp max_abs_err, Tp max_rel_err,
+		unsigned int num_threads = 1,
+		std::size_t max_batch = 64)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+  /**
+   * Adaptively integrate over a hyper-rectangle
+   * with at most @c max_iter bisections.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_cubature(FuncTp func,
+		       const std::array<Tp, Dim>& lower,
+		       const std::array<Tp, Dim>& upper,
+		       Tp max_abs_err, Tp max_rel_err,
+		       std::size_t max_iter = 4096,
+		       unsigned int num_threads = 1)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+} // namespace emsr
+
+#include <emsr/cubature_integral.tcc>
+
+#endif // CUBATURE_INTEGRAL_H
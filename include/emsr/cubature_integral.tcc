@@ -0,0 +1,346 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements adaptive cubature over hyper-rectangles.
+
+#ifndef CUBATURE_INTEGRAL_TCC
+#define CUBATURE_INTEGRAL_TCC 1
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <emsr/integration_error.h>
+#include <emsr/parallel_for.h>
+
+namespace emsr
+{
+
+  /**
+   * Set up the generators and the weights of the pair.
+   * The weights are for the mean over the region
+   * and are scaled by its volume.
+   */
+  template<typename Tp, std::size_t Dim>
+    genz_malik_integral<Tp, Dim>::genz_malik_integral()
+    : m_lambda2(std::sqrt(Tp{9} / Tp{70})),
+      m_lambda4(std::sqrt(Tp{9} / Tp{10})),
+      m_lambda5(std::sqrt(Tp{9} / Tp{19})),
+      m_weight{}, m_embedded_weight{}
+    {
+      const auto n = Tp(Dim);
+      this->m_weight[0] = (Tp{12824} - Tp{9120} * n + Tp{400} * n * n)
+			/ Tp{19683};
+      this->m_weight[1] = Tp{980} / Tp{6561};
+      this->m_weight[2] = (Tp{1820} - Tp{400} * n) / Tp{19683};
+      this->m_weight[3] = Tp{200} / Tp{19683};
+      this->m_weight[4] = Tp{6859} / Tp{19683} / Tp(std::size_t{1} << Dim);
+
+      this->m_embedded_weight[0] = (Tp{729} - Tp{950} * n + Tp{50} * n * n)
+				 / Tp{729};
+      this->m_embedded_weight[1] = Tp{245} / Tp{486};
+      this->m_embedded_weight[2] = (Tp{265} - Tp{100} * n) / Tp{1458};
+      this->m_embedded_weight[3] = Tp{25} / Tp{729};
+    }
+
+  template<typename Tp, std::size_t Dim>
+    template<typename FuncTp>
+      auto
+      genz_malik_integral<Tp, Dim>::integrate(FuncTp func,
+				const hyper_rectangle<Tp, Dim>& box) const
+      -> genz_malik_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+      {
+	using RetTp = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>;
+	using AreaTp = decltype(RetTp{} * Tp{});
+	using AbsAreaTp = decltype(std::abs(AreaTp{}));
+	const auto s_eps = std::numeric_limits<AbsAreaTp>::epsilon();
+	// The ratio of the squares of the two axial generators.
+	const auto s_ratio = Tp{1} / Tp{7};
+
+	const auto& c = box.center;
+	const auto& h = box.halfwidth;
+	auto x = c;
+
+	const auto f0 = func(x);
+	auto sum2 = RetTp{0}, sum3 = RetTp{0};
+	auto abs2 = AbsAreaTp{0}, abs3 = AbsAreaTp{0};
+	auto max_diff = AbsAreaTp{-1};
+	std::size_t split_axis = 0;
+	for (std::size_t i = 0; i < Dim; ++i)
+	  {
+	    x[i] = c[i] - this->m_lambda2 * h[i];
+	    const auto f2m = func(x);
+	    x[i] = c[i] + this->m_lambda2 * h[i];
+	    const auto f2p = func(x);
+	    x[i] = c[i] - this->m_lambda4 * h[i];
+	    const auto f3m = func(x);
+	    x[i] = c[i] + this->m_lambda4 * h[i];
+	    const auto f3p = func(x);
+	    x[i] = c[i];
+
+	    sum2 += f2m + f2p;
+	    sum3 += f3m + f3p;
+	    abs2 += std::abs(f2m) + std::abs(f2p);
+	    abs3 += std::abs(f3m) + std::abs(f3p);
+
+	    // Split along the axis with the largest fourth difference;
+	    // break ties in favour of the widest axis.
+	    const auto diff = std::abs(f2m + f2p - RetTp{2} * f0
+				- s_ratio * (f3m + f3p - RetTp{2} * f0));
+	    if (diff > max_diff * (AbsAreaTp{1} + AbsAreaTp{100} * s_eps))
+	      {
+		max_diff = diff;
+		split_axis = i;
+	      }
+	    else if (diff >= max_diff * (AbsAreaTp{1} - AbsAreaTp{100} * s_eps)
+		     && h[i] > h[split_axis])
+	      split_axis = i;
+	  }
+
+	auto sum4 = RetTp{0};
+	auto abs4 = AbsAreaTp{0};
+	for (std::size_t i = 0; i < Dim; ++i)
+	  for (std::size_t j = i + 1; j < Dim; ++j)
+	    for (int s = 0; s < 4; ++s)
+	      {
+		x[i] = c[i] + (s & 1 ? Tp{1} : Tp{-1}) * this->m_lambda4 * h[i];
+		x[j] = c[j] + (s & 2 ? Tp{1} : Tp{-1}) * this->m_lambda4 * h[j];
+		const auto f4 = func(x);
+		sum4 += f4;
+		abs4 += std::abs(f4);
+		x[i] = c[i];
+		x[j] = c[j];
+	      }
+
+	auto sum5 = RetTp{0};
+	auto abs5 = AbsAreaTp{0};
+	for (std::size_t s = 0; s < (std::size_t{1} << Dim); ++s)
+	  {
+	    for (std::size_t i = 0; i < Dim; ++i)
+	      x[i] = c[i] + ((s >> i) & 1 ? Tp{1} : Tp{-1})
+			  * this->m_lambda5 * h[i];
+	    const auto f5 = func(x);
+	    sum5 += f5;
+	    abs5 += std::abs(f5);
+	  }
+
+	const auto& w = this->m_weight;
+	const auto& we = this->m_embedded_weight;
+	const auto res7 = w[0] * f0 + w[1] * sum2 + w[2] * sum3
+			+ w[3] * sum4 + w[4] * sum5;
+	const auto res5 = we[0] * f0 + we[1] * sum2 + we[2] * sum3
+			+ we[3] * sum4;
+	const auto resabs = std::abs(w[0]) * std::abs(f0) + w[1] * abs2
+			  + std::abs(w[2]) * abs3 + w[3] * abs4 + w[4] * abs5;
+
+	const auto vol = box.volume();
+	genz_malik_integral_t<Tp, RetTp> out;
+	out.result = vol * res7;
+	out.abserr = std::max(std::abs(vol * (res7 - res5)),
+			      AbsAreaTp{50} * s_eps * std::abs(vol) * resabs);
+	out.split_axis = split_axis;
+	return out;
+      }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    adaptive_cubature_integrate(std::nothrow_t,
+		cubature_workspace<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>, Dim>&
+		  workspace,
+		FuncTp func,
+		const std::array<Tp, Dim>& lower,
+		const std::array<Tp, Dim>& upper,
+		Tp max_abs_err, Tp max_rel_err,
+		unsigned int num_threads,
+		std::size_t max_batch)
+    -> adaptive_status_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      using RetTp = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>;
+      using region_t = typename cubature_workspace<Tp, RetTp, Dim>::region;
+
+      const auto s_min_width = Tp{100} * std::numeric_limits<Tp>::epsilon();
+
+      if (!valid_tolerances(max_abs_err, max_rel_err))
+	{
+	  std::ostringstream msg;
+	  msg << "adaptive_cubature_integrate: Tolerance cannot be achieved"
+		 " with given absolute (" << max_abs_err << ") and relative ("
+	      << max_rel_err << ") error limits.";
+	  throw std::runtime_error(msg.str().c_str());
+	}
+      if (max_batch == 0)
+	max_batch = 1;
+
+      hyper_rectangle<Tp, Dim> box0;
+      for (std::size_t d = 0; d < Dim; ++d)
+	{
+	  box0.center[d] = (lower[d] + upper[d]) / Tp{2};
+	  box0.halfwidth[d] = (upper[d] - lower[d]) / Tp{2};
+	}
+
+      const genz_malik_integral<Tp, Dim> rule;
+      const auto [result0, abserr0, split0] = rule(func, box0);
+      // The children are evaluated in parallel so count rule applications.
+      std::size_t num_evals = rule.size();
+
+      auto tolerance = std::max(max_abs_err, max_rel_err * std::abs(result0));
+      if (abserr0 <= tolerance || abserr0 == Tp{0})
+	return {result0, abserr0, NO_ERROR, num_evals};
+      else if (workspace.max_size() < 2)
+	return {result0, abserr0, MAX_ITER_ERROR, num_evals,
+		"adaptive_cubature_integrate: "
+		"A maximum of one iteration was insufficient"};
+
+      workspace.clear();
+      workspace.push({box0, result0, abserr0, split0, 0});
+
+      auto area = result0;
+      auto errsum = abserr0;
+      int error_type = NO_ERROR;
+      std::vector<region_t> parent;
+      std::vector<hyper_rectangle<Tp, Dim>> child;
+      std::vector<decltype(rule(func, box0))> res;
+      while (errsum > tolerance && workspace.size() < workspace.max_size())
+	{
+	  // Take the regions with the largest errors until they
+	  // account for the excess error.
+	  const auto excess = errsum - tolerance;
+	  const auto room = std::min(max_batch,
+				     workspace.max_size() - workspace.size());
+	  auto taken = decltype(errsum){0};
+	  parent.clear();
+	  do
+	    {
+	      parent.push_back(workspace.pop());
+	      taken += parent.back().abs_error;
+	    }
+	  while (workspace.size() > 0 && parent.size() < room
+		 && taken < excess);
+
+	  // Bisect them along their split axes.
+	  child.resize(2 * parent.size());
+	  for (std::size_t p = 0; p < parent.size(); ++p)
+	    {
+	      const auto ax = parent[p].split_axis;
+	      auto lo = parent[p].box, hi = parent[p].box;
+	      lo.halfwidth[ax] /= Tp{2};
+	      hi.halfwidth[ax] /= Tp{2};
+	      lo.center[ax] -= lo.halfwidth[ax];
+	      hi.center[ax] += hi.halfwidth[ax];
+	      child[2 * p] = lo;
+	      child[2 * p + 1] = hi;
+	    }
+
+	  res.resize(child.size());
+	  parallel_for(0, child.size(), num_threads,
+		       [&rule, &func, &child, &res](std::size_t i)
+		       { res[i] = rule(func, child[i]); });
+	  num_evals += child.size() * rule.size();
+
+	  bool singular = false;
+	  for (std::size_t p = 0; p < parent.size(); ++p)
+	    {
+	      const auto& r1 = res[2 * p];
+	      const auto& r2 = res[2 * p + 1];
+	      const auto area2 = r1.result + r2.result;
+	      const auto error2 = r1.abserr + r2.abserr;
+	      workspace.push({child[2 * p], r1.result, r1.abserr,
+			      r1.split_axis, parent[p].depth + 1});
+	      workspace.push({child[2 * p + 1], r2.result, r2.abserr,
+			      r2.split_axis, parent[p].depth + 1});
+
+	      area += area2 - parent[p].result;
+	      errsum += error2 - parent[p].abs_error;
+
+	      const auto ax = parent[p].split_axis;
+	      if (std::abs(child[2 * p].halfwidth[ax])
+		  <= s_min_width * std::abs(box0.halfwidth[ax]))
+		singular = true;
+	    }
+	  tolerance = std::max(max_abs_err, max_rel_err * std::abs(area));
+
+	  // A bisection along one axis need not reduce the error
+	  // of the pair so there is no roundoff test as in QAG.
+	  // Set error flag in the case of bad integrand behaviour
+	  // at a point of the region.
+	  if (errsum > tolerance && singular)
+	    {
+	      error_type = SINGULAR_ERROR;
+	      break;
+	    }
+	}
+
+      const auto result = workspace.total_integral();
+      const auto abserr = workspace.total_error();
+
+      if (abserr <= tolerance)
+	return {result, abserr, NO_ERROR, num_evals};
+
+      if (error_type == NO_ERROR)
+	error_type = MAX_ITER_ERROR;
+
+      return {result, abserr, error_type, num_evals};
+    }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    adaptive_cubature_integrate(cubature_workspace<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>, Dim>&
+		  workspace,
+		FuncTp func,
+		const std::array<Tp, Dim>& lower,
+		const std::array<Tp, Dim>& upper,
+		Tp max_abs_err, Tp max_rel_err,
+		unsigned int num_threads,
+		std::size_t max_batch)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      return check_status(__func__,
+			  adaptive_cubature_integrate(std::nothrow, workspace,
+						      func, lower, upper,
+						      max_abs_err, max_rel_err,
+						      num_threads, max_batch));
+    }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_cubature(FuncTp func,
+		       const std::array<Tp, Dim>& lower,
+		       const std::array<Tp, Dim>& upper,
+		       Tp max_abs_err, Tp max_rel_err,
+		       std::size_t max_iter,
+		       unsigned int num_threads)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      using RetTp = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>;
+      cubature_workspace<Tp, RetTp, Dim> workspace(max_iter + 1);
+      return adaptive_cubature_integrate(workspace, func, lower, upper,
+					 max_abs_err, max_rel_err,
+					 num_threads);
+    }
+
+} // namespace emsr
+
+#endif // CUBATURE_INTEGRAL_TCC
@@ -0,0 +1,222 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef CUBATURE_WORKSPACE_H
+#define CUBATURE_WORKSPACE_H 1
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace emsr
+{
+
+  /**
+   * A hyper-rectangle given by its center and half-widths.
+   */
+  template<typename Tp, std::size_t Dim>
+    struct hyper_rectangle
+    {
+      using point_type = std::array<Tp, Dim>;
+
+      point_type center;
+      point_type halfwidth;
+
+      /// Return the volume of the hyper-rectangle.
+      Tp
+      volume() const
+      {
+	auto vol = Tp{1};
+	for (std::size_t d = 0; d < Dim; ++d)
+	  vol *= Tp{2} * this->halfwidth[d];
+	return vol;
+      }
+    };
+
+  /**
+   * A workspace for adaptive cubature over a hyper-rectangle.
+   *
+   * The regions live in a flat array and do not move once stored;
+   * the heap ordered by absolute error holds only small
+   * (error, index) entries so sifting touches a few contiguous words
+   * rather than whole regions.  The slots of popped regions are recycled.
+   */
+  template<typename Tp, typename RetTp, std::size_t Dim>
+    class cubature_workspace
+    {
+    public:
+
+      using AreaTp = decltype(RetTp{} * Tp{});
+      using ErrorTp = decltype(std::abs(AreaTp{}));
+
+      struct region
+      {
+	hyper_rectangle<Tp, Dim> box;
+	AreaTp result;
+	ErrorTp abs_error;
+	/// The axis along which the region should be bisected.
+	std::size_t split_axis;
+	std::size_t depth;
+      };
+
+    private:
+
+      struct heap_entry
+      {
+	ErrorTp abs_error;
+	std::size_t index;
+      };
+
+      /**
+       * Comparison of heap entries by absolute error.
+       */
+      struct heap_comp
+      {
+	bool
+	operator()(const heap_entry& hl, const heap_entry& hr) const
+	{ return hl.abs_error < hr.abs_error; }
+      };
+
+      // The maximum size of the workspace.
+      std::size_t m_max_size;
+
+      // The current maximum depth.
+      std::size_t m_max_depth;
+
+      std::vector<region> m_region;
+      std::vector<heap_entry> m_heap;
+      std::vector<std::size_t> m_free;
+
+    public:
+
+      explicit cubature_workspace(std::size_t cap)
+      : m_max_size(cap),
+	m_max_depth{0},
+	m_region{}, m_heap{}, m_free{}
+      {
+	this->m_region.reserve(cap);
+	this->m_heap.reserve(cap);
+      }
+
+      std::size_t
+      size() const
+      { return this->m_heap.size(); }
+
+      std::size_t
+      max_size() const
+      { return this->m_max_size; }
+
+      std::size_t
+      capacity() const
+      { return this->m_region.capacity(); }
+
+      std::size_t
+      max_depth() const
+      { return this->m_max_depth; }
+
+      void
+      clear()
+      {
+	this->m_max_depth = 0;
+	this->m_region.clear();
+	this->m_heap.clear();
+	this->m_free.clear();
+      }
+
+      /**
+       * Return the region with the largest error - the top of the heap.
+       */
+      const region&
+      top() const
+      { return this->m_region[this->m_heap.front().index]; }
+
+      /**
+       * Push a new region into the heap.
+       */
+      void
+      push(const region& reg)
+      {
+	std::size_t index;
+	if (this->m_free.empty())
+	  {
+	    index = this->m_region.size();
+	    this->m_region.push_back(reg);
+	  }
+	else
+	  {
+	    index = this->m_free.back();
+	    this->m_free.pop_back();
+	    this->m_region[index] = reg;
+	  }
+	this->m_heap.push_back({reg.abs_error, index});
+	std::push_heap(this->m_heap.begin(), this->m_heap.end(),
+		       heap_comp{});
+	this->m_max_depth = std::max(this->m_max_depth, reg.depth);
+      }
+
+      /**
+       * Remove and return the region with the largest error.
+       */
+      region
+      pop()
+      {
+	std::pop_heap(this->m_heap.begin(), this->m_heap.end(),
+		      heap_comp{});
+	const auto index = this->m_heap.back().index;
+	this->m_heap.pop_back();
+	this->m_free.push_back(index);
+	return this->m_region[index];
+      }
+
+      /// Return the total integral:
+      /// the sum of the results over all regions.
+      AreaTp
+      total_integral() const
+      {
+	auto result_sum = AreaTp{0};
+	for (const auto& ent : this->m_heap)
+	  result_sum += this->m_region[ent.index].result;
+	return result_sum;
+      }
+
+      /// Return the sum of the absolute errors over all regions.
+      ErrorTp
+      total_error() const
+      {
+	auto tot_error = ErrorTp{0};
+	for (const auto& ent : this->m_heap)
+	  tot_error += ent.abs_error;
+	return tot_error;
+      }
+
+      /// Return the regions in heap order.
+      std::vector<region>
+      regions() const
+      {
+	std::vector<region> regs;
+	regs.reserve(this->m_heap.size());
+	for (const auto& ent : this->m_heap)
+	  regs.push_back(this->m_region[ent.index]);
+	return regs;
+      }
+    };
+
+} // namespace emsr
+
+#endif // CUBATURE_WORKSPACE_H
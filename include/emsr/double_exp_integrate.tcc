@@ -120,10 +120,12 @@ namespace emsr
 	      n *= 2;
 	      h /= Tp{2};
 
+	      // Halving the step about doubles the sum of the function values.
 	      const auto curr_sum = sum + sum1 + sum2;
-	      if (auto abs_del = std::abs(curr_sum - prev_sum);
+	      const auto fact = Tp{2} * (upper - lower) * s_pi_4 * h;
+	      if (auto abs_del = std::abs(fact * (curr_sum - Tp{2} * prev_sum));
                   abs_del < max_abs_err
-		  || abs_del < std::abs(max_rel_err * curr_sum)
+		  || abs_del < std::abs(max_rel_err * fact * curr_sum)
 		  || iter + 1 == max_iter) // Keep prev_sum even if at max_iters.
 	        break;
 
@@ -218,10 +220,12 @@ namespace emsr
 	      n *= 2;
 	      h /= Tp{2};
 
+	      // Halving the step about doubles the sum of the function values.
 	      const auto curr_sum = sum + sum1 + sum2;
-	      if (auto abs_del = std::abs(curr_sum - prev_sum);
+	      const auto fact = Tp{2} * s_pi_4 * h;
+	      if (auto abs_del = std::abs(fact * (curr_sum - Tp{2} * prev_sum));
                   abs_del < max_abs_err
-		  || abs_del < std::abs(max_rel_err * curr_sum)
+		  || abs_del < std::abs(max_rel_err * fact * curr_sum)
 		  || iter + 1 == max_iter) // Keep prev_sum even if at max_iters.
 	        break;
 
@@ -318,9 +322,11 @@ namespace emsr
 	      n *= 2;
 	      h /= Tp{2};
 
-	      if (auto abs_del = std::abs(sum - prev_sum);
+	      // Halving the step about doubles the sum of the function values.
+	      const auto fact = s_pi_4 * h;
+	      if (auto abs_del = std::abs(fact * (sum - Tp{2} * prev_sum));
                   abs_del < max_abs_err
-		  || abs_del < std::abs(max_rel_err * sum)
+		  || abs_del < std::abs(max_rel_err * fact * sum)
 		  || iter + 1 == max_iter) // Keep prev_sum even if at max_iters.
 	        break;
 
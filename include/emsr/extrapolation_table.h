@@ -30,6 +30,9 @@
 #include <limits>
 #include <cmath>
 #include <algorithm>
+#include <iosfwd>
+
+#include <emsr/integration_snapshot.h>
 
 namespace emsr
 {
@@ -79,6 +82,12 @@ namespace emsr
       std::size_t
       get_nn() const
       { return this->m_nn; }
+
+      /// Write the table to a binary snapshot.
+      void save(std::ostream& out) const;
+
+      /// Restore the table from a binary snapshot written by save().
+      void restore(std::istream& in);
     };
 
 } // namespace emsr
@@ -25,6 +25,11 @@
 #ifndef EXTRAPOLATION_TABLE_TCC
 #define EXTRAPOLATION_TABLE_TCC 1
 
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
 namespace emsr
 {
 
@@ -184,6 +189,44 @@ namespace emsr
       return std::make_tuple(result, abserr);
     }
 
+  /**
+   * Write the entries of the table and the last three extrapolated
+   * results to a binary snapshot.
+   */
+  template<typename AreaTp, typename AbsAreaTp>
+    void
+    extrapolation_table<AreaTp, AbsAreaTp>::save(std::ostream& out) const
+    {
+      detail::write_snapshot_header<AbsAreaTp, AreaTp>(out,
+					Snapshot_Extrapolation_Table);
+      detail::write_value(out, std::uint64_t(this->m_nn));
+      detail::write_value(out, std::uint64_t(this->m_nres));
+      detail::write_values(out, this->m_rlist2.data(), this->m_nn);
+      detail::write_values(out, this->m_res3la.data(),
+			   this->m_res3la.size());
+    }
+
+  /**
+   * Restore the table from a binary snapshot written by save().
+   */
+  template<typename AreaTp, typename AbsAreaTp>
+    void
+    extrapolation_table<AreaTp, AbsAreaTp>::restore(std::istream& in)
+    {
+      detail::read_snapshot_header<AbsAreaTp, AreaTp>(in,
+					Snapshot_Extrapolation_Table);
+      std::uint64_t nn, nres;
+      detail::read_value(in, nn);
+      detail::read_value(in, nres);
+      if (nn > this->m_rlist2.size())
+	throw std::runtime_error("extrapolation_table: "
+				 "Snapshot has too many entries");
+      detail::read_values(in, this->m_rlist2.data(), nn);
+      detail::read_values(in, this->m_res3la.data(), this->m_res3la.size());
+      this->m_nn = nn;
+      this->m_nres = nres;
+    }
+
 } // namespace emsr
 
 #endif // EXTRAPOLATION_TABLE_TCC
@@ -0,0 +1,159 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef FFT_PLAN_H
+#define FFT_PLAN_H 1
+
+#include <cstddef>
+#include <complex>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace emsr
+{
+
+  /**
+   * A precomputed plan for the fast Fourier transform of complex data
+   * of a fixed length.
+   *
+   * Lengths whose prime factors are 2, 3, 5 and 7 are transformed
+   * in place by a digit-reversal permutation followed by iterative
+   * mixed-radix butterfly passes of radix 4, 2, 3, 5 and 7.
+   * The permutation cycles and the table of twiddle factors
+   * @f$ \omega^k = e^{-2\pi ik/N} @f$ are computed once, each twiddle
+   * directly rather than by repeated multiplication, so they do not
+   * drift at large @f$ N @f$.  These transforms allocate nothing.
+   *
+   * Any other length is transformed with Bluestein's chirp-z algorithm
+   * as a convolution of power-of-two length at least @f$ 2N - 1 @f$.
+   * The chirp and its transform are precomputed and the plan keeps
+   * a scratch buffer of the convolution length.  The buffer is taken
+   * under a lock; a transform that finds it in use by another thread
+   * allocates its own.
+   *
+   * Every length is therefore @f$ O(N \log N) @f$.  A plan is immutable
+   * once built apart from its scratch and may be shared between threads.
+   *
+   * The conventions are those of fast_fourier_transform:
+   * the forward transform uses @f$ e^{-2\pi ijk/N} @f$ and is scaled
+   * by @f$ 1/N @f$; the inverse transform is unscaled.
+   */
+  template<typename Tp>
+    class fft_plan
+    {
+    public:
+
+      /**
+       * Build a plan for transforms of length @c n.
+       * Throw std::domain_error if @c n is zero.
+       */
+      explicit fft_plan(std::size_t n);
+
+      /// Return true if a plan can be built for length @c n.
+      static constexpr bool
+      is_supported(std::size_t n)
+      { return n != 0; }
+
+      /// Return the transform length.
+      std::size_t
+      size() const
+      { return this->m_size; }
+
+      /// Return true if the length is transformed by Bluestein's algorithm.
+      bool
+      is_bluestein() const
+      { return bool(this->m_conv_plan); }
+
+      /// Return the radices of the butterfly passes in order.
+      const std::vector<int>&
+      radices() const
+      { return this->m_radix; }
+
+      /// Forward transform of @c size() values in place.
+      void
+      forward(std::complex<Tp>* z) const;
+
+      /// Inverse transform of @c size() values in place.
+      void
+      inverse(std::complex<Tp>* z) const;
+
+      /// Forward transform in place.
+      void
+      forward(std::vector<std::complex<Tp>>& z) const;
+
+      /// Inverse transform in place.
+      void
+      inverse(std::vector<std::complex<Tp>>& z) const;
+
+    private:
+
+      template<bool Inverse>
+	void
+	m_transform(std::complex<Tp>* z) const;
+
+      template<bool Inverse>
+	void
+	m_mixed_radix(std::complex<Tp>* z) const;
+
+      void
+      m_bluestein(std::complex<Tp>* z) const;
+
+      /// The Bluestein convolution buffer and its lock.
+      struct scratch_t
+      {
+	std::mutex mutex;
+	std::vector<std::complex<Tp>> buf;
+      };
+
+      std::size_t m_size;
+      /// The radix of each butterfly pass.
+      std::vector<int> m_radix;
+      /// The cycles of the digit-reversal permutation, concatenated.
+      std::vector<std::size_t> m_cycle;
+      /// One past the end of each cycle in m_cycle.
+      std::vector<std::size_t> m_cycle_end;
+      /// The twiddle factors for k in [0, N).
+      std::vector<std::complex<Tp>> m_twiddle;
+
+      /// The Bluestein chirp @f$ e^{-i\pi k^2/N} @f$.
+      std::vector<std::complex<Tp>> m_chirp;
+      /// The unscaled transform of the conjugate chirp.
+      std::vector<std::complex<Tp>> m_chirp_xform;
+      /// The plan for the Bluestein convolution.
+      std::shared_ptr<const fft_plan<Tp>> m_conv_plan;
+      /// The Bluestein scratch, shared by copies of the plan.
+      std::shared_ptr<scratch_t> m_scratch;
+    };
+
+  /**
+   * Return a plan for transforms of length @c n from a process-wide
+   * cache of the s_fft_plan_cache_size most recently built lengths.
+   * The plan is built outside the lock.
+   */
+  template<typename Tp>
+    std::shared_ptr<const fft_plan<Tp>>
+    cached_fft_plan(std::size_t n);
+
+  /// The number of plans of each type kept by cached_fft_plan.
+  inline constexpr std::size_t s_fft_plan_cache_size = 16;
+
+} // namespace emsr
+
+#include <emsr/fft_plan.tcc>
+
+#endif // FFT_PLAN_H
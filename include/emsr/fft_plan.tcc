@@ -0,0 +1,449 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef FFT_PLAN_TCC
+#define FFT_PLAN_TCC 1
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace emsr
+{
+
+namespace detail
+{
+
+  /**
+   * Multiply two complex numbers without the inf/nan recovery
+   * of the library operator which is a function call without fast-math.
+   */
+  template<typename Tp>
+    inline std::complex<Tp>
+    fft_mul(const std::complex<Tp>& a, const std::complex<Tp>& b)
+    {
+      return {a.real() * b.real() - a.imag() * b.imag(),
+	      a.real() * b.imag() + a.imag() * b.real()};
+    }
+
+  /**
+   * Multiply by -i for the forward transform or by +i for the inverse.
+   */
+  template<bool Inverse, typename Tp>
+    inline std::complex<Tp>
+    fft_rotate(const std::complex<Tp>& a)
+    {
+      if constexpr (Inverse)
+	return {-a.imag(), a.real()};
+      else
+	return {a.imag(), -a.real()};
+    }
+
+  /**
+   * Radix-2 butterfly on p[0] and p[m] with twiddle w[1].
+   */
+  template<bool Inverse, typename Tp>
+    inline void
+    fft_butterfly_2(std::complex<Tp>* p, std::size_t m,
+		    const std::complex<Tp>* w)
+    {
+      const auto t = fft_mul(w[1], p[m]);
+      const auto a = p[0];
+      p[0] = a + t;
+      p[m] = a - t;
+    }
+
+  /**
+   * Radix-4 butterfly on p[0], p[m], p[2m], p[3m] with twiddles w[1..3].
+   */
+  template<bool Inverse, typename Tp>
+    inline void
+    fft_butterfly_4(std::complex<Tp>* p, std::size_t m,
+		    const std::complex<Tp>* w)
+    {
+      const auto t0 = p[0];
+      const auto t1 = fft_mul(w[1], p[m]);
+      const auto t2 = fft_mul(w[2], p[2 * m]);
+      const auto t3 = fft_mul(w[3], p[3 * m]);
+      const auto s02 = t0 + t2, d02 = t0 - t2;
+      const auto s13 = t1 + t3;
+      const auto d13 = fft_rotate<Inverse>(t1 - t3);
+      p[0] = s02 + s13;
+      p[2 * m] = s02 - s13;
+      p[m] = d02 + d13;
+      p[3 * m] = d02 - d13;
+    }
+
+  /**
+   * Butterfly of odd radix R on p[0], p[m], ..., p[(R-1)m]
+   * with twiddles w[1..R-1].
+   * The cosines and sines of @f$ 2\pi k/R @f$ are in c[k] and s[k].
+   * Pairing the inputs symmetrically halves the real multiplications.
+   */
+  template<int R, bool Inverse, typename Tp>
+    inline void
+    fft_butterfly_odd(std::complex<Tp>* p, std::size_t m,
+		      const std::complex<Tp>* w,
+		      const Tp* c, const Tp* s)
+    {
+      constexpr int h = (R - 1) / 2;
+      const auto t0 = p[0];
+      std::complex<Tp> sum[h + 1], dif[h + 1];
+      auto y0 = t0;
+      for (int q = 1; q <= h; ++q)
+	{
+	  const auto a = fft_mul(w[q], p[q * m]);
+	  const auto b = fft_mul(w[R - q], p[(R - q) * m]);
+	  sum[q] = a + b;
+	  dif[q] = a - b;
+	  y0 += sum[q];
+	}
+      for (int k = 1; k <= h; ++k)
+	{
+	  auto re = t0;
+	  std::complex<Tp> im{};
+	  for (int q = 1; q <= h; ++q)
+	    {
+	      const auto qk = (q * k) % R;
+	      re += c[qk] * sum[q];
+	      im += s[qk] * dif[q];
+	    }
+	  const auto rim = fft_rotate<Inverse>(im);
+	  p[k * m] = re + rim;
+	  p[(R - k) * m] = re - rim;
+	}
+      p[0] = y0;
+    }
+
+  /**
+   * Return the radices for a length: fours, then a two,
+   * then threes, fives and sevens.  Whatever does not factor
+   * is returned in @c rest.
+   */
+  inline std::vector<int>
+  fft_factor(std::size_t n, std::size_t& rest)
+  {
+    std::vector<int> radix;
+    while (n % 4 == 0)
+      {
+	radix.push_back(4);
+	n /= 4;
+      }
+    if (n % 2 == 0)
+      {
+	radix.push_back(2);
+	n /= 2;
+      }
+    for (int r : {3, 5, 7})
+      while (n % r == 0)
+	{
+	  radix.push_back(r);
+	  n /= r;
+	}
+    rest = n;
+    return radix;
+  }
+
+} // namespace detail
+
+  template<typename Tp>
+    fft_plan<Tp>::fft_plan(std::size_t n)
+    : m_size(n), m_radix{}, m_cycle{}, m_cycle_end{}, m_twiddle{},
+      m_chirp{}, m_chirp_xform{}, m_conv_plan{}, m_scratch{}
+    {
+      if (!is_supported(n))
+	throw std::domain_error("fft_plan: Length must be positive.");
+
+      const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+
+      std::size_t rest = 1;
+      auto radix = detail::fft_factor(n, rest);
+      if (rest != 1)
+	{
+	  // Bluestein: X_j = w_j sum_k (z_k w_k) conj(w_{j-k})
+	  // with the chirp w_k = exp(-i pi k^2 / n).
+	  std::size_t conv = 1;
+	  while (conv < 2 * n - 1)
+	    conv *= 2;
+
+	  this->m_chirp.reserve(n);
+	  std::size_t ksq = 0; // k^2 mod 2n
+	  for (std::size_t k = 0; k < n; ++k)
+	    {
+	      this->m_chirp.push_back(std::polar(Tp{1},
+					-s_pi * Tp(ksq) / Tp(n)));
+	      ksq = (ksq + 2 * k + 1) % (2 * n);
+	    }
+
+	  this->m_conv_plan = cached_fft_plan<Tp>(conv);
+	  this->m_scratch = std::make_shared<scratch_t>();
+	  this->m_scratch->buf.resize(conv);
+	  this->m_chirp_xform.assign(conv, std::complex<Tp>{});
+	  this->m_chirp_xform[0] = std::conj(this->m_chirp[0]);
+	  for (std::size_t k = 1; k < n; ++k)
+	    this->m_chirp_xform[k] = this->m_chirp_xform[conv - k]
+				   = std::conj(this->m_chirp[k]);
+	  this->m_conv_plan->forward(this->m_chirp_xform);
+	  for (auto& b : this->m_chirp_xform)
+	    b *= Tp(conv);
+	  return;
+	}
+
+      this->m_radix = std::move(radix);
+
+      // The digit-reversal permutation: position p of the permuted data
+      // holds input element perm[p].
+      std::vector<std::size_t> perm(n);
+      for (std::size_t p = 0; p < n; ++p)
+	{
+	  std::size_t idx = 0, mult = 1, len = n, rem = p;
+	  for (auto s = this->m_radix.size(); s-- > 0; )
+	    {
+	      const auto r = std::size_t(this->m_radix[s]);
+	      len /= r;
+	      idx += (rem / len) * mult;
+	      rem %= len;
+	      mult *= r;
+	    }
+	  perm[p] = idx;
+	}
+
+      // Store the nontrivial cycles so the permutation runs in place.
+      std::vector<bool> done(n, false);
+      for (std::size_t p = 0; p < n; ++p)
+	{
+	  if (done[p] || perm[p] == p)
+	    continue;
+	  auto i = p;
+	  do
+	    {
+	      done[i] = true;
+	      this->m_cycle.push_back(i);
+	      i = perm[i];
+	    }
+	  while (i != p);
+	  this->m_cycle_end.push_back(this->m_cycle.size());
+	}
+
+      this->m_twiddle.reserve(n);
+      for (std::size_t k = 0; k < n; ++k)
+	this->m_twiddle.push_back(std::polar(Tp{1},
+				    -Tp{2} * s_pi * Tp(k) / Tp(n)));
+    }
+
+  /**
+   * Permute into digit-reversed order then run the butterfly passes.
+   * A pass of radix r combines r transforms of length m into
+   * transforms of length L = rm.
+   */
+  template<typename Tp>
+    template<bool Inverse>
+      void
+      fft_plan<Tp>::m_mixed_radix(std::complex<Tp>* z) const
+      {
+	const auto n = this->m_size;
+
+	std::size_t beg = 0;
+	for (auto end : this->m_cycle_end)
+	  {
+	    const auto tmp = z[this->m_cycle[beg]];
+	    for (auto t = beg; t + 1 < end; ++t)
+	      z[this->m_cycle[t]] = z[this->m_cycle[t + 1]];
+	    z[this->m_cycle[end - 1]] = tmp;
+	    beg = end;
+	  }
+
+	auto twiddle = [this](std::size_t k)
+	  {
+	    if constexpr (Inverse)
+	      return std::conj(this->m_twiddle[k]);
+	    else
+	      return this->m_twiddle[k];
+	  };
+
+	std::size_t len = 1;
+	for (auto r : this->m_radix)
+	  {
+	    const auto m = len;
+	    len *= r;
+	    const auto stride = n / len;
+
+	    // Cosines and sines of the radix.
+	    Tp c[7], s[7];
+	    for (int k = 0; k < r; ++k)
+	      {
+		const auto& t = this->m_twiddle[k * (n / r)];
+		c[k] = t.real();
+		s[k] = -t.imag();
+	      }
+
+	    std::complex<Tp> w[7];
+	    for (std::size_t j = 0; j < m; ++j)
+	      {
+		for (int q = 1; q < r; ++q)
+		  w[q] = twiddle(j * stride * q);
+		for (std::size_t base = j; base < n; base += len)
+		  {
+		    auto p = z + base;
+		    switch (r)
+		      {
+		      case 2:
+			detail::fft_butterfly_2<Inverse>(p, m, w);
+			break;
+		      case 4:
+			detail::fft_butterfly_4<Inverse>(p, m, w);
+			break;
+		      case 3:
+			detail::fft_butterfly_odd<3, Inverse>(p, m, w, c, s);
+			break;
+		      case 5:
+			detail::fft_butterfly_odd<5, Inverse>(p, m, w, c, s);
+			break;
+		      case 7:
+			detail::fft_butterfly_odd<7, Inverse>(p, m, w, c, s);
+			break;
+		      }
+		  }
+	      }
+	  }
+      }
+
+  /**
+   * Unscaled forward transform by Bluestein's chirp-z algorithm.
+   */
+  template<typename Tp>
+    void
+    fft_plan<Tp>::m_bluestein(std::complex<Tp>* z) const
+    {
+      using detail::fft_mul;
+
+      const auto n = this->m_size;
+      std::unique_lock<std::mutex> lock(this->m_scratch->mutex,
+					std::try_to_lock);
+      std::vector<std::complex<Tp>> own;
+      if (!lock.owns_lock())
+	own.resize(this->m_conv_plan->size());
+      auto& buf = lock.owns_lock() ? this->m_scratch->buf : own;
+      for (std::size_t k = 0; k < n; ++k)
+	buf[k] = fft_mul(z[k], this->m_chirp[k]);
+      std::fill(buf.begin() + n, buf.end(), std::complex<Tp>{});
+      this->m_conv_plan->forward(buf.data());
+      for (std::size_t k = 0; k < buf.size(); ++k)
+	buf[k] = fft_mul(buf[k], this->m_chirp_xform[k]);
+      this->m_conv_plan->inverse(buf.data());
+      for (std::size_t k = 0; k < n; ++k)
+	z[k] = fft_mul(buf[k], this->m_chirp[k]);
+    }
+
+  template<typename Tp>
+    template<bool Inverse>
+      void
+      fft_plan<Tp>::m_transform(std::complex<Tp>* z) const
+      {
+	const auto n = this->m_size;
+	if (this->m_conv_plan)
+	  {
+	    // The inverse is the conjugate of the forward of the conjugate.
+	    if constexpr (Inverse)
+	      for (std::size_t i = 0; i < n; ++i)
+		z[i] = std::conj(z[i]);
+	    this->m_bluestein(z);
+	    if constexpr (Inverse)
+	      for (std::size_t i = 0; i < n; ++i)
+		z[i] = std::conj(z[i]);
+	  }
+	else
+	  this->template m_mixed_radix<Inverse>(z);
+
+	if constexpr (!Inverse)
+	  {
+	    const auto norm = Tp{1} / Tp(n);
+	    for (std::size_t i = 0; i < n; ++i)
+	      z[i] *= norm;
+	  }
+      }
+
+  template<typename Tp>
+    void
+    fft_plan<Tp>::forward(std::complex<Tp>* z) const
+    { this->template m_transform<false>(z); }
+
+  template<typename Tp>
+    void
+    fft_plan<Tp>::inverse(std::complex<Tp>* z) const
+    { this->template m_transform<true>(z); }
+
+  template<typename Tp>
+    void
+    fft_plan<Tp>::forward(std::vector<std::complex<Tp>>& z) const
+    {
+      if (z.size() != this->m_size)
+	throw std::domain_error("fft_plan: Data length does not match plan.");
+      this->forward(z.data());
+    }
+
+  template<typename Tp>
+    void
+    fft_plan<Tp>::inverse(std::vector<std::complex<Tp>>& z) const
+    {
+      if (z.size() != this->m_size)
+	throw std::domain_error("fft_plan: Data length does not match plan.");
+      this->inverse(z.data());
+    }
+
+  /**
+   * The cache holds the plans in a map by length and evicts
+   * the oldest entry when full.
+   */
+  template<typename Tp>
+    std::shared_ptr<const fft_plan<Tp>>
+    cached_fft_plan(std::size_t n)
+    {
+      using plan_ptr = std::shared_ptr<const fft_plan<Tp>>;
+      static std::mutex s_mutex;
+      static std::map<std::size_t, plan_ptr> s_cache;
+      static std::deque<std::size_t> s_order;
+
+      {
+	std::lock_guard<std::mutex> lock(s_mutex);
+	const auto it = s_cache.find(n);
+	if (it != s_cache.end())
+	  return it->second;
+      }
+
+      auto plan = std::make_shared<const fft_plan<Tp>>(n);
+
+      std::lock_guard<std::mutex> lock(s_mutex);
+      const auto [it, inserted] = s_cache.emplace(n, std::move(plan));
+      if (inserted)
+	{
+	  s_order.push_back(n);
+	  if (s_order.size() > s_fft_plan_cache_size)
+	    {
+	      s_cache.erase(s_order.front());
+	      s_order.pop_front();
+	    }
+	}
+      return it->second;
+    }
+
+} // namespace emsr
+
+#endif // FFT_PLAN_TCC
@@ -23,6 +23,9 @@
 #include <complex>
 #include <vector>
 
+#include <emsr/fft_plan.h>
+#include <emsr/parallel_fft.h>
+
 namespace emsr
 {
 
@@ -151,19 +154,26 @@ namespace emsr
     {
     private:
 
+      std::size_t m_size;
       std::vector<std::complex<Tp>> m_xform;
 
     public:
 
       fourier_transform_t(std::size_t n)
-      : m_xform{}
+      : m_size(n), m_xform{}
       { this->m_xform.reserve(n / 2 + 1); }
 
       fourier_transform_t(std::vector<Tp> data);
 
+      /**
+       * Transform real data with a plan of length @c data.size().
+       */
+      fourier_transform_t(const std::vector<Tp>& data,
+			  const fft_plan<Tp>& plan);
+
       std::size_t
       size() const
-      { return 2 * this->m_xform.size() - 2; }
+      { return this->m_size; }
 
       std::complex<Tp>
       operator[](std::size_t k) const
@@ -171,7 +181,7 @@ namespace emsr
 	if (k < this->m_xform.size())
 	  return this->m_xform[k];
 	else
-	  return std::conj(this->m_xform[this->m_xform.size() - k]);
+	  return std::conj(this->m_xform[this->m_size - k]);
 	// This is real array indexing.
 	//if (k < len / 2)
 	//	? std::complex(xform[2 * k], xform[2 * k + 1])
@@ -198,9 +208,15 @@ namespace emsr
 
       fourier_transform_t(const std::vector<std::complex<Tp>>& data);
 
+      /**
+       * Transform complex data with a plan of length @c data.size().
+       */
+      fourier_transform_t(const std::vector<std::complex<Tp>>& data,
+			  const fft_plan<Tp>& plan);
+
       std::size_t
       size() const
-      { return 2 * this->m_xform.size() - 2; }
+      { return this->m_xform.size(); }
 
       std::complex<Tp>
       operator[](std::size_t k) const
@@ -216,47 +232,195 @@ namespace emsr
 				 std::vector<std::complex<Tp>>& z);
 
   /**
-   * Fast Fourier Transform on complex data.
+   * Fast Fourier Transform on complex data of any length.
+   * The plan for the length is taken from cached_fft_plan
+   * so repeated transforms of one length do not rebuild it.
    */
   template<typename Tp>
     void
     fast_fourier_transform(std::vector<std::complex<Tp>>& z);
 
   /**
-   * Inverse Fast Fourier Transform on complex data.
+   * Inverse Fast Fourier Transform on complex data of any length.
    */
   template<typename Tp>
     void
     inv_fast_fourier_transform(std::vector<std::complex<Tp>>& z);
 
   /**
-   * Fast Sine Transform on real data.
+   * Fast Fourier Transform on complex data using a precomputed plan.
+   */
+  template<typename Tp>
+    void
+    fast_fourier_transform(const fft_plan<Tp>& plan,
+			   std::vector<std::complex<Tp>>& z);
+
+  /**
+   * Inverse Fast Fourier Transform on complex data
+   * using a precomputed plan.
+   */
+  template<typename Tp>
+    void
+    inv_fast_fourier_transform(const fft_plan<Tp>& plan,
+			       std::vector<std::complex<Tp>>& z);
+
+  /**
+   * Fast Sine Transform on real data of length N:
+   * @f[
+   *    F_k = \sum_{j=1}^{N-1} x_j \sin\left(\frac{\pi jk}{N}\right).
+   * @f]
+   * The value @f$ x_0 @f$ is ignored and @f$ F_0 = 0 @f$.
    */
   template <typename Tp>
     void
     fast_sine_transform(std::vector<Tp>& x);
 
   /**
-   * Fast Sine Transform on real data.
+   * Inverse Fast Sine Transform on real data.
+   * This is the forward transform scaled by @f$ 2/N @f$.
    */
   template <typename Tp>
     void
     inv_fast_sine_transform(std::vector<Tp>& x);
 
   /**
-   * Fast Fourier Transform on real data.
+   * Discrete cosine transform of the first kind (DCT-I) on the
+   * @c n + 1 real values @f$ x_0, ..., x_n @f$:
+   * @f[
+   *    C_k = \frac{1}{2}[x_0 + (-1)^k x_n]
+   *        + \sum_{j=1}^{n-1} x_j \cos\left(\frac{\pi jk}{n}\right).
+   * @f]
+   * The transform is its own inverse up to the factor @f$ 2/n @f$.
+   * It is computed from a real FFT of length @c 2n.
+   */
+  template<typename Tp>
+    void
+    fast_cosine_transform_1(std::vector<Tp>& x);
+
+  /**
+   * Discrete cosine transform of the second kind (DCT-II) on
+   * N real values:
+   * @f[
+   *    C_k = \sum_{j=0}^{N-1} x_j
+   *          \cos\left(\frac{\pi (j + 1/2) k}{N}\right).
+   * @f]
+   * The inverse is fast_cosine_transform_3 scaled by @f$ 2/N @f$.
+   * It is computed from a real FFT of length N.
+   */
+  template<typename Tp>
+    void
+    fast_cosine_transform_2(std::vector<Tp>& x);
+
+  /**
+   * Discrete cosine transform of the third kind (DCT-III) on
+   * N real values:
+   * @f[
+   *    y_j = \frac{1}{2} x_0 + \sum_{k=1}^{N-1} x_k
+   *          \cos\left(\frac{\pi k (j + 1/2)}{N}\right).
+   * @f]
+   */
+  template<typename Tp>
+    void
+    fast_cosine_transform_3(std::vector<Tp>& x);
+
+  /**
+   * Discrete sine transform of the first kind (DST-I) on N real values:
+   * @f[
+   *    S_k = \sum_{j=0}^{N-1} x_j
+   *          \sin\left(\frac{\pi (j + 1)(k + 1)}{N + 1}\right).
+   * @f]
+   * The transform is its own inverse up to the factor @f$ 2/(N + 1) @f$.
+   */
+  template<typename Tp>
+    void
+    fast_sine_transform_1(std::vector<Tp>& x);
+
+  /**
+   * Discrete sine transform of the second kind (DST-II) on N real values:
+   * @f[
+   *    S_k = \sum_{j=0}^{N-1} x_j
+   *          \sin\left(\frac{\pi (j + 1/2)(k + 1)}{N}\right).
+   * @f]
+   * The inverse is fast_sine_transform_3 scaled by @f$ 2/N @f$.
+   */
+  template<typename Tp>
+    void
+    fast_sine_transform_2(std::vector<Tp>& x);
+
+  /**
+   * Discrete sine transform of the third kind (DST-III) on N real values:
+   * @f[
+   *    y_j = \frac{(-1)^j}{2} x_{N-1} + \sum_{k=0}^{N-2} x_k
+   *          \sin\left(\frac{\pi (k + 1)(j + 1/2)}{N}\right).
+   * @f]
+   */
+  template<typename Tp>
+    void
+    fast_sine_transform_3(std::vector<Tp>& x);
+
+  /**
+   * Fast Fourier Transform on real data of any length N.
+   *
+   * The transform @f$ F_k @f$ of real data has @f$ F_{N-k} = F_k^* @f$
+   * so N real numbers are returned in place:
+   * @f$ x_0 = F_0 @f$, @f$ x_{2k-1} = Re F_k @f$ and
+   * @f$ x_{2k} = Im F_k @f$ for @f$ 0 < 2k < N @f$,
+   * and @f$ x_{N-1} = F_{N/2} @f$ (which is real) if N is even.
+   *
+   * @note This packing replaces an earlier one which took only even N
+   * and stored complex pairs in @f$ x_{2k}, x_{2k+1} @f$.
+   * The earlier transform did not agree with the discrete Fourier
+   * transform of the data nor did its inverse recover the data
+   * so no compatible form is kept; code reading the old packing should
+   * use fourier_transform_t, whose operator[] returns @f$ F_k @f$
+   * for any k, rather than index the packed vector.
    */
   template<typename Tp>
     void
     fast_fourier_transform(std::vector<Tp>& x);
 
   /**
-   * Inverse Fast Fourier Transform on real data.
+   * Inverse Fast Fourier Transform on real data of any length
+   * packed as by fast_fourier_transform.
+   * See there for the change from the earlier packing.
    */
   template<typename Tp>
     void
     inv_fast_fourier_transform(std::vector<Tp>& x);
 
+  /**
+   * Multithreaded Fast Fourier Transform on complex data using
+   * @c num_threads threads (0 means hardware concurrency).
+   * This pays off for lengths of about @f$ 2^{20} @f$ and more.
+   */
+  template<typename Tp>
+    void
+    fast_fourier_transform(std::vector<std::complex<Tp>>& z,
+			   unsigned int num_threads);
+
+  /**
+   * Multithreaded Inverse Fast Fourier Transform on complex data.
+   */
+  template<typename Tp>
+    void
+    inv_fast_fourier_transform(std::vector<std::complex<Tp>>& z,
+			       unsigned int num_threads);
+
+  /**
+   * Multithreaded Fast Fourier Transform on real data
+   * packed as by the serial transform.
+   */
+  template<typename Tp>
+    void
+    fast_fourier_transform(std::vector<Tp>& x, unsigned int num_threads);
+
+  /**
+   * Multithreaded Inverse Fast Fourier Transform on real data.
+   */
+  template<typename Tp>
+    void
+    inv_fast_fourier_transform(std::vector<Tp>& x, unsigned int num_threads);
+
   /**
    * Fast Fourier Transform on input range.
    */
@@ -19,8 +19,10 @@
 #ifndef FOURIER_TRANSFORM_TCC
 #define FOURIER_TRANSFORM_TCC 1
 
+#include <algorithm>
 #include <stdexcept>
 #include <numeric>
+#include <utility>
 #include <vector>
 #include <complex>
 
@@ -61,12 +63,18 @@ namespace emsr
       z.swap(result);
     }
 
+namespace detail
+{
+
   /**
-   * Fast Fourier Transform on complex data.
+   * Recursive Fast Fourier Transform on complex data.
+   * This allocates at each level of the recursion and falls back to
+   * the quadratic discrete transform for odd lengths; it is kept
+   * as a reference for fft_plan.
    */
   template<typename Tp>
     void
-    fast_fourier_transform(std::vector<std::complex<Tp>>& z)
+    recursive_fast_fourier_transform(std::vector<std::complex<Tp>>& z)
     {
       const auto len = z.size();
       if (len % 2 == 1) // Too bad, we're odd.
@@ -85,8 +93,8 @@ namespace emsr
               ++run;
               odd.push_back(*run);
 	    }
-	  fast_fourier_transform(even);
-	  fast_fourier_transform(odd);
+	  recursive_fast_fourier_transform(even);
+	  recursive_fast_fourier_transform(odd);
 	  phase_iterator omega_iter(Tp{1}, 1, len);
 	  for (std::size_t i = 0, j = halflen; i < halflen;
 		++i, ++j, ++omega_iter)
@@ -99,11 +107,11 @@ namespace emsr
     }
 
   /**
-   * Inverse Fast Fourier Transform on complex data.
+   * Recursive Inverse Fast Fourier Transform on complex data.
    */
   template<typename Tp>
     void
-    inv_fast_fourier_transform(std::vector<std::complex<Tp>>& z)
+    recursive_inv_fast_fourier_transform(std::vector<std::complex<Tp>>& z)
     {
       const std::size_t len = z.size();
       if (len % 2 == 1) // Too bad, we're odd.
@@ -122,8 +130,8 @@ namespace emsr
 	      ++run;
 	      odd.push_back(*run);
 	    }
-	  inv_fast_fourier_transform(even);
-	  inv_fast_fourier_transform(odd);
+	  recursive_inv_fast_fourier_transform(even);
+	  recursive_inv_fast_fourier_transform(odd);
 	  phase_iterator omega_iter(Tp{-1}, 1, len);
 	  for (std::size_t i = 0, j = halflen; i < halflen;
 		++i, ++j, ++omega_iter)
@@ -135,117 +143,486 @@ namespace emsr
 	}
     }
 
+} // namespace detail
+
   /**
-   * Fast Fourier Transform on real data.
+   * Fast Fourier Transform on complex data of any length.
    */
   template<typename Tp>
     void
-    fast_fourier_transform(std::vector<Tp>& x)
+    fast_fourier_transform(std::vector<std::complex<Tp>>& z)
+    {
+      if (!z.empty())
+	cached_fft_plan<Tp>(z.size())->forward(z);
+    }
+
+  /**
+   * Inverse Fast Fourier Transform on complex data of any length.
+   */
+  template<typename Tp>
+    void
+    inv_fast_fourier_transform(std::vector<std::complex<Tp>>& z)
+    {
+      if (!z.empty())
+	cached_fft_plan<Tp>(z.size())->inverse(z);
+    }
+
+  /**
+   * Fast Fourier Transform on complex data using a precomputed plan.
+   */
+  template<typename Tp>
+    void
+    fast_fourier_transform(const fft_plan<Tp>& plan,
+			   std::vector<std::complex<Tp>>& z)
+    { plan.forward(z); }
+
+  /**
+   * Inverse Fast Fourier Transform on complex data
+   * using a precomputed plan.
+   */
+  template<typename Tp>
+    void
+    inv_fast_fourier_transform(const fft_plan<Tp>& plan,
+			       std::vector<std::complex<Tp>>& z)
+    { plan.inverse(z); }
+
+  /**
+   * Construct the transform of real data.
+   * Only the non-negative frequencies are stored.
+   */
+  template<typename Tp>
+    fourier_transform_t<Tp>::fourier_transform_t(std::vector<Tp> data)
+    : m_size(data.size()), m_xform(data.begin(), data.end())
+    {
+      fast_fourier_transform(this->m_xform);
+      this->m_xform.resize(this->m_size / 2 + 1);
+    }
+
+  template<typename Tp>
+    fourier_transform_t<Tp>::
+    fourier_transform_t(const std::vector<Tp>& data,
+			const fft_plan<Tp>& plan)
+    : m_size(data.size()), m_xform(data.begin(), data.end())
+    {
+      plan.forward(this->m_xform);
+      this->m_xform.resize(this->m_size / 2 + 1);
+    }
+
+  /**
+   * Construct the transform of complex data.
+   */
+  template<typename Tp>
+    fourier_transform_t<std::complex<Tp>>::
+    fourier_transform_t(const std::vector<std::complex<Tp>>& data)
+    : m_xform(data)
+    { fast_fourier_transform(this->m_xform); }
+
+  template<typename Tp>
+    fourier_transform_t<std::complex<Tp>>::
+    fourier_transform_t(const std::vector<std::complex<Tp>>& data,
+			const fft_plan<Tp>& plan)
+    : m_xform(data)
+    { plan.forward(this->m_xform); }
+
+namespace detail
+{
+
+  /**
+   * Fast Fourier Transform on real data of any length
+   * given a forward transform on complex vectors.
+   *
+   * Even lengths are transformed as complex data of half the length
+   * and separated using the symmetry of the transform of real data.
+   * The separation is spread over @c num_threads threads.
+   */
+  template<typename Tp, typename Xform>
+    void
+    real_fast_fourier_transform(std::vector<Tp>& x, Xform xform,
+				unsigned int num_threads)
     {
       const auto len = x.size();
-      if (len % 2 == 1) // Too bad, we're odd.
-	throw std::domain_error("fast_fourier_transform: "
-				  "Real data must have even length.");
-      else // Good, we're even.
+      if (len < 2)
+	return;
+
+      const auto s_2pi = Tp{2}
+		* Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+      const auto halflen = len / 2;
+      std::vector<std::complex<Tp>> f;
+      if (len % 2 == 1)
 	{
-	  // @todo I really want to just make a view to a complex vector.
-	  const auto halflen = len / 2;
-	  std::vector<std::complex<Tp>> z;
-	  z.reserve(halflen + 1);
-	  for (std::size_t i = 0; i < halflen; ++i)
-	    z.emplace_back(x[2 * i], x[2 * i + 1]);
-	  fast_fourier_transform(z);
-	  z.emplace_back(z[0]); // Use symmetry.  We need N/2 transform.
-	  const auto s_i2 = std::complex<Tp>{0, 2};
-	  phase_iterator omega_iter(Tp{+1}, 1, halflen);
-	  for (std::size_t i = 0; i < halflen; ++i)
+	  f.assign(x.begin(), x.end());
+	  xform(f);
+	}
+      else
+	{
+	  std::vector<std::complex<Tp>> z(halflen);
+	  parallel_for(0, halflen, num_threads,
+		       [&x, &z](std::size_t i)
+		       { z[i] = std::complex<Tp>(x[2 * i], x[2 * i + 1]); });
+	  xform(z);
+
+	  // The transforms of the even and odd samples are
+	  // (Z_k + Z*_{h-k})/2 and (Z_k - Z*_{h-k})/2i.
+	  f.resize(halflen + 1);
+	  parallel_for(0, halflen + 1, num_threads,
+	    [&](std::size_t k)
 	    {
-	      const auto z1 = z[i];
-	      const auto z2 = std::conj(z[halflen - i]);
-	      const auto f = (z1 + z2) / Tp{2}
-			     + *omega_iter * (z1 - z2) / s_i2;
-	      x[2 * i] = f.real();
-	      x[2 * i + 1] = f.imag();
-	    }
+	      const auto z1 = z[k % halflen];
+	      const auto z2 = std::conj(z[(halflen - k) % halflen]);
+	      const auto even = (z1 + z2) / Tp{2};
+	      const auto odd = std::complex<Tp>{0, -1} * (z1 - z2) / Tp{2};
+	      const auto omega = std::polar(Tp{1}, -s_2pi * Tp(k) / Tp(len));
+	      f[k] = (even + omega * odd) / Tp{2};
+	    });
+	}
+
+      x[0] = f[0].real();
+      for (std::size_t k = 1; 2 * k < len; ++k)
+	{
+	  x[2 * k - 1] = f[k].real();
+	  x[2 * k] = f[k].imag();
 	}
+      if (len % 2 == 0)
+	x[len - 1] = f[halflen].real();
     }
 
   /**
-   * Inverse Fast Fourier Transform on real data.
+   * Inverse Fast Fourier Transform on real data of any length
+   * given an inverse transform on complex vectors.
+   */
+  template<typename Tp, typename Xform>
+    void
+    real_inv_fast_fourier_transform(std::vector<Tp>& x, Xform xform,
+				    unsigned int num_threads)
+    {
+      const auto len = x.size();
+      if (len < 2)
+	return;
+
+      const auto s_2pi = Tp{2}
+		* Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+      const auto halflen = len / 2;
+      auto bin = [&x, len](std::size_t k) -> std::complex<Tp>
+	{
+	  if (k == 0)
+	    return x[0];
+	  else if (2 * k == len)
+	    return x[len - 1];
+	  else if (2 * k < len)
+	    return {x[2 * k - 1], x[2 * k]};
+	  else
+	    return {x[2 * (len - k) - 1], -x[2 * (len - k)]};
+	};
+
+      if (len % 2 == 1)
+	{
+	  std::vector<std::complex<Tp>> f(len);
+	  for (std::size_t k = 0; k < len; ++k)
+	    f[k] = bin(k);
+	  xform(f);
+	  for (std::size_t i = 0; i < len; ++i)
+	    x[i] = f[i].real();
+	}
+      else
+	{
+	  // Rebuild the transform of the even samples plus i times
+	  // the transform of the odd samples.
+	  std::vector<std::complex<Tp>> z(halflen);
+	  parallel_for(0, halflen, num_threads,
+	    [&](std::size_t k)
+	    {
+	      const auto f1 = bin(k);
+	      const auto f2 = std::conj(bin(halflen - k));
+	      const auto omega = std::polar(Tp{1}, s_2pi * Tp(k) / Tp(len));
+	      z[k] = (f1 + f2) + std::complex<Tp>{0, 1} * omega * (f1 - f2);
+	    });
+	  xform(z);
+	  parallel_for(0, halflen, num_threads,
+		       [&x, &z](std::size_t i)
+		       {
+			 x[2 * i] = z[i].real();
+			 x[2 * i + 1] = z[i].imag();
+		       });
+	}
+    }
+
+} // namespace detail
+
+  /**
+   * Fast Fourier Transform on real data of any length.
+   */
+  template<typename Tp>
+    void
+    fast_fourier_transform(std::vector<Tp>& x)
+    {
+      detail::real_fast_fourier_transform(x,
+		[](std::vector<std::complex<Tp>>& z)
+		{ cached_fft_plan<Tp>(z.size())->forward(z); }, 1);
+    }
+
+  /**
+   * Inverse Fast Fourier Transform on real data of any length.
+   * The input is packed as the output of fast_fourier_transform.
    */
   template<typename Tp>
     void
     inv_fast_fourier_transform(std::vector<Tp>& x)
+    {
+      detail::real_inv_fast_fourier_transform(x,
+		[](std::vector<std::complex<Tp>>& z)
+		{ cached_fft_plan<Tp>(z.size())->inverse(z); }, 1);
+    }
+
+  /**
+   * Multithreaded Fast Fourier Transform on complex data.
+   */
+  template<typename Tp>
+    void
+    fast_fourier_transform(std::vector<std::complex<Tp>>& z,
+			   unsigned int num_threads)
+    {
+      if (!z.empty())
+	parallel_fft_plan<Tp>(z.size(), num_threads).forward(z);
+    }
+
+  /**
+   * Multithreaded Inverse Fast Fourier Transform on complex data.
+   */
+  template<typename Tp>
+    void
+    inv_fast_fourier_transform(std::vector<std::complex<Tp>>& z,
+			       unsigned int num_threads)
+    {
+      if (!z.empty())
+	parallel_fft_plan<Tp>(z.size(), num_threads).inverse(z);
+    }
+
+  /**
+   * Multithreaded Fast Fourier Transform on real data.
+   */
+  template<typename Tp>
+    void
+    fast_fourier_transform(std::vector<Tp>& x, unsigned int num_threads)
+    {
+      num_threads = resolve_num_threads(num_threads);
+      detail::real_fast_fourier_transform(x,
+		[num_threads](std::vector<std::complex<Tp>>& z)
+		{ parallel_fft_plan<Tp>(z.size(), num_threads).forward(z); },
+		num_threads);
+    }
+
+  /**
+   * Multithreaded Inverse Fast Fourier Transform on real data.
+   */
+  template<typename Tp>
+    void
+    inv_fast_fourier_transform(std::vector<Tp>& x, unsigned int num_threads)
+    {
+      num_threads = resolve_num_threads(num_threads);
+      detail::real_inv_fast_fourier_transform(x,
+		[num_threads](std::vector<std::complex<Tp>>& z)
+		{ parallel_fft_plan<Tp>(z.size(), num_threads).inverse(z); },
+		num_threads);
+    }
+
+namespace detail
+{
+
+  /**
+   * Return the bin @c k, @f$ 0 \le k < N @f$, of the transform
+   * of real data packed as by fast_fourier_transform.
+   */
+  template<typename Tp>
+    std::complex<Tp>
+    real_fft_bin(const std::vector<Tp>& x, std::size_t k)
     {
       const auto len = x.size();
-      if (len % 2 == 1) // Too bad, we're odd.
-	throw std::domain_error("inv_fast_fourier_transform: "
-				  "Real data must have even length.");
-      else // Good, we're even.
+      if (k == 0)
+	return x[0];
+      else if (2 * k == len)
+	return x[len - 1];
+      else if (2 * k < len)
+	return {x[2 * k - 1], x[2 * k]};
+      else
+	return {x[2 * (len - k) - 1], -x[2 * (len - k)]};
+    }
+
+} // namespace detail
+
+  /**
+   * The DCT-I of length n + 1 is the transform of the even extension
+   * of length 2n: @f$ F_k = C_k / n @f$.
+   */
+  template<typename Tp>
+    void
+    fast_cosine_transform_1(std::vector<Tp>& x)
+    {
+      if (x.size() < 2)
+	return;
+
+      const auto n = x.size() - 1;
+      std::vector<Tp> y(2 * n);
+      for (std::size_t j = 0; j <= n; ++j)
+	y[j] = x[j];
+      for (std::size_t j = 1; j < n; ++j)
+	y[2 * n - j] = x[j];
+      fast_fourier_transform(y);
+
+      const auto norm = Tp(n);
+      x[0] = norm * y[0];
+      for (std::size_t k = 1; k < n; ++k)
+	x[k] = norm * y[2 * k - 1];
+      x[n] = norm * y[2 * n - 1];
+    }
+
+  /**
+   * Following J. Makhoul, A Fast Cosine Transform in One and Two
+   * Dimensions, IEEE Trans. ASSP 28 (1980), 27-34, the even samples
+   * followed by the odd samples reversed are transformed and
+   * @f$ C_k = Re(e^{-i\pi k/2N} V_k) @f$.
+   */
+  template<typename Tp>
+    void
+    fast_cosine_transform_2(std::vector<Tp>& x)
+    {
+      const auto len = x.size();
+      if (len < 2)
+	return;
+
+      const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+      std::vector<Tp> v(len);
+      for (std::size_t j = 0; 2 * j < len; ++j)
+	v[j] = x[2 * j];
+      for (std::size_t j = 0; 2 * j + 1 < len; ++j)
+	v[len - 1 - j] = x[2 * j + 1];
+      fast_fourier_transform(v);
+
+      const auto norm = Tp(len);
+      for (std::size_t k = 0; k < len; ++k)
 	{
-	  // @todo I really want to just make a view to a complex vector.
-	  const auto halflen = len / 2;
-	  std::vector<std::complex<Tp>> z;
-	  z.reserve(halflen);
-	  const auto s_i2 = std::complex<Tp>{0, 2};
-	  phase_iterator omega_iter(Tp{-1}, 1, halflen);
-	  for (std::size_t i = 0; i < halflen; ++i)
-	    {
-	      const auto z1 = std::complex<Tp>(x[2 * i], x[2 * i + 1]);
-	      const auto z2 = std::complex<Tp>(x[len - 2 * i - 2], -x[len - 2 * i - 1]);
-	      const auto ze = (z1 + z2) / Tp{2};
-	      const auto zo = -*omega_iter * (z1 - z2) / s_i2;
-	      z.emplace_back(ze + zo);
-	    }
-	  inv_fast_fourier_transform(z);
-	  for (std::size_t i = 0; i < halflen; ++i)
-	    {
-	      x[2 * i] = z[i].real();
-	      x[2 * i + 1] = z[i].imag();
-	    }
+	  const auto w = std::polar(Tp{1}, -s_pi * Tp(k) / Tp(2 * len));
+	  x[k] = norm * std::real(w * detail::real_fft_bin(v, k));
 	}
     }
 
   /**
-   * Fast Sine Transform on real data.
+   * The DCT-III undoes the steps of the DCT-II: from
+   * @f$ e^{-i\pi k/2N} V_k = C_k - i C_{N-k} @f$ the Hermitian
+   * @f$ V_k @f$ are rebuilt, inverted with a real FFT and unshuffled.
    */
-  template <typename Tp>
+  template<typename Tp>
     void
-    fast_sine_transform(std::vector<Tp>& x)
+    fast_cosine_transform_3(std::vector<Tp>& x)
     {
       const auto len = x.size();
-      const auto halflen = len / 2;
-      const auto n2 = len - 1;
-      phase_iterator omega_iter(Tp{+1}, 1, len);
-      x[0] = Tp{0};
-      for (std::size_t k = 1; k <= halflen; ++k, ++omega_iter)
+      if (len < 2)
 	{
-	  const auto y1 = omega_iter.sin()
-			  * (x[k] + x[n2 - k]);
-	  const auto y2 = (x[k] - x[n2 - k]) / Tp{2};
-	  x[k] = y1 + y2;
-	  x[n2 - k] = y1 - y2;
+	  if (len == 1)
+	    x[0] /= Tp{2};
+	  return;
 	}
-      fast_fourier_transform(x);
-      x[0] *= Tp{0.5L};
-      x[1] = Tp{0};
-      auto sum = Tp{0};
-      for (std::size_t i = 2; i < halflen; i += 2)
+
+      const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+      std::vector<Tp> v(len);
+      v[0] = x[0];
+      for (std::size_t k = 1; 2 * k <= len; ++k)
 	{
-	  sum += std::exchange(x[i], x[i + 1]);
-	  x[i + 1] = sum;
+	  const auto w = std::polar(Tp{1}, s_pi * Tp(k) / Tp(2 * len));
+	  const auto vk = w * std::complex<Tp>(x[k], -x[len - k]);
+	  if (2 * k == len)
+	    v[len - 1] = vk.real();
+	  else
+	    {
+	      v[2 * k - 1] = vk.real();
+	      v[2 * k] = vk.imag();
+	    }
 	}
+      inv_fast_fourier_transform(v);
+
+      for (std::size_t j = 0; 2 * j < len; ++j)
+	x[2 * j] = v[j] / Tp{2};
+      for (std::size_t j = 0; 2 * j + 1 < len; ++j)
+	x[2 * j + 1] = v[len - 1 - j] / Tp{2};
+    }
+
+  /**
+   * The DST-I of length N is the transform of the odd extension
+   * of length 2(N + 1): @f$ F_{k+1} = -i S_k / (N + 1) @f$.
+   */
+  template<typename Tp>
+    void
+    fast_sine_transform_1(std::vector<Tp>& x)
+    {
+      const auto len = x.size();
+      if (len == 0)
+	return;
+
+      const auto m = 2 * (len + 1);
+      std::vector<Tp> y(m);
+      for (std::size_t j = 0; j < len; ++j)
+	{
+	  y[j + 1] = x[j];
+	  y[m - 1 - j] = -x[j];
+	}
+      fast_fourier_transform(y);
+
+      const auto norm = Tp(len + 1);
+      for (std::size_t k = 0; k < len; ++k)
+	x[k] = -norm * y[2 * k + 2];
+    }
+
+  /**
+   * The DST-II is the DCT-II of @f$ (-1)^j x_j @f$ reversed.
+   */
+  template<typename Tp>
+    void
+    fast_sine_transform_2(std::vector<Tp>& x)
+    {
+      for (std::size_t j = 1; j < x.size(); j += 2)
+	x[j] = -x[j];
+      fast_cosine_transform_2(x);
+      std::reverse(x.begin(), x.end());
+    }
+
+  /**
+   * The DST-III is @f$ (-1)^j @f$ times the DCT-III of the reversed input.
+   */
+  template<typename Tp>
+    void
+    fast_sine_transform_3(std::vector<Tp>& x)
+    {
+      std::reverse(x.begin(), x.end());
+      fast_cosine_transform_3(x);
+      for (std::size_t j = 1; j < x.size(); j += 2)
+	x[j] = -x[j];
     }
 
   /**
    * Fast Sine Transform on real data.
+   * The values @f$ x_1, ..., x_{N-1} @f$ are transformed by a DST-I.
+   */
+  template <typename Tp>
+    void
+    fast_sine_transform(std::vector<Tp>& x)
+    {
+      if (x.empty())
+	return;
+
+      std::vector<Tp> y(x.begin() + 1, x.end());
+      fast_sine_transform_1(y);
+      x[0] = Tp{0};
+      std::copy(y.begin(), y.end(), x.begin() + 1);
+    }
+
+  /**
+   * Inverse Fast Sine Transform on real data.
    */
   template <typename Tp>
     void
     inv_fast_sine_transform(std::vector<Tp>& x)
     {
       fast_sine_transform(x);
-      const auto norm = Tp{2} / x.size();
+      const auto norm = Tp{2} / Tp(x.size());
       for (std::size_t i = 0; i < x.size(); ++i)
 	x[i] *= norm;
     }
@@ -28,13 +28,17 @@
 
   This library implements 4 types of quadrature
 */
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
 #include <limits>
 
-#include <ext/jacobi.h>
-#include <ext/integration_error.h>
+#include <emsr/jacobi.h>
+#include <emsr/integration_error.h>
+#include <emsr/sf_factorial.h>
+#include <emsr/quadrature_point.h>
+#include <emsr/rule_file.h>
 
 /// Admissible convergence error
 template<typename Tp>
@@ -128,6 +132,68 @@ template<typename Tp>
   }
 
 
+/**
+ * Calculates the Jacobi polynomial of order n at a point.
+ */
+template<typename Tp>
+  Tp
+  jac_quadrature<Tp>::jacobi_value(Tp x, int n, Tp alpha, Tp beta)
+  {
+    Tp value;
+    jacobi_value_array(1, &x, &value, n, alpha, beta);
+    return value;
+  }
+
+
+/**
+ * Calculates the derivative of the Jacobi polynomial of order n at a point.
+ */
+template<typename Tp>
+  Tp
+  jac_quadrature<Tp>::jacobi_deriv(Tp x, int n, Tp alpha, Tp beta)
+  {
+    if (n == 0)
+      return Tp{0};
+    Tp deriv;
+    jacobi_deriv_array(1, &x, &deriv, n, alpha, beta);
+    return deriv;
+  }
+
+
+/**
+ * Calculates the zeros of the Jacobi polynomial of order m
+ * in ascending order.
+ *
+ * @param x A Tp pointer to an array of m values for the zeros
+ * @param m Order of the Jacobi polynomial
+ * @param alpha @f$\alpha@f$ parameter of Jacobi polynomial
+ * @param beta @f$\beta@f$ parameter of Jacobi polynomial
+ * @return 0 if everything was ok. Otherwise return an error code
+ */
+template<typename Tp>
+  int
+  jac_quadrature<Tp>::jacobi_zeros(Tp* x, int m, Tp alpha, Tp beta)
+  {
+    if (m <= 0)
+      return 0;
+
+    const auto mapped = emsr::load_default_rule<Tp>(emsr::Rule_Gauss_Jacobi,
+						m, double(alpha),
+						double(beta));
+    if (mapped && mapped->point.size() == std::size_t(m))
+      std::copy(mapped->point.begin(), mapped->point.end(), x);
+    else
+      {
+	const auto pt = emsr::jacobi_zeros<Tp>(m, alpha, beta);
+	for (int i = 0; i < m; ++i)
+	  x[i] = pt[i].point;
+      }
+    std::sort(x, x + m);
+
+    return 0;
+  }
+
+
 // **** GAUSS QUADRATURE ****
 
 
@@ -273,7 +339,7 @@ template<typename Tp>
   int
   jac_quadrature<Tp>::interpmat_gj()
   {
-    for (int i = 0; i < this->xp.size(); ++i)
+    for (int i = 0; i < int(this->xp.size()); ++i)
       for (int j = 0; j < this->Q; ++j)
 	this->imat[i * this->Q + j] = this->lagrange_gj(j, this->xp[i]);
     return 0;
@@ -445,7 +511,7 @@ template<typename Tp>
   int
   jac_quadrature<Tp>::interpmat_glj()
   {
-    for (int i = 0; i < this->xp.size(); ++i)
+    for (int i = 0; i < int(this->xp.size()); ++i)
       for (int j = 0; j < this->Q; ++j)
 	this->imat[i * this->Q + j] = this->lagrange_glj(j, this->xp[i]);
     return 0;
@@ -615,7 +681,7 @@ template<typename Tp>
   int
   jac_quadrature<Tp>::interpmat_grjm()
   {
-    for (int i = 0; i < this->xp.size(); ++i)
+    for (int i = 0; i < int(this->xp.size()); ++i)
       for (int j = 0; j < this->Q; ++j)
 	this->imat[i * this->Q + j] = this->lagrange_grjm(j, this->xp[i]);
     return 0;
@@ -784,7 +850,7 @@ template<typename Tp>
   int
   jac_quadrature<Tp>::interpmat_grjp()
   {
-    for (int i = 0; i < this->xp.size(); ++i)
+    for (int i = 0; i < int(this->xp.size()); ++i)
       for (int j = 0; j < this->Q; ++j)
 	this->imat[i * this->Q + j] = this->lagrange_grjp(j, this->xp[i]);
     return 0;
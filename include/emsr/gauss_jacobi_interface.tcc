@@ -26,6 +26,7 @@
 /** @file  Wrappers to basic functions defined in gauss_quad.c
  */
 
+#include <algorithm>
 #include <stdexcept>
 #include <cstdlib>
 #include <numeric>
@@ -33,62 +34,74 @@
 #include <emsr/jacobi.h>
 #include <emsr/integration_error.h>
 
-/*
-//  Y = alpha A X + beta Y
+//  Y = A X for a row-major m x n matrix A.
 template<typename Tp>
   void
-  fake_gemv(// Specifies row-major (C) or column-major (Fortran) data ordering.
-	    // SpecifiesIn file included from test_gauss_jacobi.cpp:14:0:
-jacobi.h:111:10: note: declared private here
-     Tp* x;
-          ^
-test_gauss_jacobi.cpp:52:40: error: \u2018_Tp jac_quadrature<Tp>::integrate(Tp*) [with Tp = double]\u2019 is private within this context
-   auto integr = quad.integrate(f.data());
-                                        ^
-In file included from jacobi.h:238:0,
-                 from test_gauss_jacobi.cpp:14:
-gauss_jacobi_interface.tcc:291:3: note: declared private here
-   jac_quadrature<Tp>::integrate(Tp* f)
-   ^~~~~~~~~~~~~~~~~~~
-gauss_jacobi_interface.tcc: In instantiation of \u2018_Tp jac_quadrature<Tp>::integrate(Tp*) [with Tp = double]\u2019:
-test_gauss_jacobi.cpp:52:40:   required from here
- whether to transpose matrix A.
-	    int __M,	   // 
-	    int __N,	   // 
-	    Tp __alpha,   // Scaling factor for the product of matrix A and vector X.
-	    const Tp*__A, // Matrix A.
-	    int __lda,     // The size of the first dimension of matrix A; if you are passing a matrix A[m][n], the value should be m.
-	    const Tp*__X, // Vector X.
-	    int __incX,    // Stride within X. For example, if incX is 7, every 7th element is used.
-	    Tp __beta,    // Scaling factor for vector Y.
-	    Tp* __Y,       // Vector Y
-	    int __incY)    // Stride within Y. For example, if incY is 7, every 7th element is used.
+  matvec(std::size_t m, std::size_t n, const Tp* A, const Tp* x, Tp* y)
   {
-    if (__beta != Tp{0})
-      for (std::size_t __iy = 0, __ir = 0; __ir < __lda; __iy += __incY, ++__ir)
-	__Y[__iy] *= __beta;
-
-    if (__alpha != Tp{0})
-      for (std::size_t __iy = 0, __ir = 0; __ir < __lda; __iy += __incY, ++__ir)
-	{
-	  for (std::size_t __ix = 0, __ic = 0; __ic < __N; __ix += __incX, ++__ic)
-	    __Y[__iy] += __alpha * __A[__ir][__ic] * __X[__ix];
-	}
+    for (std::size_t ir = 0; ir < m; ++ir)
+      {
+	auto sum = Tp{0};
+	for (std::size_t ic = 0; ic < n; ++ic)
+	  sum += A[ir * n + ic] * x[ic];
+	y[ir] = sum;
+      }
   }
-*/
-//    cblas_dgemv(CblasRowMajor, CblasNoTrans, quad->Q, quad->Q, Tp{1}, quad->D, quad->Q, f, 1, Tp{0}, d, 1);
-//    matvec(quad->Q, quad->D, f, d);
 
-//  Y = A X
+/**
+ * C = A B for a row-major m x k matrix A, k x n matrix B and m x n matrix C
+ * with leading dimensions lda, ldb and ldc.
+ *
+ * The columns of B and C are the fields and are processed in blocks
+ * small enough that a panel of B and a panel of C stay in cache while
+ * all of A is applied.  The innermost loop runs along contiguous rows
+ * of B and C, four rows of B at a time, and vectorizes.
+ */
 template<typename Tp>
   void
-  matvec(std::size_t __n, const Tp* __A, const Tp* __x, Tp* __y)
+  matmat(std::size_t m, std::size_t n, std::size_t k,
+	 const Tp* A, std::size_t lda,
+	 const Tp* B, std::size_t ldb,
+	 Tp* C, std::size_t ldc)
   {
-    for (std::size_t __ir = 0; __ir < __n; ++__ir)
+    constexpr std::size_t s_col_block = 256;
+    constexpr std::size_t s_row_block = 64;
+
+    for (std::size_t jb = 0; jb < n; jb += s_col_block)
       {
-	__y[__ir] = Tp{0};
-	for (std::size_t __ic = 0; __ic < __n; ++__ic)
-	  __y[__ir] += __A[__ir][__ic] * __x[__ic];
+	const auto nb = std::min(s_col_block, n - jb);
+
+	for (std::size_t i = 0; i < m; ++i)
+	  std::fill_n(C + i * ldc + jb, nb, Tp{0});
+
+	for (std::size_t kb = 0; kb < k; kb += s_row_block)
+	  {
+	    const auto kend = std::min(kb + s_row_block, k);
+	    for (std::size_t i = 0; i < m; ++i)
+	      {
+		const auto a = A + i * lda;
+		auto c = C + i * ldc + jb;
+		auto l = kb;
+		for (; l + 4 <= kend; l += 4)
+		  {
+		    const auto a0 = a[l], a1 = a[l + 1],
+			       a2 = a[l + 2], a3 = a[l + 3];
+		    const auto b0 = B + l * ldb + jb;
+		    const auto b1 = b0 + ldb;
+		    const auto b2 = b1 + ldb;
+		    const auto b3 = b2 + ldb;
+		    for (std::size_t j = 0; j < nb; ++j)
+		      c[j] += a0 * b0[j] + a1 * b1[j] + a2 * b2[j] + a3 * b3[j];
+		  }
+		for (; l < kend; ++l)
+		  {
+		    const auto al = a[l];
+		    const auto bl = B + l * ldb + jb;
+		    for (std::size_t j = 0; j < nb; ++j)
+		      c[j] += al * bl[j];
+		  }
+	      }
+	  }
       }
   }
 
@@ -114,49 +127,49 @@ template<typename Tp>
       case Gauss:
 	err = this->zeros_gj();
 	if (err)
-	  throw integration_error("Problem calculating the zeros", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the zeros", err, Tp{}, Tp{});
 	err = this->weights_gj();
 	if (err)
-	  throw integration_error("Problem calculating the weightd", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the weightd", err, Tp{}, Tp{});
 	err = this->diffmat_gj();
 	if (err)
-	  throw integration_error("Problem calculating the differentiation matrix", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the differentiation matrix", err, Tp{}, Tp{});
 	break;
       case Gauss_Lobatto:
 	err = this->zeros_glj();
 	if (err)
-	  throw integration_error("Problem calculating the zeros", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the zeros", err, Tp{}, Tp{});
 	err = this->weights_glj();
 	if (err)
-	  throw integration_error("Problem calculating the weightd", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the weightd", err, Tp{}, Tp{});
 	err = this->diffmat_glj();
 	if (err)
-	  throw integration_error("Problem calculating the differentiation matrix", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the differentiation matrix", err, Tp{}, Tp{});
 	break;
       case Gauss_Radau_lower:
 	err = this->zeros_grjm();
 	if (err)
-	  throw integration_error("Problem calculating the zeros", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the zeros", err, Tp{}, Tp{});
 	err = this->weights_grjm();
 	if (err)
-	  throw integration_error("Problem calculating the weightd", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the weightd", err, Tp{}, Tp{});
 	err = this->diffmat_grjm();
 	if (err)
-	  throw integration_error("Problem calculating the differentiation matrix", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the differentiation matrix", err, Tp{}, Tp{});
 	break;
       case Gauss_Radau_upper:
 	err = this->zeros_grjp();
 	if (err)
-	  throw integration_error("Problem calculating the zeros", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the zeros", err, Tp{}, Tp{});
 	err = this->weights_grjp();
 	if (err)
-	  throw integration_error("Problem calculating the weightd", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the weightd", err, Tp{}, Tp{});
 	err = this->diffmat_grjp();
 	if (err)
-	  throw integration_error("Problem calculating the differentiation matrix", err, Tp{}, Tp{});
+	  throw emsr::integration_error("Problem calculating the differentiation matrix", err, Tp{}, Tp{});
 	break;
       default:
-	throw integration_error("Illegal quadrature type", err, Tp{}, Tp{});
+	throw emsr::integration_error("Illegal quadrature type", err, Tp{}, Tp{});
       }
 
     return 0;
@@ -174,7 +187,7 @@ template<typename Tp>
  */
 template<typename Tp>
   int
-  jac_quadrature<Tp>::interpmat_alloc(int npoints, Tp* xp)
+  jac_quadrature<Tp>::interpmat_alloc(int npoints, const Tp* xp)
   {
     if (npoints < 1)
       std::__throw_domain_error("The number of interpolating points should be at least 1");
@@ -201,7 +214,7 @@ template<typename Tp>
       err = this->interpmat_grjp();
       break;
     default:
-      throw integration_error("Illegal quadrature type", err, Tp{}, Tp{});
+      throw emsr::integration_error("Illegal quadrature type", err, Tp{}, Tp{});
     }
 
     return err;
@@ -257,9 +270,38 @@ template<typename Tp>
  */
 template<typename Tp>
   int
-  jac_quadrature<Tp>::differentiate(Tp* f, Tp* d)
+  jac_quadrature<Tp>::differentiate(const Tp* f, Tp* d) const
+  {
+    matvec<Tp>(this->Q, this->Q, this->D.data(), f, d);
+    return 0;
+  }
+
+
+/**
+ * Calculates the derivatives at the quadrature points of a block of functions.
+ *
+ * The values are stored point by point: the value of field k at quadrature
+ * point j is f[j * ldf + k].  The block is differentiated at once
+ * as the matrix product @f$ D F @f$ which is far cheaper than
+ * differentiating the fields one at a time.
+ *
+ * @param nfields Number of fields in the block
+ * @param f Q x nfields values of the fields at the quadrature points
+ * @param ldf Leading dimension of f (at least nfields)
+ * @param d Q x nfields estimated derivatives at the quadrature points
+ * @param ldd Leading dimension of d (at least nfields)
+ * @return 0 if everything was ok. Otherwise return an error code
+ */
+template<typename Tp>
+  int
+  jac_quadrature<Tp>::differentiate(int nfields, const Tp* f, int ldf,
+				    Tp* d, int ldd) const
   {
-    matvec(this->Q, this->D, f, d);
+    if (nfields < 0 || ldf < nfields || ldd < nfields)
+      std::__throw_domain_error("differentiate: bad field block dimensions");
+
+    matmat<Tp>(this->Q, nfields, this->Q, this->D.data(), this->Q,
+	       f, ldf, d, ldd);
     return 0;
   }
 
@@ -285,13 +327,43 @@ template<typename Tp>
  */
 template<typename Tp>
   int
-  jac_quadrature<Tp>::interpolate(Tp* f, Tp* fout)
+  jac_quadrature<Tp>::interpolate(const Tp* f, Tp* fout) const
+  {
+    if (this->xp.size() == 0)
+      throw std::runtime_error("No interpolation info was setup");
+
+    matvec<Tp>(this->xp.size(), this->Q, this->imat.data(), f, fout);
+    return 0;
+  }
+
+
+/**
+ * Interpolates a block of functions given at quadrature points
+ * using the interpolation matrix.
+ *
+ * The values are stored point by point as for the block version
+ * of differentiate: the block is interpolated as the matrix product
+ * @f$ I F @f$.
+ *
+ * @param nfields Number of fields in the block
+ * @param f Q x nfields values of the fields at the quadrature points
+ * @param ldf Leading dimension of f (at least nfields)
+ * @param fout num_interp_points() x nfields interpolated values
+ * @param ldout Leading dimension of fout (at least nfields)
+ * @return 0 if everything was ok. Otherwise return an error code
+ */
+template<typename Tp>
+  int
+  jac_quadrature<Tp>::interpolate(int nfields, const Tp* f, int ldf,
+				  Tp* fout, int ldout) const
   {
     if (this->xp.size() == 0)
       throw std::runtime_error("No interpolation info was setup");
+    if (nfields < 0 || ldf < nfields || ldout < nfields)
+      std::__throw_domain_error("interpolate: bad field block dimensions");
 
-    //cblas_dgemv(CblasRowMajor, CblasNoTrans, this->np, this->Q, Tp{1}, this->imat, this->Q, f, 1, Tp{0}, fout, 1);
-    matvec(this->Q, this->D, f, fout);
+    matmat<Tp>(this->xp.size(), nfields, this->Q, this->imat.data(), this->Q,
+	       f, ldf, fout, ldout);
     return 0;
   }
 
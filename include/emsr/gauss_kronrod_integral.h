@@ -25,9 +25,14 @@
 #ifndef GAUSS_KRONROD_INTERGAL_H
 #define GAUSS_KRONROD_INTERGAL_H 1
 
+#include <cstddef>
+#include <memory>
+#include <span>
 #include <type_traits>
 #include <vector>
 
+#include <emsr/static_gauss_table.h>
+
 namespace emsr
 {
 
@@ -61,8 +66,18 @@ namespace emsr
       AbsAreaTp resasc = AbsAreaTp{};
     };
 
+  /**
+   * A Gauss-Kronrod rule.
+   *
+   * With the default @c KronrodN of zero the rule is chosen at run time
+   * by the number of Kronrod points.  A nonzero @c KronrodN selects a rule
+   * with that many points whose table is built at compile time.
+   */
+  template<typename Tp, std::size_t KronrodN = 0>
+    class gauss_kronrod_integral;
+
   template<typename Tp>
-    class gauss_kronrod_integral
+    class gauss_kronrod_integral<Tp, 0>
     {
     public:
 
@@ -92,9 +107,36 @@ namespace emsr
 
       unsigned m_rule = Kronrod_15;
 
-      std::vector<Tp> m_x_kronrod;
-      std::vector<Tp> m_w_gauss;
-      std::vector<Tp> m_w_kronrod;
+      // Rules other than the tabulated ones are shared by all integrators
+      // of the same rule; m_owner keeps the storage the views point into
+      // (a built rule or the mapping of the default rule file) alive.
+      std::shared_ptr<const void> m_owner;
+      std::span<const Tp> m_x_kronrod;
+      std::span<const Tp> m_w_gauss;
+      std::span<const Tp> m_w_kronrod;
+    };
+
+  template<typename Tp, std::size_t KronrodN>
+    class gauss_kronrod_integral
+    {
+    public:
+
+      /// The Gauss-Kronrod table, built at compile time.
+      static constexpr static_gauss_kronrod_table<Tp, KronrodN>
+      s_table = make_gauss_kronrod_table<Tp, KronrodN>();
+
+      constexpr gauss_kronrod_integral() = default;
+
+      template<typename FuncTp>
+	auto
+	integrate(FuncTp func, Tp lower, Tp upper) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      template<typename FuncTp>
+	auto
+	operator()(FuncTp func, Tp lower, Tp upper) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+	{ return this->integrate(func, lower, upper); }
     };
 
   template<typename Tp, typename FuncTp>
@@ -29,24 +29,124 @@
 #include <vector>
 #include <cmath>
 #include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 
 #include <emsr/integration_error.h>
 #include <emsr/gauss_kronrod_rule.tcc>
+#include <emsr/rule_file.h>
 
 namespace emsr
 {
 
+namespace detail
+{
+  /**
+   * A Gauss-Kronrod rule beyond the tabulated ones, either viewed
+   * in the default rule file or built.
+   */
+  template<typename Tp>
+    struct gauss_kronrod_rule
+    {
+      /// The default rule file generation the rule was looked up under.
+      std::uint64_t generation = 0;
+      /// The rule file the views point into, if any.
+      std::shared_ptr<const rule_file> file;
+      /// The storage of a built rule.
+      std::vector<Tp> x_kronrod, w_gauss, w_kronrod;
+      /// The nodes, Kronrod weights and Gauss weights.
+      rule_view<Tp> view;
+    };
+
+  /**
+   * Return the Gauss-Kronrod rule with @c gk_rule points
+   * looking in the default rule file first and building it otherwise.
+   *
+   * Rules are cached per rule and real type.  Each thread remembers
+   * the rules it has used so once a thread has seen a rule it gets it
+   * back without locking or copying; a change of the default rule file
+   * makes the cached rules stale.  A thread keeps a stale rule,
+   * and the rule file it was mapped from, until it next asks for it.
+   */
+  template<typename Tp>
+    std::shared_ptr<const gauss_kronrod_rule<Tp>>
+    get_gauss_kronrod_rule(unsigned gk_rule)
+    {
+      using rule_ptr = std::shared_ptr<const gauss_kronrod_rule<Tp>>;
+
+      const auto gen = default_rule_file_generation();
+      thread_local std::map<unsigned, rule_ptr> t_seen;
+      auto& seen = t_seen[gk_rule];
+      if (seen && seen->generation == gen)
+	return seen;
+
+      static std::mutex s_mutex;
+      static std::map<unsigned, rule_ptr> s_shared;
+      {
+	std::lock_guard<std::mutex> lock(s_mutex);
+	const auto& shared = s_shared[gk_rule];
+	if (shared && shared->generation == gen)
+	  return seen = shared;
+      }
+
+      // Build outside the lock; a rule built twice by racing threads
+      // is the same rule.
+      auto rule = std::make_shared<gauss_kronrod_rule<Tp>>();
+      rule->generation = gen;
+      if (auto mapped = load_default_rule<Tp>(Rule_Gauss_Kronrod,
+					      int(gk_rule)))
+	{
+	  rule->file = std::move(mapped->file);
+	  rule->view = *mapped;
+	}
+      else
+	{
+	  const int n = (gk_rule - 1) / 2;
+	  const auto eps = 4 * std::numeric_limits<Tp>::epsilon();
+	  build_gauss_kronrod(n, eps,
+			      rule->x_kronrod, rule->w_gauss,
+			      rule->w_kronrod);
+	  rule->view = {rule->x_kronrod, rule->w_kronrod, rule->w_gauss};
+	}
+
+      std::lock_guard<std::mutex> lock(s_mutex);
+      auto& shared = s_shared[gk_rule];
+      if (!shared || shared->generation < gen)
+	shared = rule;
+      return seen = rule;
+    }
+} // namespace detail
+
+  /**
+   * The tabulated rules need no storage; any other rule is shared
+   * with every other integrator of the same rule.
+   */
   template<typename Tp>
     gauss_kronrod_integral<Tp>::gauss_kronrod_integral(unsigned gk_rule)
     : m_rule{gk_rule},
-      m_x_kronrod{}, m_w_gauss{}, m_w_kronrod{}
+      m_owner{}, m_x_kronrod{}, m_w_gauss{}, m_w_kronrod{}
     {
-      const int n = (this->m_rule - 1) / 2;
-      const auto eps = 4 * std::numeric_limits<Tp>::epsilon();
-      build_gauss_kronrod(n, eps,
-			    this->m_x_kronrod, this->m_w_gauss,
-			    this->m_w_kronrod);
+      switch (this->m_rule)
+	{
+	case Kronrod_15:
+	case Kronrod_21:
+	case Kronrod_31:
+	case Kronrod_41:
+	case Kronrod_51:
+	case Kronrod_61:
+	  break;
+	default:
+	  {
+	    auto rule = detail::get_gauss_kronrod_rule<Tp>(this->m_rule);
+	    this->m_x_kronrod = rule->view.point;
+	    this->m_w_kronrod = rule->view.weight;
+	    this->m_w_gauss = rule->view.aux_weight;
+	    this->m_owner = std::move(rule);
+	  }
+	}
     }
 
   template<typename AreaTp, typename AbsAreaTp>
@@ -637,6 +737,19 @@ namespace emsr
 	  }
       }
 
+  template<typename Tp, std::size_t KronrodN>
+    template<typename FuncTp>
+      auto
+      gauss_kronrod_integral<Tp, KronrodN>::
+      integrate(FuncTp func, Tp lower, Tp upper) const
+      -> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	return gauss_kronrod_integral<Tp>::s_integrate(s_table.x_kronrod,
+						       s_table.w_gauss,
+						       s_table.w_kronrod,
+						       func, lower, upper);
+      }
+
 } // namespace emsr
 
 #endif // GAUSS_KRONROD_INTERGAL_TCC
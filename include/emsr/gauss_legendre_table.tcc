@@ -28,6 +28,7 @@
 #include <stdexcept>
 
 #include <emsr/quadrature_point.h>
+#include <emsr/rule_file.h>
 
 namespace emsr
 {
@@ -47,13 +48,21 @@ namespace emsr
 	auto prec = std::find_if(prec_beg, prec_end,
 				   [this, n](prec_t tab)
 				   { return tab.order == this->order; });
-	if (prec == prec_end)
-	  this->rule = legendre_zeros<Tp>(this->order);
-	else
+	if (prec != prec_end)
 	  {
 	    this->precomputed = true;
 	    this->i_precomp = prec - prec_beg;
 	  }
+	else if (const auto mapped
+		   = load_default_rule<Tp>(Rule_Gauss_Legendre,
+					   int(this->order)))
+	  {
+	    this->rule.resize(mapped->point.size());
+	    for (std::size_t i = 0; i < mapped->point.size(); ++i)
+	      this->rule[i] = {mapped->point[i], mapped->weight[i]};
+	  }
+	else
+	  this->rule = legendre_zeros<Tp>(this->order);
       }
 
   /**
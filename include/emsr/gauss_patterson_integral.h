@@ -0,0 +1,177 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements the nested Gauss-Patterson family of quadrature rules.
+
+#ifndef GAUSS_PATTERSON_INTEGRAL_H
+#define GAUSS_PATTERSON_INTEGRAL_H 1
+
+#include <cstddef>
+#include <memory>
+#include <new> // For std::nothrow
+#include <type_traits>
+#include <vector>
+
+#include <emsr/gauss_kronrod_integral.h>
+
+namespace emsr
+{
+
+  /**
+   * The nodes and weights of the nested Gauss-Patterson rules
+   * up to some level.
+   *
+   * Level @c L has @f$ 2^{L+1} - 1 @f$ points: 1, 3, 7, 15, ..., 511.
+   * The rules are symmetric so only the central node and the positive
+   * nodes are stored, in nested order: the first num_abscissae(L)
+   * entries of @c point are exactly the non-negative nodes of level @c L.
+   * The weights of level @c L are in weight[L] in the same order.
+   */
+  template<typename Tp>
+    struct gauss_patterson_rule
+    {
+      std::vector<Tp> point;
+      std::vector<std::vector<Tp>> weight;
+
+      /// Return the number of points of the rule at a given level.
+      static constexpr std::size_t
+      num_points(int level)
+      { return (std::size_t{2} << level) - 1; }
+
+      /// Return the number of non-negative points at a given level.
+      static constexpr std::size_t
+      num_abscissae(int level)
+      { return std::size_t{1} << level; }
+
+      /// Return the highest level stored.
+      int
+      max_level() const
+      { return int(this->weight.size()) - 1; }
+    };
+
+  /**
+   * Return the Gauss-Patterson rules up to @c max_level.
+   * The rules are converted from the tables once per type and shared.
+   */
+  template<typename Tp>
+    std::shared_ptr<const gauss_patterson_rule<Tp>>
+    gauss_patterson_rules(int max_level);
+
+  /**
+   * Integrate with the nested Gauss-Patterson rules.
+   *
+   * Each level reuses every function value of the levels below it,
+   * so climbing from 1 to 511 points costs 511 evaluations in total.
+   *
+   * Used as the local rule of an adaptive bisection driver such as
+   * qag_integrate the integral climbs from @c min_level and stops
+   * as soon as the difference between successive levels has fallen
+   * to roundoff.  Intervals where the integrand is smooth then cost
+   * only the evaluations they need rather than a full high order rule.
+   * As a local rule the climb stops at @c max_local_level, by default
+   * s_max_local_level (127 points), so that an interval the driver
+   * is about to bisect anyway does not cost the full 511 points.
+   */
+  template<typename Tp>
+    class gauss_patterson_integral
+    {
+    public:
+
+      /// The highest level available (511 points).
+      static constexpr int s_max_level = 8;
+
+      /// The highest level climbed as a local rule (127 points).
+      static constexpr int s_max_local_level = 6;
+
+      explicit gauss_patterson_integral(int max_level = s_max_level,
+					int min_level = 2,
+					int max_local_level = s_max_local_level);
+
+      /**
+       * Integrate climbing levels until the error estimate from
+       * successive levels meets the tolerance.
+       * Throw integration_error if the highest level fails.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(FuncTp func, Tp lower, Tp upper,
+		  Tp max_abs_err, Tp max_rel_err) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      /**
+       * Integrate climbing levels until the error estimate from
+       * successive levels meets the tolerance without throwing
+       * if the highest level fails.  The error code, the result
+       * and error estimate of the highest level and the number
+       * of function evaluations are returned instead.
+       * Invalid tolerances still throw.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(std::nothrow_t, FuncTp func, Tp lower, Tp upper,
+		  Tp max_abs_err, Tp max_rel_err) const
+	-> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      /**
+       * Integrate as the local rule of an adaptive driver.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(FuncTp func, Tp lower, Tp upper) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      template<typename FuncTp>
+	auto
+	operator()(FuncTp func, Tp lower, Tp upper) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+	{ return this->integrate(func, lower, upper); }
+
+      /// Return the lowest level used.
+      int
+      min_level() const
+      { return this->m_min_level; }
+
+      /// Return the highest level used.
+      int
+      max_level() const
+      { return this->m_max_level; }
+
+      /// Return the highest level used as a local rule.
+      int
+      max_local_level() const
+      { return this->m_max_local_level; }
+
+    private:
+
+      static constexpr const char* s_tolerance_msg
+	= "gauss_patterson_integral: Failed to reach tolerance with highest-order rule";
+
+      template<typename FuncTp, typename Done>
+	auto
+	m_climb(FuncTp func, Tp lower, Tp upper, int top_level,
+		Done done) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      int m_min_level;
+      int m_max_level;
+      int m_max_local_level;
+      std::shared_ptr<const gauss_patterson_rule<Tp>> m_rule;
+    };
+
+} // namespace emsr
+
+#endif // GAUSS_PATTERSON_INTEGRAL_H
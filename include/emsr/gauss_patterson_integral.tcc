@@ -0,0 +1,1006 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef GAUSS_PATTERSON_INTEGRAL_TCC
+#define GAUSS_PATTERSON_INTEGRAL_TCC 1
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <emsr/gauss_rule_registry.h>
+#include <emsr/integration_error.h>
+#include <emsr/nested_rule_integral.tcc>
+
+namespace emsr
+{
+
+  // The nodes and weights were computed in 160-digit arithmetic
+  // following Patterson: the nodal polynomial of each extension is
+  // expanded in the Legendre polynomials of degree above the number
+  // of points being extended and made to vanish at the existing nodes.
+  // See T. N. L. Patterson, The Optimum Addition of Points to Quadrature
+  // Formulae, Mathematics of Computation, Volume 22, Number 104,
+  // October 1968, pages 847-856.
+
+  // Positive abscissae of the Gauss-Patterson rules in nested order:
+  // level L adds the 2^(L-1) entries starting at 2^(L-1) - 1.
+  inline constexpr long double
+  patterson_x[255]
+  {
+    // Level 1, 3 points.
+    0.774596669241483377035853079956479922L,
+    // Level 2, 7 points.
+    0.960491268708020283423507092629079963L,
+    0.434243749346802558002071502844627817L,
+    // Level 3, 15 points.
+    0.993831963212755022208512841307951444L,
+    0.888459232872256998890420167258502893L,
+    0.621102946737226402940687443816594795L,
+    0.223386686428966881628203986843998040L,
+    // Level 4, 31 points.
+    0.999098124967667597662226062412998228L,
+    0.981531149553740106867361888547025995L,
+    0.929654857429740056670125725933373527L,
+    0.836725938168868735502753818110221990L,
+    0.702496206491527078609800156008001394L,
+    0.531319743644375623972103438052468707L,
+    0.331135393257976833092640782248746539L,
+    0.112488943133186625745843327560318994L,
+    // Level 5, 63 points.
+    0.999872888120357611937956782213944071L,
+    0.997206259372221959076452532976228305L,
+    0.988684757547429479938528919613635432L,
+    0.972182874748581796578058835234688014L,
+    0.946342858373402905148496208230196252L,
+    0.910371156957004292497790670606627802L,
+    0.863907938193690477146415857372833975L,
+    0.806940531950217611856307980888497524L,
+    0.739756044352694758677217797247847849L,
+    0.662909660024780595461015255689389143L,
+    0.577195710052045814843690955654189189L,
+    0.483618026945841027562153280531749529L,
+    0.383359324198730346916485193850312925L,
+    0.277749822021824315065356412191446337L,
+    0.168235251552207464982313275440102195L,
+    0.056344313046592789971967860789446799L,
+    // Level 6, 127 points.
+    0.999982430354891598580012135905109718L,
+    0.999598799671910683251967529211801630L,
+    0.998316635318407392530634580111074985L,
+    0.995724104698407188509439459018460213L,
+    0.991495721178106132398500079082519841L,
+    0.985371499598520371113758241326513835L,
+    0.977141514639705714156395810916629371L,
+    0.966637851558416567092279836370846961L,
+    0.953730006425761136414748643963112199L,
+    0.938320397779592883654822310657872070L,
+    0.920340025470012420729821382965612468L,
+    0.899744899776940036638633212194468143L,
+    0.876513414484705269741626645388423610L,
+    0.850644494768350279757827407542049434L,
+    0.822156254364980407372527142399375938L,
+    0.791084933799848361434638057884175040L,
+    0.757483966380513637926269606413039215L,
+    0.721423085370098915484976184424530393L,
+    0.682987431091079228087077605443637571L,
+    0.642276642509759513774113624213729384L,
+    0.599403930242242892974251049643553400L,
+    0.554495132631932548866381362001869387L,
+    0.507687757533716602154783137518047825L,
+    0.459130011989832332873501971840246610L,
+    0.408979821229888672409031653482169654L,
+    0.357403837831532152376214925551056575L,
+    0.304576441556714043335324049984830587L,
+    0.250678730303483176612957105310757375L,
+    0.195897502711100153915460230694341455L,
+    0.140424233152560174593819634863430055L,
+    0.084454040083710883710182167279385113L,
+    0.028184648949745694339397327870361455L,
+    // Level 7, 255 points.
+    0.999997596379748464620231592559093838L,
+    0.999943996207054375763853646470050627L,
+    0.999760490924432047330447933438138365L,
+    0.999380338025023581928079338774322760L,
+    0.998745614468095114703528542397791960L,
+    0.997805354495957274561833338685736106L,
+    0.996514145914890273848684083613153803L,
+    0.994831502800621000519130529785414200L,
+    0.992721344282788615328202203758497351L,
+    0.990151370400770159180535140748087193L,
+    0.987092527954034067189898792468859040L,
+    0.983518657578632728761664630770795617L,
+    0.979406281670862683806133521363753398L,
+    0.974734459752402667760726712997609708L,
+    0.969484659502459231770908123207442170L,
+    0.963640621569812132520974048832142317L,
+    0.957188216109860962736208621751374729L,
+    0.950115297521294876557842262038304179L,
+    0.942411565191083059812560025758972248L,
+    0.934068436157725787999477771530264179L,
+    0.925078932907075652364132996222672693L,
+    0.915437587155765040643953616154536974L,
+    0.905140358813261595189303779754262290L,
+    0.894184568335559022859352159222674194L,
+    0.882568840247341906841695404228946667L,
+    0.870293055548113905851151444154923420L,
+    0.857358310886232156525126596087163923L,
+    0.843766882672708601038314138625718102L,
+    0.829522194637401400178105088351227617L,
+    0.814628787655137413435816577891367084L,
+    0.799092290960841401799803164024282389L,
+    0.782919394118283016385180478369806362L,
+    0.766117819303760090716674093891474571L,
+    0.748696293616936602822828737479369223L,
+    0.730664521242181261329306715350070028L,
+    0.712033155362252034586679081013994470L,
+    0.692813769779114702894651485928486731L,
+    0.673018830230418479198879472689545415L,
+    0.652661665410017496100770934689234627L,
+    0.631756437711194230413584623172536712L,
+    0.610318113715186400155578672320162394L,
+    0.588362434447662541434367386275547112L,
+    0.565905885423654422622970392231343950L,
+    0.542965666498311490492303133422203431L,
+    0.519559661537457021992914143047305013L,
+    0.495706407918761460170111534008667847L,
+    0.471425065871658876934088018252224136L,
+    0.446735387662028473742222281592907968L,
+    0.421657686626163300056304726883310970L,
+    0.396212806057615939182521394284924513L,
+    0.370422087950078230137537383958155880L,
+    0.344307341599438022776622416041385263L,
+    0.317890812068476683181739338725980798L,
+    0.291195148518246681963691099017626573L,
+    0.264243372410926761944948292977628979L,
+    0.237058845589829727212668030348623872L,
+    0.209665238243181194766342717964439603L,
+    0.182086496759252198246399488588060039L,
+    0.154346811481378108692446779987579230L,
+    0.126470584372301966850663538758563346L,
+    0.098482396598119202090275757897138670L,
+    0.070406976042855179063296876055596837L,
+    0.042269164765363603212404898844476949L,
+    0.014093886410782462614188488235526363L,
+    // Level 8, 511 points.
+    0.999999672956734384381255159219504364L,
+    0.999992298136257588027755643653277672L,
+    0.999966730098486276882830885249829533L,
+    0.999913081144678282800060235069510655L,
+    0.999822363679787739195887250384588541L,
+    0.999686286448317731776164145356439212L,
+    0.999497112467187190535254233642142550L,
+    0.999247618943342473598956442663599265L,
+    0.998931050830810562235800876396739441L,
+    0.998541055697167906026535840998703140L,
+    0.998071634524930323301862258025675477L,
+    0.997517116063472399965248778013340713L,
+    0.996872143485260161299488943893739714L,
+    0.996131662079315037786103069427033253L,
+    0.995290903148810302261441221134548383L,
+    0.994345364356723405931051404638823329L,
+    0.993290788851684966210630567482642982L,
+    0.992123145530863117682577626420874750L,
+    0.990838611958294243677056285821971149L,
+    0.989433560520240838716432580021828748L,
+    0.987904547695124280466641905020268033L,
+    0.986248305913007552681500984782933022L,
+    0.984461737328814534596391771473417111L,
+    0.982541908851080604250588677831770972L,
+    0.980486047876721339415983624301005241L,
+    0.978291538324758539526086160038420277L,
+    0.975955916702011753128799181439485043L,
+    0.973476868052506926773292287987565539L,
+    0.970852221732792443255952442569277608L,
+    0.968079947017759947963519321888740483L,
+    0.965158148579915665978748255831441744L,
+    0.962085061904651475740672658554329479L,
+    0.958859048710200221355841044142829926L,
+    0.955478592438183697573539743995601294L,
+    0.951942293872573589498252097644762507L,
+    0.948248866934137357062665220126395084L,
+    0.944397134685866648590658080707628440L,
+    0.940386025573669721370327188912126638L,
+    0.936214569916450806624944479090247516L,
+    0.931881896650953639345354400511520145L,
+    0.927387230329536696843211690624689034L,
+    0.922729888363349241522733951313044774L,
+    0.917909278499077501636477106031358488L,
+    0.912924896514370590079612985970192848L,
+    0.907776324115058903624408454321067330L,
+    0.902463227016165675048288297479834034L,
+    0.896985353188316590375563852478288554L,
+    0.891342531251319871666073517860396525L,
+    0.885534668997285008926065810947063001L,
+    0.879561752026556262567558918969831274L,
+    0.873423842480859310192448475755954521L,
+    0.867121077859315215614411686442293867L,
+    0.860653669904299969802344431679808599L,
+    0.854021903545468625813403671748430354L,
+    0.847226135891580884380537849403620383L,
+    0.840266795261030442350241206926867112L,
+    0.833144380243172624727943660481355907L,
+    0.825859458783650001087663767660628188L,
+    0.818412667287925807395404043191145468L,
+    0.810804709738146594361162662676158197L,
+    0.803036356819268687781707006870765941L,
+    0.795108445051100526779765742947619777L,
+    0.787021875923539422169923323741905332L,
+    0.778777615032822744702101629520361006L,
+    0.770376691217076824277500017133351229L,
+    0.761820195689839149173437924653647585L,
+    0.753109281170558142522517669810313795L,
+    0.744245161011347082309441398540227433L,
+    0.735229108319491547663437293814242461L,
+    0.726062455075389632685181784549147818L,
+    0.716746591245747095766955882802977877L,
+    0.707282963891961103411571396443421118L,
+    0.697673076273711232906268432444665621L,
+    0.687918486947839325755671239892119552L,
+    0.678020808862644517838207978295913361L,
+    0.667981708447749702165342767010660939L,
+    0.657802904699713735421940270137991804L,
+    0.647486168263572388781752384318535412L,
+    0.637033320510492495071297969207218262L,
+    0.626446232611719746541612603839722967L,
+    0.615726824608992638013732647929277824L,
+    0.604877064481584353319269553424672342L,
+    0.593898967210121954392748735781504899L,
+    0.582794593837318850839487067630703866L,
+    0.571566050525742833992171441191290996L,
+    0.560215487612728441817628214650371343L,
+    0.548745098662529448607596354508061769L,
+    0.537157119515795115981789701208283207L,
+    0.525453827336442687395072298705711378L,
+    0.513637539655988578507410663073248307L,
+    0.501710613415391878250546194647679694L,
+    0.489675444004456155436369884522791172L,
+    0.477534464298829155283575455463143732L,
+    0.465290143694634735858169562264939210L,
+    0.452944987140767283783874859373182660L,
+    0.440501534168875795782875930034670055L,
+    0.427962357921062742583273213352666611L,
+    0.415330064175321663764338828068254514L,
+    0.402607290368737092671111178854680699L,
+    0.389796704618470795479342632852727580L,
+    0.376901004740559344801845755742270672L,
+    0.363922917266549655269424134645355777L,
+    0.350865196458001209010794870666661043L,
+    0.337730623318886219620576667938434779L,
+    0.324522004605921855206648873895049867L,
+    0.311242171836871800300193771589406702L,
+    0.297893980296857823436564947771059784L,
+    0.284480308042725577495999284613193763L,
+    0.271004054905512543536209666476221085L,
+    0.257468141491069790481253043302448799L,
+    0.243875508178893021592923490555893028L,
+    0.230229114119222177155704589842474943L,
+    0.216531936228472628081382342675026775L,
+    0.202786968183064697556528857524340532L,
+    0.188997219411721861059196031656369889L,
+    0.175165714086311475707446070019754868L,
+    0.161295490111305257360594492010282067L,
+    0.147389598111939940054076867489504698L,
+    0.133451100421161601344115164152418089L,
+    0.119483070065440005133381524270645502L,
+    0.105488589749541988532652675372782829L,
+    0.091470750840355390909456726411039780L,
+    0.077432652349857282567521070875497335L,
+    0.063377399917322289879668363898950211L,
+    0.049308104790868626715648458572091531L,
+    0.035227882808441023260312770951944837L,
+    0.021139853378331088334963087669280490L,
+    0.007047138459336746485137933366153092L,
+  };
+
+  // Weights of the Gauss-Patterson rules: level L has 2^L entries
+  // starting at 2^L - 1, the central weight first
+  // and then the weights of the positive abscissae in nested order.
+  inline constexpr long double
+  patterson_w[511]
+  {
+    // Level 0, 1 points.
+    2.000000000000000000000000000000000000e+0L,
+    // Level 1, 3 points.
+    8.888888888888888888888888888888888889e-1L,
+    5.555555555555555555555555555555555556e-1L,
+    // Level 2, 7 points.
+    4.509165386584741423451100870455709165e-1L,
+    2.684880898683334407285692806667096248e-1L,
+    1.046562260264672651938238571920730382e-1L,
+    4.013974147759622229050518186184318787e-1L,
+    // Level 3, 15 points.
+    2.255104997982066873864225491559497449e-1L,
+    1.344152552437842203599687648024915205e-1L,
+    5.160328299707973969692012056786098371e-2L,
+    2.006285293769890210339318733313593062e-1L,
+    1.700171962994026033902741740265352524e-2L,
+    9.292719531512453768589422265416882635e-2L,
+    1.715119091363913807873531650197172179e-1L,
+    2.191568584015874964036931616437737477e-1L,
+    // Level 4, 31 points.
+    1.127552567207686916071498699838049560e-1L,
+    6.720775429599070354040106358134300918e-2L,
+    2.580759809617665356464611876523284970e-2L,
+    1.003142786117955787712936426950060792e-1L,
+    8.434565739321106246314929644160198548e-3L,
+    4.646289326175798654140464296394171612e-2L,
+    8.575592004999035115418652043679765524e-2L,
+    1.095784210559246382366883605725170684e-1L,
+    2.544780791561874415402782329831038101e-3L,
+    1.644604985438781093378838806897998755e-2L,
+    3.595710330712932209677782622096998624e-2L,
+    5.697950949412335741219736654572003167e-2L,
+    7.687962049900353104270519008094564115e-2L,
+    9.362710998126447361665878033925986584e-2L,
+    1.056698935802348097438158904421685347e-1L,
+    1.119568730209534568801435623212238603e-1L,
+    // Level 5, 63 points.
+    5.637762836038471738766255716523454566e-2L,
+    3.360387714820773054173398847317354038e-2L,
+    1.290380010035126562597665321863291201e-2L,
+    5.015713930589953741367954742395107586e-2L,
+    4.217630441558854839084226823573861929e-3L,
+    2.323144663991026944325648893658525481e-2L,
+    4.287796002500773449291230378198158022e-2L,
+    5.478921052796286503221753099415582133e-2L,
+    1.265156556230068011372609099981821966e-3L,
+    8.223007957235929669257784415467739529e-3L,
+    1.797855156812827033289604667086095875e-2L,
+    2.848975474583354861250609477239787165e-2L,
+    3.843981024945553203864034677787870968e-2L,
+    4.681355499062801240264808233434866429e-2L,
+    5.283494679011651986207665639653083993e-2L,
+    5.597843651047631940755337858722690740e-2L,
+    3.632214818455306596935806002405563080e-4L,
+    2.579049794685688272427795558561555269e-3L,
+    6.115506822117246339678283833260551553e-3L,
+    1.049824690962132189827284458363553209e-2L,
+    1.540675046655949780213082633154752871e-2L,
+    2.059423391591271114918856195031962958e-2L,
+    2.586967932721474691075826624484808157e-2L,
+    3.107355111168796487988438782454235850e-2L,
+    3.606443278078257264010716058960689164e-2L,
+    4.071551011694431893389409560051208037e-2L,
+    4.491453165363219741425424826183073589e-2L,
+    4.856433040667319871594711816675152860e-2L,
+    5.158325395204845877680910085752591009e-2L,
+    5.390549933526606392687695488636276391e-2L,
+    5.548140435655936398783840799554742484e-2L,
+    5.627769983125430127259534942554203852e-2L,
+    // Level 6, 127 points.
+    2.818881418019235869383127858820979581e-2L,
+    1.680193857410386527086941773733764195e-2L,
+    6.451900050175736922805097768238648011e-3L,
+    2.507856965294976870683977384428434046e-2L,
+    2.108815245726632879332553259080053076e-3L,
+    1.161572331995513472698495388680636386e-2L,
+    2.143898001250386724645615933406245868e-2L,
+    2.739460526398143251610876550935069013e-2L,
+    6.326073193626335442190140966758806993e-4L,
+    4.111503978654693047170267993894724247e-3L,
+    8.989275784064135723280603741188043253e-3L,
+    1.424487737291677430634156624364406055e-2L,
+    1.921990512472776601932028033142183501e-2L,
+    2.340677749531400620132404197002573952e-2L,
+    2.641747339505825993103832823119856888e-2L,
+    2.798921825523815970377668930041812399e-2L,
+    1.807395644453883578203339195147721939e-4L,
+    1.289524082610417392098508697787224412e-3L,
+    3.057753410175531136131383953541340403e-3L,
+    5.249123454808859125133846126353226462e-3L,
+    7.703375233279741848165978196893268169e-3L,
+    1.029711695795635552368646410702541347e-2L,
+    1.293483966360737345473395587423652836e-2L,
+    1.553677555584398243992841701629754294e-2L,
+    1.803221639039128632005309998572659181e-2L,
+    2.035775505847215946694702111777389682e-2L,
+    2.245726582681609870712712181444419161e-2L,
+    2.428216520333659935797355877403152746e-2L,
+    2.579162697602422938840455036603079780e-2L,
+    2.695274966763303196343847742405753825e-2L,
+    2.774070217827968199391920398907545532e-2L,
+    2.813884991562715063629767470689748903e-2L,
+    5.053609520786251762466560063371396484e-5L,
+    3.777466463269846602743645251576592928e-4L,
+    9.383698485423815007940443946818321381e-4L,
+    1.681142865421469906313730234914666183e-3L,
+    2.568764943794020373127715985638333157e-3L,
+    3.572892783517299649384487698645701995e-3L,
+    4.671050372114321747405433408267189464e-3L,
+    5.843449875835639507559511964505665047e-3L,
+    7.072489995433555468046316268413033411e-3L,
+    8.342838753968157705584124241679229360e-3L,
+    9.641177729702536695298303002847673903e-3L,
+    1.095573338783790164803272573630715955e-2L,
+    1.227583056008277008696633074136676179e-2L,
+    1.359157100976554678957291618149623178e-2L,
+    1.489364166481518203481039592676377671e-2L,
+    1.617321872957771994194796279803421828e-2L,
+    1.742193015946417374715226313972785493e-2L,
+    1.863184825613879018631403953327829110e-2L,
+    1.979549504809749948802772293891531282e-2L,
+    2.090585144581202385222185058787708592e-2L,
+    2.195636630531782493926050042078079299e-2L,
+    2.294096422938774876080053191959743574e-2L,
+    2.385405210603854008044603266874708054e-2L,
+    2.469052474448767690906083535284878416e-2L,
+    2.544576996546476581257439634457429652e-2L,
+    2.611567337670609768049880937712726028e-2L,
+    2.669662292745035990615469928819625153e-2L,
+    2.718551322962479181920860273203284538e-2L,
+    2.757974956648187303486871261891106967e-2L,
+    2.787725147661370160852379669029962637e-2L,
+    2.807645579381724660684784853368315662e-2L,
+    2.817631903301660213065358053263113467e-2L,
+    // Level 7, 255 points.
+    1.409440709009617934691563929410489791e-2L,
+    8.400969287051932635434708868668820976e-3L,
+    3.225950025087868461402548886646744000e-3L,
+    1.253928482647488435341988692214217023e-2L,
+    1.054407622863316772249566812567230934e-3L,
+    5.807861659977567363492476943403181933e-3L,
+    1.071949000625193362322807966703122934e-2L,
+    1.369730263199071625805438275467534507e-2L,
+    3.163036608222644768860015423197656737e-4L,
+    2.055751989327346523585571798919678924e-3L,
+    4.494637892032067861640301870594078951e-3L,
+    7.122438686458387153170783121822030276e-3L,
+    9.609952562363883009660140165710917504e-3L,
+    1.170338874765700310066202098501286976e-2L,
+    1.320873669752912996551916411559928444e-2L,
+    1.399460912761907985188834465020906200e-2L,
+    9.037273465875114926120482927994478011e-5L,
+    6.447620413057247793271972601326612446e-4L,
+    1.528876705087765568381057897981934512e-3L,
+    2.624561727404429562566923943037366505e-3L,
+    3.851687616639870924082989098456858783e-3L,
+    5.148558478978177761843232053512707174e-3L,
+    6.467419831803686727366977937118264181e-3L,
+    7.768387777921991219964208508148771469e-3L,
+    9.016108195195643160026549992863295904e-3L,
+    1.017887752923607973347351055888694841e-2L,
+    1.122863291340804935356356090722209581e-2L,
+    1.214108260166829967898677938701576373e-2L,
+    1.289581348801211469420227518301539890e-2L,
+    1.347637483381651598171923871202876912e-2L,
+    1.387035108913984099695960199453772766e-2L,
+    1.406942495781357531814883735344874452e-2L,
+    2.515787038428066148860299018743682692e-5L,
+    1.888732645065049136609305690626688208e-4L,
+    4.691849242478504097545664772033982874e-4L,
+    8.405714327107224636468446482045424897e-4L,
+    1.284382471897010176805112263688852445e-3L,
+    1.786446391758649824681032870434367798e-3L,
+    2.335525186057160873702697950350526759e-3L,
+    2.921724937917819753779755937115479033e-3L,
+    3.536244997716777734023158134052344653e-3L,
+    4.171419376984078852792062120838878941e-3L,
+    4.820588864851268347649151501423832125e-3L,
+    5.477866693918950824016362868153579734e-3L,
+    6.137915280041385043483165370683380894e-3L,
+    6.795785504882773394786458090748115889e-3L,
+    7.446820832407591017405197963381888354e-3L,
+    8.086609364788859970973981399017109141e-3L,
+    8.710965079732086873576131569863927463e-3L,
+    9.315924128069395093157019766639145552e-3L,
+    9.897747524048749744013861469457656411e-3L,
+    1.045292572290601192611092529393854296e-2L,
+    1.097818315265891246963025021039039649e-2L,
+    1.147048211469387438040026595979871787e-2L,
+    1.192702605301927004022301633437354027e-2L,
+    1.234526237224383845453041767642439208e-2L,
+    1.272288498273238290628719817228714826e-2L,
+    1.305783668835304884024940468856363014e-2L,
+    1.334831146372517995307734964409812577e-2L,
+    1.359275661481239590960430136601642269e-2L,
+    1.378987478324093651743435630945553483e-2L,
+    1.393862573830685080426189834514981319e-2L,
+    1.403822789690862330342392426684157831e-2L,
+    1.408815951650830106532679026631556733e-2L,
+    6.937936432410826716953822971699793686e-6L,
+    5.327529366978061312535243938958818238e-5L,
+    1.357549109492287197298428956563398749e-4L,
+    2.492124004829972940245376628680230094e-4L,
+    3.897452844732822932155638798458387275e-4L,
+    5.542953149303747149177321202669061304e-4L,
+    7.402828042445033304631601777002225950e-4L,
+    9.453615168585253824630151986074519793e-4L,
+    1.167484117429959407693331578729400458e-3L,
+    1.404907995655144642715211232969169003e-3L,
+    1.656112728154452605216827864511351095e-3L,
+    1.919712971013872412522717344669703587e-3L,
+    2.194406925363838838802918408686288671e-3L,
+    2.478958226657567930678215357454763749e-3L,
+    2.772195764593450993995214249610834186e-3L,
+    3.073018434702578323407837652266059736e-3L,
+    3.380397991086920382349930390388856729e-3L,
+    3.693377917025650818257299987644525356e-3L,
+    4.011068724075023398889936149039655716e-3L,
+    4.332640968092982854537699833246952964e-3L,
+    4.657317299756854777277944848496249697e-3L,
+    4.984364564765538601200010221620804869e-3L,
+    5.313086605187056566288043403729239638e-3L,
+    5.642818101384444158454605873116710714e-3L,
+    5.972919565508165804947298569359138991e-3L,
+    6.302773449085758717163987634189490525e-3L,
+    6.631781242901887894122007341803982664e-3L,
+    6.959361409390422939445075444791144490e-3L,
+    7.284947980553807063879811475349931101e-3L,
+    7.607989665719056583217396942233865796e-3L,
+    7.927949334294849110252542351157285749e-3L,
+    8.244303763032868030550597065353564389e-3L,
+    8.556543561307689619172932750049182737e-3L,
+    8.864173209482494264114294530917590552e-3L,
+    9.166711163560788406705196484728886285e-3L,
+    9.463689993830065294272431139432158665e-3L,
+    9.754656536317411461082934527354973796e-3L,
+    1.003917204405684079818102904383780801e-2L,
+    1.031681233094762168192070002441819124e-2L,
+    1.058716790488519793094281899324023992e-2L,
+    1.084984408933731409902452633180761922e-2L,
+    1.110446113400692653699941884545720964e-2L,
+    1.135065431598059660173448408049688025e-2L,
+    1.158807403304395256842397760123857942e-2L,
+    1.181638589083023576322479000849662416e-2L,
+    1.203527078527956263044986943061036064e-2L,
+    1.224442498161198589862920633246273715e-2L,
+    1.244356019071403526314950310871151295e-2L,
+    1.263240364354207876454054410852003176e-2L,
+    1.281069816387736196684170392180643879e-2L,
+    1.297820223953739928584218033482454968e-2L,
+    1.313469009196015283638132603817796584e-2L,
+    1.327995174393053065037750897102813367e-2L,
+    1.341379308511009851296637760857172156e-2L,
+    1.353603593495621361366530918905227171e-2L,
+    1.364651810257129142839989121586925905e-2L,
+    1.374509344300189663225205400255502738e-2L,
+    1.383163190950642867649596885351141433e-2L,
+    1.390601960132546126353122152536098858e-2L,
+    1.396815880651693851572777976743267218e-2L,
+    1.401796803945660880987222496884960418e-2L,
+    1.405538207264996427716792533110239869e-2L,
+    1.408035196255366132484584111045365131e-2L,
+    1.409284506916040835495927353867562304e-2L,
+    // Level 8, 511 points.
+    7.047203545048089673457819647052448954e-3L,
+    4.200484643525966317717354434334410488e-3L,
+    1.612975012543934230701274443323372000e-3L,
+    6.269642413237442176709943461071085114e-3L,
+    5.272038114316583861247834062837505137e-4L,
+    2.903930829988783681746238471701590967e-3L,
+    5.359745003125966811614039833515614670e-3L,
+    6.848651315995358129027191377337672533e-3L,
+    1.581518304111322429236866009827762721e-4L,
+    1.027875994663673261792785899459839462e-3L,
+    2.247318946016033930820150935297039476e-3L,
+    3.561219343229193576585391560911015138e-3L,
+    4.804976281181941504830070082855458752e-3L,
+    5.851694373828501550331010492506434880e-3L,
+    6.604368348764564982759582057799642221e-3L,
+    6.997304563809539925944172325104530998e-3L,
+    4.518636741262961431054468594557449068e-5L,
+    3.223810206528623896635991313931885875e-4L,
+    7.644383525438827841905289489909672561e-4L,
+    1.312280863702214781283461971518683252e-3L,
+    1.925843808319935462041494549228429391e-3L,
+    2.574279239489088880921616026756353587e-3L,
+    3.233709915901843363683488968559132090e-3L,
+    3.884193888960995609982104254074385734e-3L,
+    4.508054097597821580013274996431647952e-3L,
+    5.089438764618039866736755279443474205e-3L,
+    5.614316456704024676781780453611047903e-3L,
+    6.070541300834149839493389693507881866e-3L,
+    6.447906744006057347101137591507699450e-3L,
+    6.738187416908257990859619356014384562e-3L,
+    6.935175544569920498479800997268863831e-3L,
+    7.034712478906787659074418676724372258e-3L,
+    1.257927818895927435254076474864935690e-5L,
+    9.443663225327055270659013063730714303e-5L,
+    2.345924621239252048786303500667793093e-4L,
+    4.202857163553612318234223243350442939e-4L,
+    6.421912359485050884025561318444263201e-4L,
+    8.932231958793249123405164352171838988e-4L,
+    1.167762593028580436851348975175263380e-3L,
+    1.460862468958909876889877968557739516e-3L,
+    1.768122498858388867011579067026172326e-3L,
+    2.085709688492039426396031060419439471e-3L,
+    2.410294432425634173824575750711916062e-3L,
+    2.738933346959475412008181434076789867e-3L,
+    3.068957640020692521741582685341690447e-3L,
+    3.397892752441386697393229045374057945e-3L,
+    3.723410416203795508702598981690944177e-3L,
+    4.043304682394429985486990699508554570e-3L,
+    4.355482539866043436788065784931963732e-3L,
+    4.657962064034697546578509883319572776e-3L,
+    4.948873762024374872006930734728828206e-3L,
+    5.226462861453005963055462646969271479e-3L,
+    5.489091576329456234815125105195198246e-3L,
+    5.735241057346937190200132979899358934e-3L,
+    5.963513026509635020111508167186770136e-3L,
+    6.172631186121919227265208838212196040e-3L,
+    6.361442491366191453143599086143574129e-3L,
+    6.528918344176524420124702344281815070e-3L,
+    6.674155731862589976538674822049062883e-3L,
+    6.796378307406197954802150683008211344e-3L,
+    6.894937391620468258717178154727767416e-3L,
+    6.969312869153425402130949172574906593e-3L,
+    7.019113948454311651711962133420789155e-3L,
+    7.044079758254150532663395133157783667e-3L,
+    3.454565071691491348978551253139440947e-6L,
+    2.663764123390009013579133902662789160e-5L,
+    6.787745547339724162267099017874311492e-5L,
+    1.246062002414983684820440068045981614e-4L,
+    1.948726422366411465320755351694990445e-4L,
+    2.771476574651873574588407732512424526e-4L,
+    3.701414021222516652315800783446738288e-4L,
+    4.726807584292626912315075992982725539e-4L,
+    5.837420587149797038466657893646966960e-4L,
+    7.024539978275723213576056164845844986e-4L,
+    8.280563640772263026084139322556755477e-4L,
+    9.598564855069362062613586723348517934e-4L,
+    1.097203462681919419401459204343144335e-3L,
+    1.239479113328783965339107678727381875e-3L,
+    1.386097882296725496997607124805417093e-3L,
+    1.536509217351289161703918826133029868e-3L,
+    1.690198995543460191174965195194428365e-3L,
+    1.846688958512825409128649993822262678e-3L,
+    2.005534362037511699444968074519827858e-3L,
+    2.166320484046491427268849916623476482e-3L,
+    2.328658649878427388638972424248124848e-3L,
+    2.492182282382769300600005110810402434e-3L,
+    2.656543302593528283144021701864619819e-3L,
+    2.821409050692222079227302936558355357e-3L,
+    2.986459782754082902473649284679569496e-3L,
+    3.151386724542879358581993817094745263e-3L,
+    3.315890621450943947061003670901991332e-3L,
+    3.479680704695211469722537722395572245e-3L,
+    3.642473990276903531939905737674965550e-3L,
+    3.803994832859528291608698471116932898e-3L,
+    3.963974667147424555126271175578642874e-3L,
+    4.122151881516434015275298532676782195e-3L,
+    4.278271780653844809586466375024591369e-3L,
+    4.432086604741247132057147265458795276e-3L,
+    4.583355581780394203352598242364443142e-3L,
+    4.731844996915032647136215569716079333e-3L,
+    4.877328268158705730541467263677486898e-3L,
+    5.019586022028420399090514521918904005e-3L,
+    5.158406165473810840960350012209095622e-3L,
+    5.293583952442598965471409496620119959e-3L,
+    5.424922044668657049512263165903809609e-3L,
+    5.552230567003463268499709422728604819e-3L,
+    5.675327157990298300867242040248440124e-3L,
+    5.794037016521976284211988800619289709e-3L,
+    5.908192945415117881612395004248312081e-3L,
+    6.017635392639781315224934715305180320e-3L,
+    6.122212490805992949314603166231368574e-3L,
+    6.221780095357017631574751554355756474e-3L,
+    6.316201821771039382270272054260015879e-3L,
+    6.405349081938680983420851960903219395e-3L,
+    6.489101119768699642921090167412274838e-3L,
+    6.567345045980076418190663019088982922e-3L,
+    6.639975871965265325188754485514066835e-3L,
+    6.706896542555049256483188804285860782e-3L,
+    6.768017967478106806832654594526135853e-3L,
+    6.823259051285645714199945607934629527e-3L,
+    6.872546721500948316126027001277513689e-3L,
+    6.915815954753214338247984426755707166e-3L,
+    6.953009800662730631765610762680494289e-3L,
+    6.984079403258469257863889883716336088e-3L,
+    7.008984019728304404936112484424802092e-3L,
+    7.027691036324982138583962665551199346e-3L,
+    7.040175981276830662422920555226825653e-3L,
+    7.046422534580204177479636769337811518e-3L,
+    9.457159339500070488272099180927088483e-7L,
+    7.366240691023216688567789447348730828e-6L,
+    1.902136819058758166793211257779354370e-5L,
+    3.537513720551895886276783988207606940e-5L,
+    5.603195078561642521404745495560611021e-5L,
+    8.068992280140352938510528160409905250e-5L,
+    1.090855456457415220509609183724693793e-4L,
+    1.409703022041047914131625319890356146e-4L,
+    1.761267655450831954743902017800383131e-4L,
+    2.143680900342169371489540424810228610e-4L,
+    2.555255895952368620135212462828321535e-4L,
+    2.994391768509117308742032135934726501e-4L,
+    3.459544921299038713501353268591507491e-4L,
+    3.949241382468737044339002729945354191e-4L,
+    4.462098101014032474880867162276061926e-4L,
+    4.996835533128004845185512564562359975e-4L,
+    5.552277339773075797147214089221913042e-4L,
+    6.127340080122252092941278109445814867e-4L,
+    6.721017769601081946459487343321880316e-4L,
+    7.332365542247679120553441497414986198e-4L,
+    7.960485172975508715060794760504746517e-4L,
+    8.604513778085278481280035189654254980e-4L,
+    9.263615956131112833682294212978552532e-4L,
+    9.936978996387608579447009190422289610e-4L,
+    1.062381048853400713750675753402672489e-3L,
+    1.132333760515976649166612455230800982e-3L,
+    1.203480740012659648807128132976102589e-3L,
+    1.275748759773469473445174909633786180e-3L,
+    1.349066749283531131272004534383746939e-3L,
+    1.423365871417205199003014151053379654e-3L,
+    1.498579571064566362143137297626939133e-3L,
+    1.574643590032121661885542737470706204e-3L,
+    1.651495947719145706551482830492196251e-3L,
+    1.729076890544616071676115869135778762e-3L,
+    1.807328815018089300790104457725687422e-3L,
+    1.886196170158084753935809221788168222e-3L,
+    1.965625345031505477319863433414086125e-3L,
+    2.045564546799582934463364932668689220e-3L,
+    2.125963674014725330445621655947530757e-3L,
+    2.206774189160033291935512107261810371e-3L,
+    2.287948993651959723782584661520702691e-3L,
+    2.369442307793804951457886626830166633e-3L,
+    2.451209557505564839230764479342231382e-3L,
+    2.533207269079253257496822568665891019e-3L,
+    2.615392972722361092252703825776082416e-3L,
+    2.697725115252945866665130366535911752e-3L,
+    2.780162981991394350446511388062470525e-3L,
+    2.862666627647578682528622075706443259e-3L,
+    2.945196815818575822839190941521064964e-3L,
+    3.027714966581985444797317888220925504e-3L,
+    3.110183111584275461578145956738085943e-3L,
+    3.192563855974347367902482251934521194e-3L,
+    3.274820346512339695644765032641292415e-3L,
+    3.356916245186167613416010370767783793e-3L,
+    3.438815707687905918762164703826341562e-3L,
+    3.520483366134179226820381131305595242e-3L,
+    3.601884315455324318686596669252579272e-3L,
+    3.682984102924039119667012677898520728e-3L,
+    3.763748720342963382405069270977020326e-3L,
+    3.844144598460131589167386494498211779e-3L,
+    3.924138603229957746601745280574862014e-3L,
+    4.003698033584216885615542948307096109e-3L,
+    4.082790620421578383501539251520014400e-3L,
+    4.161384526565097457638877356301234491e-3L,
+    4.239448347474381844343106474626009912e-3L,
+    4.316951112532794799277995646575212772e-3L,
+    4.393862286760041952604764077563440155e-3L,
+    4.470151772826927269004349507099018841e-3L,
+    4.545789913272132854875543566455163695e-3L,
+    4.620747492840806874816488251657890922e-3L,
+    4.694995740881790465320074654484251405e-3L,
+    4.768506333754749252632007359711177318e-3L,
+    4.841251397210571352138037387936674389e-3L,
+    4.913203508718418973667814368994761120e-3L,
+    4.984335699721030299139881108819602212e-3L,
+    5.054621457806501250582808965810243329e-3L,
+    5.124034728790053518309267101797126941e-3L,
+    5.192549918703416148626546621325630106e-3L,
+    5.260141895692593112049568295312885341e-3L,
+    5.326785991827118579741222428314785034e-3L,
+    5.392458004825555936063869635661277567e-3L,
+    5.457134199703098639954120683300436805e-3L,
+    5.520791310347787064573862611676820078e-3L,
+    5.583406541032156376099665466315620680e-3L,
+    5.644957567867153688851040909672738695e-3L,
+    5.705422540204973323119534149612309585e-3L,
+    5.764780081997111429543180855557192456e-3L,
+    5.823009293113480577021125312228502391e-3L,
+    5.880089750627888032045560367305683962e-3L,
+    5.936001510074598276141296193725530182e-3L,
+    5.990725106680094714715791595039170229e-3L,
+    6.044241556573546345888426681350166715e-3L,
+    6.096532357978886929232101591026956972e-3L,
+    6.147579492390837902142095897073729600e-3L,
+    6.197365425736659963419841773510615208e-3L,
+    6.245873109524907485412873374106746965e-3L,
+    6.293085981981988366877291804970570034e-3L,
+    6.338987969176901659116499649338532012e-3L,
+    6.383563486134137097953197866101851422e-3L,
+    6.426797437934374389218365612710924163e-3L,
+    6.468675220802314816882664587826231853e-3L,
+    6.509182723180712008269367552135187587e-3L,
+    6.548306326789440640540462870565756689e-3L,
+    6.586032907668249377944798889940440493e-3L,
+    6.622349837201685094575125827800213465e-3L,
+    6.657244983124547082172288616238600050e-3L,
+    6.690706710506130065835754864570941550e-3L,
+    6.722723882711441080361792774164637014e-3L,
+    6.753285862337525290783806739712392919e-3L,
+    6.782382512123007460824620716047881672e-3L,
+    6.810004195828946883737400197268071975e-3L,
+    6.836141779089112218406345586038522812e-3L,
+    6.860786630227806979514037253833670968e-3L,
+    6.883930621043414709947343434909551093e-3L,
+    6.905566127555883548029751022550345401e-3L,
+    6.925686030716431556212957083753497618e-3L,
+    6.944283717077825494380298424811661558e-3L,
+    6.961353079423665514931340239816850739e-3L,
+    6.976888517355195458447296755316817246e-3L,
+    6.990884937834252075446842671184359356e-3L,
+    7.003337755681065728196766373380406938e-3L,
+    7.014242894025729164251784978471075292e-3L,
+    7.023596784712259110307302780324331013e-3L,
+    7.031396368654287095082315437612118478e-3L,
+    7.037639096141530523187353876284360758e-3L,
+    7.042322927096312095966347043517204587e-3L,
+    7.045446331279514767796553755909377512e-3L,
+    7.047008288445480137299624641003250741e-3L,
+  };
+
+  template<typename Tp>
+    std::shared_ptr<const gauss_patterson_rule<Tp>>
+    gauss_patterson_rules(int max_level)
+    {
+      using rule_t = gauss_patterson_rule<Tp>;
+      return gauss_rule_registry<Tp>::instance().template get<rule_t>
+	({Gauss_Patterson, max_level},
+	 [max_level]()
+	 {
+	   rule_t rule;
+	   const auto num = rule_t::num_abscissae(max_level);
+	   rule.point.reserve(num);
+	   rule.point.push_back(Tp{0});
+	   for (std::size_t i = 0; i + 1 < num; ++i)
+	     rule.point.push_back(Tp(patterson_x[i]));
+	   for (int l = 0; l <= max_level; ++l)
+	     {
+	       const auto beg = rule_t::num_abscissae(l) - 1;
+	       rule.weight.emplace_back(patterson_w + beg,
+					patterson_w + beg
+					+ rule_t::num_abscissae(l));
+	     }
+	   return rule;
+	 });
+    }
+
+  template<typename Tp>
+    gauss_patterson_integral<Tp>::
+    gauss_patterson_integral(int max_level, int min_level,
+			     int max_local_level)
+    : m_min_level(min_level),
+      m_max_level(max_level),
+      m_max_local_level(std::min(max_level, max_local_level)),
+      m_rule()
+    {
+      if (max_level < 1 || max_level > s_max_level)
+	throw std::domain_error("gauss_patterson_integral: "
+				"max_level out of range");
+      if (min_level < 1 || min_level > max_level)
+	throw std::domain_error("gauss_patterson_integral: "
+				"min_level out of range");
+      if (max_local_level < min_level)
+	throw std::domain_error("gauss_patterson_integral: "
+				"max_local_level out of range");
+      this->m_rule = gauss_patterson_rules<Tp>(max_level);
+    }
+
+  /**
+   * Climb the levels reusing all previous function values.
+   */
+  template<typename Tp>
+    template<typename FuncTp, typename Done>
+      auto
+      gauss_patterson_integral<Tp>::
+      m_climb(FuncTp func, Tp lower, Tp upper, int top_level,
+	      Done done) const
+      -> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	using RetTp = std::invoke_result_t<FuncTp, Tp>;
+	using AreaTp = decltype(RetTp{} * Tp{});
+
+	const auto& rule = *this->m_rule;
+	const auto center = (lower + upper) / Tp{2};
+	const auto half_length = (upper - lower) / Tp{2};
+
+	// Function values at the center and in symmetric pairs.
+	const auto num_max = rule.num_abscissae(top_level);
+	std::vector<RetTp> fval1, fval2;
+	fval1.reserve(num_max);
+	fval2.reserve(num_max);
+	fval1.push_back(func(center));
+	fval2.push_back(fval1[0]);
+
+	auto level_sums = [&func, &rule, center, half_length,
+			   &fval1, &fval2](int level)
+	  {
+	    const auto num = rule.num_abscissae(level);
+	    for (auto i = fval1.size(); i < num; ++i)
+	      {
+		const auto abscissa = half_length * rule.point[i];
+		fval1.push_back(func(center - abscissa));
+		fval2.push_back(func(center + abscissa));
+	      }
+
+	    const auto& w = rule.weight[level];
+	    detail::nested_level_sums<Tp, AreaTp>
+	      sums{w[0] * fval1[0], w[0] * std::abs(fval1[0]), Tp{0}};
+	    for (std::size_t i = 1; i < num; ++i)
+	      {
+		sums.res += w[i] * (fval1[i] + fval2[i]);
+		sums.resabs += w[i] * (std::abs(fval1[i])
+				     + std::abs(fval2[i]));
+	      }
+	    const auto mean = sums.res / Tp{2};
+	    sums.resasc = w[0] * std::abs(fval1[0] - mean);
+	    for (std::size_t i = 1; i < num; ++i)
+	      sums.resasc += w[i] * (std::abs(fval1[i] - mean)
+				   + std::abs(fval2[i] - mean));
+	    return sums;
+	  };
+
+	return detail::climb_nested_rules<Tp, RetTp>(0, this->m_min_level,
+						     top_level,
+						     half_length,
+						     level_sums, done);
+      }
+
+  template<typename Tp>
+    template<typename FuncTp>
+      auto
+      gauss_patterson_integral<Tp>::
+      integrate(FuncTp func, Tp lower, Tp upper,
+		Tp max_abs_err, Tp max_rel_err) const
+      -> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	const auto [out, ok] = detail::integrate_nested_rule("gauss_patterson_integral",
+		[this, &func, lower, upper](auto converged)
+		{
+		  return this->m_climb(func, lower, upper,
+				       this->m_max_level, converged);
+		},
+		max_abs_err, max_rel_err);
+	if (!ok)
+	  throw integration_error(s_tolerance_msg, TOLERANCE_ERROR,
+				  out.result, out.abserr);
+	return out;
+      }
+
+  template<typename Tp>
+    template<typename FuncTp>
+      auto
+      gauss_patterson_integral<Tp>::
+      integrate(std::nothrow_t, FuncTp func, Tp lower, Tp upper,
+		Tp max_abs_err, Tp max_rel_err) const
+      -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	std::size_t num_evals = 0;
+	auto counted_func = [&func, &num_evals](Tp x)
+			    { ++num_evals; return func(x); };
+	const auto [out, ok] = detail::integrate_nested_rule("gauss_patterson_integral",
+		[this, &counted_func, lower, upper](auto converged)
+		{
+		  return this->m_climb(counted_func, lower, upper,
+				       this->m_max_level, converged);
+		},
+		max_abs_err, max_rel_err);
+	if (ok)
+	  return {out.result, out.abserr, NO_ERROR, num_evals};
+	else
+	  return {out.result, out.abserr, TOLERANCE_ERROR, num_evals,
+		  s_tolerance_msg};
+      }
+
+  template<typename Tp>
+    template<typename FuncTp>
+      auto
+      gauss_patterson_integral<Tp>::
+      integrate(FuncTp func, Tp lower, Tp upper) const
+      -> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	return this->m_climb(func, lower, upper, this->m_max_local_level,
+			     detail::nested_rule_at_roundoff{});
+      }
+
+} // namespace emsr
+
+#endif // GAUSS_PATTERSON_INTEGRAL_TCC
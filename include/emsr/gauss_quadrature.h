@@ -22,6 +22,8 @@
 #include <type_traits>
 #include <vector>
 
+#include <emsr/gauss_rule_registry.h>
+
 namespace emsr
 {
 
@@ -200,6 +202,16 @@ namespace emsr
 	decltype(std::invoke_result_t<FuncTp, Tp>{} * Tp{})
 	operator()(FuncTp func, Tp lower, Tp upper) const;
 
+      /// Return the nodes of the rule for the weight @f$ |x|^\alpha e^{-x^2} @f$.
+      const std::vector<Tp>&
+      nodes() const
+      { return this->point; }
+
+      /// Return the weights of the rule for the weight @f$ |x|^\alpha e^{-x^2} @f$.
+      const std::vector<Tp>&
+      weights() const
+      { return this->weight; }
+
     private:
       std::vector<Tp> point;
       std::vector<Tp> weight;
@@ -246,6 +258,22 @@ namespace emsr
       std::vector<Tp> weight;
     };
 
+  namespace detail
+  {
+    /**
+     * Fetch a fixed Gauss rule from the process-wide registry
+     * building it on first use.
+     */
+    template<typename RuleTp, typename Tp, typename Builder>
+      std::shared_ptr<const RuleTp>
+      cached_gauss_rule(const typename gauss_rule_registry<Tp>::key_type& key,
+			Builder build)
+      {
+	return gauss_rule_registry<Tp>::instance()
+		 .template get<RuleTp>(key, build);
+      }
+  } // namespace detail
+
   template<typename Tp, typename FuncTp>
     fixed_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     integrate_fixed_gauss_legendre(int n,
@@ -264,8 +292,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_legendre_integral<Tp> integ(n);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_legendre_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Legendre, n},
+			 [=](){ return rule_t(n); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -287,8 +318,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_chebyshev_t_integral<Tp> integ(n);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_chebyshev_t_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Chebyshev_T, n},
+			 [=](){ return rule_t(n); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -311,8 +345,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_chebyshev_u_integral<Tp> integ(n);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_chebyshev_u_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Chebyshev_U, n},
+			 [=](){ return rule_t(n); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -334,8 +371,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_chebyshev_v_integral<Tp> integ(n);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_chebyshev_v_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Chebyshev_V, n},
+			 [=](){ return rule_t(n); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -357,8 +397,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_chebyshev_w_integral<Tp> integ(n);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_chebyshev_w_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Chebyshev_W, n},
+			 [=](){ return rule_t(n); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -380,8 +423,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_gegenbauer_integral<Tp> integ(n, lambda);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_gegenbauer_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Gegenbauer, n, lambda},
+			 [=](){ return rule_t(n, lambda); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -404,8 +450,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_jacobi_integral<Tp> integ(n, alf, bet);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_jacobi_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Jacobi, n, alf, bet},
+			 [=](){ return rule_t(n, alf, bet); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -427,8 +476,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_laguerre_integral<Tp> integ(n, alf);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_laguerre_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Laguerre, n, alf},
+			 [=](){ return rule_t(n, alf); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -450,8 +502,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_hermite_integral<Tp> integ(n, alf);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_hermite_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Hermite, n, alf},
+			 [=](){ return rule_t(n, alf); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -473,8 +528,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_exponential_integral<Tp> integ(n, alf);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_exponential_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Exponential, n, alf},
+			 [=](){ return rule_t(n, alf); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
@@ -497,8 +555,11 @@ namespace emsr
 	return {area_t{}};
       else
 	{
-          fixed_gauss_rational_integral<Tp> integ(n, alf, bet);
-          return { integ(func, lower, upper) };
+	  using rule_t = fixed_gauss_rational_integral<Tp>;
+	  auto integ = detail::cached_gauss_rule<rule_t, Tp>
+			({Gauss_Rational, n, alf, bet},
+			 [=](){ return rule_t(n, alf, bet); });
+	  return { (*integ)(func, lower, upper) };
 	}
     }
 
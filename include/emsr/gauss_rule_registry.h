@@ -0,0 +1,181 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef GAUSS_RULE_REGISTRY_H
+#define GAUSS_RULE_REGISTRY_H 1
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <utility>
+
+namespace emsr
+{
+
+  /**
+   * The families of rules held by gauss_rule_registry.
+   *
+   * The Gauss families up to Gauss_Rational are built by Golub-Welsch
+   * and keyed by order; Gauss_Patterson and Clenshaw_Curtis are nested
+   * interval rules keyed by level, Triangle_Symmetric is the fully
+   * symmetric triangle rule keyed by degree and Sparse_Grid holds
+   * the difference rules of a sparse grid keyed by level
+   * with the sparse_grid_family as the first parameter.
+   */
+  enum Gauss_Family
+  {
+    Gauss_Legendre,
+    Gauss_Chebyshev_T,
+    Gauss_Chebyshev_U,
+    Gauss_Chebyshev_V,
+    Gauss_Chebyshev_W,
+    Gauss_Gegenbauer,
+    Gauss_Jacobi,
+    Gauss_Laguerre,
+    Gauss_Hermite,
+    Gauss_Exponential,
+    Gauss_Rational,
+    Gauss_Patterson,
+    Clenshaw_Curtis,
+    Triangle_Symmetric,
+    Sparse_Grid
+  };
+
+  /**
+   * A process-wide, thread-safe, memoizing registry of fixed quadrature
+   * rules for a given real type.
+   *
+   * Rules are keyed by rule type, family, order (or level or degree)
+   * and the (up to two) family parameters and are handed out
+   * as shared pointers to immutable rule objects.
+   * The least recently used rules are evicted once the registry holds
+   * more than capacity() rules.  An evicted rule stays alive for as long
+   * as somebody holds a pointer to it.
+   *
+   * Rules are built outside the lock so concurrent lookups of other rules
+   * are not serialized behind a long Golub-Welsch computation.
+   */
+  template<typename Tp>
+    class gauss_rule_registry
+    {
+    public:
+
+      /// The lookup key of a rule.
+      struct key_type
+      {
+	Gauss_Family family;
+	int order;
+	Tp alpha = Tp{0};
+	Tp beta = Tp{0};
+
+	bool
+	operator<(const key_type& k) const
+	{
+	  if (this->family != k.family)
+	    return this->family < k.family;
+	  if (this->order != k.order)
+	    return this->order < k.order;
+	  if (this->alpha != k.alpha)
+	    return this->alpha < k.alpha;
+	  return this->beta < k.beta;
+	}
+      };
+
+      /// Usage statistics for the registry.
+      struct stats_t
+      {
+	/// Number of lookups satisfied from the registry.
+	std::size_t hits = 0;
+	/// Number of lookups that had to build a rule.
+	std::size_t misses = 0;
+	/// Number of rules evicted to honor the capacity.
+	std::size_t evictions = 0;
+	/// Current number of rules held.
+	std::size_t size = 0;
+	/// Maximum number of rules held.
+	std::size_t capacity = 0;
+      };
+
+      /// The default maximum number of rules held.
+      static constexpr std::size_t s_default_capacity = 64;
+
+      /// Return the process-wide registry for this real type.
+      static gauss_rule_registry&
+      instance();
+
+      /**
+       * Return the rule for a key building it with @c build
+       * if it is not in the registry.
+       *
+       * @tparam RuleTp  The rule type; one type per family.
+       * @param key    The lookup key.
+       * @param build  A callable with no arguments returning a @c RuleTp.
+       * @throws std::domain_error if a family parameter is NaN.
+       */
+      template<typename RuleTp, typename Builder>
+	std::shared_ptr<const RuleTp>
+	get(const key_type& key, Builder build);
+
+      /// Return a snapshot of the usage statistics.
+      stats_t
+      stats() const;
+
+      /// Return the maximum number of rules held.
+      std::size_t
+      capacity() const;
+
+      /// Set the maximum number of rules held evicting as needed.
+      void
+      set_capacity(std::size_t cap);
+
+      /// Drop all rules and reset the statistics.
+      void
+      clear();
+
+    private:
+
+      // The rule type is part of the stored key so that a rule is never
+      // handed back as a different type than the one it was built as.
+      using index_key = std::pair<std::type_index, key_type>;
+      using value_type = std::pair<index_key, std::shared_ptr<const void>>;
+      using list_type = std::list<value_type>;
+
+      gauss_rule_registry() = default;
+
+      void
+      m_evict();
+
+      mutable std::mutex m_mutex;
+
+      // Most recently used first.
+      list_type m_lru;
+      std::map<index_key, typename list_type::iterator> m_index;
+
+      std::size_t m_capacity = s_default_capacity;
+      std::size_t m_hits = 0;
+      std::size_t m_misses = 0;
+      std::size_t m_evictions = 0;
+    };
+
+} // namespace emsr
+
+#include <emsr/gauss_rule_registry.tcc>
+
+#endif // GAUSS_RULE_REGISTRY_H
@@ -0,0 +1,133 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef GAUSS_RULE_REGISTRY_TCC
+#define GAUSS_RULE_REGISTRY_TCC 1
+
+#include <cmath>
+#include <stdexcept>
+#include <typeinfo>
+
+namespace emsr
+{
+
+  template<typename Tp>
+    gauss_rule_registry<Tp>&
+    gauss_rule_registry<Tp>::instance()
+    {
+      static gauss_rule_registry<Tp> s_registry;
+      return s_registry;
+    }
+
+  template<typename Tp>
+    template<typename RuleTp, typename Builder>
+      std::shared_ptr<const RuleTp>
+      gauss_rule_registry<Tp>::get(const key_type& rule_key, Builder build)
+      {
+	// NaN parameters would break the ordering of the index.
+	if (std::isnan(rule_key.alpha) || std::isnan(rule_key.beta))
+	  throw std::domain_error("gauss_rule_registry: "
+				  "NaN family parameter");
+
+	const index_key key{std::type_index(typeid(RuleTp)), rule_key};
+	{
+	  std::lock_guard<std::mutex> lock(this->m_mutex);
+	  auto pos = this->m_index.find(key);
+	  if (pos != this->m_index.end())
+	    {
+	      ++this->m_hits;
+	      this->m_lru.splice(this->m_lru.begin(), this->m_lru, pos->second);
+	      return std::static_pointer_cast<const RuleTp>(pos->second->second);
+	    }
+	  ++this->m_misses;
+	}
+
+	// Build without holding the lock.
+	auto rule = std::make_shared<const RuleTp>(build());
+
+	std::lock_guard<std::mutex> lock(this->m_mutex);
+	auto pos = this->m_index.find(key);
+	if (pos != this->m_index.end())
+	  {
+	    // Another thread beat us to it; share its rule.
+	    this->m_lru.splice(this->m_lru.begin(), this->m_lru, pos->second);
+	    return std::static_pointer_cast<const RuleTp>(pos->second->second);
+	  }
+	this->m_lru.emplace_front(key, rule);
+	this->m_index.emplace(key, this->m_lru.begin());
+	this->m_evict();
+
+	return rule;
+      }
+
+  template<typename Tp>
+    typename gauss_rule_registry<Tp>::stats_t
+    gauss_rule_registry<Tp>::stats() const
+    {
+      std::lock_guard<std::mutex> lock(this->m_mutex);
+      return {this->m_hits, this->m_misses, this->m_evictions,
+	      this->m_lru.size(), this->m_capacity};
+    }
+
+  template<typename Tp>
+    std::size_t
+    gauss_rule_registry<Tp>::capacity() const
+    {
+      std::lock_guard<std::mutex> lock(this->m_mutex);
+      return this->m_capacity;
+    }
+
+  template<typename Tp>
+    void
+    gauss_rule_registry<Tp>::set_capacity(std::size_t cap)
+    {
+      std::lock_guard<std::mutex> lock(this->m_mutex);
+      this->m_capacity = cap;
+      this->m_evict();
+    }
+
+  template<typename Tp>
+    void
+    gauss_rule_registry<Tp>::clear()
+    {
+      std::lock_guard<std::mutex> lock(this->m_mutex);
+      this->m_index.clear();
+      this->m_lru.clear();
+      this->m_hits = 0;
+      this->m_misses = 0;
+      this->m_evictions = 0;
+    }
+
+  /**
+   * Drop least recently used rules until the capacity is honored.
+   * The caller must hold the lock.
+   */
+  template<typename Tp>
+    void
+    gauss_rule_registry<Tp>::m_evict()
+    {
+      while (this->m_lru.size() > this->m_capacity)
+	{
+	  this->m_index.erase(this->m_lru.back().first);
+	  this->m_lru.pop_back();
+	  ++this->m_evictions;
+	}
+    }
+
+} // namespace emsr
+
+#endif // GAUSS_RULE_REGISTRY_TCC
@@ -2,10 +2,73 @@
 #define GEGENBAUER_ZEROS_TCC 1
 
 #include <stdexcept>
+#include <vector>
+#include <cmath>
+
+#include <emsr/matrix.h>
+#include <emsr/parallel_for.h>
 
 namespace emsr
+{
+
+namespace detail
 {
 
+  /**
+   * Refine an approximate zero @c z of the Gegenbauer polynomial
+   * @f$ C_n^{(\lambda)}(x) @f$ by Newton's method
+   * and return the zero and weight.
+   */
+  template<typename Tp>
+    QuadraturePoint<Tp>
+    gegenbauer_newton(unsigned int n, Tp lambda, Tp z)
+    {
+      const auto s_eps = std::numeric_limits<Tp>::epsilon();
+      const unsigned int s_maxit = 1000u;
+
+      auto w = Tp{0};
+      auto __2lambda = Tp{2} * lambda;
+      for (auto its = 1u; its <= s_maxit; ++its)
+	{
+	  auto temp = Tp{2} + __2lambda;
+	  auto C1 = (temp * z) / Tp{2};
+	  auto C2 = Tp{1};
+	  for (auto j = 2u; j <= n; ++j)
+	    {
+	      auto C3 = C2;
+	      C2 = C1;
+	      temp = Tp(2 * j) + __2lambda;
+	      auto a = Tp(2 * j) * (j + __2lambda)
+		       * (temp - Tp{2});
+	      auto b = (temp - Tp{1})
+		       * temp * (temp - Tp{2}) * z;
+	      auto c = Tp{2} * (j - 1 + lambda)
+		       * (j - 1 + lambda) * temp;
+	      C1 = (b * C2 - c * C3) / a;
+	    }
+	  auto Cp = (n * (-temp * z) * C1
+		    + Tp{2} * (n + lambda) * (n + lambda) * C2)
+		    / (temp * (Tp{1} - z * z));
+	  auto z1 = z;
+	  z = z1 - C1 / Cp;
+	  if (std::abs(z - z1) <= s_eps)
+	    {
+	      w = std::exp(std::lgamma(lambda + Tp(n))
+			   + std::lgamma(lambda + Tp(n))
+			   - std::lgamma(Tp(n + 1))
+			   - std::lgamma(Tp(n + 1) + __2lambda))
+		  * temp * std::pow(Tp{2}, __2lambda) / (Cp * C2);
+	      break;
+	    }
+	  if (its == s_maxit)
+	    throw std::logic_error("gegenbauer_zeros: Too many iterations");
+	}
+
+      return {z, w};
+    }
+
+} // namespace detail
+
   /**
    * Return a vector containing the zeros of the Gegenbauer or ultraspherical
    * polynomial @f$ C_n^{(\lambda)}@f$.
@@ -19,12 +82,9 @@ namespace emsr
     std::vector<QuadraturePoint<Tp>>
     gegenbauer_zeros(unsigned int n, Tp lambda)
     {
-      const auto s_eps = std::numeric_limits<Tp>::epsilon();
-      const unsigned int s_maxit = 1000u;
       std::vector<QuadraturePoint<Tp>> pt(n);
 
       Tp z;
-      Tp w;
       for (auto i = 1u; i <= n; ++i)
 	{
 	  if (i == 1)
@@ -74,49 +134,56 @@ namespace emsr
 	    z = 3.0 * pt[i - 2].point
 		- 3.0 * pt[i - 3].point + pt[i - 4].point;
 
-	  auto __2lambda = Tp{2} * lambda;
-	  for (auto its = 1u; its <= s_maxit; ++its)
-	    {
-	      auto temp = Tp{2} + __2lambda;
-	      auto C1 = (temp * z) / Tp{2};
-	      auto C2 = Tp{1};
-	      for (auto j = 2u; j <= n; ++j)
-		{
-		  auto C3 = C2;
-		  C2 = C1;
-		  temp = Tp(2 * j) + __2lambda;
-		  auto a = Tp(2 * j) * (j + __2lambda)
-			   * (temp - Tp{2});
-		  auto b = (temp - Tp{1})
-			   * temp * (temp - Tp{2}) * z;
-		  auto c = Tp{2} * (j - 1 + lambda)
-			   * (j - 1 + lambda) * temp;
-		  C1 = (b * C2 - c * C3) / a;
-		}
-	      auto Cp = (n * (-temp * z) * C1
-			+ Tp{2} * (n + lambda) * (n + lambda) * C2)
-			/ (temp * (Tp{1} - z * z));
-	      auto z1 = z;
-	      z = z1 - C1 / Cp;
-	      if (std::abs(z - z1) <= s_eps)
-		{
-		  w = std::exp(std::lgamma(lambda + Tp(n))
-			       + std::lgamma(lambda + Tp(n))
-			       - std::lgamma(Tp(n + 1))
-			       - std::lgamma(Tp(n + 1) + __2lambda))
-		      * temp * std::pow(Tp{2}, __2lambda) / (Cp * C2);
-		  break;
-		}
-	      if (its > s_maxit)
-		throw std::logic_error("gegenbauer_zeros: Too many iterations");
-	    }
-	  pt[i - 1].point = z;
-	  pt[i - 1].weight = w;
+	  pt[i - 1] = detail::gegenbauer_newton(n, lambda, z);
+	  // The next guesses extrapolate from the refined roots.
+	  z = pt[i - 1].point;
 	}
 
       return pt;
     }
 
+  /**
+   * Return a vector containing the zeros of the Gegenbauer or ultraspherical
+   * polynomial @f$ C_n^{(\lambda)}@f$ spreading the root refinement
+   * over @c num_threads threads.
+   *
+   * The serial version seeds each root from the ones before it.
+   * Here each root is instead isolated independently by Sturm bisection
+   * and then polished by Newton's method so the result does not depend
+   * on the thread count.  The Newton iteration above runs the Jacobi
+   * recursion with @f$ \alpha = \beta = \lambda @f$ so the same
+   * Jacobi matrix is used for the bisection.
+   *
+   * @tparam  Tp  The real type of the order
+   * @param[in]  n  The degree of the Gegenbauer polynomial
+   * @param[in]  lambda  The order of the Gegenbauer polynomial
+   * @param[in]  num_threads  The number of threads
+   *                          (0 means hardware concurrency)
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    gegenbauer_zeros(unsigned int n, Tp lambda, unsigned int num_threads)
+    {
+      std::vector<QuadraturePoint<Tp>> pt(n);
+      if (n == 0)
+	return pt;
+
+      std::vector<Tp> diag, subd;
+      detail::jacobi_matrix(n, lambda, lambda, diag, subd);
+
+      // The i-th largest zero is the (n - i)-th smallest eigenvalue.
+      parallel_for(1u, n + 1u, num_threads,
+		   [n, lambda, &diag, &subd, &pt](std::size_t ii)
+		   {
+		     const auto i = unsigned(ii);
+		     const auto z = s_tridiag_symm_eigenvalue(n, diag, subd,
+							      n - i, 8);
+		     pt[i - 1] = detail::gegenbauer_newton(n, lambda, z);
+		   });
+
+      return pt;
+    }
+
 } // namespace emsr
 
 #endif // GEGENBAUER_ZEROS_TCC
@@ -21,18 +21,25 @@
 #ifndef GLFIXED_INTEGRATE_TCC
 #define GLFIXED_INTEGRATE_TCC 1
 
+#include <cstddef>
 #include <type_traits>
 
 #include <emsr/gauss_legendre_table.h>
+#include <emsr/static_gauss_table.h>
 
 namespace emsr
 {
 
-  template<typename Tp, typename FuncTp>
+namespace detail
+{
+
+  /**
+   * Apply a symmetric Gauss-Legendre table storing only the nonnegative
+   * abscissae to a function on the interval @f$ [lower, upper] @f$.
+   */
+  template<typename Tp, typename Table, typename FuncTp>
     decltype(std::invoke_result_t<FuncTp, Tp>{} * Tp{})
-    glfixed_integrate(const gauss_legendre_table<Tp>& t,
-		      FuncTp func,
-		      Tp lower, Tp upper)
+    glfixed_sum(const Table& t, FuncTp func, Tp lower, Tp upper)
     {
       using RetTp = std::invoke_result_t<FuncTp, Tp>;
       using AreaTp = decltype(RetTp{} * Tp{});
@@ -65,6 +72,34 @@ namespace emsr
 	}
     }
 
+} // namespace detail
+
+  template<typename Tp, typename FuncTp>
+    decltype(std::invoke_result_t<FuncTp, Tp>{} * Tp{})
+    glfixed_integrate(const gauss_legendre_table<Tp>& t,
+		      FuncTp func,
+		      Tp lower, Tp upper)
+    { return detail::glfixed_sum(t, func, lower, upper); }
+
+  template<typename Tp, std::size_t N, typename FuncTp>
+    decltype(std::invoke_result_t<FuncTp, Tp>{} * Tp{})
+    glfixed_integrate(const static_gauss_legendre_table<Tp, N>& t,
+		      FuncTp func,
+		      Tp lower, Tp upper)
+    { return detail::glfixed_sum(t, func, lower, upper); }
+
+  /**
+   * Integrate a function with the Gauss-Legendre rule of order @c N
+   * whose table is built at compile time.
+   */
+  template<std::size_t N, typename Tp, typename FuncTp>
+    decltype(std::invoke_result_t<FuncTp, Tp>{} * Tp{})
+    glfixed_integrate(FuncTp func, Tp lower, Tp upper)
+    {
+      return detail::glfixed_sum(gauss_legendre_table_v<Tp, N>,
+				 func, lower, upper);
+    }
+
 } // namespace emsr
 
 #endif // GLFIXED_INTEGRATE_TCC
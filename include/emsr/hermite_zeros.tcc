@@ -3,45 +3,95 @@
 
 #include <stdexcept>
 #include <cmath>
+#include <algorithm>
+
+#include <emsr/matrix.h>
+#include <emsr/parallel_for.h>
 
 namespace emsr
+{
+
+namespace detail
 {
 
   /**
-   * Build a vector of the Gauss-Hermite integration rule abscissae and weights.
+   * Refine an approximate zero @c z of the Hermite polynomial
+   * of degree @c n by Newton's method and return the zero and weight.
    */
   template<typename Tp>
-    std::vector<QuadraturePoint<Tp>>
-    hermite_zeros(unsigned int n)
+    QuadraturePoint<Tp>
+    hermite_newton(unsigned int n, Tp z)
     {
       const auto s_eps = std::numeric_limits<Tp>::epsilon();
       const unsigned int s_maxit = 1000u;
       const auto s_pim4 = Tp{0.7511255444649424828587030047762276930510L};
-      const auto s_sqrt_pi = Tp{1} / Tp{5.6418'95835'47756'28694'80794'51560'77258'58438e-1L};
+      const auto s_sqrt_eps = std::sqrt(s_eps);
+
+      auto w = Tp{0};
+      auto dz_prev = std::numeric_limits<Tp>::max();
+      for (auto its = 1u; its <= s_maxit; ++its)
+	{
+	  auto H = s_pim4;
+	  auto H1 = Tp{0};
+	  for (auto k = 1u; k <= n; ++k)
+	    {
+	      auto H2 = H1;
+	      H1 = H;
+	      H = z * std::sqrt(Tp{2} / k) * H1
+		- std::sqrt(Tp(k - 1) / Tp(k)) * H2;
+	    }
+	  auto Hp = std::sqrt(Tp(2 * n)) * H1;
+	  auto z1 = z;
+	  z = z1 - H / Hp;
+	  // The zeros grow with the degree so use a relative tolerance.
+	  // Stop also once roundoff in the recursion stalls the iteration.
+	  const auto scale = std::max(Tp{1}, std::abs(z));
+	  const auto dz = std::abs(z - z1);
+	  if (dz <= Tp{8} * s_eps * scale
+	      || (dz >= dz_prev && dz <= s_sqrt_eps * scale))
+	    {
+	      w = Tp{2} / (Hp * Hp);
+	      break;
+	    }
+	  dz_prev = dz;
+	  if (its == s_maxit)
+	    throw std::logic_error("hermite_zeros: Too many iterations");
+	}
+
+      return {z, w};
+    }
+
+  /**
+   * Return the central zero and weight of the Gauss-Hermite rule
+   * for odd order @c n.
+   * The zero is exact so one Newton pass only supplies the weight
+   * from the derivative.  This avoids the overflow-prone factorials.
+   */
+  template<typename Tp>
+    QuadraturePoint<Tp>
+    hermite_central_zero(unsigned int n)
+    { return hermite_newton(n, Tp{0}); }
+
+} // namespace detail
 
+  /**
+   * Build a vector of the Gauss-Hermite integration rule abscissae and weights.
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    hermite_zeros(unsigned int n)
+    {
       std::vector<QuadraturePoint<Tp>> pt(n);
 
       const auto m = n / 2;
 
       // Treat the central zero for odd order specially.
-      // Be careful to avoid overflow of the factorials.
-      // An alternative would be to proceed with the recursion
-      // for large order.
       if (n & 1)
-	{
-	  auto nm = n - 1;
-	  auto nmfact = std::lgamma(Tp(nm - 1));
-	  auto mm = nm / 2;
-	  auto mmfact = std::lgamma(Tp(mm - 1));
-	  pt[m].point = Tp{0};
-	  pt[m].weight = s_sqrt_pi * std::pow(Tp{2}, Tp(n - 1))
-			     *std::exp(-(nmfact - 2 * mmfact)) / n;
-	}
+	pt[m] = detail::hermite_central_zero<Tp>(n);
 
+      auto z = Tp{0};
       for (auto i = 1u; i <= m; ++i)
 	{
-	  Tp z;
-	  Tp w = Tp{0};
 	  if (i == 1)
 	    z = std::sqrt(Tp(2 * n + 1))
 		- 1.85575 * std::pow(Tp(2 * n + 1), -0.166667);
@@ -53,37 +103,63 @@ namespace emsr
 	    z = 1.91 * z - 0.91 * pt[1].point;
 	  else
 	    z = 2.0 * z - pt[i - 3].point;
-	  for (auto its = 1u; its <= s_maxit; ++its)
-	    {
-	      auto H = s_pim4;
-	      auto H1 = Tp{0};
-	      for (auto k = 1u; k <= n; ++k)
-		{
-		  auto H2 = H1;
-		  H1 = H;
-		  H = z * std::sqrt(Tp{2} / k) * H1
-		    - std::sqrt(Tp(k - 1) / Tp(k)) * H2;
-		}
-	      auto Hp = std::sqrt(Tp(2 * n)) * H1;
-	      auto z1 = z;
-	      z = z1 - H / Hp;
-	      if (std::abs(z - z1) <= s_eps)
-		{
-		  w = Tp{2} / (Hp * Hp);
-		  break;
-		}
-	      if (its > s_maxit)
-		throw std::logic_error("hermite_zeros: Too many iterations");
-	    }
+	  const auto zw = detail::hermite_newton(n, z);
+	  z = zw.point;
 	  pt[n - i].point = -z;
-	  pt[n - i].weight = w;
+	  pt[n - i].weight = zw.weight;
 	  pt[i - 1].point = z;
-	  pt[i - 1].weight = w;
+	  pt[i - 1].weight = zw.weight;
 	}
 
       return pt;
     }
 
+  /**
+   * Build a vector of the Gauss-Hermite integration rule abscissae and weights
+   * spreading the root refinement over @c num_threads threads.
+   *
+   * The serial version seeds each root from the ones before it.
+   * Here each positive root is instead isolated independently by Sturm
+   * bisection on the Jacobi matrix of the Hermite recursion and then polished
+   * by Newton's method so the result does not depend on the thread count.
+   *
+   * @param n  The degree of the Hermite polynomial.
+   * @param num_threads  The number of threads (0 means hardware concurrency).
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    hermite_zeros(unsigned int n, unsigned int num_threads)
+    {
+      std::vector<QuadraturePoint<Tp>> pt(n);
+
+      const auto m = n / 2;
+
+      if (n & 1)
+	pt[m] = detail::hermite_central_zero<Tp>(n);
+
+      std::vector<Tp> diag(n, Tp{0});
+      std::vector<Tp> subd(n);
+      for (auto i = 0u; i < n; ++i)
+	subd[i] = std::sqrt(Tp(i + 1) / Tp{2});
+
+      // The i-th largest zero is the (n - i)-th smallest eigenvalue.
+      parallel_for(1u, m + 1u, num_threads,
+		   [n, &diag, &subd, &pt](std::size_t ii)
+		   {
+		     const auto i = unsigned(ii);
+		     const auto z = s_tridiag_symm_eigenvalue(n, diag, subd,
+							      n - i, 8);
+		     const auto zw = detail::hermite_newton(n, z);
+
+		     pt[n - i].point = -zw.point;
+		     pt[n - i].weight = zw.weight;
+		     pt[i - 1].point = zw.point;
+		     pt[i - 1].weight = zw.weight;
+		   });
+
+      return pt;
+    }
+
 } // namespace emsr
 
 #endif // HERMITE_ZEROS_TCC
@@ -20,11 +20,15 @@
 #ifndef INTEGRATION_H
 #define INTEGRATION_H 1
 
+#include <cstddef>
 #include <limits>
+#include <new> // For std::nothrow
 #include <tuple>
 #include <complex> // For complex abs
+#include <string_view>
 #include <type_traits>
 
+#include <emsr/integration_error.h>
 #include <emsr/quadrature_point.h>
 #include <emsr/gauss_kronrod_integral.h>
 
@@ -61,8 +65,61 @@ namespace emsr
       AbsAreaTp abserr = AbsAreaTp{};
     };
 
+  /**
+   * The return type for the non-throwing adaptive integrators,
+   * those taking @c std::nothrow as first argument.
+   * Failure to meet the tolerance is reported in the error code
+   * along with the best result and error estimate found.
+   */
+  template<typename Tp, typename RetTp>
+    struct adaptive_status_t
+    {
+      using AreaTp = decltype(RetTp{} * Tp{});
+      using AbsAreaTp = decltype(std::abs(AreaTp{}));
+
+      /// Result of the integral.
+      AreaTp    result = AreaTp{};
+      /// Absolute value of estimated error.
+      AbsAreaTp abserr = AbsAreaTp{};
+      /// The error code: NO_ERROR if the tolerance was met.
+      int error_code = NO_ERROR;
+      /// The number of function evaluations.
+      std::size_t num_evals = 0;
+      /// A description of the error more specific than the code or null.
+      const char* message = nullptr;
+
+      /// Return true if the tolerance was met.
+      explicit
+      operator bool() const
+      { return this->error_code == NO_ERROR; }
+    };
+
+  /**
+   * Throw the integration_error reported by a non-throwing integrator
+   * or return its result and error estimate.
+   *
+   * @param func The name of the integrator for the error message.
+   * @param status The status returned by the non-throwing integrator.
+   */
+  template<typename Tp, typename RetTp>
+    adaptive_integral_t<Tp, RetTp>
+    check_status(std::string_view func,
+		 const adaptive_status_t<Tp, RetTp>& status)
+    {
+      if (status.error_code != NO_ERROR)
+	{
+	  if (status.message != nullptr)
+	    throw integration_error(status.message, status.error_code,
+				    status.result, status.abserr);
+	  check_error(func, status.error_code, status.result, status.abserr);
+	}
+      return {status.result, status.abserr};
+    }
+
 } // namespace emsr
 
+#include <emsr/gauss_patterson_integral.h>
+#include <emsr/clenshaw_curtis_integral.h>
 #include <emsr/trapezoid_integral.h>
 #include <emsr/midpoint_integral.h>
 #include <emsr/simpson_integral.h>
@@ -423,8 +480,10 @@ namespace emsr
     -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
 
   /**
-   * Adaptively integrate a function using a recursive Gauss-Kronrod quadrature
-   * called the Patterson algorithm.
+   * Integrate a function using the nested Gauss-Patterson rules
+   * of 1, 3, 7, ..., 511 points.  Each rule reuses all the function values
+   * of the rules before it and the climb stops when the difference
+   * between successive rules meets the tolerance.
    */
   template<typename Tp, typename FuncTp>
     auto
@@ -620,9 +679,12 @@ namespace emsr
 #include <emsr/midpoint_integral.tcc>
 #include <emsr/simpson_integral.tcc>
 #include <emsr/gauss_kronrod_integral.tcc>
+#include <emsr/mapped_gauss_kronrod_integral.h>
 #include <emsr/qag_integrate.tcc>
 #include <emsr/qags_integrate.tcc>
 #include <emsr/qng_integrate.tcc>
+#include <emsr/gauss_patterson_integral.tcc>
+#include <emsr/clenshaw_curtis_integral.tcc>
 #include <emsr/qagp_integrate.tcc>
 #include <emsr/qcheb_integrate.tcc>
 #include <emsr/qawc_integrate.tcc>
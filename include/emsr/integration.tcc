@@ -128,11 +128,10 @@ namespace emsr
 	{
           integration_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>
 	    workspace(max_iter);
-          return qag_integrate(workspace,
-			       map_minf_pinf<Tp, FuncTp>(func),
-			       Tp{0}, Tp{1},
+          return qag_integrate(workspace, func, Tp{0}, Tp{1},
 			       max_abs_error, max_rel_error,
-			       gauss_kronrod_integral<Tp>(qkintrule));
+			       mapped_gauss_kronrod_integral<Tp,
+				 coord_map_minf_pinf<Tp>>(qkintrule, {}));
 	}
     }
 
@@ -172,11 +171,10 @@ namespace emsr
 	{
           integration_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>
 	    workspace(max_iter);
-          return qag_integrate(workspace,
-			       map_minf_b(func, upper),
-			       Tp{0}, Tp{1},
+          return qag_integrate(workspace, func, Tp{0}, Tp{1},
 			       max_abs_error, max_rel_error,
-			       gauss_kronrod_integral<Tp>(qkintrule));
+			       mapped_gauss_kronrod_integral<Tp,
+				 coord_map_minf_b<Tp>>(qkintrule, {upper}));
 	}
     }
 
@@ -216,11 +214,10 @@ namespace emsr
 	{
           integration_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>
 	    workspace(max_iter);
-          return qag_integrate(workspace,
-			       map_a_pinf(func, lower),
-			       Tp{0}, Tp{1},
+          return qag_integrate(workspace, func, Tp{0}, Tp{1},
 			       max_abs_error, max_rel_error,
-			       gauss_kronrod_integral<Tp>(qkintrule));
+			       mapped_gauss_kronrod_integral<Tp,
+				 coord_map_a_pinf<Tp>>(qkintrule, {lower}));
 	}
     }
 
@@ -298,10 +295,10 @@ namespace emsr
 	{
           integration_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>
 	    workspace(max_iter);
-          return qags_integrate(workspace,
-			        map_minf_pinf<Tp, FuncTp>(func),
-			        Tp{0}, Tp{1},
-			        max_abs_error, max_rel_error);
+          return qags_integrate(workspace, func, Tp{0}, Tp{1},
+			        max_abs_error, max_rel_error,
+			        mapped_gauss_kronrod_integral<Tp,
+				  coord_map_minf_pinf<Tp>>(Kronrod_15, {}));
 	}
     }
 
@@ -331,10 +328,10 @@ namespace emsr
 	{
           integration_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>
 	    workspace(max_iter);
-          return qags_integrate(workspace,
-			        map_minf_b(func, upper),
-			        Tp{0}, Tp{1},
-			        max_abs_error, max_rel_error);
+          return qags_integrate(workspace, func, Tp{0}, Tp{1},
+			        max_abs_error, max_rel_error,
+			        mapped_gauss_kronrod_integral<Tp,
+				  coord_map_minf_b<Tp>>(Kronrod_15, {upper}));
 	}
     }
 
@@ -371,10 +368,10 @@ namespace emsr
 	{
           integration_workspace<Tp, std::invoke_result_t<FuncTp, Tp>>
 	    workspace(max_iter);
-          return qags_integrate(workspace,
-			        map_a_pinf(func, lower),
-			        Tp{0}, Tp{1},
-			        max_abs_error, max_rel_error);
+          return qags_integrate(workspace, func, Tp{0}, Tp{1},
+			        max_abs_error, max_rel_error,
+			        mapped_gauss_kronrod_integral<Tp,
+				  coord_map_a_pinf<Tp>>(Kronrod_15, {lower}));
 	}
     }
 
@@ -594,8 +591,10 @@ namespace emsr
     }
 
   /**
-   * Adaptively integrate a function using a recursive Gauss-Kronrod quadrature
-   * called the Patterson algorithm.
+   * Integrate a function using the nested Gauss-Patterson rules
+   * of 1, 3, 7, ..., 511 points.  Each rule reuses all the function values
+   * of the rules before it and the climb stops when the difference
+   * between successive rules meets the tolerance.
    */
   template<typename Tp, typename FuncTp>
     auto
@@ -620,8 +619,10 @@ namespace emsr
 	return {area_t{}, absarea_t{}};
       else
 	{
-          return qng_integrate(func, lower, upper,
-			       max_abs_error, max_rel_error);
+	  const auto res = gauss_patterson_integral<Tp>()
+			     .integrate(func, lower, upper,
+					max_abs_error, max_rel_error);
+	  return {res.result, res.abserr};
 	}
     }
 
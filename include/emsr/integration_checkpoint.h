@@ -0,0 +1,195 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+//
+// Implements the resumable state of the adaptive integration loops.
+
+#ifndef INTEGRATION_CHECKPOINT_H
+#define INTEGRATION_CHECKPOINT_H 1
+
+#include <cmath>
+#include <complex> // For complex abs
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include <emsr/integration_snapshot.h>
+#include <emsr/extrapolation_table.h>
+
+namespace emsr
+{
+
+  /**
+   * The state of the qags_integrate loop between bisections
+   * beyond that held by the integration workspace.
+   *
+   * A default-constructed state starts a new integration.
+   * A state passed to the checkpoint callback of qags_integrate,
+   * saved with the workspace and restored later, resumes the
+   * integration where it was checkpointed.  The integrand, limits,
+   * tolerances and rule must be those of the interrupted run.
+   */
+  template<typename Tp, typename RetTp>
+    struct qags_state
+    {
+      using AreaTp = decltype(RetTp{} * Tp{});
+      using AbsAreaTp = decltype(std::abs(AreaTp{}));
+
+      /// The number of integrations so far; zero for a new integration.
+      unsigned int iteration = 0;
+      /// The number of function evaluations so far.
+      std::size_t num_evals = 0;
+
+      AreaTp result0 = AreaTp{};
+      AbsAreaTp resabs0 = AbsAreaTp{};
+      AreaTp area = AreaTp{};
+      AbsAreaTp errsum = AbsAreaTp{};
+      Tp tolerance = Tp{};
+      AreaTp res_ext = AreaTp{};
+      AbsAreaTp err_ext = AbsAreaTp{};
+      AbsAreaTp correc = AbsAreaTp{};
+      Tp ertest = Tp{};
+      Tp error_over_large_intervals = Tp{};
+      unsigned int ktmin = 0;
+      int error_type = 0;
+      int error_type2 = 0;
+      int roundoff_type1 = 0;
+      int roundoff_type2 = 0;
+      int roundoff_type3 = 0;
+      bool extrapolate = false;
+      bool allow_extrapolation = true;
+
+      /// The table of the sequence of results to extrapolate.
+      extrapolation_table<AreaTp, AbsAreaTp> table;
+
+      /// Write the state to a binary snapshot.
+      void
+      save(std::ostream& out) const
+      {
+	detail::write_snapshot_header<Tp, AreaTp>(out, Snapshot_Qags_State);
+	detail::write_value(out, std::uint64_t(this->iteration));
+	detail::write_value(out, std::uint64_t(this->num_evals));
+	detail::write_value(out, this->result0);
+	detail::write_value(out, this->resabs0);
+	detail::write_value(out, this->area);
+	detail::write_value(out, this->errsum);
+	detail::write_value(out, this->tolerance);
+	detail::write_value(out, this->res_ext);
+	detail::write_value(out, this->err_ext);
+	detail::write_value(out, this->correc);
+	detail::write_value(out, this->ertest);
+	detail::write_value(out, this->error_over_large_intervals);
+	detail::write_value(out, std::uint64_t(this->ktmin));
+	const std::int32_t flags[7]
+	  = {this->error_type, this->error_type2,
+	     this->roundoff_type1, this->roundoff_type2, this->roundoff_type3,
+	     this->extrapolate, this->allow_extrapolation};
+	detail::write_values(out, flags, 7);
+	this->table.save(out);
+      }
+
+      /// Restore the state from a binary snapshot written by save().
+      void
+      restore(std::istream& in)
+      {
+	detail::read_snapshot_header<Tp, AreaTp>(in, Snapshot_Qags_State);
+	std::uint64_t iter, evals, kt;
+	detail::read_value(in, iter);
+	detail::read_value(in, evals);
+	detail::read_value(in, this->result0);
+	detail::read_value(in, this->resabs0);
+	detail::read_value(in, this->area);
+	detail::read_value(in, this->errsum);
+	detail::read_value(in, this->tolerance);
+	detail::read_value(in, this->res_ext);
+	detail::read_value(in, this->err_ext);
+	detail::read_value(in, this->correc);
+	detail::read_value(in, this->ertest);
+	detail::read_value(in, this->error_over_large_intervals);
+	detail::read_value(in, kt);
+	std::int32_t flags[7];
+	detail::read_values(in, flags, 7);
+	this->table.restore(in);
+	this->iteration = iter;
+	this->num_evals = evals;
+	this->ktmin = kt;
+	this->error_type = flags[0];
+	this->error_type2 = flags[1];
+	this->roundoff_type1 = flags[2];
+	this->roundoff_type2 = flags[3];
+	this->roundoff_type3 = flags[4];
+	this->extrapolate = flags[5] != 0;
+	this->allow_extrapolation = flags[6] != 0;
+      }
+    };
+
+  /**
+   * The state of the cquad_integrate loop between interval updates
+   * beyond that held by the cquad workspace: the running totals
+   * and the contributions of the intervals dropped as too small
+   * to refine.  See qags_state for usage.
+   */
+  template<typename Tp, typename RetTp>
+    struct cquad_state
+    {
+      using AreaTp = decltype(RetTp{} * Tp{});
+
+      /// True once the first interval has been integrated.
+      bool started = false;
+      /// The number of function evaluations so far.
+      std::size_t num_evals = 0;
+
+      AreaTp igral = AreaTp{};
+      AreaTp igral_final = AreaTp{};
+      Tp err = Tp{};
+      Tp err_final = Tp{};
+
+      /// Write the state to a binary snapshot.
+      void
+      save(std::ostream& out) const
+      {
+	detail::write_snapshot_header<Tp, AreaTp>(out, Snapshot_Cquad_State);
+	detail::write_value(out, std::uint32_t(this->started));
+	detail::write_value(out, std::uint64_t(this->num_evals));
+	detail::write_value(out, this->igral);
+	detail::write_value(out, this->igral_final);
+	detail::write_value(out, this->err);
+	detail::write_value(out, this->err_final);
+      }
+
+      /// Restore the state from a binary snapshot written by save().
+      void
+      restore(std::istream& in)
+      {
+	detail::read_snapshot_header<Tp, AreaTp>(in, Snapshot_Cquad_State);
+	std::uint32_t start;
+	std::uint64_t evals;
+	detail::read_value(in, start);
+	detail::read_value(in, evals);
+	detail::read_value(in, this->igral);
+	detail::read_value(in, this->igral_final);
+	detail::read_value(in, this->err);
+	detail::read_value(in, this->err_final);
+	this->started = start != 0;
+	this->num_evals = evals;
+      }
+    };
+
+} // namespace emsr
+
+#endif // INTEGRATION_CHECKPOINT_H
@@ -0,0 +1,163 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+//
+// Implements the binary format of snapshots of integration state.
+
+#ifndef INTEGRATION_SNAPSHOT_H
+#define INTEGRATION_SNAPSHOT_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace emsr
+{
+
+  /**
+   * The kinds of integration state that can be written to a snapshot.
+   * Each snapshot starts with a header naming its kind so that
+   * a snapshot cannot be restored into the wrong object.
+   * Values are written in the native byte order; snapshots are meant
+   * to be restored by a program built for the same platform.
+   */
+  enum snapshot_kind : std::uint32_t
+  {
+    Snapshot_Integration_Workspace = 1,
+    Snapshot_Extrapolation_Table,
+    Snapshot_Cquad_Workspace,
+    Snapshot_Qags_State,
+    Snapshot_Cquad_State
+  };
+
+namespace detail
+{
+  /// The tag at the start of every snapshot.
+  inline constexpr char s_snapshot_magic[8]
+    = {'e', 'm', 's', 'r', 's', 'n', 'a', 'p'};
+
+  /// The version of the snapshot format.
+  inline constexpr std::uint32_t s_snapshot_version = 2;
+
+  /**
+   * Write the bytes of a trivially copyable value.
+   */
+  template<typename ValTp>
+    void
+    write_value(std::ostream& out, const ValTp& val)
+    {
+      static_assert(std::is_trivially_copyable_v<ValTp>,
+		    "write_value: Type must be trivially copyable.");
+      out.write(reinterpret_cast<const char*>(&val), sizeof(ValTp));
+    }
+
+  /**
+   * Write the bytes of an array of trivially copyable values.
+   */
+  template<typename ValTp>
+    void
+    write_values(std::ostream& out, const ValTp* val, std::size_t num)
+    {
+      static_assert(std::is_trivially_copyable_v<ValTp>,
+		    "write_values: Type must be trivially copyable.");
+      out.write(reinterpret_cast<const char*>(val), num * sizeof(ValTp));
+    }
+
+  /**
+   * Read the bytes of a trivially copyable value.
+   */
+  template<typename ValTp>
+    void
+    read_value(std::istream& in, ValTp& val)
+    {
+      static_assert(std::is_trivially_copyable_v<ValTp>,
+		    "read_value: Type must be trivially copyable.");
+      if (!in.read(reinterpret_cast<char*>(&val), sizeof(ValTp)))
+	throw std::runtime_error("read_value: Snapshot is truncated");
+    }
+
+  /**
+   * Read the bytes of an array of trivially copyable values.
+   */
+  template<typename ValTp>
+    void
+    read_values(std::istream& in, ValTp* val, std::size_t num)
+    {
+      static_assert(std::is_trivially_copyable_v<ValTp>,
+		    "read_values: Type must be trivially copyable.");
+      if (!in.read(reinterpret_cast<char*>(val), num * sizeof(ValTp)))
+	throw std::runtime_error("read_values: Snapshot is truncated");
+    }
+
+  /**
+   * Write the header of a snapshot of the given kind holding values
+   * of the real type @c Tp and the area type @c AreaTp.
+   */
+  template<typename Tp, typename AreaTp>
+    void
+    write_snapshot_header(std::ostream& out, snapshot_kind kind)
+    {
+      out.write(s_snapshot_magic, sizeof(s_snapshot_magic));
+      write_value(out, s_snapshot_version);
+      write_value(out, kind);
+      write_value(out, std::uint32_t(std::numeric_limits<Tp>::digits));
+      write_value(out, std::uint32_t(sizeof(Tp)));
+      write_value(out, std::uint32_t(sizeof(AreaTp)));
+    }
+
+  /**
+   * Read and check the header of a snapshot of the given kind holding
+   * values of the real type @c Tp and the area type @c AreaTp.
+   * Throw std::runtime_error if the snapshot is of another kind,
+   * another version or other types.
+   */
+  template<typename Tp, typename AreaTp>
+    void
+    read_snapshot_header(std::istream& in, snapshot_kind kind)
+    {
+      char magic[sizeof(s_snapshot_magic)];
+      std::uint32_t version, kind_in, digits, size_real, size_area;
+      read_values(in, magic, sizeof(magic));
+      for (std::size_t i = 0; i < sizeof(magic); ++i)
+	if (magic[i] != s_snapshot_magic[i])
+	  throw std::runtime_error("read_snapshot_header: "
+				   "Not an integration snapshot");
+      read_value(in, version);
+      if (version != s_snapshot_version)
+	throw std::runtime_error("read_snapshot_header: "
+				 "Unsupported snapshot version");
+      read_value(in, kind_in);
+      if (kind_in != kind)
+	throw std::runtime_error("read_snapshot_header: "
+				 "Snapshot is of another kind");
+      read_value(in, digits);
+      read_value(in, size_real);
+      read_value(in, size_area);
+      if (digits != std::uint32_t(std::numeric_limits<Tp>::digits)
+	  || size_real != sizeof(Tp) || size_area != sizeof(AreaTp))
+	throw std::runtime_error("read_snapshot_header: "
+				 "Snapshot holds values of other types");
+    }
+} // namespace detail
+
+} // namespace emsr
+
+#endif // INTEGRATION_SNAPSHOT_H
@@ -181,6 +181,93 @@ namespace emsr
       }
     };
 
+  /**
+   * The coordinate map of map_minf_pinf without the function:
+   * @f$ x(t) = -1/t + 1/(1-t) @f$ of @f$ t \in (0, 1) @f$ onto
+   * @f$ (-\infty, +\infty) @f$ with @f$ dx/dt = 1/t^2 + 1/(1-t)^2 @f$.
+   * The endpoints map to the infinities with unit Jacobian
+   * as in map_minf_pinf.
+   */
+  template<typename Tp>
+    struct coord_map_minf_pinf
+    {
+      void
+      operator()(Tp t, Tp& x, Tp& dxdt) const
+      {
+	if (t == Tp{0})
+	  {
+	    x = -std::numeric_limits<Tp>::infinity();
+	    dxdt = Tp{1};
+	  }
+	else if (t == Tp{1})
+	  {
+	    x = +std::numeric_limits<Tp>::infinity();
+	    dxdt = Tp{1};
+	  }
+	else
+	  {
+	    const auto inv_t = Tp{1} / t;
+	    const auto inv_1mt = Tp{1} / (Tp{1} - t);
+	    x = -inv_t + inv_1mt;
+	    dxdt = inv_t * inv_t + inv_1mt * inv_1mt;
+	  }
+      }
+    };
+
+  /**
+   * The coordinate map of map_minf_b without the function:
+   * @f$ x(t) = b - (1-t)/t @f$ of @f$ t \in (0, 1] @f$ onto
+   * @f$ (-\infty, b] @f$ with @f$ dx/dt = 1/t^2 @f$.
+   */
+  template<typename Tp>
+    struct coord_map_minf_b
+    {
+      Tp m_b;
+
+      void
+      operator()(Tp t, Tp& x, Tp& dxdt) const
+      {
+	if (t == Tp{0})
+	  {
+	    x = -std::numeric_limits<Tp>::infinity();
+	    dxdt = Tp{1};
+	  }
+	else
+	  {
+	    const auto inv_t = Tp{1} / t;
+	    x = m_b - (Tp{1} - t) * inv_t;
+	    dxdt = inv_t * inv_t;
+	  }
+      }
+    };
+
+  /**
+   * The coordinate map of map_a_pinf without the function:
+   * @f$ x(t) = a + t/(1-t) @f$ of @f$ t \in [0, 1) @f$ onto
+   * @f$ [a, +\infty) @f$ with @f$ dx/dt = 1/(1-t)^2 @f$.
+   */
+  template<typename Tp>
+    struct coord_map_a_pinf
+    {
+      Tp m_a;
+
+      void
+      operator()(Tp t, Tp& x, Tp& dxdt) const
+      {
+	if (t == Tp{1})
+	  {
+	    x = +std::numeric_limits<Tp>::infinity();
+	    dxdt = Tp{1};
+	  }
+	else
+	  {
+	    const auto inv_1mt = Tp{1} / (Tp{1} - t);
+	    x = m_a + t * inv_1mt;
+	    dxdt = inv_1mt * inv_1mt;
+	  }
+      }
+    };
+
 } // namespace emsr
 
 #endif // INTEGRATION_TRANSFORM_H
@@ -29,6 +29,9 @@
 #include <cmath>
 #include <iosfwd>
 
+#include <emsr/compensated_sum.h>
+#include <emsr/integration_snapshot.h>
+
 namespace emsr
 {
 
@@ -77,13 +80,37 @@ namespace emsr
 
       std::vector<interval> m_ival;
 
+      // The running totals of the interval results and errors
+      // in the chosen summation mode.
+      summation_mode m_summation;
+      compensated_sum<AreaTp> m_result_sum;
+      compensated_sum<ErrorTp> m_error_sum;
+      exact_sum<AreaTp> m_exact_result;
+      exact_sum<ErrorTp> m_exact_error;
+
+      void m_update_totals(const interval& iv, bool remove);
+
+      void m_rebuild_totals();
+
     public:
 
-      integration_workspace(std::size_t cap)
+      /**
+       * Construct a workspace for at most @c cap intervals.
+       *
+       * The totals of the interval results and errors are kept
+       * as intervals are added and removed.  By default they are
+       * compensated sums.  With @c Summation_Reproducible they are
+       * exact sums rounded once, so that the same set of intervals
+       * gives bitwise the same totals whatever the order in which
+       * they were added and bisected.
+       */
+      integration_workspace(std::size_t cap,
+			    summation_mode mode = Summation_Compensated)
       : m_curr_index{0},
 	m_max_depth{0},
 	m_max_size(cap),
-	m_ival{}
+	m_ival{},
+	m_summation(mode)
       {
 	m_ival.reserve(cap);
       }
@@ -148,6 +175,20 @@ namespace emsr
 	this->m_curr_index = 0;
 	this->m_max_depth = 0;
 	this->m_ival.clear();
+	this->m_rebuild_totals();
+      }
+
+      /// Return the summation mode of the totals.
+      summation_mode
+      summation() const
+      { return this->m_summation; }
+
+      /// Change the summation mode and recompute the totals.
+      void
+      set_summation(summation_mode mode)
+      {
+	this->m_summation = mode;
+	this->m_rebuild_totals();
       }
 
       /**
@@ -157,6 +198,7 @@ namespace emsr
       void
       push(const interval& iv)
       {
+	this->m_update_totals(iv, false);
 	this->m_ival.push_back(iv);
 	std::push_heap(this->begin(), this->end(), interval_comp{});
       }
@@ -168,6 +210,7 @@ namespace emsr
       void
       pop()
       {
+	this->m_update_totals(this->top(), true);
 	std::pop_heap(this->begin(), this->end());
 	this->m_ival.pop_back();
       }
@@ -212,8 +255,7 @@ namespace emsr
        * Only used by qagp.
        */
       ErrorTp
-      set_abs_error(std::size_t ii, ErrorTp abserr)
-      { return this->m_ival[this->curr_index() + ii].abs_error = abserr; }
+      set_abs_error(std::size_t ii, ErrorTp abserr);
 
       /**
        * Set the depth of segment at start + ii to the given value.
@@ -273,20 +315,20 @@ namespace emsr
       AreaTp
       total_integral() const
       {
-	auto result_sum = AreaTp{0};
-	for (const auto& iv : this->m_ival)
-	  result_sum += iv.result;
-	return result_sum;
+	if (this->m_summation == Summation_Reproducible)
+	  return this->m_exact_result.value();
+	else
+	  return this->m_result_sum.value();
       }
 
       /// Return the sum of the absolute errors over all integration segments.
       ErrorTp
       total_error() const
       {
-	auto tot_error = ErrorTp{0};
-	for (auto& iv : this->m_ival)
-	  tot_error += iv.abs_error;
-	return tot_error;
+	if (this->m_summation == Summation_Reproducible)
+	  return this->m_exact_error.value();
+	else
+	  return this->m_error_sum.value();
       }
 
       /// Return the vector of integration intervals.
@@ -294,6 +336,34 @@ namespace emsr
       intervals() const
       { return this->m_ival; }
 
+      /**
+       * Return the break points of the intervals in the workspace
+       * running from the lower to the upper limit of integration.
+       * The partition can start the adaptive integration of a similar
+       * integrand with qag_integrate.
+       *
+       * Runs of adjacent intervals whose errors sum to no more than
+       * @c max_merge_error are merged into one.  The warm-start
+       * qag_integrate already coarsens the panels it is given
+       * with a threshold taken from its tolerance so the default
+       * of no merging is normally right.  The error of a merged interval
+       * is usually much larger than the sum of the errors of its parts
+       * so a nonzero @c max_merge_error should be a small fraction
+       * of the tolerance share of an interval.
+       */
+      std::vector<Tp>
+      partition(ErrorTp max_merge_error = ErrorTp{0}) const;
+
+      /// Write the intervals, heap state and totals to a binary snapshot.
+      void save(std::ostream& out) const;
+
+      /**
+       * Restore the intervals and heap state from a binary snapshot
+       * written by save().  The capacity and summation mode become
+       * those of the saved workspace.
+       */
+      void restore(std::istream& in);
+
       /*
        * 
        */
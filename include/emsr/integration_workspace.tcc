@@ -23,8 +23,11 @@
 #ifndef INTEGRATION_WORKSPACE_TCC
 #define INTEGRATION_WORKSPACE_TCC 1
 
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
+#include <stdexcept>
+#include <utility>
 
 #include <emsr/integration_error.h>
 
@@ -100,6 +103,82 @@ namespace emsr
 	this->m_max_depth = depth;
     }
 
+  /**
+   * Set the absolute error of the segment at start + ii to the given value
+   * and update the total error.
+   * Only used by qagp.
+   */
+  template<typename Tp, typename RetTp>
+    auto
+    integration_workspace<Tp, RetTp>::
+    set_abs_error(std::size_t ii, ErrorTp abserr)
+    -> ErrorTp
+    {
+      auto& iv = this->m_ival[this->curr_index() + ii];
+      if (this->m_summation == Summation_Reproducible)
+	{
+	  this->m_exact_error -= iv.abs_error;
+	  this->m_exact_error += abserr;
+	}
+      else
+	{
+	  this->m_error_sum -= iv.abs_error;
+	  this->m_error_sum += abserr;
+	}
+      return iv.abs_error = abserr;
+    }
+
+  /**
+   * Add an interval to or remove it from the running totals.
+   */
+  template<typename Tp, typename RetTp>
+    void
+    integration_workspace<Tp, RetTp>::
+    m_update_totals(const interval& iv, bool remove)
+    {
+      if (this->m_summation == Summation_Reproducible)
+	{
+	  if (remove)
+	    {
+	      this->m_exact_result -= iv.result;
+	      this->m_exact_error -= iv.abs_error;
+	    }
+	  else
+	    {
+	      this->m_exact_result += iv.result;
+	      this->m_exact_error += iv.abs_error;
+	    }
+	}
+      else
+	{
+	  if (remove)
+	    {
+	      this->m_result_sum -= iv.result;
+	      this->m_error_sum -= iv.abs_error;
+	    }
+	  else
+	    {
+	      this->m_result_sum += iv.result;
+	      this->m_error_sum += iv.abs_error;
+	    }
+	}
+    }
+
+  /**
+   * Recompute the running totals from the intervals.
+   */
+  template<typename Tp, typename RetTp>
+    void
+    integration_workspace<Tp, RetTp>::m_rebuild_totals()
+    {
+      this->m_result_sum = compensated_sum<AreaTp>{};
+      this->m_error_sum = compensated_sum<ErrorTp>{};
+      this->m_exact_result.clear();
+      this->m_exact_error.clear();
+      for (const auto& iv : this->m_ival)
+	this->m_update_totals(iv, false);
+    }
+
   /**
    * Increase the heap start point until the current segment has a smaller
    * depth than the current maximum depth.  After each increment rebuild
@@ -135,6 +214,145 @@ namespace emsr
       return false;
     }
 
+  /**
+   * Return the break points of the intervals in the workspace
+   * in the direction of integration merging runs
+   * of adjacent intervals with small errors.
+   */
+  template<typename Tp, typename RetTp>
+    std::vector<Tp>
+    integration_workspace<Tp, RetTp>::
+    partition(ErrorTp max_merge_error) const
+    {
+      if (this->m_ival.empty())
+	return {};
+
+      std::vector<const interval*> ival;
+      ival.reserve(this->m_ival.size());
+      for (const auto& iv : this->m_ival)
+	ival.push_back(&iv);
+      const bool ascending = ival.front()->lower_lim
+			    <= ival.front()->upper_lim;
+      std::sort(ival.begin(), ival.end(),
+		[ascending](const interval* ivl, const interval* ivr)
+		{
+		  return ascending ? ivl->lower_lim < ivr->lower_lim
+				   : ivl->lower_lim > ivr->lower_lim;
+		});
+
+      // Grow runs of adjacent intervals while their errors sum
+      // to no more than max_merge_error.
+      std::vector<Tp> pts;
+      pts.reserve(ival.size() + 1);
+      pts.push_back(ival.front()->lower_lim);
+      auto run_error = ival.front()->abs_error;
+      for (std::size_t i = 1; i < ival.size(); ++i)
+	{
+	  if (max_merge_error <= ErrorTp{0}
+	      || run_error + ival[i]->abs_error > max_merge_error)
+	    {
+	      pts.push_back(ival[i]->lower_lim);
+	      run_error = ErrorTp{0};
+	    }
+	  run_error += ival[i]->abs_error;
+	}
+      pts.push_back(ival.back()->upper_lim);
+
+      return pts;
+    }
+
+  /**
+   * Write the intervals in heap order, the heap start, the maximum depth
+   * and the running totals to a binary snapshot.
+   */
+  template<typename Tp, typename RetTp>
+    void
+    integration_workspace<Tp, RetTp>::save(std::ostream& out) const
+    {
+      detail::write_snapshot_header<Tp, AreaTp>(out,
+				Snapshot_Integration_Workspace);
+      detail::write_value(out, std::uint64_t(this->capacity()));
+      detail::write_value(out, std::uint64_t(this->m_max_size));
+      detail::write_value(out, std::uint64_t(this->m_curr_index));
+      detail::write_value(out, std::uint64_t(this->m_max_depth));
+      detail::write_value(out, std::uint64_t(this->m_ival.size()));
+      for (const auto& iv : this->m_ival)
+	{
+	  detail::write_value(out, iv.lower_lim);
+	  detail::write_value(out, iv.upper_lim);
+	  detail::write_value(out, iv.result);
+	  detail::write_value(out, iv.abs_error);
+	  detail::write_value(out, std::uint64_t(iv.depth));
+	}
+
+      // The compensated totals depend on the order of past updates
+      // so they are saved; the exact totals are rebuilt on restore.
+      detail::write_value(out, std::uint32_t(this->m_summation));
+      detail::write_value(out, this->m_result_sum.sum());
+      detail::write_value(out, this->m_result_sum.correction());
+      detail::write_value(out, this->m_error_sum.sum());
+      detail::write_value(out, this->m_error_sum.correction());
+    }
+
+  /**
+   * Restore the intervals, heap state and totals from a binary snapshot.
+   */
+  template<typename Tp, typename RetTp>
+    void
+    integration_workspace<Tp, RetTp>::restore(std::istream& in)
+    {
+      detail::read_snapshot_header<Tp, AreaTp>(in,
+				Snapshot_Integration_Workspace);
+      std::uint64_t cap, max_size, curr_index, max_depth, size;
+      detail::read_value(in, cap);
+      detail::read_value(in, max_size);
+      detail::read_value(in, curr_index);
+      detail::read_value(in, max_depth);
+      detail::read_value(in, size);
+      if (size > cap || (size > 0 && curr_index >= size))
+	throw std::runtime_error("integration_workspace: "
+				 "Inconsistent snapshot");
+
+      std::vector<interval> ival;
+      ival.reserve(cap);
+      for (std::uint64_t i = 0; i < size; ++i)
+	{
+	  interval iv;
+	  std::uint64_t depth;
+	  detail::read_value(in, iv.lower_lim);
+	  detail::read_value(in, iv.upper_lim);
+	  detail::read_value(in, iv.result);
+	  detail::read_value(in, iv.abs_error);
+	  detail::read_value(in, depth);
+	  iv.depth = depth;
+	  ival.push_back(iv);
+	}
+
+      std::uint32_t summation;
+      AreaTp result_sum, result_corr;
+      ErrorTp error_sum, error_corr;
+      detail::read_value(in, summation);
+      detail::read_value(in, result_sum);
+      detail::read_value(in, result_corr);
+      detail::read_value(in, error_sum);
+      detail::read_value(in, error_corr);
+      if (summation > Summation_Reproducible)
+	throw std::runtime_error("integration_workspace: "
+				 "Inconsistent snapshot");
+
+      this->m_ival = std::move(ival);
+      this->m_max_size = max_size;
+      this->m_curr_index = curr_index;
+      this->m_max_depth = max_depth;
+      this->m_summation = summation_mode(summation);
+      this->m_rebuild_totals();
+      if (this->m_summation == Summation_Compensated)
+	{
+	  this->m_result_sum = compensated_sum<AreaTp>(result_sum, result_corr);
+	  this->m_error_sum = compensated_sum<ErrorTp>(error_sum, error_corr);
+	}
+    }
+
   /**
    * Output the integration workspace to a stream.
    */
@@ -38,6 +38,8 @@
 #ifndef JACOBI_H
 #define JACOBI_H
 
+#include <vector>
+
   /** 
    * \brief Enumeration gor differing types of Gauss quadrature.
    * The gauss_quad_type is used to determine the boundary condition
@@ -76,7 +78,7 @@ template<typename Tp>
 
     jac_quadrature(gauss_quad_type qtype, int nq, Tp a, Tp b)
     : type(qtype), Q(nq), alpha(a), beta(b),
-      x(nq), w(nq), D(nq),
+      x(nq), w(nq), D(nq * nq),
       xp{}, imat{}
     {
       this->quadrature_zwd();
@@ -87,22 +89,40 @@ template<typename Tp>
     template<typename Func>
       Tp integrate(Func fun);
 
-    ~jac_quadrature() = default;
-
-  private:
+    /// Returns the quadrature nodes.
+    const std::vector<Tp>& nodes() const
+    { return this->x; }
 
-    /// Calculates the quadrature zeros, weights and derivative matrix.
-    int quadrature_zwd();
+    /// Calculates the interpolation matrix for the points xp.
+    int interpmat_alloc(int npoints, const Tp* xp);
 
-    /// Allocates memory for an interpolation matrix.
-    int interpmat_alloc(int npoints, Tp* xp);
+    /// Returns the number of interpolation points.
+    int num_interp_points() const
+    { return this->xp.size(); }
 
     /// Calculates the derivative at quadrature points of a function f
     /// and derivative matrix D
-    int differentiate(Tp* f, Tp* d);
+    int differentiate(const Tp* f, Tp* d) const;
+
+    /// Calculates the derivatives at quadrature points of a block
+    /// of nfields functions stored point by point.
+    int differentiate(int nfields, const Tp* f, int ldf,
+		      Tp* d, int ldd) const;
 
     /// Interpolates the function given by f using the interpolation matrix.
-    int interpolate(Tp* f, Tp* fout);
+    int interpolate(const Tp* f, Tp* fout) const;
+
+    /// Interpolates a block of nfields functions stored point by point
+    /// using the interpolation matrix.
+    int interpolate(int nfields, const Tp* f, int ldf,
+		    Tp* fout, int ldout) const;
+
+    ~jac_quadrature() = default;
+
+  private:
+
+    /// Calculates the quadrature zeros, weights and derivative matrix.
+    int quadrature_zwd();
 
     /// Array that stores the nodes coordinates
     std::vector<Tp> x;
@@ -120,6 +140,9 @@ template<typename Tp>
     std::vector<Tp> imat;
 
 
+    /// Calculates the Jacobi polynomial of order n
+    Tp jacobi_value(Tp x, int n, Tp alpha, Tp beta);
+
     /// Calculates the derivative of the Jacobi polynomial of order n
     Tp jacobi_deriv(Tp x, int n, Tp alpha, Tp beta);
 
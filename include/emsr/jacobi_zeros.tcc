@@ -2,10 +2,105 @@
 #define JACOBI_ZEROS_TCC 1
 
 #include <stdexcept>
+#include <vector>
+#include <cmath>
+
+#include <emsr/matrix.h>
+#include <emsr/parallel_for.h>
 
 namespace emsr
 {
 
+namespace detail
+{
+
+  /**
+   * Refine an approximate zero @c z of the Jacobi polynomial
+   * @f$ P_n^{(\alpha,\beta)}(x) @f$ by Newton's method
+   * and return the zero and weight.
+   */
+  template<typename Tp>
+    QuadraturePoint<Tp>
+    jacobi_newton(unsigned int n, Tp alpha1, Tp beta1, Tp z)
+    {
+      const auto s_eps = std::numeric_limits<Tp>::epsilon();
+      const unsigned int s_maxit = 1000u;
+
+      auto w = Tp{0};
+      auto alphabeta = alpha1 + beta1;
+      for (auto its = 1u; its <= s_maxit; ++its)
+	{
+	  auto temp = Tp{2} + alphabeta;
+	  auto P1 = (alpha1 - beta1 + temp * z) / Tp{2};
+	  auto P2 = Tp{1};
+	  for (auto j = 2u; j <= n; ++j)
+	    {
+	      auto P3 = P2;
+	      P2 = P1;
+	      temp = Tp{2} * j + alphabeta;
+	      auto a = Tp{2} * j * (j + alphabeta)
+		       * (temp - Tp{2});
+	      auto b = (temp - Tp{1})
+		       * (alpha1 * alpha1 - beta1 * beta1
+			    + temp * (temp - Tp{2}) * z);
+	      auto c = Tp{2} * (j - 1 + alpha1)
+		       * (j - 1 + beta1) * temp;
+	      P1 = (b * P2 - c * P3) / a;
+	    }
+	  auto Pp = (n * (alpha1 - beta1 - temp * z) * P1
+		       + Tp{2} * (n + alpha1) * (n + beta1) * P2)
+		    / (temp * (Tp{1} - z * z));
+	  auto z1 = z;
+	  z = z1 - P1 / Pp;
+	  if (std::abs(z - z1) <= s_eps)
+	    {
+	      w = std::exp(std::lgamma(alpha1 + Tp(n))
+			   + std::lgamma(beta1 + Tp(n))
+			   - std::lgamma(Tp(n + 1))
+			   - std::lgamma(Tp(n + 1) + alphabeta))
+		  * temp * std::pow(Tp{2}, alphabeta) / (Pp * P2);
+	      break;
+	    }
+	  if (its == s_maxit)
+	    throw std::logic_error("jacobi_zeros: Too many iterations");
+	}
+
+      return {z, w};
+    }
+
+  /**
+   * Fill the diagonal and subdiagonal of the symmetric tridiagonal
+   * Jacobi matrix whose eigenvalues are the zeros of the Jacobi polynomial
+   * @f$ P_n^{(\alpha,\beta)}(x) @f$.
+   */
+  template<typename Tp>
+    void
+    jacobi_matrix(unsigned int n, Tp alpha1, Tp beta1,
+		  std::vector<Tp>& diag, std::vector<Tp>& subd)
+    {
+      diag.resize(n);
+      subd.resize(n);
+
+      const auto ab = alpha1 + beta1;
+      auto abp2i = ab + Tp{2};
+      diag[0] = (beta1 - alpha1) / abp2i;
+      subd[0] = Tp{2} * std::sqrt((alpha1 + Tp{1}) * (beta1 + Tp{1})
+				  / (abp2i + Tp{1})) / abp2i;
+      const auto a2mb2 = (beta1 - alpha1) * (beta1 + alpha1);
+      for (auto i = 1u; i < n; ++i)
+	{
+	  const auto abp2ip2 = abp2i + Tp{2};
+	  diag[i] = a2mb2 / abp2i / abp2ip2;
+	  const auto ip1 = Tp(i + 1);
+	  subd[i] = std::sqrt(Tp(4 * ip1) * (alpha1 + ip1)
+			      * (beta1 + ip1) * (ab + ip1)
+			      / (abp2ip2 * abp2ip2 - Tp{1})) / abp2ip2;
+	  abp2i += Tp{2};
+	}
+    }
+
+} // namespace detail
+
   /**
    * Return a vector containing the zeros of the Jacobi polynomial
    * @f$ P_n^{(\alpha,\beta)}(x) @f$.
@@ -20,13 +115,9 @@ namespace emsr
     std::vector<QuadraturePoint<Tp>>
     jacobi_zeros(unsigned int n, Tp alpha1, Tp beta1)
     {
-      const auto s_eps = epsilon(alpha1);
-      const unsigned int s_maxit = 1000u;
-
       std::vector<QuadraturePoint<Tp>> pt(n);
 
       Tp z;
-      Tp w;
       for (auto i = 1u; i <= n; ++i)
 	{
 	  if (i == 1)
@@ -84,50 +175,56 @@ namespace emsr
 		  - 3.0 * pt[i - 3].point + pt[i - 4].point;
 	    }
 
-	  auto alphabeta = alpha1 + beta1;
-	  for (auto its = 1u; its <= s_maxit; ++its)
-	    {
-	      auto temp = Tp{2} + alphabeta;
-	      auto P1 = (alpha1 - beta1 + temp * z) / Tp{2};
-	      auto P2 = Tp{1};
-	      for (auto j = 2u; j <= n; ++j)
-		{
-		  auto P3 = P2;
-		  P2 = P1;
-		  temp = Tp{2} * j + alphabeta;
-		  auto a = Tp{2} * j * (j + alphabeta)
-			   * (temp - Tp{2});
-		  auto b = (temp - Tp{1})
-			   * (alpha1 * alpha1 - beta1 * beta1
-				+ temp * (temp - Tp{2}) * z);
-		  auto c = Tp{2} * (j - 1 + alpha1)
-			   * (j - 1 + beta1) * temp;
-		  P1 = (b * P2 - c * P3) / a;
-		}
-	      auto Pp = (n * (alpha1 - beta1 - temp * z) * P1
-			   + Tp{2} * (n + alpha1) * (n + beta1) * P2)
-			/ (temp * (Tp{1} - z * z));
-	      auto z1 = z;
-	      z = z1 - P1 / Pp;
-	      if (std::abs(z - z1) <= s_eps)
-		{
-		  w = std::exp(std::lgamma(alpha1 + Tp(n))
-			       + std::lgamma(beta1 + Tp(n))
-			       - std::lgamma(Tp(n + 1))
-			       - std::lgamma(Tp(n + 1) + alphabeta))
-		      * temp * std::pow(Tp{2}, alphabeta) / (Pp * P2);
-		  break;
-		}
-	      if (its > s_maxit)
-		throw std::logic_error("jacobi_zeros: Too many iterations");
-	    }
-	  pt[i - 1].point = z;
-	  pt[i - 1].weight = w;
+	  pt[i - 1] = detail::jacobi_newton(n, alpha1, beta1, z);
+	  // The next guesses extrapolate from the refined roots.
+	  z = pt[i - 1].point;
 	}
 
       return pt;
     }
 
+  /**
+   * Return a vector containing the zeros of the Jacobi polynomial
+   * @f$ P_n^{(\alpha,\beta)}(x) @f$ spreading the root refinement
+   * over @c num_threads threads.
+   *
+   * The serial version seeds each root from the ones before it.
+   * Here each root is instead isolated independently by Sturm bisection
+   * on the Jacobi matrix and then polished by Newton's method
+   * so the result does not depend on the thread count.
+   *
+   * @tparam  Tp  The real type of the parameters
+   * @param[in]  n  The degree of the Jacobi polynomial
+   * @param[in]  alpha1  The first order parameter of the Jacobi polynomial
+   * @param[in]  beta1  The second order parameter of the Jacobi polynomial
+   * @param[in]  num_threads  The number of threads
+   *                          (0 means hardware concurrency)
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    jacobi_zeros(unsigned int n, Tp alpha1, Tp beta1,
+		 unsigned int num_threads)
+    {
+      std::vector<QuadraturePoint<Tp>> pt(n);
+      if (n == 0)
+	return pt;
+
+      std::vector<Tp> diag, subd;
+      detail::jacobi_matrix(n, alpha1, beta1, diag, subd);
+
+      // The i-th largest zero is the (n - i)-th smallest eigenvalue.
+      parallel_for(1u, n + 1u, num_threads,
+		   [n, alpha1, beta1, &diag, &subd, &pt](std::size_t ii)
+		   {
+		     const auto i = unsigned(ii);
+		     const auto z = s_tridiag_symm_eigenvalue(n, diag, subd,
+							      n - i, 8);
+		     pt[i - 1] = detail::jacobi_newton(n, alpha1, beta1, z);
+		   });
+
+      return pt;
+    }
+
 } // namespace emsr
 
 #endif // JACOBI_ZEROS_TCC
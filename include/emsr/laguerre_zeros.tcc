@@ -3,26 +3,83 @@
 
 #include <stdexcept>
 #include <cmath>
+#include <algorithm>
+
+#include <emsr/matrix.h>
+#include <emsr/parallel_for.h>
 
 namespace emsr
+{
+
+namespace detail
 {
 
   /**
-   * Return an array of abscissae and weights for the Gauss-Laguerre rule.
+   * Refine an approximate zero @c z of the associated Laguerre polynomial
+   * @f$ L_n^{(\alpha)}(x) @f$ by Newton's method
+   * and return the zero and weight.
    */
   template<typename Tp>
-    std::vector<QuadraturePoint<Tp>>
-    laguerre_zeros(unsigned int n, Tp alpha1)
+    QuadraturePoint<Tp>
+    laguerre_newton(unsigned int n, Tp alpha1, Tp z)
     {
       const auto s_eps = std::numeric_limits<Tp>::epsilon();
       const unsigned int s_maxit = 1000;
+      const auto s_sqrt_eps = std::sqrt(s_eps);
+
+      auto w = Tp{0};
+      auto dz_prev = std::numeric_limits<Tp>::max();
+      // Iterate TTRR for polynomial values
+      for (auto its = 1u; its <= s_maxit; ++its)
+	{
+	  auto L2 = Tp{0};
+	  auto L1 = Tp{1};
+	  for (auto j = 1u; j <= n; ++j)
+	    {
+	      auto L3 = L2;
+	      L2 = L1;
+	      L1 = ((Tp(2 * j - 1 + alpha1) - z) * L2
+		 - (Tp(j - 1 + alpha1)) * L3) / Tp(j);
+	    }
+	  // Derivative.
+	  auto Lp = (Tp(n) * L1 - Tp(n + alpha1) * L2) / z;
+	  // Newton's rule for root.
+	  auto z1 = z;
+	  z = z1 - L1 / Lp;
+	  // The zeros grow with the degree so use a relative tolerance.
+	  // Stop also once roundoff in the recursion stalls the iteration.
+	  const auto scale = std::max(Tp{1}, std::abs(z));
+	  const auto dz = std::abs(z - z1);
+	  if (dz <= Tp{8} * s_eps * scale
+	      || (dz >= dz_prev && dz <= s_sqrt_eps * scale))
+	    {
+	      auto exparg = std::lgamma(Tp(alpha1 + n))
+			    - std::lgamma(Tp(n));
+	      w = -std::exp(exparg) / (Lp * n * L2);
+	      break;
+	    }
+	  dz_prev = dz;
+	  if (its == s_maxit)
+	    throw std::logic_error("laguerre_zeros: Too many iterations");
+	}
+
+      return {z, w};
+    }
 
+} // namespace detail
+
+  /**
+   * Return an array of abscissae and weights for the Gauss-Laguerre rule.
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    laguerre_zeros(unsigned int n, Tp alpha1)
+    {
       std::vector<QuadraturePoint<Tp>> pt(n);
 
+      auto z = Tp{0};
       for (auto i = 1u; i <= n; ++i)
 	{
-	  auto z = Tp{0};
-	  auto w = Tp{0};
 	  // Clever approximations for roots.
 	  if (i == 1)
 	    z += (1.0 + alpha1)
@@ -36,39 +93,51 @@ namespace emsr
 		     + 1.26 * ai * alpha1 / (1.0 + 3.5 * ai))
 		   * (z - pt[i - 3].point) / (1.0 + 0.3 * alpha1);
 	    }
-	  // Iterate TTRR for polynomial values
-	  for (auto its = 1u; its <= s_maxit; ++its)
-	    {
-	      auto L2 = Tp{0};
-	      auto L1 = Tp{1};
-	      for (auto j = 1u; j <= n; ++j)
-		{
-		  auto L3 = L2;
-		  L2 = L1;
-		  L1 = ((Tp(2 * j - 1 + alpha1) - z) * L2
-		     - (Tp(j - 1 + alpha1)) * L3) / Tp(j);
-		}
-	      // Derivative.
-	      auto Lp = (Tp(n) * L1 - Tp(n + alpha1) * L2) / z;
-	      // Newton's rule for root.
-	      auto z1 = z;
-	      z = z1 - L1 / Lp;
-	      if (std::abs(z - z1) <= s_eps)
-		{
-		  auto exparg = std::lgamma(Tp(alpha1 + n))
-				- std::lgamma(Tp(n));
-		  w = -std::exp(exparg) / (Lp * n * L2);
-		  break;
-		}
-	      if (its > s_maxit)
-		throw std::logic_error("laguerre_zeros: Too many iterations");
-	   }
-	  pt[i - 1].point = z;
-	  pt[i - 1].weight = w;
+	  const auto zw = detail::laguerre_newton(n, alpha1, z);
+	  z = zw.point;
+	  pt[i - 1] = zw;
 	}
     return pt;
   }
 
+  /**
+   * Return an array of abscissae and weights for the Gauss-Laguerre rule
+   * spreading the root refinement over @c num_threads threads.
+   *
+   * The serial version seeds each root from the ones before it.
+   * Here each root is instead isolated independently by Sturm bisection
+   * on the Jacobi matrix of the Laguerre recursion and then polished
+   * by Newton's method so the result does not depend on the thread count.
+   *
+   * @param n  The degree of the Laguerre polynomial.
+   * @param alpha1  The order of the Laguerre polynomial.
+   * @param num_threads  The number of threads (0 means hardware concurrency).
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    laguerre_zeros(unsigned int n, Tp alpha1, unsigned int num_threads)
+    {
+      std::vector<QuadraturePoint<Tp>> pt(n);
+
+      std::vector<Tp> diag(n);
+      std::vector<Tp> subd(n);
+      for (auto i = 0u; i < n; ++i)
+	{
+	  diag[i] = Tp(2 * i + 1) + alpha1;
+	  subd[i] = std::sqrt(Tp(i + 1) * (alpha1 + Tp(i + 1)));
+	}
+
+      parallel_for(0u, n, num_threads,
+		   [n, alpha1, &diag, &subd, &pt](std::size_t i)
+		   {
+		     const auto z = s_tridiag_symm_eigenvalue(n, diag, subd,
+							      i, 8);
+		     pt[i] = detail::laguerre_newton(n, alpha1, z);
+		   });
+
+      return pt;
+    }
+
 } // namespace emsr
 
 #endif // LAGUERRE_ZEROS_TCC
@@ -4,9 +4,84 @@
 #include <stdexcept>
 #include <cmath>
 
+#include <emsr/parallel_for.h>
+
 namespace emsr
 {
 
+namespace detail
+{
+
+  /**
+   * Return the central zero and weight of the Gauss-Legendre rule
+   * for odd degree @c l.
+   * Be careful to avoid overflow of the factorials.
+   * An alternative would be to proceed with the recursion
+   * for large degree.
+   */
+  template<typename Tp>
+    QuadraturePoint<Tp>
+    legendre_central_zero(unsigned int l)
+    {
+      const auto lm = l - 1;
+      const auto mm = lm / 2;
+      auto Am = Tp{1};
+      for (auto m = 1u; m <= mm; ++m)
+	Am *= -Tp(2 * m - 1) / Tp(2 * m);
+      auto Plm1 = Am;
+      auto Ppl = l * Plm1;
+      return {Tp{0}, Tp{2} / Ppl / Ppl};
+    }
+
+  /**
+   * Refine an approximate zero @c z of the Legendre polynomial
+   * of degree @c l by Newton's method and return the zero and weight.
+   */
+  template<typename Tp>
+    QuadraturePoint<Tp>
+    legendre_newton(unsigned int l, Tp z)
+    {
+      const auto s_eps = std::numeric_limits<Tp>::epsilon();
+      const unsigned int s_maxit = 1000u;
+
+      auto z1 = z;
+      auto w = Tp{0};
+      for (auto its = 1u; its <= s_maxit; ++its)
+	{
+	  // Compute P, P1, and P2 the Legendre polynomials of degree
+	  // l, l-1, l-2 respectively by iterating through the recursion
+	  // relation for the Legendre polynomials.
+	  // Compute Pp the derivative of the Legendre polynomial
+	  // of degree l.
+	  auto P1 = Tp{0};
+	  auto P = Tp{1};
+	  for  (auto k = 1u; k <= l; ++k)
+	    {
+	      auto P2 = P1;
+	      P1 = P;
+	      // Recursion for Legendre polynomials.
+	      P = ((Tp{2} * k - Tp{1}) * z * P1
+		  - (k - Tp{1}) * P2) / k;
+	    }
+	  // Recursion for the derivative of The Legendre polynomial.
+	  auto Pp = l * (z * P - P1) / (z * z - Tp{1});
+	  z1 = z;
+	  // Converge on root by Newton's method.
+	  z = z1 - P / Pp;
+	  if (std::abs(z - z1) < s_eps)
+	    {
+	      w = Tp{2} / ((Tp{1} - z * z) * Pp * Pp);
+	      break;
+	    }
+	  if (its == s_maxit)
+	    throw std::logic_error("legendre_zeros: Too many iterations");
+	}
+
+      return {z, w};
+    }
+
+} // namespace detail
+
   /**
    * Build a list of zeros and weights for the Gauss-Legendre integration rule
    * for the Legendre polynomial of degree @c l.
@@ -15,78 +90,72 @@ namespace emsr
     std::vector<QuadraturePoint<Tp>>
     legendre_zeros(unsigned int l)
     {
-      const auto s_eps = std::numeric_limits<Tp>::epsilon();
       const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
-      const unsigned int s_maxit = 1000u;
-
       std::vector<QuadraturePoint<Tp>> pt(l);
 
       auto m = l / 2;
 
       // Treat the central zero for odd degree specially.
-      // Be careful to avoid overflow of the factorials.
-      // An alternative would be to proceed with the recursion
-      // for large degree.
       if (l & 1)
-	{
-	  const auto lm = l - 1;
-	  const auto mm = lm / 2;
-	  auto Am = Tp{1};
-	  for (auto m = 1u; m <= mm; ++m)
-	    Am *= -Tp(2 * m - 1) / Tp(2 * m);
-	  auto Plm1 = Am;
-	  auto Ppl = l * Plm1;
-	  pt[m].point = Tp{0};
-	  pt[m].weight = Tp{2} / Ppl / Ppl;
-	}
+	pt[m] = detail::legendre_central_zero<Tp>(l);
 
       for (auto i = 1u; i <= m; ++i)
 	{
 	  // Clever approximation of root.
 	  auto z = std::cos(s_pi * (i - Tp{1} / Tp{4})
 				    / (l + Tp{1} / Tp{2}));
-	  auto z1 = z;
-	  auto w = Tp{0};
-	  for (auto its = 0u; its < s_maxit; ++its)
-	    {
-	      // Compute P, P1, and P2 the Legendre polynomials of degree
-	      // l, l-1, l-2 respectively by iterating through the recursion
-	      // relation for the Legendre polynomials.
-	      // Compute Pp the derivative of the Legendre polynomial
-	      // of degree l.
-	      auto P1 = Tp{0};
-	      auto P = Tp{1};
-	      for  (auto k = 1u; k <= l; ++k)
-		{
-		  auto P2 = P1;
-		  P1 = P;
-		  // Recursion for Legendre polynomials.
-		  P = ((Tp{2} * k - Tp{1}) * z * P1
-		      - (k - Tp{1}) * P2) / k;
-		}
-	      // Recursion for the derivative of The Legendre polynomial.
-	      auto Pp = l * (z * P - P1) / (z * z - Tp{1});
-	      z1 = z;
-	      // Converge on root by Newton's method.
-	      z = z1 - P / Pp;
-	      if (std::abs(z - z1) < s_eps)
-		{
-		  w = Tp{2} / ((Tp{1} - z * z) * Pp * Pp);
-		  break;
-		}
-	      if (its > s_maxit)
-		throw std::logic_error("legendre_zeros: Too many iterations");
-	    }
+	  const auto zw = detail::legendre_newton(l, z);
 
-	  pt[i - 1].point = -z;
-	  pt[l - i].point = z;
-	  pt[i - 1].weight = w;
-	  pt[l - i].weight = w;
+	  pt[i - 1].point = -zw.point;
+	  pt[l - i].point = zw.point;
+	  pt[i - 1].weight = zw.weight;
+	  pt[l - i].weight = zw.weight;
 	}
 
       return pt;
     }
 
+  /**
+   * Build a list of zeros and weights for the Gauss-Legendre integration rule
+   * for the Legendre polynomial of degree @c l spreading the root refinement
+   * over @c num_threads threads.
+   *
+   * Each root is refined from its own initial guess so the result
+   * is identical to that of the serial version for any thread count.
+   *
+   * @param l  The degree of the Legendre polynomial.
+   * @param num_threads  The number of threads (0 means hardware concurrency).
+   */
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    legendre_zeros(unsigned int l, unsigned int num_threads)
+    {
+      const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+
+      std::vector<QuadraturePoint<Tp>> pt(l);
+
+      const auto m = l / 2;
+
+      if (l & 1)
+	pt[m] = detail::legendre_central_zero<Tp>(l);
+
+      parallel_for(1u, m + 1u, num_threads,
+		   [l, s_pi, &pt](std::size_t ii)
+		   {
+		     const auto i = unsigned(ii);
+		     auto z = std::cos(s_pi * (i - Tp{1} / Tp{4})
+					    / (l + Tp{1} / Tp{2}));
+		     const auto zw = detail::legendre_newton(l, z);
+
+		     pt[i - 1].point = -zw.point;
+		     pt[l - i].point = zw.point;
+		     pt[i - 1].weight = zw.weight;
+		     pt[l - i].weight = zw.weight;
+		   });
+
+      return pt;
+    }
+
 } // namespace emsr
 
 #endif // LEGENDRE_ZEROS_TCC
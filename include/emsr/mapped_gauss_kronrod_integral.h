@@ -0,0 +1,92 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements Gauss-Kronrod rules pre-mapped through a change of variables.
+
+#ifndef MAPPED_GAUSS_KRONROD_INTEGRAL_H
+#define MAPPED_GAUSS_KRONROD_INTEGRAL_H 1
+
+#include <type_traits>
+#include <vector>
+
+#include <emsr/gauss_kronrod_integral.h>
+#include <emsr/integration_transform.h>
+
+namespace emsr
+{
+
+  /**
+   * A Gauss-Kronrod rule on an interval of a variable @f$ t @f$
+   * applied to @f$ f(x(t)) dx/dt @f$ for a coordinate map
+   * such as coord_map_minf_pinf, coord_map_minf_b or coord_map_a_pinf.
+   *
+   * For each interval the transformed nodes @f$ x(t_i) @f$
+   * and the weights with the Jacobian folded in are computed
+   * in one pass before the integrand is called at the nodes directly.
+   * The integrand is not wrapped in a mapping functor so the mapping
+   * arithmetic is hoisted out of the function calls and can vectorize.
+   * The result, error, @c resabs and @c resasc are those of
+   * gauss_kronrod_integral applied to the mapped function
+   * so the adaptive drivers behave the same.
+   *
+   * @tparam MapTp A coordinate map callable as @c map(t, x, dxdt).
+   */
+  template<typename Tp, typename MapTp>
+    class mapped_gauss_kronrod_integral
+    {
+    public:
+
+      mapped_gauss_kronrod_integral(unsigned gk_rule, MapTp map);
+
+      template<typename FuncTp>
+	auto
+	integrate(FuncTp func, Tp lower, Tp upper) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+      template<typename FuncTp>
+	auto
+	operator()(FuncTp func, Tp lower, Tp upper) const
+	-> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+	{ return this->integrate(func, lower, upper); }
+
+      /// Return the coordinate map.
+      const MapTp&
+      map() const
+      { return this->m_map; }
+
+    private:
+
+      template<typename FuncTp, typename RetTp>
+	auto
+	m_integrate(FuncTp& func, Tp lower, Tp upper,
+		    Tp* x, Tp* jac, Tp* w_kronrod, Tp* w_gauss,
+		    RetTp* fv) const
+	-> gauss_kronrod_integral_t<Tp, RetTp>;
+
+      unsigned m_rule = Kronrod_15;
+      MapTp m_map;
+
+      std::vector<Tp> m_x_kronrod;
+      std::vector<Tp> m_w_gauss;
+      std::vector<Tp> m_w_kronrod;
+    };
+
+} // namespace emsr
+
+#include <emsr/mapped_gauss_kronrod_integral.tcc>
+
+#endif // MAPPED_GAUSS_KRONROD_INTEGRAL_H
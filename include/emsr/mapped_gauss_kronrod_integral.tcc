@@ -0,0 +1,219 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements Gauss-Kronrod rules pre-mapped through a change of variables.
+
+#ifndef MAPPED_GAUSS_KRONROD_INTEGRAL_TCC
+#define MAPPED_GAUSS_KRONROD_INTEGRAL_TCC 1
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include <emsr/integration_error.h>
+#include <emsr/gauss_kronrod_integral.tcc>
+
+namespace emsr
+{
+
+  /**
+   * Copy the tabulated QUADPACK rules so the mapped integrals agree
+   * with those of the wrapped functions; build any other rule.
+   */
+  template<typename Tp, typename MapTp>
+    mapped_gauss_kronrod_integral<Tp, MapTp>::
+    mapped_gauss_kronrod_integral(unsigned gk_rule, MapTp map)
+    : m_rule{gk_rule},
+      m_map(map),
+      m_x_kronrod{}, m_w_gauss{}, m_w_kronrod{}
+    {
+      auto copy = [this](const auto& x, const auto& wg, const auto& wk)
+	{
+	  this->m_x_kronrod.assign(x.begin(), x.end());
+	  this->m_w_gauss.assign(wg.begin(), wg.end());
+	  this->m_w_kronrod.assign(wk.begin(), wk.end());
+	};
+
+      switch (this->m_rule)
+	{
+	case Kronrod_15:
+	  {
+	    using _GK = qk_integrator<Tp, void, Kronrod_15>;
+	    copy(_GK::s_x_kronrod, _GK::s_w_gauss, _GK::s_w_kronrod);
+	    break;
+	  }
+	case Kronrod_21:
+	  {
+	    using _GK = qk_integrator<Tp, void, Kronrod_21>;
+	    copy(_GK::s_x_kronrod, _GK::s_w_gauss, _GK::s_w_kronrod);
+	    break;
+	  }
+	case Kronrod_31:
+	  {
+	    using _GK = qk_integrator<Tp, void, Kronrod_31>;
+	    copy(_GK::s_x_kronrod, _GK::s_w_gauss, _GK::s_w_kronrod);
+	    break;
+	  }
+	case Kronrod_41:
+	  {
+	    using _GK = qk_integrator<Tp, void, Kronrod_41>;
+	    copy(_GK::s_x_kronrod, _GK::s_w_gauss, _GK::s_w_kronrod);
+	    break;
+	  }
+	case Kronrod_51:
+	  {
+	    using _GK = qk_integrator<Tp, void, Kronrod_51>;
+	    copy(_GK::s_x_kronrod, _GK::s_w_gauss, _GK::s_w_kronrod);
+	    break;
+	  }
+	case Kronrod_61:
+	  {
+	    using _GK = qk_integrator<Tp, void, Kronrod_61>;
+	    copy(_GK::s_x_kronrod, _GK::s_w_gauss, _GK::s_w_kronrod);
+	    break;
+	  }
+	default:
+	  {
+	    const auto rule = detail::get_gauss_kronrod_rule<Tp>(this->m_rule);
+	    copy(rule->view.point, rule->view.aux_weight, rule->view.weight);
+	  }
+	}
+    }
+
+  /**
+   * Use buffers on the stack for all but very large rules.
+   */
+  template<typename Tp, typename MapTp>
+    template<typename FuncTp>
+      auto
+      mapped_gauss_kronrod_integral<Tp, MapTp>::
+      integrate(FuncTp func, Tp lower, Tp upper) const
+      -> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+      {
+	using RetTp = std::invoke_result_t<FuncTp, Tp>;
+	constexpr std::size_t s_max_stack = 2 * Kronrod_61 + 1;
+
+	const auto num_nodes = 2 * this->m_x_kronrod.size() - 1;
+	if (num_nodes <= s_max_stack)
+	  {
+	    std::array<Tp, s_max_stack> x, jac, w_kronrod, w_gauss;
+	    std::array<RetTp, s_max_stack> fv;
+	    return this->m_integrate(func, lower, upper, x.data(), jac.data(),
+				     w_kronrod.data(), w_gauss.data(),
+				     fv.data());
+	  }
+	else
+	  {
+	    std::vector<Tp> x(num_nodes), jac(num_nodes);
+	    std::vector<Tp> w_kronrod(num_nodes), w_gauss(num_nodes);
+	    std::vector<RetTp> fv(num_nodes);
+	    return this->m_integrate(func, lower, upper, x.data(), jac.data(),
+				     w_kronrod.data(), w_gauss.data(),
+				     fv.data());
+	  }
+      }
+
+  /**
+   * The nodes are stored as in gauss_kronrod_integral::s_integrate:
+   * the abscissae decrease to the center, which is last;
+   * the Gauss nodes are those of odd index.
+   * Node @c i of the left half and node @c i of the right half
+   * are at @c i and <tt>K + i</tt> of the mapped tables,
+   * the center at <tt>K - 1</tt> where @c K is the size of the table.
+   */
+  template<typename Tp, typename MapTp>
+    template<typename FuncTp, typename RetTp>
+      auto
+      mapped_gauss_kronrod_integral<Tp, MapTp>::
+      m_integrate(FuncTp& func, Tp lower, Tp upper,
+		  Tp* x, Tp* jac, Tp* w_kronrod, Tp* w_gauss,
+		  RetTp* fv) const
+      -> gauss_kronrod_integral_t<Tp, RetTp>
+      {
+	using AreaTp = decltype(RetTp{} * Tp{});
+	using AbsAreaTp = decltype(std::abs(AreaTp{}));
+
+	const auto KronrodSz = this->m_x_kronrod.size();
+	const auto num_half = KronrodSz - 1;
+	const auto num_nodes = 2 * num_half + 1;
+
+	const auto center = (lower + upper) / Tp{2};
+	const auto half_length = (upper - lower) / Tp{2};
+	const auto abs_half_length = std::abs(half_length);
+
+	// Map the nodes and fold the Jacobian into the weights.
+	for (std::size_t i = 0; i < num_half; ++i)
+	  {
+	    const auto abscissa = half_length * this->m_x_kronrod[i];
+	    const auto j = num_half + 1 + i;
+	    this->m_map(center - abscissa, x[i], jac[i]);
+	    this->m_map(center + abscissa, x[j], jac[j]);
+	    w_kronrod[i] = this->m_w_kronrod[i] * jac[i];
+	    w_kronrod[j] = this->m_w_kronrod[i] * jac[j];
+	    w_gauss[i] = w_gauss[j] = Tp{0};
+	  }
+	this->m_map(center, x[num_half], jac[num_half]);
+	w_kronrod[num_half] = this->m_w_kronrod[num_half] * jac[num_half];
+	w_gauss[num_half] = KronrodSz % 2 == 0
+			  ? this->m_w_gauss[KronrodSz / 2 - 1] * jac[num_half]
+			  : Tp{0};
+	for (std::size_t jj = 0; jj < num_half / 2; ++jj)
+	  {
+	    const auto jtw = jj * 2 + 1;
+	    w_gauss[jtw] = this->m_w_gauss[jj] * jac[jtw];
+	    w_gauss[num_half + 1 + jtw] = this->m_w_gauss[jj]
+					* jac[num_half + 1 + jtw];
+	  }
+
+	for (std::size_t i = 0; i < num_nodes; ++i)
+	  fv[i] = func(x[i]);
+
+	auto result_gauss = AreaTp{0};
+	auto result_kronrod = AreaTp{0};
+	auto result_abs = AbsAreaTp{0};
+	for (std::size_t i = 0; i < num_nodes; ++i)
+	  {
+	    result_gauss += w_gauss[i] * fv[i];
+	    result_kronrod += w_kronrod[i] * fv[i];
+	    result_abs += w_kronrod[i] * std::abs(fv[i]);
+	  }
+
+	const auto mean = result_kronrod / Tp{2};
+	auto result_asc = this->m_w_kronrod[num_half]
+			* std::abs(fv[num_half] * jac[num_half] - mean);
+	for (std::size_t i = 0; i < num_half; ++i)
+	  {
+	    const auto j = num_half + 1 + i;
+	    result_asc += this->m_w_kronrod[i]
+			* (std::abs(fv[i] * jac[i] - mean)
+			 + std::abs(fv[j] * jac[j] - mean));
+	  }
+
+	auto err = (result_kronrod - result_gauss) * half_length;
+
+	result_kronrod *= half_length;
+	result_abs *= abs_half_length;
+	result_asc *= abs_half_length;
+
+	return {result_kronrod,
+		rescale_error(err, result_abs, result_asc),
+		result_abs, result_asc};
+      }
+
+} // namespace emsr
+
+#endif // MAPPED_GAUSS_KRONROD_INTEGRAL_TCC
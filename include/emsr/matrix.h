@@ -19,6 +19,9 @@
 #ifndef MATRIX_H
 #define MATRIX_H 1
 
+#include <cstddef>
+#include <type_traits>
+
 namespace emsr
 {
 
@@ -34,6 +37,14 @@ namespace emsr
 		   RandAccIter& diag, RandAccIter& subd,
 		   RandAccIterRHS& rhs);
 
+  template<typename RandAccIter>
+    auto
+    s_tridiag_symm_eigenvalue(std::size_t n,
+			      const RandAccIter& diag,
+			      const RandAccIter& subd,
+			      std::size_t k, int num_refine = -1)
+    -> std::decay_t<decltype(diag[0])>;
+
 } // namespace emsr
 
 #include <emsr/matrix.tcc>
@@ -21,6 +21,9 @@
 
 #include <stdexcept>
 #include <type_traits> // For decay.
+#include <limits>
+#include <cmath>
+#include <algorithm>
 
 namespace emsr
 {
@@ -247,6 +250,110 @@ namespace emsr
       return 0;
     }
 
+  /**
+   *  @brief Return the k-th smallest eigenvalue of a symmetric
+   *  tridiagonal matrix by Sturm sequence bisection.
+   *
+   *  Each eigenvalue is found independently of all the others
+   *  so this is a natural building block for parallel root finders.
+   *  The inputs are not modified.
+   *
+   *  @see W. Barth, R. S. Martin, J. H. Wilkinson,
+   *  Calculation of the Eigenvalues of a Symmetric Tridiagonal Matrix
+   *  by the Method of Bisection,
+   *  Numerische Mathematik,
+   *  Volume 9, Number 5, 1967, pages 386-393.
+   *
+   *  @param[in] n     The order of the matrix.
+   *  @param[in] diag  The diagonal entries [0, n-1] of the matrix.
+   *  @param[in] subd  The subdiagonal entries of the matrix,
+   *                   in entries [0, n-2].
+   *  @param[in] k     The index of the eigenvalue in increasing order
+   *                   in [0, n-1].
+   *  @param[in] num_refine  The number of bisections to perform once
+   *                   the eigenvalue has been isolated from its neighbors.
+   *                   A negative value bisects to full precision.
+   *                   A small positive value gives a cheap starting
+   *                   point for a Newton iteration.
+   */
+  template<typename RandAccIter>
+    auto
+    s_tridiag_symm_eigenvalue(std::size_t n,
+			      const RandAccIter& diag,
+			      const RandAccIter& subd,
+			      std::size_t k, int num_refine)
+    -> std::decay_t<decltype(diag[0])>
+    {
+      using Tp = std::decay_t<decltype(diag[0])>;
+
+      if (k >= n)
+	throw std::domain_error("s_tridiag_symm_eigenvalue:"
+				" Eigenvalue index out of range");
+
+      const auto prec = std::numeric_limits<Tp>::epsilon();
+      const auto tiny = std::numeric_limits<Tp>::min();
+
+      // Gershgorin bounds for the spectrum.
+      auto lower = diag[0];
+      auto upper = diag[0];
+      for (std::size_t i = 0; i < n; ++i)
+	{
+	  auto r = Tp{0};
+	  if (i > 0)
+	    r += std::abs(subd[i - 1]);
+	  if (i + 1 < n)
+	    r += std::abs(subd[i]);
+	  lower = std::min(lower, Tp(diag[i] - r));
+	  upper = std::max(upper, Tp(diag[i] + r));
+	}
+
+      // Number of eigenvalues strictly less than x.
+      auto sturm_count = [n, &diag, &subd, tiny](Tp x)
+	{
+	  std::size_t count = 0;
+	  auto q = diag[0] - x;
+	  for (std::size_t i = 0; i < n; ++i)
+	    {
+	      if (i > 0)
+		q = diag[i] - x - subd[i - 1] * subd[i - 1] / q;
+	      if (q == Tp{0})
+		q = -tiny;
+	      if (q < Tp{0})
+		++count;
+	    }
+	  return count;
+	};
+
+      std::size_t count_lower = 0;
+      std::size_t count_upper = n;
+      while (true)
+	{
+	  const auto mid = lower + (upper - lower) / Tp{2};
+	  const auto scale = std::max(std::abs(lower), std::abs(upper));
+	  if (upper - lower <= Tp{2} * prec * scale
+	      || mid == lower || mid == upper)
+	    return mid;
+	  if (num_refine >= 0
+	      && count_lower == k && count_upper == k + 1)
+	    {
+	      if (num_refine == 0)
+		return mid;
+	      --num_refine;
+	    }
+	  const auto count = sturm_count(mid);
+	  if (count > k)
+	    {
+	      upper = mid;
+	      count_upper = count;
+	    }
+	  else
+	    {
+	      lower = mid;
+	      count_lower = count;
+	    }
+	}
+    }
+
 } // namespace emsr
 
 #endif // MATRIX_TCC
@@ -0,0 +1,197 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements a memoizing wrapper for expensive integrands.
+
+#ifndef MEMOIZED_INTEGRAND_H
+#define MEMOIZED_INTEGRAND_H 1
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace emsr
+{
+
+namespace detail
+{
+
+  /**
+   * The bit pattern of an abscissa.
+   *
+   * Only the bytes carrying the value are used so that the padding
+   * of the 80-bit x87 long double does not enter the key.
+   * Distinct bit patterns are distinct keys: +0 and -0 are not merged,
+   * nor are NaNs with different payloads.
+   */
+  template<typename Tp>
+    struct abscissa_key
+    {
+      static constexpr std::size_t s_num_bytes
+	= (std::numeric_limits<Tp>::digits == 64 && sizeof(Tp) > 10)
+	? 10
+	: sizeof(Tp);
+
+      std::array<std::uint64_t, (s_num_bytes + 7) / 8> bits{};
+
+      explicit abscissa_key(Tp x);
+
+      bool operator==(const abscissa_key&) const = default;
+
+      /// Return a well-mixed hash of the bits.
+      std::uint64_t
+      hash() const;
+    };
+
+  template<typename Tp>
+    struct abscissa_hash
+    {
+      std::size_t
+      operator()(const abscissa_key<Tp>& key) const
+      { return key.hash(); }
+    };
+
+} // namespace detail
+
+  /**
+   * Counters of a memoized integrand.
+   */
+  struct memoization_stats
+  {
+    /// The number of calls answered from the cache.
+    std::size_t hits = 0;
+    /// The number of calls that evaluated the integrand.
+    std::size_t misses = 0;
+    /// The number of values dropped to make room for new ones.
+    std::size_t evictions = 0;
+    /// The number of values held.
+    std::size_t size = 0;
+    /// The maximum number of values held.
+    std::size_t capacity = 0;
+
+    /// Return the fraction of calls answered from the cache.
+    double
+    hit_rate() const
+    {
+      const auto calls = this->hits + this->misses;
+      return calls == 0 ? 0.0 : double(this->hits) / double(calls);
+    }
+  };
+
+  /**
+   * Wrap an integrand so that repeated abscissae are evaluated once.
+   *
+   * Adaptive integrators revisit abscissae at shared break points,
+   * on repeated calls with the same limits and in outer loops of
+   * nested integrals.  This wrapper keeps the function values
+   * in a bounded hash table keyed on the bit pattern of the abscissa.
+   * When the table is full the oldest value is dropped.
+   *
+   * The integrators take the integrand by value.  Copies of the wrapper
+   * share one cache, so a cache filled through one copy serves all.
+   *
+   * The wrapper may be called from several threads at once.
+   * The table is split into shards, each with its own lock, chosen
+   * by the hash of the abscissa.  The integrand itself is called
+   * outside the locks, so it must be safe to call concurrently.
+   * Two threads missing on the same abscissa at the same time
+   * both evaluate it.
+   *
+   * Caching only pays when the integrand costs more than a hash
+   * lookup and a lock: a special function, a nested integral
+   * or a simulation.
+   *
+   * @tparam Tp The real type of the abscissa.
+   * @tparam FuncTp The type of the integrand.
+   */
+  template<typename Tp, typename FuncTp>
+    class memoized_integrand
+    {
+    public:
+
+      using value_type = std::invoke_result_t<FuncTp, Tp>;
+
+      /**
+       * Construct from an integrand and the size of the cache.
+       *
+       * @param func The integrand.
+       * @param capacity The maximum number of values held.
+       * @param num_shards The number of independently locked shards
+       *                   (0 means a few per hardware thread).
+       */
+      explicit
+      memoized_integrand(FuncTp func, std::size_t capacity = 65536,
+			 std::size_t num_shards = 0);
+
+      /// Return the integrand at @c x from the cache or by evaluation.
+      value_type
+      operator()(Tp x) const;
+
+      /// Return the counters summed over the shards.
+      memoization_stats
+      stats() const;
+
+      /// Drop all values and reset the counters.
+      void
+      clear();
+
+      /// Return the number of shards.
+      std::size_t
+      num_shards() const
+      { return this->m_cache->num_shards; }
+
+    private:
+
+      using key_type = detail::abscissa_key<Tp>;
+
+      /// A slice of the table.  Aligned to keep the locks
+      /// of neighbouring shards off a shared cache line.
+      struct alignas(64) shard
+      {
+	mutable std::mutex mutex;
+	std::unordered_map<key_type, value_type,
+			   detail::abscissa_hash<Tp>> table;
+	/// The keys in order of insertion; a ring once full.
+	std::vector<key_type> order;
+	std::size_t oldest = 0;
+	std::size_t hits = 0;
+	std::size_t misses = 0;
+	std::size_t evictions = 0;
+      };
+
+      struct cache
+      {
+	std::size_t num_shards;
+	std::size_t shard_capacity;
+	std::unique_ptr<shard[]> shards;
+      };
+
+      FuncTp m_func;
+      std::shared_ptr<cache> m_cache;
+    };
+
+} // namespace emsr
+
+#include <emsr/memoized_integrand.tcc>
+
+#endif // MEMOIZED_INTEGRAND_H
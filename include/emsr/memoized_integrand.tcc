@@ -0,0 +1,165 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements a memoizing wrapper for expensive integrands.
+
+#ifndef MEMOIZED_INTEGRAND_TCC
+#define MEMOIZED_INTEGRAND_TCC 1
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace emsr
+{
+
+namespace detail
+{
+
+  template<typename Tp>
+    abscissa_key<Tp>::abscissa_key(Tp x)
+    { std::memcpy(this->bits.data(), &x, s_num_bytes); }
+
+  template<typename Tp>
+    std::uint64_t
+    abscissa_key<Tp>::hash() const
+    {
+      // Combine the words and finish with the splitmix64 mixer
+      // so that both the shard and the bucket see well-mixed bits.
+      std::uint64_t h = 0;
+      for (auto w : this->bits)
+	{
+	  h ^= w + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+	  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+	  h ^= h >> 31;
+	}
+      return h;
+    }
+
+} // namespace detail
+
+  template<typename Tp, typename FuncTp>
+    memoized_integrand<Tp, FuncTp>::
+    memoized_integrand(FuncTp func, std::size_t capacity,
+		       std::size_t num_shards)
+    : m_func(func),
+      m_cache(std::make_shared<cache>())
+    {
+      if (capacity == 0)
+	throw std::domain_error("memoized_integrand: "
+				"The cache capacity must be positive");
+
+      if (num_shards == 0)
+	{
+	  const std::size_t num_threads
+	    = std::max(1u, std::thread::hardware_concurrency());
+	  num_shards = 4 * num_threads;
+	}
+      // Keep enough room in each shard to be useful.
+      num_shards = std::max(std::size_t{1},
+			    std::min(num_shards, capacity / 16));
+
+      this->m_cache->num_shards = num_shards;
+      this->m_cache->shard_capacity = (capacity + num_shards - 1) / num_shards;
+      this->m_cache->shards = std::make_unique<shard[]>(num_shards);
+    }
+
+  template<typename Tp, typename FuncTp>
+    auto
+    memoized_integrand<Tp, FuncTp>::operator()(Tp x) const
+    -> value_type
+    {
+      const key_type key(x);
+      const auto hash = key.hash();
+      auto& cache = *this->m_cache;
+      auto& sh = cache.shards[(hash >> 32) % cache.num_shards];
+
+      {
+	std::lock_guard<std::mutex> lock(sh.mutex);
+	const auto found = sh.table.find(key);
+	if (found != sh.table.end())
+	  {
+	    ++sh.hits;
+	    return found->second;
+	  }
+	++sh.misses;
+      }
+
+      // Evaluate without holding the lock.
+      const value_type value = this->m_func(x);
+
+      std::lock_guard<std::mutex> lock(sh.mutex);
+      const auto [pos, inserted] = sh.table.try_emplace(key, value);
+      if (inserted)
+	{
+	  if (sh.order.size() < cache.shard_capacity)
+	    sh.order.push_back(key);
+	  else
+	    {
+	      sh.table.erase(sh.order[sh.oldest]);
+	      sh.order[sh.oldest] = key;
+	      if (++sh.oldest == sh.order.size())
+		sh.oldest = 0;
+	      ++sh.evictions;
+	    }
+	}
+
+      return value;
+    }
+
+  template<typename Tp, typename FuncTp>
+    memoization_stats
+    memoized_integrand<Tp, FuncTp>::stats() const
+    {
+      const auto& cache = *this->m_cache;
+      memoization_stats stats;
+      stats.capacity = cache.num_shards * cache.shard_capacity;
+      for (std::size_t i = 0; i < cache.num_shards; ++i)
+	{
+	  const auto& sh = cache.shards[i];
+	  std::lock_guard<std::mutex> lock(sh.mutex);
+	  stats.hits += sh.hits;
+	  stats.misses += sh.misses;
+	  stats.evictions += sh.evictions;
+	  stats.size += sh.table.size();
+	}
+      return stats;
+    }
+
+  template<typename Tp, typename FuncTp>
+    void
+    memoized_integrand<Tp, FuncTp>::clear()
+    {
+      auto& cache = *this->m_cache;
+      for (std::size_t i = 0; i < cache.num_shards; ++i)
+	{
+	  auto& sh = cache.shards[i];
+	  std::lock_guard<std::mutex> lock(sh.mutex);
+	  sh.table.clear();
+	  sh.order.clear();
+	  sh.oldest = 0;
+	  sh.hits = 0;
+	  sh.misses = 0;
+	  sh.evictions = 0;
+	}
+    }
+
+} // namespace emsr
+
+#endif // MEMOIZED_INTEGRAND_TCC
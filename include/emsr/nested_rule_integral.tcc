@@ -0,0 +1,143 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements the level climb shared by the integrals
+// built on sequences of nested rules.
+
+#ifndef NESTED_RULE_INTEGRAL_TCC
+#define NESTED_RULE_INTEGRAL_TCC 1
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <emsr/gauss_kronrod_integral.h>
+#include <emsr/integration_error.h>
+
+namespace emsr
+{
+namespace detail
+{
+
+  /**
+   * The weighted sums of one level of a nested rule on [-1, 1]:
+   * the integral, the integral of the absolute value and the integral
+   * of the absolute deviation from the mean.
+   */
+  template<typename Tp, typename AreaTp>
+    struct nested_level_sums
+    {
+      AreaTp res;
+      Tp resabs;
+      Tp resasc;
+    };
+
+  /**
+   * Climb the levels of a sequence of nested rules
+   * from @c first_level to @c max_level.
+   *
+   * @c level_sums(level) evaluates the integrand at the points the level
+   * adds to the one below and returns the nested_level_sums of the level.
+   * From @c min_level on the result is scaled by @c half_length
+   * and its error estimated from the difference with the level below,
+   * scaled as in QUADPACK.  The climb stops as soon as @c done(out)
+   * is true for the result @c out; otherwise the result of the highest
+   * level is returned.
+   */
+  template<typename Tp, typename RetTp, typename LevelSums, typename Done>
+    gauss_kronrod_integral_t<Tp, RetTp>
+    climb_nested_rules(int first_level, int min_level, int max_level,
+		       Tp half_length, LevelSums level_sums, Done done)
+    {
+      using AreaTp = decltype(RetTp{} * Tp{});
+
+      const auto abs_half_length = std::abs(half_length);
+
+      gauss_kronrod_integral_t<Tp, RetTp> out;
+      auto prev = AreaTp{0};
+      for (int level = first_level; level <= max_level; ++level)
+	{
+	  const auto sums = level_sums(level);
+	  if (level >= min_level)
+	    {
+	      out.result = sums.res * half_length;
+	      out.resabs = sums.resabs * abs_half_length;
+	      out.resasc = sums.resasc * abs_half_length;
+	      out.abserr = rescale_error((sums.res - prev) * half_length,
+					 out.resabs, out.resasc);
+	      if (done(out))
+		return out;
+	    }
+	  prev = sums.res;
+	}
+
+      return out;
+    }
+
+  /**
+   * Climb a nested rule with @c climb(done) until the error estimate
+   * meets the tolerance.  Return the result of the climb and whether
+   * it met the tolerance.  Invalid tolerances throw naming @c name.
+   */
+  template<typename Tp, typename Climb>
+    auto
+    integrate_nested_rule(const char* name, Climb climb,
+			  Tp max_abs_err, Tp max_rel_err)
+    {
+      if (!valid_tolerances(max_abs_err, max_rel_err))
+	{
+	  std::ostringstream msg;
+	  msg << name << ": Tolerance cannot be achieved"
+		 " with given absolute (" << max_abs_err << ") and relative ("
+	      << max_rel_err << ") error limits.";
+	  throw std::runtime_error(msg.str().c_str());
+	}
+
+      auto converged = [max_abs_err, max_rel_err](const auto& out)
+	{
+	  return out.abserr < max_abs_err
+	      || out.abserr < max_rel_err * std::abs(out.result);
+	};
+
+      const auto out = climb(converged);
+      return std::make_pair(out, converged(out));
+    }
+
+  /**
+   * The stopping test of a nested rule used as the local rule
+   * of an adaptive driver: stop once the estimate is as good
+   * as roundoff allows.
+   */
+  struct nested_rule_at_roundoff
+  {
+    template<typename OutTp>
+      bool
+      operator()(const OutTp& out) const
+      {
+	using AbsAreaTp = std::decay_t<decltype(out.abserr)>;
+	const auto s_eps = std::numeric_limits<AbsAreaTp>::epsilon();
+	return out.abserr <= AbsAreaTp{50} * s_eps * out.resabs;
+      }
+  };
+
+} // namespace detail
+} // namespace emsr
+
+#endif // NESTED_RULE_INTEGRAL_TCC
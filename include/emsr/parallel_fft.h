@@ -0,0 +1,126 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef PARALLEL_FFT_H
+#define PARALLEL_FFT_H 1
+
+#include <cstddef>
+#include <complex>
+#include <vector>
+
+#include <emsr/fft_plan.h>
+
+namespace emsr
+{
+
+  /**
+   * A plan for the multithreaded fast Fourier transform of complex data
+   * of a fixed length by the four-step algorithm.
+   *
+   * The length is split as @f$ N = N_1 N_2 @f$ with both factors near
+   * @f$ \sqrt{N} @f$ so that each sub-transform fits in cache.
+   * The data are viewed as an @f$ N_2 \times N_1 @f$ matrix and
+   * -# the @f$ N_1 @f$ columns are transformed (length @f$ N_2 @f$),
+   * -# multiplied by the twiddles @f$ \omega_N^{j_1 k_2} @f$,
+   * -# the @f$ N_2 @f$ rows are transformed (length @f$ N_1 @f$)
+   *    and written back transposed.
+   * Columns are gathered in blocks into per-thread buffers so the strided
+   * accesses use whole cache lines, and each pass is spread over the
+   * persistent worker threads of parallel_for.  The blocks narrow when
+   * there are fewer columns or rows than threads so that, for instance,
+   * the two long column transforms of @f$ N = 2p @f$ run in parallel.
+   * One scratch array of length @f$ N @f$ is allocated per transform.
+   *
+   * Lengths that do not split (primes) are transformed by a serial
+   * fft_plan.  The conventions are those of fft_plan: the forward
+   * transform is scaled by @f$ 1/N @f$, the inverse is unscaled.
+   */
+  template<typename Tp>
+    class parallel_fft_plan
+    {
+    public:
+
+      /**
+       * Build a plan for transforms of length @c n
+       * using @c num_threads threads (0 means hardware concurrency).
+       */
+      explicit parallel_fft_plan(std::size_t n, unsigned int num_threads = 0);
+
+      /// Return the transform length.
+      std::size_t
+      size() const
+      { return this->m_size; }
+
+      /// Return the number of threads used.
+      unsigned int
+      num_threads() const
+      { return this->m_num_threads; }
+
+      /// Return the factor @f$ N_1 @f$ of the length (the number of columns).
+      std::size_t
+      num_columns() const
+      { return this->m_plan1.size(); }
+
+      /// Return the factor @f$ N_2 @f$ of the length (the number of rows).
+      std::size_t
+      num_rows() const
+      { return this->m_plan2.size(); }
+
+      /// Forward transform of @c size() values in place.
+      void
+      forward(std::complex<Tp>* z) const;
+
+      /// Inverse transform of @c size() values in place.
+      void
+      inverse(std::complex<Tp>* z) const;
+
+      /// Forward transform in place.
+      void
+      forward(std::vector<std::complex<Tp>>& z) const;
+
+      /// Inverse transform in place.
+      void
+      inverse(std::vector<std::complex<Tp>>& z) const;
+
+    private:
+
+      template<bool Inverse>
+	void
+	m_transform(std::complex<Tp>* z) const;
+
+      template<bool Inverse>
+	std::complex<Tp>
+	m_twiddle(std::size_t m) const;
+
+      std::size_t m_size;
+      unsigned int m_num_threads;
+      /// The transform of length N_1 applied to the rows.
+      fft_plan<Tp> m_plan1;
+      /// The transform of length N_2 applied to the columns.
+      fft_plan<Tp> m_plan2;
+      /// The twiddles @f$ \omega_N^m @f$ as a product of
+      /// @f$ \omega_N^{m \bmod B} @f$ and @f$ \omega_N^{B \lfloor m/B \rfloor} @f$.
+      std::size_t m_twiddle_block;
+      std::vector<std::complex<Tp>> m_twiddle_lo;
+      std::vector<std::complex<Tp>> m_twiddle_hi;
+    };
+
+} // namespace emsr
+
+#include <emsr/parallel_fft.tcc>
+
+#endif // PARALLEL_FFT_H
@@ -0,0 +1,223 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef PARALLEL_FFT_TCC
+#define PARALLEL_FFT_TCC 1
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <emsr/parallel_for.h>
+
+namespace emsr
+{
+
+namespace detail
+{
+
+  /**
+   * Return the largest divisor of @c n not exceeding @f$ \sqrt{n} @f$.
+   */
+  inline std::size_t
+  four_step_split(std::size_t n)
+  {
+    std::size_t n1 = 1;
+    for (std::size_t d = 2; d * d <= n; ++d)
+      if (n % d == 0)
+	n1 = d;
+    return n1;
+  }
+
+  /// The number of columns or rows moved together in the four-step passes.
+  constexpr std::size_t s_four_step_block = 16;
+
+} // namespace detail
+
+  template<typename Tp>
+    parallel_fft_plan<Tp>::parallel_fft_plan(std::size_t n,
+					     unsigned int num_threads)
+    : m_size(n),
+      m_num_threads(resolve_num_threads(num_threads)),
+      m_plan1(n == 0 ? 1 : detail::four_step_split(n)),
+      m_plan2(n == 0 ? 1 : n / detail::four_step_split(n)),
+      m_twiddle_block(1), m_twiddle_lo{}, m_twiddle_hi{}
+    {
+      if (n == 0)
+	throw std::domain_error("parallel_fft_plan: Length must be positive.");
+
+      if (this->m_plan1.size() == 1)
+	return;
+
+      const auto s_2pi = Tp{2}
+		* Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+      while (this->m_twiddle_block * this->m_twiddle_block < n)
+	++this->m_twiddle_block;
+      const auto blk = this->m_twiddle_block;
+      this->m_twiddle_lo.reserve(blk);
+      for (std::size_t k = 0; k < blk; ++k)
+	this->m_twiddle_lo.push_back(std::polar(Tp{1},
+					-s_2pi * Tp(k) / Tp(n)));
+      this->m_twiddle_hi.reserve(n / blk + 1);
+      for (std::size_t k = 0; k * blk < n; ++k)
+	this->m_twiddle_hi.push_back(std::polar(Tp{1},
+					-s_2pi * Tp(k * blk) / Tp(n)));
+    }
+
+  template<typename Tp>
+    template<bool Inverse>
+      std::complex<Tp>
+      parallel_fft_plan<Tp>::m_twiddle(std::size_t m) const
+      {
+	const auto blk = this->m_twiddle_block;
+	const auto w = detail::fft_mul(this->m_twiddle_hi[m / blk],
+				       this->m_twiddle_lo[m % blk]);
+	if constexpr (Inverse)
+	  return std::conj(w);
+	else
+	  return w;
+      }
+
+  /**
+   * The input element @f$ x_{j_1 + N_1 j_2} @f$ is row @f$ j_2 @f$,
+   * column @f$ j_1 @f$; the output is
+   * @f[
+   *   X_{k_2 + N_2 k_1} = \sum_{j_1} \omega_{N_1}^{j_1 k_1}
+   *      \omega_N^{j_1 k_2} \sum_{j_2} \omega_{N_2}^{j_2 k_2}
+   *      x_{j_1 + N_1 j_2}.
+   * @f]
+   */
+  template<typename Tp>
+    template<bool Inverse>
+      void
+      parallel_fft_plan<Tp>::m_transform(std::complex<Tp>* z) const
+      {
+	const auto n1 = this->m_plan1.size();
+	const auto n2 = this->m_plan2.size();
+
+	// Narrow the blocks when there are few columns or rows
+	// so that every thread gets work; for N = 2p the two long
+	// column transforms then run in parallel.
+	const auto nt = std::size_t(this->m_num_threads);
+	const auto col_blk = std::clamp<std::size_t>((n1 + nt - 1) / nt,
+					       1, detail::s_four_step_block);
+	const auto row_blk = std::clamp<std::size_t>((n2 + nt - 1) / nt,
+					       1, detail::s_four_step_block);
+
+	auto sub_transform = [](const fft_plan<Tp>& plan, std::complex<Tp>* p)
+	  {
+	    if constexpr (Inverse)
+	      plan.inverse(p);
+	    else
+	      plan.forward(p);
+	  };
+
+	if (n1 == 1)
+	  {
+	    sub_transform(this->m_plan2, z);
+	    return;
+	  }
+
+	std::vector<std::complex<Tp>> tmp(this->m_size);
+
+	// Run the blocks [0, num_blocks) over the threads,
+	// each thread with its own gather buffer.
+	auto run = [this](std::size_t num_blocks, std::size_t buf_size,
+			  auto block_func)
+	  {
+	    const auto nt = std::min<std::size_t>(this->m_num_threads,
+						  num_blocks);
+	    parallel_for(0, nt, unsigned(nt),
+	      [&](std::size_t t)
+	      {
+		std::vector<std::complex<Tp>> buf(buf_size);
+		const auto beg = t * num_blocks / nt;
+		const auto end = (t + 1) * num_blocks / nt;
+		for (auto b = beg; b < end; ++b)
+		  block_func(b, buf.data());
+	      });
+	  };
+
+	// Columns: gather, transform, twiddle and store transposed in tmp.
+	run((n1 + col_blk - 1) / col_blk, col_blk * n2,
+	    [&](std::size_t b, std::complex<Tp>* buf)
+	    {
+	      const auto j1b = b * col_blk;
+	      const auto nc = std::min(col_blk, n1 - j1b);
+	      for (std::size_t j2 = 0; j2 < n2; ++j2)
+		for (std::size_t c = 0; c < nc; ++c)
+		  buf[c * n2 + j2] = z[j1b + c + n1 * j2];
+	      for (std::size_t c = 0; c < nc; ++c)
+		{
+		  auto col = buf + c * n2;
+		  sub_transform(this->m_plan2, col);
+		  const auto j1 = j1b + c;
+		  for (std::size_t k2 = 1; k2 < n2; ++k2)
+		    col[k2] = detail::fft_mul(col[k2],
+				this->template m_twiddle<Inverse>(j1 * k2));
+		}
+	      for (std::size_t k2 = 0; k2 < n2; ++k2)
+		for (std::size_t c = 0; c < nc; ++c)
+		  tmp[k2 * n1 + j1b + c] = buf[c * n2 + k2];
+	    });
+
+	// Rows: transform in place in tmp and scatter transposed into z.
+	run((n2 + row_blk - 1) / row_blk, 0,
+	    [&](std::size_t b, std::complex<Tp>*)
+	    {
+	      const auto k2b = b * row_blk;
+	      const auto nr = std::min(row_blk, n2 - k2b);
+	      for (std::size_t r = 0; r < nr; ++r)
+		sub_transform(this->m_plan1, tmp.data() + (k2b + r) * n1);
+	      for (std::size_t k1 = 0; k1 < n1; ++k1)
+		for (std::size_t r = 0; r < nr; ++r)
+		  z[k2b + r + n2 * k1] = tmp[(k2b + r) * n1 + k1];
+	    });
+      }
+
+  template<typename Tp>
+    void
+    parallel_fft_plan<Tp>::forward(std::complex<Tp>* z) const
+    { this->template m_transform<false>(z); }
+
+  template<typename Tp>
+    void
+    parallel_fft_plan<Tp>::inverse(std::complex<Tp>* z) const
+    { this->template m_transform<true>(z); }
+
+  template<typename Tp>
+    void
+    parallel_fft_plan<Tp>::forward(std::vector<std::complex<Tp>>& z) const
+    {
+      if (z.size() != this->m_size)
+	throw std::domain_error("parallel_fft_plan: "
+				"Data length does not match plan.");
+      this->forward(z.data());
+    }
+
+  template<typename Tp>
+    void
+    parallel_fft_plan<Tp>::inverse(std::vector<std::complex<Tp>>& z) const
+    {
+      if (z.size() != this->m_size)
+	throw std::domain_error("parallel_fft_plan: "
+				"Data length does not match plan.");
+      this->inverse(z.data());
+    }
+
+} // namespace emsr
+
+#endif // PARALLEL_FFT_TCC
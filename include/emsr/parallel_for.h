@@ -0,0 +1,265 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H 1
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace emsr
+{
+
+  /**
+   * Return the number of threads to use for a requested thread count.
+   * A request of zero means "use the hardware concurrency".
+   */
+  inline unsigned int
+  resolve_num_threads(unsigned int num_threads)
+  {
+    if (num_threads == 0)
+      num_threads = std::thread::hardware_concurrency();
+    return num_threads == 0 ? 1u : num_threads;
+  }
+
+namespace detail
+{
+  /**
+   * A process-wide pool of worker threads for parallel_for.
+   *
+   * Workers are started on demand and live until the end of the program
+   * so repeated parallel loops do not pay for thread creation.
+   */
+  class thread_pool
+  {
+  public:
+
+    static thread_pool&
+    instance()
+    {
+      static thread_pool s_pool;
+      return s_pool;
+    }
+
+    /**
+     * Start workers until there are at least @c num of them.
+     * A failure to start a thread leaves the pool smaller; callers
+     * of parallel_for do the work themselves in that case.
+     */
+    void
+    reserve(unsigned int num)
+    {
+      std::lock_guard<std::mutex> lock(this->m_mutex);
+      try
+	{
+	  while (this->m_workers.size() < num)
+	    this->m_workers.emplace_back([this]{ this->m_run(); });
+	}
+      catch (const std::system_error&)
+	{ }
+    }
+
+    /// Queue a task for the next free worker.
+    void
+    submit(std::function<void()> task)
+    {
+      {
+	std::lock_guard<std::mutex> lock(this->m_mutex);
+	this->m_tasks.push_back(std::move(task));
+      }
+      this->m_cond.notify_one();
+    }
+
+    ~thread_pool()
+    {
+      {
+	std::lock_guard<std::mutex> lock(this->m_mutex);
+	this->m_stop = true;
+      }
+      this->m_cond.notify_all();
+      for (auto& th : this->m_workers)
+	th.join();
+    }
+
+  private:
+
+    thread_pool() = default;
+
+    void
+    m_run()
+    {
+      while (true)
+	{
+	  std::function<void()> task;
+	  {
+	    std::unique_lock<std::mutex> lock(this->m_mutex);
+	    this->m_cond.wait(lock, [this]
+			      { return this->m_stop || !this->m_tasks.empty(); });
+	    if (this->m_tasks.empty())
+	      return;
+	    task = std::move(this->m_tasks.front());
+	    this->m_tasks.pop_front();
+	  }
+	  task();
+	}
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::function<void()>> m_tasks;
+    std::vector<std::thread> m_workers;
+    bool m_stop = false;
+  };
+
+  /**
+   * The blocks of one parallel_for call.  Blocks are claimed in order
+   * by the caller and by the pool workers helping it.
+   */
+  template<typename Func>
+    struct parallel_blocks
+    {
+      parallel_blocks(Func& func, std::size_t first, std::size_t count,
+		      unsigned int num_blocks)
+      : m_func(func), m_first(first), m_chunk(count / num_blocks),
+	m_extra(count % num_blocks), m_num_blocks(num_blocks),
+	m_error(num_blocks)
+      { }
+
+      /// Run blocks until none are left to claim.
+      void
+      run()
+      {
+	while (true)
+	  {
+	    const auto t = this->m_next.fetch_add(1);
+	    if (t >= this->m_num_blocks)
+	      return;
+	    const auto beg = this->m_first + t * this->m_chunk
+			   + std::min<std::size_t>(t, this->m_extra);
+	    const auto end = beg + this->m_chunk + (t < this->m_extra ? 1 : 0);
+	    try
+	      {
+		for (auto i = beg; i < end; ++i)
+		  this->m_func(i);
+	      }
+	    catch (...)
+	      {
+		this->m_error[t] = std::current_exception();
+	      }
+	    std::lock_guard<std::mutex> lock(this->m_mutex);
+	    if (++this->m_done == this->m_num_blocks)
+	      this->m_cond.notify_all();
+	  }
+      }
+
+      /// Wait for every block to finish.
+      void
+      wait()
+      {
+	std::unique_lock<std::mutex> lock(this->m_mutex);
+	this->m_cond.wait(lock, [this]
+			  { return this->m_done == this->m_num_blocks; });
+      }
+
+      Func& m_func;
+      std::size_t m_first;
+      std::size_t m_chunk;
+      std::size_t m_extra;
+      unsigned int m_num_blocks;
+      std::atomic<unsigned int> m_next{0};
+      unsigned int m_done = 0;
+      std::mutex m_mutex;
+      std::condition_variable m_cond;
+      std::vector<std::exception_ptr> m_error;
+    };
+} // namespace detail
+
+  /**
+   * Call @c func(i) for every @c i in [first, last) spreading the work
+   * over @c num_threads threads.
+   *
+   * The index range is cut into contiguous blocks, one per thread,
+   * so the assignment of indices to blocks depends only on the range
+   * and the thread count.  The caller is responsible for making each
+   * call independent of the others; results written to distinct slots
+   * are then identical to those of a serial loop.
+   *
+   * The blocks run on a persistent pool of worker threads;
+   * the calling thread works on them too so the loop completes
+   * even when no worker is free, as in a nested parallel_for.
+   *
+   * If any call throws, the exception from the lowest-numbered block
+   * is rethrown after all blocks have finished.
+   *
+   * @param first The first index.
+   * @param last  One past the last index.
+   * @param num_threads The number of threads (0 means hardware concurrency).
+   * @param func  A callable taking a single @c std::size_t index.
+   */
+  template<typename Func>
+    void
+    parallel_for(std::size_t first, std::size_t last,
+		 unsigned int num_threads, Func func)
+    {
+      if (last <= first)
+	return;
+
+      const auto count = last - first;
+      num_threads = resolve_num_threads(num_threads);
+      if (std::size_t(num_threads) > count)
+	num_threads = unsigned(count);
+
+      if (num_threads == 1)
+	{
+	  for (auto i = first; i < last; ++i)
+	    func(i);
+	  return;
+	}
+
+      auto blocks = std::make_shared<detail::parallel_blocks<Func>>(func,
+						first, count, num_threads);
+      auto& pool = detail::thread_pool::instance();
+      pool.reserve(num_threads - 1);
+      // A helper that cannot be queued leaves its blocks to the caller.
+      try
+	{
+	  for (auto t = 1u; t < num_threads; ++t)
+	    pool.submit([blocks]{ blocks->run(); });
+	}
+      catch (...)
+	{ }
+      blocks->run();
+      blocks->wait();
+
+      for (const auto& err : blocks->m_error)
+	if (err)
+	  std::rethrow_exception(err);
+    }
+
+} // namespace emsr
+
+#endif // PARALLEL_FOR_H
@@ -25,18 +25,194 @@
 #ifndef QAG_INTEGRATE_TCC
 #define QAG_INTEGRATE_TCC 1
 
+#include <algorithm>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <limits>
+#include <new>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 #include <emsr/integration_workspace.h>
+#include <emsr/parallel_for.h>
 
 namespace emsr
 {
 
+namespace detail
+{
+  /**
+   * Bisect the interval of largest error in the workspace until
+   * the total error meets the tolerance, the workspace is full
+   * or the integrand misbehaves.  This is the refinement loop
+   * of qag_integrate whether it started from one interval or many.
+   * At least one bisection is done.
+   *
+   * @param[in,out] area The total of the interval results.
+   * @param[in,out] errsum The total of the interval errors.
+   * @param[in,out] tolerance The error target for the current area.
+   * @param[in] iteration The number of intervals evaluated so far.
+   *
+   * @return NO_ERROR if the tolerance was met
+   *         or the error code describing why it was not.
+   */
+  template<typename Tp, typename RetTp, typename FuncTp,
+	   typename Integrator, typename AreaTp, typename AbsAreaTp>
+    int
+    qag_bisect(integration_workspace<Tp, RetTp>& workspace,
+	       FuncTp& func, const Integrator& quad,
+	       Tp max_abs_err, Tp max_rel_err,
+	       std::size_t iteration,
+	       AreaTp& area, AbsAreaTp& errsum, Tp& tolerance)
+    {
+      const auto max_iter = workspace.capacity();
+      // Try to adjust tests for varing precision.
+      const auto s_rel_err = std::pow(Tp{10},
+				 -std::numeric_limits<Tp>::digits / Tp{10});
+
+      int error_type = NO_ERROR;
+      int roundoff_type1 = 0, roundoff_type2 = 0;
+      do
+	{
+	  // Bisect the subinterval with the largest error estimate
+	  const auto curr = workspace.retrieve();
+
+	  const auto a1 = curr.lower_lim;
+	  const auto mid = (curr.lower_lim + curr.upper_lim) / Tp{2};
+	  const auto a2 = mid;
+	  const auto b2 = curr.upper_lim;
+
+	  auto [area1, error1, resabs1, resasc1]
+	    = quad(func, a1, mid);
+
+	  auto [area2, error2, resabs2, resasc2]
+	    = quad(func, a2, b2);
+
+	  const auto area12 = area1 + area2;
+	  const auto error12 = error1 + error2;
+	  const auto delta = area12 - curr.result;
+
+	  // The workspace keeps compensated or reproducible totals.
+	  workspace.split(mid, area1, error1, area2, error2);
+	  area = workspace.total_integral();
+	  errsum = workspace.total_error();
+
+	  tolerance = std::max(max_abs_err,
+				 max_rel_err * std::abs(area));
+
+	  if (resasc1 != error1 && resasc2 != error2)
+	    {
+	      if (std::abs(delta) <= s_rel_err * std::abs(area12)
+		  && error12 >= Tp{0.99} * curr.abs_error)
+		++roundoff_type1;
+	      if (iteration >= 10 && error12 > curr.abs_error)
+		++roundoff_type2;
+	    }
+
+	  if (errsum > tolerance)
+	    {
+	      if (roundoff_type1 >= 6 || roundoff_type2 >= 20)
+		error_type = ROUNDOFF_ERROR;
+
+	      // Set error flag in the case of bad integrand behaviour at
+	      // a point of the integration range.
+	      if (workspace.subinterval_too_small(a1, a2, b2))
+		error_type = SINGULAR_ERROR;
+	    }
+
+	  ++iteration;
+	}
+      while (iteration < max_iter
+	     && !error_type
+	     && errsum > tolerance);
+
+      if (error_type == NO_ERROR && errsum > tolerance)
+	error_type = MAX_ITER_ERROR;
+
+      return error_type;
+    }
+} // namespace detail
+
+  /**
+   * Integrates a function from finite a to finite b using an adaptive
+   * quadrature rule without throwing when the tolerance is not met.
+   * The error code, the best result and error estimate found and
+   * the number of function evaluations are returned instead.
+   * Invalid tolerances still throw.
+   * The other arguments are those of the throwing overload below.
+   *
+   * Unlike qags_integrate and cquad_integrate this has no overload
+   * taking a loop state and a checkpoint callback so a run cannot be
+   * resumed after an interruption.  Use qags_integrate where a long
+   * integration must be resumable.
+   */
+  template<typename Tp, typename FuncTp,
+	   typename Integrator = gauss_kronrod_integral<Tp>>
+    auto
+    qag_integrate(std::nothrow_t,
+		  integration_workspace<Tp,
+		  std::invoke_result_t<FuncTp, Tp>>& workspace,
+		  FuncTp func,
+		  Tp lower, Tp upper,
+		  Tp max_abs_err, Tp max_rel_err,
+		  Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_21))
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      std::size_t num_evals = 0;
+      auto counted_func = [&func, &num_evals](Tp x)
+			  { ++num_evals; return func(x); };
+
+      const auto max_iter = workspace.capacity();
+
+      if (!valid_tolerances(max_abs_err, max_rel_err))
+	{
+	  std::ostringstream msg;
+	  msg << "qag_integrate: Tolerance cannot be achieved with given "
+		   "absolute (" << max_abs_err << ") and relative ("
+		<< max_rel_err << ") error limits.";
+	  throw std::runtime_error(msg.str().c_str());
+	}
+
+      auto [result0, abserr0, resabs0, resasc0]
+	= quad(counted_func, lower, upper);
+
+      auto tolerance = std::max(max_abs_err, max_rel_err * std::abs(result0));
+
+      // Compute roundoff tolerance.
+      const auto round_off = Tp{10} * tolerance * resabs0;
+
+      if (abserr0 <= round_off && abserr0 > tolerance)
+	return {result0, abserr0, ROUNDOFF_ERROR, num_evals,
+		"qag_integrate: Cannot reach tolerance because "
+		"of roundoff error on first attempt"};
+      else if ((abserr0 <= tolerance && abserr0 != resasc0)
+		|| abserr0 == Tp{0})
+	return {result0, abserr0, NO_ERROR, num_evals};
+      else if (max_iter == 1)
+	return {result0, abserr0, MAX_ITER_ERROR, num_evals,
+		"qag_integrate: A maximum of one iteration was insufficient"};
+
+      workspace.clear();
+      workspace.append(lower, upper, result0, abserr0);
+
+      auto area = result0;
+      auto errsum = abserr0;
+      const auto error_type
+	= detail::qag_bisect(workspace, counted_func, quad,
+			     max_abs_err, max_rel_err, 1,
+			     area, errsum, tolerance);
+
+      auto result = workspace.total_integral();
+      auto abserr = errsum;
+
+      if (errsum <= tolerance)
+	return {result, abserr, NO_ERROR, num_evals};
+
+      return {result, abserr, error_type, num_evals};
+    }
+
   /**
    * Integrates a function from finite a to finite b using an adaptive
    * quadrature rule.  The integration domain is recursively subdivided
@@ -44,6 +220,9 @@ namespace emsr
    * estimate.  Subdivision continues until a prescribed error target is reached
    * or until a maximum number of divisions is performed.
    *
+   * The run cannot be checkpointed and resumed; see the non-throwing
+   * overload.
+   *
    * Once either the absolute or relative error limit is reached,
    * qag_integrate() returns
    *
@@ -76,10 +255,36 @@ namespace emsr
 		  Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_21))
     -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
+      return check_status(__func__,
+			  qag_integrate(std::nothrow, workspace, func,
+					lower, upper,
+					max_abs_err, max_rel_err, quad));
+    }
+
+  /**
+   * Integrates a function adaptively starting from a partition
+   * of the integration range without throwing when the tolerance
+   * is not met.  The error code, the best result and error estimate found
+   * and the number of function evaluations are returned instead.
+   * Invalid arguments still throw.
+   * The other arguments are those of the throwing overload below.
+   */
+  template<typename Tp, typename FuncTp,
+	   typename Integrator = gauss_kronrod_integral<Tp>>
+    auto
+    qag_integrate(std::nothrow_t,
+		  integration_workspace<Tp,
+		  std::invoke_result_t<FuncTp, Tp>>& workspace,
+		  FuncTp func,
+		  const std::vector<Tp>& partition,
+		  Tp max_abs_err, Tp max_rel_err,
+		  Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_21),
+		  unsigned int num_threads = 1)
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      using PanelTp = decltype(quad(func, Tp{}, Tp{}));
+
       const auto max_iter = workspace.capacity();
-      // Try to adjust tests for varing precision.
-      const auto s_rel_err = std::pow(Tp{10},
-				 -std::numeric_limits<Tp>::digits / Tp{10});
 
       if (!valid_tolerances(max_abs_err, max_rel_err))
 	{
@@ -90,102 +295,153 @@ namespace emsr
 	  throw std::runtime_error(msg.str().c_str());
 	}
 
-      auto [result0, abserr0, resabs0, resasc0]
-	= quad(func, lower, upper);
+      if (partition.size() < 2)
+	throw std::runtime_error("qag_integrate: "
+				 "a partition needs at least two points");
 
-      auto tolerance = std::max(max_abs_err, max_rel_err * std::abs(result0));
+      const auto num_panels = partition.size() - 1;
+      if (num_panels > max_iter)
+	throw std::runtime_error("qag_integrate: "
+				 "number of panels exceeds size of workspace");
 
-      // Compute roundoff tolerance.
-      const auto round_off = Tp{10} * tolerance * resabs0;
+      const bool ascending = partition.front() < partition.back();
+      if (std::adjacent_find(partition.begin(), partition.end(),
+			     [ascending](Tp a, Tp b)
+			     { return ascending ? !(a < b) : !(a > b); })
+	  != partition.end())
+	throw std::runtime_error("qag_integrate: "
+				 "partition points are not strictly monotonic");
 
-      if (abserr0 <= round_off && abserr0 > tolerance)
-	throw integration_error("qag_integrate: "
-				"Cannot reach tolerance because "
-				"of roundoff error on first attempt",
-				ROUNDOFF_ERROR, result0, abserr0);
-      else if ((abserr0 <= tolerance && abserr0 != resasc0)
-		|| abserr0 == Tp{0})
-	return {result0, abserr0};
-      else if (max_iter == 1)
-	throw integration_error("qag_integrate: "
-				"A maximum of one iteration was insufficient",
-				MAX_ITER_ERROR, result0, abserr0);
+      // The panels are independent; each counts its own evaluations.
+      std::vector<PanelTp> panel(num_panels);
+      std::vector<std::size_t> panel_evals(num_panels, 0);
+      parallel_for(0, num_panels, num_threads,
+		   [&func, &quad, &partition, &panel, &panel_evals]
+		   (std::size_t i)
+		   {
+		     auto& count = panel_evals[i];
+		     auto counted_func = [&func, &count](Tp x)
+					 { ++count; return func(x); };
+		     panel[i] = quad(counted_func,
+				     partition[i], partition[i + 1]);
+		   });
 
-      workspace.clear();
-      workspace.append(lower, upper, result0, abserr0);
-
-      auto area = result0;
-      auto errsum = abserr0;
-      int error_type = NO_ERROR;
-      std::size_t iteration = 1;
-
-      int roundoff_type1 = 0, roundoff_type2 = 0;
-      do
+      std::size_t num_evals = 0;
+      auto approx_area = decltype(panel[0].result){};
+      for (std::size_t i = 0; i < num_panels; ++i)
 	{
-	  // Bisect the subinterval with the largest error estimate
-	  const auto& curr = workspace.retrieve();
-
-	  const auto a1 = curr.lower_lim;
-	  const auto mid = (curr.lower_lim + curr.upper_lim) / Tp{2};
-	  const auto a2 = mid;
-	  const auto b2 = curr.upper_lim;
-
-	  auto [area1, error1, resabs1, resasc1]
-	    = quad(func, a1, mid);
-
-	  auto [area2, error2, resabs2, resasc2]
-	    = quad(func, a2, b2);
-
-	  const auto area12 = area1 + area2;
-	  const auto error12 = error1 + error2;
-	  const auto delta = area12 - curr.result;
-
-	  area += delta;
-	  errsum += error12 - curr.abs_error;
-
-	  tolerance = std::max(max_abs_err,
-				 max_rel_err * std::abs(area));
+	  num_evals += panel_evals[i];
+	  approx_area += panel[i].result;
+	}
 
-	  if (resasc1 != error1 && resasc2 != error2)
+      // Coarsen where the integrand has become smooth since the partition
+      // was made: merge runs of adjacent panels whose errors sum to a tenth
+      // of the tolerance share of a panel so that partitions do not keep
+      // growing along a sweep.  Merged panels keep the sums of the results
+      // and errors of their parts.
+      const auto s_merge_fraction = Tp{0.1L};
+      const auto max_merge_error
+	= s_merge_fraction
+	* std::max(max_abs_err, max_rel_err * std::abs(approx_area))
+	/ Tp(num_panels);
+      workspace.clear();
+      std::size_t num_merged = 0;
+      for (std::size_t i = 0; i < num_panels; )
+	{
+	  auto j = i + 1;
+	  auto result = panel[i].result;
+	  auto abserr = panel[i].abserr;
+	  while (j < num_panels
+		 && abserr + panel[j].abserr <= max_merge_error)
 	    {
-	      if (std::abs(delta) <= s_rel_err * std::abs(area12)
-		  && error12 >= Tp{0.99} * curr.abs_error)
-		++roundoff_type1;
-	      if (iteration >= 10 && error12 > curr.abs_error)
-		++roundoff_type2;
+	      result += panel[j].result;
+	      abserr += panel[j].abserr;
+	      ++j;
 	    }
+	  workspace.append(partition[i], partition[j], result, abserr);
+	  ++num_merged;
+	  i = j;
+	}
+      auto area = workspace.total_integral();
+      auto errsum = workspace.total_error();
 
-	  if (errsum > tolerance)
-	    {
-	      if (roundoff_type1 >= 6 || roundoff_type2 >= 20)
-		error_type = ROUNDOFF_ERROR;
-
-	      // Set error flag in the case of bad integrand behaviour at
-	      // a point of the integration range.
-	      if (workspace.subinterval_too_small(a1, a2, b2))
-		error_type = SINGULAR_ERROR;
-	    }
+      auto tolerance = std::max(max_abs_err, max_rel_err * std::abs(area));
 
-	  workspace.split(mid, area1, error1, area2, error2);
+      if (errsum <= tolerance)
+	return {workspace.total_integral(), errsum, NO_ERROR, num_evals};
+      else if (num_merged >= max_iter)
+	return {workspace.total_integral(), errsum, MAX_ITER_ERROR, num_evals,
+		"qag_integrate: The partition fills the workspace"};
 
-	  ++iteration;
-	}
-      while (iteration < max_iter
-	     && !error_type
-	     && errsum > tolerance);
+      auto counted_func = [&func, &num_evals](Tp x)
+			  { ++num_evals; return func(x); };
+      const auto error_type
+	= detail::qag_bisect(workspace, counted_func, quad,
+			     max_abs_err, max_rel_err, num_merged,
+			     area, errsum, tolerance);
 
       auto result = workspace.total_integral();
       auto abserr = errsum;
 
       if (errsum <= tolerance)
-	return {result, abserr};
+	return {result, abserr, NO_ERROR, num_evals};
 
-      if (error_type == NO_ERROR && iteration >= max_iter)
-	error_type = MAX_ITER_ERROR;
+      return {result, abserr, error_type, num_evals};
+    }
 
-      check_error(__func__, error_type, result, abserr);
-      throw integration_error("qag_integrate: Unknown error.",
-			      UNKNOWN_ERROR, result, abserr);
+  /**
+   * Integrates a function adaptively starting from a partition
+   * of the integration range rather than from the range as a whole.
+   *
+   * When integrating a family of functions @f$ f(x; p) @f$ over
+   * a slowly varying parameter the partition found for one parameter,
+   * returned by integration_workspace::partition(), is a good start
+   * for the next.  The panels of the partition are integrated
+   * on @c num_threads threads (0 means hardware concurrency).
+   * Runs of adjacent panels whose errors sum to a small share
+   * of the tolerance are merged so the partition coarsens where
+   * the integrand has become smoother.  The panels with the largest errors
+   * are then bisected in turn as in the standard algorithm
+   * until the tolerance is met.
+   * The function must be safe to call concurrently
+   * if more than one thread is used.  The result does not depend
+   * on the number of threads.
+   *
+   * @tparam FuncTp     A function type that takes a single real scalar
+   *                     argument and returns a real scalar.
+   * @tparam Tp         A real type for the limits of integration and the step.
+   * @tparam Integrator A non-adaptive integrator that is able to return
+   *                     an error estimate in addition to the result.
+   *
+   * @param[in] workspace The workspace that manages adaptive quadrature
+   * @param[in] func The single-variable function to be integrated
+   * @param[in] partition The strictly monotonic break points of the panels
+   *                      from the lower to the upper limit of integration
+   * @param[in] max_abs_err The limit on absolute error
+   * @param[in] max_rel_err The limit on relative error
+   * @param[in] quad The quadrature stepper taking a function object
+   *                   and two integration limits
+   * @param[in] num_threads The number of threads for the initial panels
+   *
+   * @return A tuple with the first value being the integration result,
+   *	     and the second value being the estimated error.
+   */
+  template<typename Tp, typename FuncTp,
+	   typename Integrator = gauss_kronrod_integral<Tp>>
+    auto
+    qag_integrate(integration_workspace<Tp,
+		  std::invoke_result_t<FuncTp, Tp>>& workspace,
+		  FuncTp func,
+		  const std::vector<Tp>& partition,
+		  Tp max_abs_err, Tp max_rel_err,
+		  Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_21),
+		  unsigned int num_threads = 1)
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      return check_status(__func__,
+			  qag_integrate(std::nothrow, workspace, func,
+					partition, max_abs_err, max_rel_err,
+					quad, num_threads));
     }
 
 } // namespace emsr
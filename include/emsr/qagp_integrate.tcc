@@ -26,9 +26,11 @@
 #ifndef QAGP_INTEGRATE_TCC
 #define QAGP_INTEGRATE_TCC 1
 
+#include <new>
 #include <stdexcept>
 #include <type_traits>
 #include <tuple>
+#include <utility>
 
 #include <emsr/integration_workspace.h>
 #include <emsr/extrapolation_table.h>
@@ -37,37 +39,32 @@ namespace emsr
 {
 
   /**
-   * Adaptively integrate a function with known singular/discontinuous points.
-   *
-   * @tparam FuncTp     A function type that takes a single real scalar
-   *                     argument and returns a real scalar.
-   * @tparam Tp         A real type for the limits of integration and the step.
-   * @tparam Integrator A non-adaptive integrator that is able to return
-   *                     an error estimate in addition to the result.
-   *
-   * @param[in] workspace The workspace that manages adaptive quadrature
-   * @param[in] func The single-variable function to be integrated
-   * @param[in] pts The sorted array of points including the integration
-   *                  limits and intermediate discontinuities/singularities
-   * @param[in] max_abs_err The limit on absolute error
-   * @param[in] max_rel_err The limit on relative error
-   * @param[in] quad The quadrature stepper taking a function object
-   *                   and two integration limits
+   * Adaptively integrate a function with known singular/discontinuous
+   * points without throwing when the tolerance is not met.
+   * The error code, the best result and error estimate found and
+   * the number of function evaluations are returned instead.
+   * Invalid arguments still throw.
+   * The other arguments are those of the throwing overload below.
    */
   template<typename Tp, typename FuncTp,
 	   typename Integrator = gauss_kronrod_integral<Tp>>
     auto
-    qagp_integrate(integration_workspace<Tp,
+    qagp_integrate(std::nothrow_t,
+		   integration_workspace<Tp,
 			std::invoke_result_t<FuncTp, Tp>>& workspace,
 		   FuncTp func,
 		   std::vector<Tp> pts,
 		   Tp max_abs_err, Tp max_rel_err,
 		   Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_21))
-    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
       using AreaTp = std::invoke_result_t<FuncTp, Tp>;
       using AbsAreaTp = decltype(std::abs(AreaTp{}));
 
+      std::size_t num_evals = 0;
+      auto counted_func = [&func, &num_evals](Tp x)
+			  { ++num_evals; return func(x); };
+
       const auto s_max = std::numeric_limits<Tp>::max();
       const auto max_iter = workspace.capacity();
       const auto n_ivals = pts.size() - 1;
@@ -110,7 +107,7 @@ namespace emsr
 	  const auto upper = pts[i + 1];
 
 	  auto [area0, error0, resabs0, resasc0]
-	    = quad(func, lower, upper);
+	    = quad(counted_func, lower, upper);
 
 	  result0 += area0;
 	  abserr0 += error0;
@@ -142,16 +139,14 @@ namespace emsr
       const auto round_off = Tp{10} * tolerance * resabs0;
 
       if (abserr0 <= round_off && abserr0 > tolerance)
-	throw integration_error("qagp_integrate: "
-				"Cannot reach tolerance because "
-				"of roundoff error on first attempt",
-				ROUNDOFF_ERROR, result0, abserr0);
+	return {result0, abserr0, ROUNDOFF_ERROR, num_evals,
+		"qagp_integrate: Cannot reach tolerance because "
+		"of roundoff error on first attempt"};
       else if (abserr0 <= tolerance)
-	return {result0, abserr0};
+	return {result0, abserr0, NO_ERROR, num_evals};
       else if (max_iter == 1)
-	throw integration_error("qagp_integrate: "
-				"A maximum of one iteration was insufficient",
-				MAX_ITER_ERROR, result0, abserr0);
+	return {result0, abserr0, MAX_ITER_ERROR, num_evals,
+		"qagp_integrate: A maximum of one iteration was insufficient"};
 
       extrapolation_table<AreaTp, AbsAreaTp> table;
       table.append(result0);
@@ -182,10 +177,10 @@ namespace emsr
 	  ++iteration;
 
 	  auto [area1, error1, resabs1, resasc1]
-	    = quad(func, a1, mid);
+	    = quad(counted_func, a1, mid);
 
 	  auto [area2, error2, resabs2, resasc2]
-	    = quad(func, a2, b2);
+	    = quad(counted_func, a2, b2);
 
 	  const auto area12 = area1 + area2;
 	  const auto error12 = error1 + error2;
@@ -236,8 +231,7 @@ namespace emsr
 	  if (errsum <= tolerance)
 	    {
 	      const auto result = workspace.total_integral();
-	      check_error(__func__, error_type, result, errsum);
-	      return {result, errsum};
+	      return {result, errsum, error_type, num_evals};
 	    }
 
 	  if (error_type != NO_ERROR)
@@ -329,8 +323,7 @@ namespace emsr
       if (err_ext == s_max)
 	{
 	  const auto result = workspace.total_integral();
-	  check_error(__func__, error_type, result, errsum);
-	  return {result, errsum};
+	  return {result, errsum, error_type, num_evals};
 	}
 
       if (error_type != NO_ERROR || error_type2 != NO_ERROR)
@@ -346,20 +339,17 @@ namespace emsr
 	      if (err_ext / std::abs(res_ext) > errsum / std::abs(area))
 		{
 		  const auto result = workspace.total_integral();
-		  check_error(__func__, error_type, result, errsum);
-		  return {result, errsum};
+		  return {result, errsum, error_type, num_evals};
 		}
 	    }
 	  else if (err_ext > errsum)
 	    {
 	      const auto result = workspace.total_integral();
-	      check_error(__func__, error_type, result, errsum);
-	      return {result, errsum};
+	      return {result, errsum, error_type, num_evals};
 	    }
 	  else if (area == Tp{0})
 	    {
-	      check_error(__func__, error_type, result, abserr);
-	      throw std::runtime_error("qagp_integrate: Unknown error.");
+	      return {result, abserr, error_type, num_evals};
 	    }
 	}
 
@@ -368,8 +358,10 @@ namespace emsr
       auto max_area = std::max(std::abs(res_ext), std::abs(area));
       if (!positive_integrand && max_area < Tp{0.01} * resabs0)
 	{
-	  check_error(__func__, error_type, result, abserr);
-	  throw std::runtime_error("qagp_integrate: Unknown error.");
+	  if (error_type == NO_ERROR)
+	    return {result, abserr, UNKNOWN_ERROR, num_evals,
+		    "qagp_integrate: Unknown error."};
+	  return {result, abserr, error_type, num_evals};
 	}
 
       auto ratio = res_ext / area;
@@ -377,12 +369,42 @@ namespace emsr
 	  || errsum > std::abs(area))
 	error_type = UNKNOWN_ERROR;
 
-      if (error_type == NO_ERROR)
-	return {result, abserr};
+      return {result, abserr, error_type, num_evals};
+    }
 
-      check_error(__func__, error_type, result, abserr);
-      throw integration_error("qagp_integrate: Unknown error.",
-			      UNKNOWN_ERROR, result, abserr);
+  /**
+   * Adaptively integrate a function with known singular/discontinuous points.
+   *
+   * @tparam FuncTp     A function type that takes a single real scalar
+   *                     argument and returns a real scalar.
+   * @tparam Tp         A real type for the limits of integration and the step.
+   * @tparam Integrator A non-adaptive integrator that is able to return
+   *                     an error estimate in addition to the result.
+   *
+   * @param[in] workspace The workspace that manages adaptive quadrature
+   * @param[in] func The single-variable function to be integrated
+   * @param[in] pts The sorted array of points including the integration
+   *                  limits and intermediate discontinuities/singularities
+   * @param[in] max_abs_err The limit on absolute error
+   * @param[in] max_rel_err The limit on relative error
+   * @param[in] quad The quadrature stepper taking a function object
+   *                   and two integration limits
+   */
+  template<typename Tp, typename FuncTp,
+	   typename Integrator = gauss_kronrod_integral<Tp>>
+    auto
+    qagp_integrate(integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		   FuncTp func,
+		   std::vector<Tp> pts,
+		   Tp max_abs_err, Tp max_rel_err,
+		   Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_21))
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      return check_status(__func__,
+			  qagp_integrate(std::nothrow, workspace, func,
+					 std::move(pts),
+					 max_abs_err, max_rel_err, quad));
     }
 
 } // namespace emsr
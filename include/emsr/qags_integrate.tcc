@@ -30,57 +30,68 @@
 #include <type_traits>
 #include <utility>
 #include <limits>
+#include <new>
 #include <tuple>
 #include <stdexcept>
 
 #include <emsr/integration_error.h>
 #include <emsr/integration_transform.h>
+#include <emsr/mapped_gauss_kronrod_integral.h>
 #include <emsr/integration_workspace.h>
 #include <emsr/extrapolation_table.h>
+#include <emsr/integration_checkpoint.h>
 
 namespace emsr
 {
 
   /**
    * Adaptively integrate a potentially singular function from a to b
-   * using a recursive Gauss-Kronrod algorithm.
+   * without throwing when the tolerance is not met, resuming from
+   * and checkpointing to a saved state.
    *
-   * @tparam FuncTp     A function type that takes a single real scalar
-   *                     argument and returns a real scalar.
-   * @tparam Tp         A real type for the limits of integration and the step.
-   * @tparam Integrator A non-adaptive integrator that is able to return
-   *                     an error estimate in addition to the result.
+   * Before each bisection the callback @c checkpoint is called with
+   * the workspace and the loop state.  Saving both there, with
+   * integration_workspace::save() and qags_state::save(), and restoring
+   * both and calling again with the restored state resumes
+   * the integration with the same result as an uninterrupted run.
+   * A default-constructed state starts a new integration.
    *
-   * @param[in] workspace The workspace that manages adaptive quadrature
-   * @param[in] func The single-variable function to be integrated
-   * @param[in] pts The sorted array of points including the integration
-   *                  limits and intermediate discontinuities/singularities
-   * @param[in] max_abs_err The limit on absolute error
-   * @param[in] max_rel_err The limit on relative error
-   * @param[in] quad The quadrature stepper taking a function object
-   *                   and two integration limits
+   * The evaluations of the bisection in progress are not saved:
+   * a run interrupted between two checkpoints loses the work since
+   * the last one, the two rule applications of one bisection
+   * (30 evaluations with the default 15-point Gauss-Kronrod rule),
+   * and repeats it on resumption.  A run interrupted before the first
+   * checkpoint loses the first application of the rule to the whole range.
+   *
+   * @param[in,out] state The loop state.
+   * @param[in] checkpoint A callable taking the workspace and the state
+   *                       by const reference.
+   *
+   * The other arguments are those of the throwing overload below.
    */
-  template<typename Tp, typename FuncTp,
-	   typename Integrator = gauss_kronrod_integral<Tp>>
+  template<typename Tp, typename FuncTp, typename Integrator,
+	   typename CheckpointFunc>
     auto
-    qags_integrate(integration_workspace<Tp,
+    qags_integrate(std::nothrow_t,
+		   integration_workspace<Tp,
 			std::invoke_result_t<FuncTp, Tp>>& workspace,
 		   FuncTp func,
 		   Tp lower, Tp upper,
 		   Tp max_abs_err, Tp max_rel_err,
-		   Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_15))
-    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+		   Integrator quad,
+		   qags_state<Tp, std::invoke_result_t<FuncTp, Tp>>& state,
+		   CheckpointFunc checkpoint)
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
-      using AreaTp = std::invoke_result_t<FuncTp, Tp>;
-      using AbsAreaTp = decltype(std::abs(AreaTp{}));
+      auto& num_evals = state.num_evals;
+      auto counted_func = [&func, &num_evals](Tp x)
+			  { ++num_evals; return func(x); };
 
       const auto s_max = std::numeric_limits<Tp>::max();
       const auto max_iter = workspace.capacity();
       // Try to adjust tests for varing precision.
       const auto s_rel_err = std::pow(Tp{10},
 				 -std::numeric_limits<Tp>::digits / Tp{10});
-      bool extrapolate = false;
-      bool allow_extrapolation = true;
 
       if (!valid_tolerances(max_abs_err, max_rel_err))
 	{
@@ -91,51 +102,71 @@ namespace emsr
 	  throw std::runtime_error(msg.str().c_str());
 	}
 
-      workspace.clear();
-
-      // Perform the first integration.
-
-      auto [result0, abserr0, resabs0, resasc0]
-	= quad(func, lower, upper);
-
-      workspace.append(lower, upper, result0, abserr0);
-
-      auto tolerance = std::max(max_abs_err,
-				  max_rel_err * std::abs(result0));
-
-      // Compute roundoff tolerance.
-      const auto round_off = Tp{10} * tolerance * resabs0;
-
-      if (abserr0 <= round_off && abserr0 > tolerance)
-	throw integration_error("qags_integrate: "
-				"Cannot reach tolerance because "
-				"of roundoff error on first attempt",
-				ROUNDOFF_ERROR, result0, abserr0);
-      else if ((abserr0 <= tolerance && abserr0 != resasc0)
-		|| abserr0 == Tp{0})
-	return {result0, abserr0};
-      else if (max_iter == 1)
-	throw integration_error("qags_integrate: "
-				"A maximum of one iteration was insufficient",
-				MAX_ITER_ERROR, result0, abserr0);
-
-      extrapolation_table<AreaTp, AbsAreaTp> table;
-      table.append(result0);
-
-      auto res_ext = result0;
-      auto err_ext = s_max;
-
-      auto area = result0;
-      auto errsum = abserr0;
-      auto iteration = 1u;
-      auto ktmin = 0u;
-      auto ertest = Tp{0};
-      auto error_over_large_intervals = Tp{0};
-      auto reseps = AreaTp{0}, abseps = AbsAreaTp{0}, correc = AbsAreaTp{0};
-      int error_type = NO_ERROR, error_type2 = NO_ERROR;
-      int roundoff_type1 = 0, roundoff_type2 = 0, roundoff_type3 = 0;
+      auto& table = state.table;
+      auto& res_ext = state.res_ext;
+      auto& err_ext = state.err_ext;
+      auto& area = state.area;
+      auto& errsum = state.errsum;
+      auto& tolerance = state.tolerance;
+      auto& iteration = state.iteration;
+      auto& ktmin = state.ktmin;
+      auto& ertest = state.ertest;
+      auto& error_over_large_intervals = state.error_over_large_intervals;
+      auto& correc = state.correc;
+      auto& error_type = state.error_type;
+      auto& error_type2 = state.error_type2;
+      auto& roundoff_type1 = state.roundoff_type1;
+      auto& roundoff_type2 = state.roundoff_type2;
+      auto& roundoff_type3 = state.roundoff_type3;
+      auto& extrapolate = state.extrapolate;
+      auto& allow_extrapolation = state.allow_extrapolation;
+
+      if (iteration == 0)
+	{
+	  workspace.clear();
+
+	  // Perform the first integration.
+
+	  auto [result0, abserr0, resabs0, resasc0]
+	    = quad(counted_func, lower, upper);
+
+	  workspace.append(lower, upper, result0, abserr0);
+
+	  tolerance = std::max(max_abs_err,
+			       max_rel_err * std::abs(result0));
+
+	  // Compute roundoff tolerance.
+	  const auto round_off = Tp{10} * tolerance * resabs0;
+
+	  if (abserr0 <= round_off && abserr0 > tolerance)
+	    return {result0, abserr0, ROUNDOFF_ERROR, num_evals,
+		    "qags_integrate: Cannot reach tolerance because "
+		    "of roundoff error on first attempt"};
+	  else if ((abserr0 <= tolerance && abserr0 != resasc0)
+		    || abserr0 == Tp{0})
+	    return {result0, abserr0, NO_ERROR, num_evals};
+	  else if (max_iter == 1)
+	    return {result0, abserr0, MAX_ITER_ERROR, num_evals,
+		    "qags_integrate: A maximum of one iteration "
+		    "was insufficient"};
+
+	  table.append(result0);
+
+	  state.result0 = result0;
+	  state.resabs0 = resabs0;
+	  res_ext = result0;
+	  err_ext = s_max;
+	  area = result0;
+	  errsum = abserr0;
+	  iteration = 1;
+	}
+
+      auto reseps = decltype(state.area){0};
+      auto abseps = decltype(state.errsum){0};
       do
 	{
+	  checkpoint(std::as_const(workspace), std::as_const(state));
+
 	  // Bisect the subinterval with the largest error estimate.
 	  const auto& curr = workspace.retrieve();
 	  const auto current_depth = workspace.curr_depth() + 1;
@@ -147,10 +178,10 @@ namespace emsr
 	  ++iteration;
 
 	  auto [area1, error1, resabs1, resasc1]
-	    = quad(func, a1, mid);
+	    = quad(counted_func, a1, mid);
 
 	  auto [area2, error2, resabs2, resasc2]
-	    = quad(func, a2, b2);
+	    = quad(counted_func, a2, b2);
 
 	  const auto area12 = area1 + area2;
 	  const auto error12 = error1 + error2;
@@ -201,8 +232,7 @@ namespace emsr
 	  if (errsum <= tolerance)
 	    {
 	      const auto result = workspace.total_integral();
-	      check_error(__func__, error_type, result, errsum);
-	      return {result, errsum};
+	      return {result, errsum, error_type, num_evals};
 	    }
 
 	  if (error_type != NO_ERROR)
@@ -293,8 +323,7 @@ namespace emsr
       if (err_ext == s_max)
 	{
 	  const auto result = workspace.total_integral();
-	  check_error(__func__, error_type, result, errsum);
-	  return {result, errsum};
+	  return {result, errsum, error_type, num_evals};
 	}
 
       if (error_type != NO_ERROR || error_type2 != NO_ERROR)
@@ -310,30 +339,31 @@ namespace emsr
 	      if (err_ext / std::abs(res_ext) > errsum / std::abs(area))
 		{
 		  const auto result = workspace.total_integral();
-		  check_error(__func__, error_type, result, errsum);
-		  return {result, errsum};
+		  return {result, errsum, error_type, num_evals};
 		}
 	    }
 	  else if (err_ext > errsum)
 	    {
 	      const auto result = workspace.total_integral();
-	      check_error(__func__, error_type, result, errsum);
-	      return {result, errsum};
+	      return {result, errsum, error_type, num_evals};
 	    }
 	  else if (area == Tp{0})
 	    {
-	      check_error(__func__, error_type, result, errsum);
-	      throw std::runtime_error("qags_integrate: Unknown error.");
+	      return {result, errsum, error_type, num_evals};
 	    }
 	}
 
       // Test on divergence.
+      const auto result0 = state.result0;
+      const auto resabs0 = state.resabs0;
       auto positive_integrand = test_positivity(result0, resabs0);
       auto max_area = std::max(std::abs(res_ext), std::abs(area));
       if (!positive_integrand && max_area < Tp{0.01} * resabs0)
 	{
-	  check_error(__func__, error_type, area, errsum);
-	  throw std::runtime_error("qags_integrate: Unknown error.");
+	  if (error_type == NO_ERROR)
+	    return {area, errsum, UNKNOWN_ERROR, num_evals,
+		    "qags_integrate: Unknown error."};
+	  return {area, errsum, error_type, num_evals};
 	}
 
       auto ratio = std::abs(res_ext / area); // FIXME: Added abs for complex type issues.
@@ -341,12 +371,95 @@ namespace emsr
 	  || errsum > std::abs(area))
 	error_type = UNKNOWN_ERROR;
 
-      if (error_type == NO_ERROR)
-	return {result, abserr};
+      return {result, abserr, error_type, num_evals};
+    }
+
+  /**
+   * Adaptively integrate a potentially singular function from a to b
+   * without throwing when the tolerance is not met.
+   * The error code, the best result and error estimate found and
+   * the number of function evaluations are returned instead.
+   * Invalid tolerances still throw.
+   * The other arguments are those of the throwing overload below.
+   */
+  template<typename Tp, typename FuncTp,
+	   typename Integrator = gauss_kronrod_integral<Tp>>
+    auto
+    qags_integrate(std::nothrow_t,
+		   integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		   FuncTp func,
+		   Tp lower, Tp upper,
+		   Tp max_abs_err, Tp max_rel_err,
+		   Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_15))
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      qags_state<Tp, std::invoke_result_t<FuncTp, Tp>> state;
+      return qags_integrate(std::nothrow, workspace, func, lower, upper,
+			    max_abs_err, max_rel_err, quad, state,
+			    [](const auto&, const auto&){});
+    }
+
+  /**
+   * Adaptively integrate a potentially singular function from a to b
+   * using a recursive Gauss-Kronrod algorithm.
+   *
+   * @tparam FuncTp     A function type that takes a single real scalar
+   *                     argument and returns a real scalar.
+   * @tparam Tp         A real type for the limits of integration and the step.
+   * @tparam Integrator A non-adaptive integrator that is able to return
+   *                     an error estimate in addition to the result.
+   *
+   * @param[in] workspace The workspace that manages adaptive quadrature
+   * @param[in] func The single-variable function to be integrated
+   * @param[in] pts The sorted array of points including the integration
+   *                  limits and intermediate discontinuities/singularities
+   * @param[in] max_abs_err The limit on absolute error
+   * @param[in] max_rel_err The limit on relative error
+   * @param[in] quad The quadrature stepper taking a function object
+   *                   and two integration limits
+   */
+  template<typename Tp, typename FuncTp,
+	   typename Integrator = gauss_kronrod_integral<Tp>>
+    auto
+    qags_integrate(integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		   FuncTp func,
+		   Tp lower, Tp upper,
+		   Tp max_abs_err, Tp max_rel_err,
+		   Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_15))
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      return check_status(__func__,
+			  qags_integrate(std::nothrow, workspace, func,
+					 lower, upper,
+					 max_abs_err, max_rel_err, quad));
+    }
 
-      check_error(__func__, error_type, decltype(result)(), decltype(abserr)());
-      throw integration_error("qags_integrate: Unknown error.",
-			      UNKNOWN_ERROR, result, abserr);
+  /**
+   * Adaptively integrate a potentially singular function from a to b
+   * resuming from and checkpointing to a saved state.
+   * The callback @c checkpoint is called with the workspace and the state
+   * before each bisection.  See the non-throwing overload for details.
+   */
+  template<typename Tp, typename FuncTp, typename Integrator,
+	   typename CheckpointFunc>
+    auto
+    qags_integrate(integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		   FuncTp func,
+		   Tp lower, Tp upper,
+		   Tp max_abs_err, Tp max_rel_err,
+		   Integrator quad,
+		   qags_state<Tp, std::invoke_result_t<FuncTp, Tp>>& state,
+		   CheckpointFunc checkpoint)
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      return check_status(__func__,
+			  qags_integrate(std::nothrow, workspace, func,
+					 lower, upper,
+					 max_abs_err, max_rel_err, quad,
+					 state, checkpoint));
     }
 
   /**
@@ -358,12 +471,33 @@ namespace emsr
 			std::invoke_result_t<FuncTp, Tp>>& workspace,
 		   FuncTp func,
 		   Tp max_abs_err, Tp max_rel_err)
-    -> adaptive_integral_t<Tp, decltype(map_minf_pinf<Tp, FuncTp>(func)(Tp{}))>
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
-      using FuncTp2 = decltype(map_minf_pinf<Tp, FuncTp>(func));
-      return qags_integrate<Tp, FuncTp2>(workspace,
-				map_minf_pinf<Tp, FuncTp>(func),
-				Tp{0}, Tp{1}, max_abs_err, max_rel_err);
+      using Integrator
+	= mapped_gauss_kronrod_integral<Tp, coord_map_minf_pinf<Tp>>;
+      return qags_integrate(workspace, func, Tp{0}, Tp{1},
+			    max_abs_err, max_rel_err,
+			    Integrator(Kronrod_15, coord_map_minf_pinf<Tp>{}));
+    }
+
+  /**
+   * Integrate a potentially singular function defined over (-\infty, +\infty)
+   * without throwing when the tolerance is not met.
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    qagi_integrate(std::nothrow_t,
+		   integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		   FuncTp func,
+		   Tp max_abs_err, Tp max_rel_err)
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      using Integrator
+	= mapped_gauss_kronrod_integral<Tp, coord_map_minf_pinf<Tp>>;
+      return qags_integrate(std::nothrow, workspace, func, Tp{0}, Tp{1},
+			    max_abs_err, max_rel_err,
+			    Integrator(Kronrod_15, coord_map_minf_pinf<Tp>{}));
     }
 
   /**
@@ -384,6 +518,26 @@ namespace emsr
 				Tp{0}, Tp{1}, max_abs_err, max_rel_err);
     }
 
+  /**
+   * Integrate a potentially singular symmetric function
+   * defined over (-\infty, +\infty)
+   * without throwing when the tolerance is not met.
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    qagis_integrate(std::nothrow_t,
+		    integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		    FuncTp func,
+		    Tp max_abs_err, Tp max_rel_err)
+    -> adaptive_status_t<Tp, decltype(map_minf_pinf_symm<Tp, FuncTp>(func)(Tp{}))>
+    {
+      using FuncTp2 = decltype(map_minf_pinf_symm<Tp, FuncTp>(func));
+      return qags_integrate<Tp, FuncTp2>(std::nothrow, workspace,
+				map_minf_pinf_symm<Tp, FuncTp>(func),
+				Tp{0}, Tp{1}, max_abs_err, max_rel_err);
+    }
+
   /**
    * Integrate a potentially singular function defined over (-\infty, b].
    */
@@ -393,12 +547,33 @@ namespace emsr
 			std::invoke_result_t<FuncTp, Tp>>& workspace,
 		    FuncTp func, Tp upper,
 		    Tp max_abs_err, Tp max_rel_err)
-    -> adaptive_integral_t<Tp, decltype(map_minf_b<Tp, FuncTp>(func, upper)(Tp{}))>
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
-      using FuncTp2 = decltype(map_minf_b<Tp, FuncTp>(func, Tp{}));
-      return qags_integrate<Tp, FuncTp2>(workspace,
-				map_minf_b<Tp, FuncTp>(func, upper),
-				Tp{0}, Tp{1}, max_abs_err, max_rel_err);
+      using Integrator
+	= mapped_gauss_kronrod_integral<Tp, coord_map_minf_b<Tp>>;
+      return qags_integrate(workspace, func, Tp{0}, Tp{1},
+			    max_abs_err, max_rel_err,
+			    Integrator(Kronrod_15, coord_map_minf_b<Tp>{upper}));
+    }
+
+  /**
+   * Integrate a potentially singular function defined over (-\infty, b]
+   * without throwing when the tolerance is not met.
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    qagil_integrate(std::nothrow_t,
+		    integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		    FuncTp func, Tp upper,
+		    Tp max_abs_err, Tp max_rel_err)
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      using Integrator
+	= mapped_gauss_kronrod_integral<Tp, coord_map_minf_b<Tp>>;
+      return qags_integrate(std::nothrow, workspace, func, Tp{0}, Tp{1},
+			    max_abs_err, max_rel_err,
+			    Integrator(Kronrod_15, coord_map_minf_b<Tp>{upper}));
     }
 
   /**
@@ -410,12 +585,33 @@ namespace emsr
 			std::invoke_result_t<FuncTp, Tp>>& workspace,
 		    FuncTp func, Tp lower,
 		    Tp max_abs_err, Tp max_rel_err)
-    -> adaptive_integral_t<Tp, decltype(map_a_pinf<Tp, FuncTp>(func, lower)(Tp{}))>
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
-      using FuncTp2 = decltype(map_a_pinf<Tp, FuncTp>(func, Tp{}));
-      return qags_integrate<Tp, FuncTp2>(workspace,
-				map_a_pinf<Tp, FuncTp>(func, lower),
-				Tp{0}, Tp{1}, max_abs_err, max_rel_err);
+      using Integrator
+	= mapped_gauss_kronrod_integral<Tp, coord_map_a_pinf<Tp>>;
+      return qags_integrate(workspace, func, Tp{0}, Tp{1},
+			    max_abs_err, max_rel_err,
+			    Integrator(Kronrod_15, coord_map_a_pinf<Tp>{lower}));
+    }
+
+  /**
+   * Integrate a potentially singular function defined over [a, +\infty)
+   * without throwing when the tolerance is not met.
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    qagiu_integrate(std::nothrow_t,
+		    integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		    FuncTp func, Tp lower,
+		    Tp max_abs_err, Tp max_rel_err)
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      using Integrator
+	= mapped_gauss_kronrod_integral<Tp, coord_map_a_pinf<Tp>>;
+      return qags_integrate(std::nothrow, workspace, func, Tp{0}, Tp{1},
+			    max_abs_err, max_rel_err,
+			    Integrator(Kronrod_15, coord_map_a_pinf<Tp>{lower}));
     }
 
 } // namespace emsr
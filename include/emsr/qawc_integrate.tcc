@@ -26,6 +26,7 @@
 #ifndef QAWC_INTEGRATE_TCC
 #define QAWC_INTEGRATE_TCC 1
 
+#include <new>
 #include <stdexcept>
 #include <type_traits>
 #include <array>
@@ -45,32 +46,33 @@ namespace emsr
     compute_moments(std::size_t N, Tp cc);
 
   /**
-   * Adaptive integration for Cauchy principal values:
-   * @f[
-   *   I = \int_a^b dx f(x) / (x - c)
-   * @f]
-   * The adaptive bisection algorithm of QAG is used, with modifications
-   * to ensure that subdivisions do not occur at the singular point x = c.
-   * When a subinterval contains the point x = c or is close to it then
-   * a special 25-point modified Clenshaw-Curtis rule is used to control
-   * the singularity. Further away from the singularity the algorithm uses
-   * a user-supplied integration rule (default 15-point Gauss-Kronrod). 
+   * Adaptive integration for Cauchy principal values without throwing
+   * when the tolerance is not met.
+   * The error code, the best result and error estimate found and
+   * the number of function evaluations are returned instead.
+   * Invalid arguments still throw.
+   * The other arguments are those of the throwing overload below.
    */
   template<typename Tp, typename FuncTp,
 	   typename Integrator = gauss_kronrod_integral<Tp>>
     auto
-    qawc_integrate(integration_workspace<Tp,
+    qawc_integrate(std::nothrow_t,
+		   integration_workspace<Tp,
 			std::invoke_result_t<FuncTp, Tp>>& workspace,
 		   FuncTp func,
 		   Tp lower, Tp upper, Tp center,
 		   Tp max_abs_err, Tp max_rel_err,
 		   Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_15))
-    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
       using RetTp = std::invoke_result_t<FuncTp, Tp>;
       using AreaTp = decltype(RetTp{} * Tp{});
       using AbsAreaTp = decltype(std::abs(AreaTp{}));
 
+      std::size_t num_evals = 0;
+      auto counted_func = [&func, &num_evals](Tp x)
+			  { ++num_evals; return func(x); };
+
       auto result = AreaTp{};
       auto abserr = AbsAreaTp{};
 
@@ -104,7 +106,7 @@ namespace emsr
 
       // Perform the first integration.
       auto [result0, abserr0, err_reliable]
-	= qc25c(func, lower, upper, center, quad);
+	= qc25c(counted_func, lower, upper, center, quad);
 
       workspace.append(lower, upper, result0, abserr0);
 
@@ -114,11 +116,10 @@ namespace emsr
 				  max_rel_err * std::abs( result0));
       if (abserr0 < tolerance && abserr0
 	  < Tp{0.01} * std::abs(result0))
-	return {sign * result0, abserr0};
+	return {sign * result0, abserr0, NO_ERROR, num_evals};
       else if (limit == 1)
-	throw integration_error("qawc_integrate: "
-				"A maximum of one iteration was insufficient",
-				MAX_ITER_ERROR, sign * result0, abserr0);
+	return {sign * result0, abserr0, MAX_ITER_ERROR, num_evals,
+		"qawc_integrate: A maximum of one iteration was insufficient"};
 
       auto area = result0;
       auto errsum = abserr0;
@@ -140,10 +141,10 @@ namespace emsr
 	  const auto a2 = mid;
 
 	  auto [area1, error1, err_reliable1]
-	    = qc25c(func, a1, mid, center, quad);
+	    = qc25c(counted_func, a1, mid, center, quad);
 
 	  auto [area2, error2, err_reliable2]
-	    = qc25c(func, a2, b2, center, quad);
+	    = qc25c(counted_func, a2, b2, center, quad);
 
 	  const auto area12 = area1 + area2;
 	  const auto error12 = error1 + error2;
@@ -187,14 +188,38 @@ namespace emsr
 	error_type = MAX_SUBDIV_ERROR;
 
       if (errsum <= tolerance)
-	return {result, abserr};
+	return {result, abserr, NO_ERROR, num_evals};
 
-      if (error_type == NO_ERROR)
-	return {result, abserr};
+      return {result, abserr, error_type, num_evals};
+    }
 
-      check_error(__func__, error_type, result, abserr);
-      throw integration_error("qawc_integrate: Unknown error.",
-			      UNKNOWN_ERROR, result, abserr);
+  /**
+   * Adaptive integration for Cauchy principal values:
+   * @f[
+   *   I = \int_a^b dx f(x) / (x - c)
+   * @f]
+   * The adaptive bisection algorithm of QAG is used, with modifications
+   * to ensure that subdivisions do not occur at the singular point x = c.
+   * When a subinterval contains the point x = c or is close to it then
+   * a special 25-point modified Clenshaw-Curtis rule is used to control
+   * the singularity. Further away from the singularity the algorithm uses
+   * a user-supplied integration rule (default 15-point Gauss-Kronrod). 
+   */
+  template<typename Tp, typename FuncTp,
+	   typename Integrator = gauss_kronrod_integral<Tp>>
+    auto
+    qawc_integrate(integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		   FuncTp func,
+		   Tp lower, Tp upper, Tp center,
+		   Tp max_abs_err, Tp max_rel_err,
+		   Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_15))
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      return check_status(__func__,
+			  qawc_integrate(std::nothrow, workspace, func,
+					 lower, upper, center,
+					 max_abs_err, max_rel_err, quad));
     }
 
   /**
@@ -210,7 +235,7 @@ namespace emsr
    * a user-supplied integration rule. 
    */
   template<typename Tp, typename FuncTp,
-	   typename Integrator = gauss_kronrod_integral<Tp>>
+	   typename Integrator>
     auto
     qc25c(FuncTp func, Tp lower, Tp upper, Tp center,
 	  Integrator quad)
@@ -26,6 +26,7 @@
 #ifndef QAWF_INTEGRATE_TCC
 #define QAWF_INTEGRATE_TCC 1
 
+#include <new>
 #include <stdexcept>
 #include <type_traits>
 #include <cmath>
@@ -38,22 +39,29 @@ namespace emsr
 
   /**
    * This function attempts to compute a Fourier integral of the function f
-   * over the semi-infinite interval [a,+\infty)
+   * over the semi-infinite interval [a,+\infty) without throwing
+   * when the tolerance is not met.
+   * The error code, the best result and error estimate found and
+   * the number of function evaluations are returned instead.
+   * A cycle that misses its tolerance loosens the tolerance
+   * of the following cycles as in QUADPACK.
    */
   template<typename Tp, typename FuncTp>
     auto
-    qawf_integrate(integration_workspace<Tp,
+    qawf_integrate(std::nothrow_t,
+		   integration_workspace<Tp,
 			std::invoke_result_t<FuncTp, Tp>>& workspace,
 		   integration_workspace<Tp,
 			std::invoke_result_t<FuncTp, Tp>>& cycle_workspace,
 		   oscillatory_integration_table<Tp>& wf,
 		   FuncTp func,
 		   Tp lower, Tp max_abs_err)
-    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
       using AreaTp = std::invoke_result_t<FuncTp, Tp>;
       using AbsAreaTp = decltype(std::abs(AreaTp{}));
 
+      std::size_t num_evals = 0;
       std::size_t ktmin = 0;
       std::size_t iteration = 0;
 
@@ -86,11 +94,11 @@ namespace emsr
 	{
 	  if (wf.circfun == oscillatory_integration_table<Tp>::INTEG_SINE)
 	    // The function sin(w x) f(x) is always zero for w = 0.
-	    return {Tp{0}, Tp{0}};
+	    return {Tp{0}, Tp{0}, NO_ERROR, 0};
 	  else
 	    // The function cos(w x) f(x) is always f(x) for w = 0.
-	    return qagiu_integrate(cycle_workspace, func, lower, max_abs_err,
-				   Tp{0});
+	    return qagiu_integrate(std::nothrow, cycle_workspace, func, lower,
+				   max_abs_err, Tp{0});
 	}
 
       if (max_abs_err * (Tp{1} - p) > std::numeric_limits<Tp>::min())
@@ -120,10 +128,12 @@ namespace emsr
 
 	  const auto max_abs_err1 = eps * factor;
 
-	  auto out1 = qawo_integrate(cycle_workspace, wf, func, a1,
-			     max_abs_err1, Tp{0});
+	  auto out1 = qawo_integrate(std::nothrow, cycle_workspace, wf, func,
+				     a1, max_abs_err1, Tp{0});
 	  auto area1 = out1.result;
 	  auto error1 = out1.abserr;
+	  num_evals += out1.num_evals;
+	  status = out1.error_code;
 
 	  workspace.append(a1, b1, area1, error1);
 
@@ -184,7 +194,7 @@ namespace emsr
       abserr = err_ext;
 
       if (error_type == NO_ERROR)
-	return {result, abserr};
+	return {result, abserr, NO_ERROR, num_evals};
 
       if (res_ext != Tp{0} && area != Tp{0})
 	{
@@ -207,13 +217,32 @@ namespace emsr
       abserr = total_error;
 
       if (error_type == NO_ERROR)
-	return {result, abserr};
+	return {result, abserr, NO_ERROR, num_evals};
 
     return_error:
 
-      check_error(__func__, error_type, result, abserr);
-      throw integration_error("qawf_integrate: Unknown error.", UNKNOWN_ERROR,
-			      result, abserr);
+      return {result, abserr, error_type, num_evals};
+    }
+
+  /**
+   * This function attempts to compute a Fourier integral of the function f
+   * over the semi-infinite interval [a,+\infty)
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    qawf_integrate(integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		   integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& cycle_workspace,
+		   oscillatory_integration_table<Tp>& wf,
+		   FuncTp func,
+		   Tp lower, Tp max_abs_err)
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      return check_status(__func__,
+			  qawf_integrate(std::nothrow, workspace,
+					 cycle_workspace, wf, func,
+					 lower, max_abs_err));
     }
 
 } // namespace emsr
@@ -26,6 +26,7 @@
 #ifndef QAWO_INTEGRATE_TCC
 #define QAWO_INTEGRATE_TCC 1
 
+#include <new>
 #include <stdexcept>
 #include <type_traits>
 #include <cmath>
@@ -42,19 +43,33 @@ namespace emsr
 	  std::size_t depth)
     -> gauss_kronrod_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
 
+  /**
+   * Adaptively integrate a function with an oscillatory weight
+   * @f$ \sin(\omega x) @f$ or @f$ \cos(\omega x) @f$ from the table
+   * @c wf over [lower, lower + L] where L is the length of the table
+   * without throwing when the tolerance is not met.
+   * The error code, the best result and error estimate found and
+   * the number of function evaluations are returned instead.
+   * Invalid tolerances still throw.
+   */
   template<typename Tp, typename FuncTp>
     auto
-    qawo_integrate(integration_workspace<Tp,
+    qawo_integrate(std::nothrow_t,
+		   integration_workspace<Tp,
 			std::invoke_result_t<FuncTp, Tp>>& workspace,
 		   oscillatory_integration_table<Tp>& wf,
 		   FuncTp func,
 		   const Tp lower,
 		   const Tp max_abs_err, const Tp max_rel_err)
-    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
       using AreaTp = std::invoke_result_t<FuncTp, Tp>;
       using AbsAreaTp = decltype(std::abs(AreaTp{}));
 
+      std::size_t num_evals = 0;
+      auto counted_func = [&func, &num_evals](Tp x)
+			  { ++num_evals; return func(x); };
+
       const auto s_max = std::numeric_limits<Tp>::max();
       const auto s_eps = std::numeric_limits<Tp>::epsilon();
       const auto limit = workspace.capacity();
@@ -87,7 +102,7 @@ namespace emsr
 
       // Perform the first integration.
       auto [result0, abserr0, resabs0, resasc0]
-	= qc25f(wf, func, lower, upper, 0);
+	= qc25f(wf, counted_func, lower, upper, 0);
 
       workspace.append(lower, upper, result0, abserr0);
 
@@ -96,17 +111,15 @@ namespace emsr
 
       if (abserr0 <= Tp{100} * s_eps * resabs0
 	  && abserr0 > tolerance)
-	throw integration_error("qawo_integrate: "
-				"Cannot reach tolerance because "
-				"of roundoff error on first attempt",
-				ROUNDOFF_ERROR, result0, abserr0);
+	return {result0, abserr0, ROUNDOFF_ERROR, num_evals,
+		"qawo_integrate: Cannot reach tolerance because "
+		"of roundoff error on first attempt"};
       else if ((abserr0 <= tolerance && abserr0 != resasc0)
 		|| abserr0 == Tp{0})
-	return {result0, abserr0};
+	return {result0, abserr0, NO_ERROR, num_evals};
       else if (limit == 1)
-	throw integration_error("qawo_integrate: "
-				"A maximum of one iteration was insufficient",
-				MAX_ITER_ERROR, result0, abserr0);
+	return {result0, abserr0, MAX_ITER_ERROR, num_evals,
+		"qawo_integrate: A maximum of one iteration was insufficient"};
 
       if (0.5 * abs_omega * std::abs(upper - lower) <= Tp{2})
 	{
@@ -147,10 +160,10 @@ namespace emsr
 	  ++iteration;
 
 	  auto [area1, error1, resabs1, resasc1]
-	    = qc25f(wf, func, a1, mid, current_depth);
+	    = qc25f(wf, counted_func, a1, mid, current_depth);
 
 	  auto [area2, error2, resabs2, resasc2]
-	    = qc25f(wf, func, a2, b2, current_depth);
+	    = qc25f(wf, counted_func, a2, b2, current_depth);
 
 	  const auto area12 = area1 + area2;
 	  const auto error12 = error1 + error2;
@@ -201,8 +214,7 @@ namespace emsr
 	    {
 	      result = workspace.total_integral();
 	      abserr = errsum;
-	      check_error(__func__, error_type, result, abserr);
-	      return {result, abserr};
+	      return {result, abserr, error_type, num_evals};
 	    }
 
 	  if (error_type != NO_ERROR)
@@ -319,8 +331,7 @@ namespace emsr
 	{
 	  result = workspace.total_integral();
 	  abserr = errsum;
-	  check_error(__func__, error_type, result, abserr);
-	  return {result, abserr};
+	  return {result, abserr, error_type, num_evals};
 	}
 
       if (error_type != NO_ERROR || error_type2 != NO_ERROR)
@@ -337,21 +348,18 @@ namespace emsr
 		{
 		  result = workspace.total_integral();
 		  abserr = errsum;
-		  check_error(__func__, error_type, result, abserr);
-		  return {result, abserr};
+		  return {result, abserr, error_type, num_evals};
 		}
 	    }
 	  else if (err_ext > errsum)
 	    {
 	      result = workspace.total_integral();
 	      abserr = errsum;
-	      check_error(__func__, error_type, result, abserr);
-	      return {result, abserr};
+	      return {result, abserr, error_type, num_evals};
 	    }
 	  else if (area == Tp{0})
 	    {
-	      check_error(__func__, error_type, result, abserr);
-	      return {result, abserr};
+	      return {result, abserr, error_type, num_evals};
 	    }
 	}
 
@@ -360,8 +368,7 @@ namespace emsr
       auto max_area = std::max(std::abs(res_ext), std::abs(area));
       if (!positive_integrand && max_area < Tp{0.01} * resabs0)
 	{
-	  check_error(__func__, error_type, result, abserr);
-	  return {result, abserr};
+	  return {result, abserr, error_type, num_evals};
 	}
 
       auto ratio = res_ext / area;
@@ -369,11 +376,30 @@ namespace emsr
 	  || errsum > std::abs(area))
 	error_type = UNKNOWN_ERROR;
 
-      check_error(__func__, error_type, result, abserr);
-      return {result, abserr};
+      return {result, abserr, error_type, num_evals};
     }
 
 
+  /**
+   * Adaptively integrate a function with an oscillatory weight
+   * @f$ \sin(\omega x) @f$ or @f$ \cos(\omega x) @f$ from the table
+   * @c wf over [lower, lower + L] where L is the length of the table.
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    qawo_integrate(integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		   oscillatory_integration_table<Tp>& wf,
+		   FuncTp func,
+		   const Tp lower,
+		   const Tp max_abs_err, const Tp max_rel_err)
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      return check_status(__func__,
+			  qawo_integrate(std::nothrow, workspace, wf, func,
+					 lower, max_abs_err, max_rel_err));
+    }
+
   template<typename Tp, typename FuncTp>
     auto
     qc25f(oscillatory_integration_table<Tp>& wf,
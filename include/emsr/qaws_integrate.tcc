@@ -26,6 +26,7 @@
 #ifndef QAWS_INTEGRATE_TCC
 #define QAWS_INTEGRATE_TCC 1
 
+#include <new>
 #include <stdexcept>
 #include <type_traits>
 #include <array>
@@ -61,40 +62,31 @@ namespace emsr
 	  Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_15));
 
   /**
-   * The singular weight function is defined by:
-   * @f[
-   *    W(x) = (x-a)^\alpha (b-x)^\beta log^\mu (x-a) log^\nu (b-x)
-   * @f]
-   * where @f$ \alpha > -1 @f$, @f$ \beta > -1 @f$,
-   * and @f$ \mu = 0 @f$, 1, @f$ \nu = 0, 1 @f$.
-   *
-   * The weight function can take four different forms depending
-   * on the values of \mu and \nu,
-   * @f[
-   *    W(x) = (x-a)^\alpha (b-x)^\beta                   (\mu = 0, \nu = 0)
-   *    W(x) = (x-a)^\alpha (b-x)^\beta log(x-a)          (\mu = 1, \nu = 0)
-   *    W(x) = (x-a)^\alpha (b-x)^\beta log(b-x)          (\mu = 0, \nu = 1)
-   *    W(x) = (x-a)^\alpha (b-x)^\beta log(x-a) log(b-x) (\mu = 1, \nu = 1)
-   * @f]
-   *
-   * The QAWS algorithm is designed for integrands with algebraic-logarithmic
-   * singularities at the end-points of an integration region.
-   *
-   * In order to work efficiently the algorithm requires a precomputed table
-   * of Chebyshev moments.
+   * Adaptively integrate a function with the algebraic-logarithmic
+   * endpoint weight of the table without throwing when the tolerance
+   * is not met.
+   * The error code, the best result and error estimate found and
+   * the number of function evaluations are returned instead.
+   * Invalid arguments still throw.
+   * The other arguments are those of the throwing overload below.
    */
   template<typename Tp, typename FuncTp,
 	   typename Integrator = gauss_kronrod_integral<Tp>>
     auto
-    qaws_integrate(integration_workspace<Tp,
+    qaws_integrate(std::nothrow_t,
+		   integration_workspace<Tp,
 			std::invoke_result_t<FuncTp, Tp>>& workspace,
 		   qaws_integration_table<Tp>& table,
 		   FuncTp func,
 		   Tp lower, Tp upper,
 		   Tp max_abs_err, Tp max_rel_err,
 		   Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_15))
-    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    -> adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
     {
+      std::size_t num_evals = 0;
+      auto counted_func = [&func, &num_evals](Tp x)
+			  { ++num_evals; return func(x); };
+
       // Try to adjust tests for varing precision.
       const auto m_rel_err = std::pow(Tp{10},
 				 -std::numeric_limits<Tp>::digits / Tp{10});
@@ -122,11 +114,11 @@ namespace emsr
 	const auto b2 = upper;
 
         auto [area1, error1, err_reliable1]
-	  = qc25s(table, func, lower, upper, a1, mid, quad);
+	  = qc25s(table, counted_func, lower, upper, a1, mid, quad);
 	workspace.append(a1, mid, area1, error1);
 
 	auto [area2, error2, err_reliable2]
-	  = qc25s(table, func, lower, upper, mid, b2, quad);
+	  = qc25s(table, counted_func, lower, upper, mid, b2, quad);
 	workspace.append(mid, b2, area2, error2);
 
 	result0 = area1 + area2;
@@ -138,11 +130,10 @@ namespace emsr
       auto tolerance = std::max(max_abs_err, max_rel_err * std::abs(result0));
       if (abserr0 < tolerance && abserr0
 	  < Tp{0.01} * std::abs(result0))
-	return {result0, abserr0};
+	return {result0, abserr0, NO_ERROR, num_evals};
       else if (limit == 1)
-	throw integration_error("qaws_integrate: "
-				"A maximum of one iteration was insufficient",
-				MAX_ITER_ERROR, result0, abserr0);
+	return {result0, abserr0, MAX_ITER_ERROR, num_evals,
+		"qaws_integrate: A maximum of one iteration was insufficient"};
 
       auto area = result0;
       auto errsum = abserr0;
@@ -159,10 +150,10 @@ namespace emsr
 	  const auto b2 = curr.upper_lim;
 
 	  auto [area1, error1, err_reliable1]
-	    = qc25s(table, func, lower, upper, a1, mid, quad);
+	    = qc25s(table, counted_func, lower, upper, a1, mid, quad);
 
 	  auto [area2, error2, err_reliable2]
-	    = qc25s(table, func, lower, upper, mid, b2, quad);
+	    = qc25s(table, counted_func, lower, upper, mid, b2, quad);
 
 	  const auto area12 = area1 + area2;
 	  const auto error12 = error1 + error2;
@@ -206,21 +197,57 @@ namespace emsr
 	error_type = MAX_SUBDIV_ERROR;
 
       if (errsum <= tolerance)
-	return {result, abserr};
+	return {result, abserr, NO_ERROR, num_evals};
 
-      if (error_type == NO_ERROR)
-	return {result, abserr};
-
-      check_error(__func__, error_type, result, abserr);
-      throw integration_error("qaws_integrate: Unknown error.",
-			      UNKNOWN_ERROR, result, abserr);
+      return {result, abserr, error_type, num_evals};
     }
 
   /**
+   * The singular weight function is defined by:
+   * @f[
+   *    W(x) = (x-a)^\alpha (b-x)^\beta log^\mu (x-a) log^\nu (b-x)
+   * @f]
+   * where @f$ \alpha > -1 @f$, @f$ \beta > -1 @f$,
+   * and @f$ \mu = 0 @f$, 1, @f$ \nu = 0, 1 @f$.
    *
+   * The weight function can take four different forms depending
+   * on the values of \mu and \nu,
+   * @f[
+   *    W(x) = (x-a)^\alpha (b-x)^\beta                   (\mu = 0, \nu = 0)
+   *    W(x) = (x-a)^\alpha (b-x)^\beta log(x-a)          (\mu = 1, \nu = 0)
+   *    W(x) = (x-a)^\alpha (b-x)^\beta log(b-x)          (\mu = 0, \nu = 1)
+   *    W(x) = (x-a)^\alpha (b-x)^\beta log(x-a) log(b-x) (\mu = 1, \nu = 1)
+   * @f]
+   *
+   * The QAWS algorithm is designed for integrands with algebraic-logarithmic
+   * singularities at the end-points of an integration region.
+   *
+   * In order to work efficiently the algorithm requires a precomputed table
+   * of Chebyshev moments.
    */
   template<typename Tp, typename FuncTp,
 	   typename Integrator = gauss_kronrod_integral<Tp>>
+    auto
+    qaws_integrate(integration_workspace<Tp,
+			std::invoke_result_t<FuncTp, Tp>>& workspace,
+		   qaws_integration_table<Tp>& table,
+		   FuncTp func,
+		   Tp lower, Tp upper,
+		   Tp max_abs_err, Tp max_rel_err,
+		   Integrator quad = gauss_kronrod_integral<Tp>(Kronrod_15))
+    -> adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      return check_status(__func__,
+			  qaws_integrate(std::nothrow, workspace, table, func,
+					 lower, upper,
+					 max_abs_err, max_rel_err, quad));
+    }
+
+  /**
+   *
+   */
+  template<typename Tp, typename FuncTp,
+	   typename Integrator>
     std::tuple<Tp, Tp, bool>
     qc25s(qaws_integration_table<Tp>& t,
 	  FuncTp func, Tp lower, Tp upper, Tp a1, Tp b1,
@@ -22,6 +22,10 @@
 
 #include <type_traits>
 #include <array>
+#include <stdexcept>
+#include <vector>
+
+#include <emsr/fourier_transform.h>
 
 namespace emsr
 {
@@ -246,6 +250,48 @@ namespace emsr
       return out;
     }
 
+  /**
+   * Return the coefficients @f$ c_k @f$, @f$ k = 0, ..., n @f$,
+   * of the Chebyshev interpolant
+   * @f[
+   *    f(x) \approx \sum_{k=0}^{n} c_k T_k(t),
+   *    \quad x = \frac{a + b}{2} + \frac{b - a}{2} t
+   * @f]
+   * of a real function at the @c n + 1 Clenshaw-Curtis nodes
+   * @f$ t_j = \cos(j\pi/n) @f$.
+   * The convention is that of qcheb_integrate which returns the cases
+   * @c n = 12 and @c n = 24; here any degree costs one DCT-I,
+   * @f$ O(n \log n) @f$, rather than the cosine sums.
+   */
+  template<typename Tp, typename FuncTp>
+    std::vector<Tp>
+    chebyshev_coefficients(FuncTp func, Tp lower, Tp upper, std::size_t n)
+    {
+      if (n == 0)
+	throw std::domain_error("chebyshev_coefficients: "
+				"Degree must be positive.");
+
+      const auto center = (lower + upper) / Tp{2};
+      const auto half_length = (upper - lower) / Tp{2};
+
+      std::vector<Tp> cheb(n + 1);
+      cheb[0] = Tp(func(upper));
+      for (std::size_t j = 1; j < n; ++j)
+	cheb[j] = Tp(func(center + half_length
+			  * detail::clenshaw_curtis_node<Tp>(j, n)));
+      cheb[n] = Tp(func(lower));
+
+      fast_cosine_transform_1(cheb);
+
+      const auto norm = Tp{2} / Tp(n);
+      for (auto& c : cheb)
+	c *= norm;
+      cheb[0] /= Tp{2};
+      cheb[n] /= Tp{2};
+
+      return cheb;
+    }
+
 } // namespace emsr
 
 #endif // QCHEB_INTEGRATE_TCC
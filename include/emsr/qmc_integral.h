@@ -0,0 +1,372 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements randomized quasi-Monte Carlo integration over boxes.
+
+#ifndef QMC_INTEGRAL_H
+#define QMC_INTEGRAL_H 1
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new> // For std::nothrow
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <emsr/integration.h>
+
+namespace emsr
+{
+
+  /**
+   * The Sobol sequence in base 2 with 32-bit integer coordinates.
+   *
+   * Point @c k is the point of Gray code rank @c k so consecutive points
+   * differ by one direction number per coordinate (Antonov and Saleev).
+   * Every aligned run of @f$ 2^m @f$ points is a permutation of the first
+   * @f$ 2^m @f$ points of the sequence in natural order.
+   *
+   * The first 37 coordinates use the primitive polynomials and initial
+   * direction numbers of S. Joe and F. Y. Kuo, Constructing Sobol
+   * sequences with better two-dimensional projections, SIAM J. Sci.
+   * Comput. 30 (2008), 2635-2654.  Further coordinates take the next
+   * primitive polynomials in order of degree and odd initial direction
+   * numbers from a fixed pseudo-random stream; they are still
+   * a valid (t,s)-sequence but their projections are not optimized.
+   */
+  class sobol_sequence
+  {
+  public:
+
+    /// The number of bits of each coordinate.
+    static constexpr int s_num_bits = 32;
+
+    /// The number of coordinates with tabulated direction numbers.
+    static constexpr std::size_t s_num_tabulated = 37;
+
+    /// Build the direction numbers of the first @c dim coordinates.
+    explicit sobol_sequence(std::size_t dim);
+
+    /// Return the number of coordinates.
+    std::size_t
+    dim() const
+    { return this->m_dim; }
+
+    /**
+     * Write the integer coordinates of point @c k into @c x;
+     * the coordinate @c j of the point in [0,1) is @f$ x_j / 2^{32} @f$.
+     */
+    void
+    point(std::uint64_t k, std::uint32_t* x) const;
+
+    /**
+     * Advance the integer coordinates of point @c k in @c x
+     * to those of point @c k + 1.
+     */
+    void
+    next(std::uint64_t k, std::uint32_t* x) const;
+
+    /// Return the direction number of coordinate @c j for bit @c b.
+    std::uint32_t
+    direction(std::size_t j, int b) const
+    { return this->m_direction[j * s_num_bits + b]; }
+
+  private:
+
+    std::size_t m_dim;
+    std::vector<std::uint32_t> m_direction;
+  };
+
+  /**
+   * An extensible rank-1 lattice sequence in base 2.
+   *
+   * Point @c k has the integer coordinates
+   * @f$ x_j = \phi_2(k) z_j \bmod 2^{32} @f$ where @f$ \phi_2(k) @f$
+   * reverses the 32 bits of @c k so the first @f$ 2^m @f$ points
+   * are the lattice rule @f$ \{ i z / 2^m \} @f$.
+   *
+   * The generating vector is of Korobov form @f$ z_j = a^j \bmod 2^m @f$
+   * with @c a chosen among a spread of candidates to minimize the
+   * worst-case error @f$ P_2 @f$ in the weighted Korobov space
+   * with product weights @f$ \gamma_j = 1 / j^2 @f$ for @f$ 2^m @f$ points.
+   * The search costs @f$ O(2^m \cdot dim) @f$ per candidate so @c m
+   * should be modest; the sequence may be used beyond @f$ 2^m @f$ points.
+   */
+  class rank1_lattice
+  {
+  public:
+
+    /// The number of Korobov candidates searched.
+    static constexpr int s_num_candidates = 128;
+
+    /**
+     * Search for a generating vector of @c dim coordinates
+     * for @f$ 2^{log2\_points} @f$ points.
+     */
+    explicit rank1_lattice(std::size_t dim, int log2_points = 14);
+
+    /// Build a lattice from a given generating vector.
+    explicit rank1_lattice(std::vector<std::uint32_t> generator);
+
+    /// Return the number of coordinates.
+    std::size_t
+    dim() const
+    { return this->m_generator.size(); }
+
+    /// Return the generating vector.
+    const std::vector<std::uint32_t>&
+    generator() const
+    { return this->m_generator; }
+
+    /**
+     * Write the integer coordinates of point @c k into @c x;
+     * the coordinate @c j of the point in [0,1) is @f$ x_j / 2^{32} @f$.
+     */
+    void
+    point(std::uint64_t k, std::uint32_t* x) const;
+
+    /**
+     * Return the worst-case error @f$ P_2 @f$ of the first
+     * @f$ 2^{log2\_points} @f$ points with weights @f$ \gamma_j = 1 / j^2 @f$.
+     */
+    double
+    figure_of_merit(int log2_points) const;
+
+  private:
+
+    std::vector<std::uint32_t> m_generator;
+  };
+
+  /**
+   * Return the rank-1 lattice of @c dim coordinates searched
+   * for @f$ 2^{log2\_points} @f$ points.  The search is run once
+   * per dimension and number of points and the lattice is shared.
+   */
+  std::shared_ptr<const rank1_lattice>
+  cached_rank1_lattice(std::size_t dim, int log2_points = 14);
+
+  /**
+   * The low-discrepancy sequences available for QMC integration.
+   */
+  enum qmc_sequence_kind
+  {
+    /// The Sobol sequence with random digital shifts.
+    QMC_Sobol,
+    /// The rank-1 lattice sequence with random shifts modulo one.
+    QMC_Lattice
+  };
+
+  namespace detail
+  {
+    /**
+     * The value type of a QMC integrand: the return type of a function
+     * of a point or @c Tp for a batched integrand.
+     */
+    template<typename Tp, std::size_t Dim, typename FuncTp,
+	     bool = std::is_invocable_v<FuncTp, const std::array<Tp, Dim>&>>
+      struct qmc_value
+      { using type = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>; };
+
+    template<typename Tp, std::size_t Dim, typename FuncTp>
+      struct qmc_value<Tp, Dim, FuncTp, false>
+      { using type = Tp; };
+
+    template<typename Tp, std::size_t Dim, typename FuncTp>
+      using qmc_value_t = typename qmc_value<Tp, Dim, FuncTp>::type;
+  } // namespace detail
+
+  /**
+   * Randomized quasi-Monte Carlo integration over a box.
+   *
+   * The integral is estimated by @c num_shifts independently
+   * randomized copies of a low-discrepancy sequence: random digital
+   * shifts of the Sobol sequence or random shifts modulo one
+   * of the lattice sequence.  Each copy gives an unbiased estimate;
+   * their mean is the result and their standard error is the error
+   * estimate.  This is a one-sigma statistical estimate,
+   * not a bound.  The shifts are drawn from a generator seeded
+   * with @c seed so results are reproducible.
+   *
+   * The integrand is either a function of a point,
+   * @code
+   *   RetTp func(const std::array<Tp, Dim>& x);
+   * @endcode
+   * or a batched real-valued function
+   * @code
+   *   void func(std::span<const std::array<Tp, Dim>> x, std::span<Tp> f);
+   * @endcode
+   * writing @c f[i] for each @c x[i].  Batches hold the points
+   * of one block of @c s_block_size consecutive indices
+   * of one shifted copy.
+   *
+   * The index range is cut into these blocks whatever
+   * the number of threads.  Blocks are evaluated on
+   * @c num_threads threads (0 means hardware concurrency)
+   * and their sums are added in index order so results
+   * do not depend on the number of threads.
+   */
+  template<typename Tp, std::size_t Dim>
+    class qmc_integral
+    {
+      static_assert(Dim >= 1, "qmc_integral: Dimension must be positive.");
+
+    public:
+
+      /// The number of consecutive points of a work block.
+      static constexpr std::size_t s_block_size = 1024;
+
+      /**
+       * Build the integrator.
+       * The lattice generating vector is taken from cached_rank1_lattice
+       * so the search runs once per dimension.
+       *
+       * @param kind The low-discrepancy sequence.
+       * @param num_shifts The number of randomized copies (at least 2).
+       * @param seed The seed of the random shifts.
+       */
+      explicit qmc_integral(qmc_sequence_kind kind = QMC_Sobol,
+			    std::size_t num_shifts = 16,
+			    std::uint64_t seed = 0);
+
+      /**
+       * Integrate over the box [lower, upper] with @c num_points points
+       * in each shifted copy, rounded up to a power of two.
+       *
+       * @param func The integrand.
+       * @param lower The lower corner of the box.
+       * @param upper The upper corner of the box.
+       * @param num_points The number of points of each copy.
+       * @param num_threads The number of threads.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(FuncTp func,
+		  const std::array<Tp, Dim>& lower,
+		  const std::array<Tp, Dim>& upper,
+		  std::size_t num_points,
+		  unsigned int num_threads = 1) const
+	-> adaptive_integral_t<Tp, detail::qmc_value_t<Tp, Dim, FuncTp>>;
+
+      /**
+       * Integrate over the box [lower, upper] doubling the number
+       * of points of each copy until the standard error meets
+       * the tolerance.  Points already evaluated are kept.
+       *
+       * @param func The integrand.
+       * @param lower The lower corner of the box.
+       * @param upper The upper corner of the box.
+       * @param max_abs_err The limit on absolute error.
+       * @param max_rel_err The limit on relative error.
+       * @param max_evals The maximum number of function evaluations
+       *                  over all copies.
+       * @param num_threads The number of threads.
+       *
+       * This overload does not throw when the tolerance is not met
+       * within the evaluation budget; the error code, the best result
+       * and error estimate found and the number of function evaluations
+       * are returned instead.  Invalid tolerances still throw.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(std::nothrow_t, FuncTp func,
+		  const std::array<Tp, Dim>& lower,
+		  const std::array<Tp, Dim>& upper,
+		  Tp max_abs_err, Tp max_rel_err,
+		  std::size_t max_evals,
+		  unsigned int num_threads = 1) const
+	-> adaptive_status_t<Tp, detail::qmc_value_t<Tp, Dim, FuncTp>>;
+
+      /**
+       * Integrate over the box [lower, upper] to a tolerance.
+       * An integration_error is thrown if the tolerance is not met.
+       * The arguments are those of the non-throwing overload.
+       */
+      template<typename FuncTp>
+	auto
+	integrate(FuncTp func,
+		  const std::array<Tp, Dim>& lower,
+		  const std::array<Tp, Dim>& upper,
+		  Tp max_abs_err, Tp max_rel_err,
+		  std::size_t max_evals,
+		  unsigned int num_threads = 1) const
+	-> adaptive_integral_t<Tp, detail::qmc_value_t<Tp, Dim, FuncTp>>
+	{
+	  return check_status(__func__,
+			      this->integrate(std::nothrow, func, lower, upper,
+					      max_abs_err, max_rel_err,
+					      max_evals, num_threads));
+	}
+
+      /// Return the sequence kind.
+      qmc_sequence_kind
+      kind() const
+      { return this->m_kind; }
+
+      /// Return the number of randomized copies.
+      std::size_t
+      num_shifts() const
+      { return this->m_shift.size(); }
+
+      /**
+       * Write the points of indices [first, first + count) of copy
+       * @c shift in the unit cube into @c x.
+       * The points never lie on the faces of the cube.
+       */
+      void
+      points(std::size_t shift, std::uint64_t first, std::size_t count,
+	     std::array<Tp, Dim>* x) const;
+
+    private:
+
+      template<typename FuncTp, typename AreaTp>
+	void
+	m_accumulate(FuncTp& func,
+		     const std::array<Tp, Dim>& lower,
+		     const std::array<Tp, Dim>& upper,
+		     std::uint64_t first, std::uint64_t last,
+		     std::vector<AreaTp>& sum,
+		     unsigned int num_threads) const;
+
+      qmc_sequence_kind m_kind;
+      std::shared_ptr<const sobol_sequence> m_sobol;
+      std::shared_ptr<const rank1_lattice> m_lattice;
+      std::vector<std::array<std::uint32_t, Dim>> m_shift;
+    };
+
+  /**
+   * Integrate over the box [lower, upper] by randomized quasi-Monte Carlo
+   * with 16 shifted copies, doubling the number of points
+   * until the standard error meets the tolerance.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_qmc(FuncTp func,
+		  const std::array<Tp, Dim>& lower,
+		  const std::array<Tp, Dim>& upper,
+		  Tp max_abs_err, Tp max_rel_err,
+		  std::size_t max_evals = std::size_t{1} << 24,
+		  qmc_sequence_kind kind = QMC_Sobol,
+		  unsigned int num_threads = 1)
+    -> adaptive_integral_t<Tp, detail::qmc_value_t<Tp, Dim, FuncTp>>;
+
+} // namespace emsr
+
+#include <emsr/qmc_integral.tcc>
+
+#endif // QMC_INTEGRAL_H
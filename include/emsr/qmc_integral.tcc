@@ -0,0 +1,631 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements randomized quasi-Monte Carlo integration over boxes.
+
+#ifndef QMC_INTEGRAL_TCC
+#define QMC_INTEGRAL_TCC 1
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <emsr/integration_error.h>
+#include <emsr/parallel_for.h>
+
+namespace emsr
+{
+
+  namespace detail
+  {
+    /**
+     * The degree, the coefficients and the initial direction numbers
+     * @f$ m_1, ..., m_s @f$ of the Sobol coordinates 2 through 37
+     * from the table new-joe-kuo-6.21201 of Joe and Kuo.
+     * The coefficients @c a hold the inner bits of the primitive
+     * polynomial @f$ x^s + a_1 x^{s-1} + \cdots + a_{s-1} x + 1 @f$.
+     */
+    struct sobol_init_t
+    {
+      int s;
+      std::uint32_t a;
+      std::uint32_t m[7];
+    };
+
+    inline constexpr sobol_init_t
+    s_sobol_init[sobol_sequence::s_num_tabulated - 1]
+    {
+      {1,  0, {1}},
+      {2,  1, {1, 3}},
+      {3,  1, {1, 3, 1}},
+      {3,  2, {1, 1, 1}},
+      {4,  1, {1, 1, 3, 3}},
+      {4,  4, {1, 3, 5, 13}},
+      {5,  2, {1, 1, 5, 5, 17}},
+      {5,  4, {1, 1, 5, 5, 5}},
+      {5,  7, {1, 1, 7, 11, 19}},
+      {5, 11, {1, 1, 5, 1, 1}},
+      {5, 13, {1, 1, 1, 3, 11}},
+      {5, 14, {1, 3, 5, 5, 31}},
+      {6,  1, {1, 3, 3, 9, 7, 49}},
+      {6, 13, {1, 1, 1, 15, 21, 21}},
+      {6, 16, {1, 3, 1, 13, 27, 49}},
+      {6, 19, {1, 1, 1, 15, 7, 5}},
+      {6, 22, {1, 3, 1, 15, 13, 25}},
+      {6, 25, {1, 1, 5, 5, 19, 61}},
+      {7,  1, {1, 3, 7, 11, 23, 15, 103}},
+      {7,  4, {1, 3, 7, 13, 13, 15, 69}},
+      {7,  7, {1, 1, 3, 13, 7, 35, 63}},
+      {7,  8, {1, 3, 5, 9, 1, 25, 53}},
+      {7, 14, {1, 3, 1, 13, 9, 35, 107}},
+      {7, 19, {1, 3, 1, 5, 27, 61, 31}},
+      {7, 21, {1, 1, 5, 11, 19, 41, 61}},
+      {7, 28, {1, 3, 5, 3, 3, 13, 69}},
+      {7, 31, {1, 1, 7, 13, 1, 19, 1}},
+      {7, 32, {1, 3, 7, 5, 13, 19, 59}},
+      {7, 37, {1, 1, 3, 9, 25, 29, 41}},
+      {7, 41, {1, 3, 5, 13, 23, 1, 55}},
+      {7, 42, {1, 3, 7, 3, 13, 59, 17}},
+      {7, 50, {1, 3, 1, 3, 5, 53, 69}},
+      {7, 55, {1, 1, 5, 5, 23, 33, 13}},
+      {7, 56, {1, 1, 7, 7, 1, 61, 123}},
+      {7, 59, {1, 1, 7, 9, 13, 61, 49}},
+      {7, 62, {1, 3, 3, 5, 3, 55, 33}},
+    };
+
+    /**
+     * Return true if the polynomial of degree @c s over GF(2)
+     * with inner coefficients @c a is primitive, that is if @c x
+     * has order @f$ 2^s - 1 @f$ modulo the polynomial.
+     */
+    inline bool
+    gf2_primitive(int s, std::uint32_t a)
+    {
+      const std::uint64_t poly = (std::uint64_t{1} << s)
+			       | (std::uint64_t{a} << 1) | 1u;
+      auto mulmod = [s, poly](std::uint64_t u, std::uint64_t v)
+	{
+	  std::uint64_t r = 0;
+	  while (v)
+	    {
+	      if (v & 1u)
+		r ^= u;
+	      v >>= 1;
+	      u <<= 1;
+	      if ((u >> s) & 1u)
+		u ^= poly;
+	    }
+	  return r;
+	};
+      auto powmod = [mulmod](std::uint64_t e)
+	{
+	  std::uint64_t r = 1, b = 2;
+	  while (e)
+	    {
+	      if (e & 1u)
+		r = mulmod(r, b);
+	      b = mulmod(b, b);
+	      e >>= 1;
+	    }
+	  return r;
+	};
+
+      const std::uint64_t order = (std::uint64_t{1} << s) - 1;
+      if (s == 1)
+	return a == 0;
+      if (powmod(order) != 1)
+	return false;
+      auto rest = order;
+      for (std::uint64_t q = 2; q * q <= rest; ++q)
+	if (rest % q == 0)
+	  {
+	    if (powmod(order / q) == 1)
+	      return false;
+	    while (rest % q == 0)
+	      rest /= q;
+	  }
+      if (rest > 1 && rest != order && powmod(order / rest) == 1)
+	return false;
+      return true;
+    }
+
+    /**
+     * Return the 32 bits of @c k in reverse order.
+     */
+    inline std::uint32_t
+    bit_reverse(std::uint32_t k)
+    {
+      k = ((k >> 1) & 0x55555555u) | ((k & 0x55555555u) << 1);
+      k = ((k >> 2) & 0x33333333u) | ((k & 0x33333333u) << 2);
+      k = ((k >> 4) & 0x0f0f0f0fu) | ((k & 0x0f0f0f0fu) << 4);
+      k = ((k >> 8) & 0x00ff00ffu) | ((k & 0x00ff00ffu) << 8);
+      return (k >> 16) | (k << 16);
+    }
+  } // namespace detail
+
+  /**
+   * Build the direction numbers by the recurrence of the primitive
+   * polynomial of each coordinate.
+   */
+  inline
+  sobol_sequence::sobol_sequence(std::size_t dim)
+  : m_dim(dim),
+    m_direction(dim * s_num_bits)
+  {
+    if (dim == 0)
+      throw std::domain_error("sobol_sequence: Dimension must be positive.");
+
+    // Odd initial direction numbers of the untabulated coordinates.
+    std::mt19937 gen(20080101u);
+    int s = 7;
+    std::uint32_t a = 63;
+
+    for (std::size_t j = 0; j < dim; ++j)
+      {
+	auto* v = this->m_direction.data() + j * s_num_bits;
+	if (j == 0)
+	  {
+	    for (int b = 0; b < s_num_bits; ++b)
+	      v[b] = std::uint32_t{1} << (s_num_bits - 1 - b);
+	    continue;
+	  }
+
+	std::uint32_t m[s_num_bits];
+	if (j < s_num_tabulated)
+	  {
+	    const auto& init = detail::s_sobol_init[j - 1];
+	    s = init.s;
+	    a = init.a;
+	    for (int b = 0; b < s; ++b)
+	      m[b] = init.m[b];
+	  }
+	else
+	  {
+	    // The next primitive polynomial in order of degree.
+	    do
+	      {
+		++a;
+		if (a >= (std::uint32_t{1} << (s - 1)))
+		  {
+		    ++s;
+		    a = 0;
+		  }
+	      }
+	    while (!detail::gf2_primitive(s, a));
+	    if (s >= s_num_bits)
+	      throw std::domain_error("sobol_sequence: Dimension too large.");
+	    for (int b = 0; b < s; ++b)
+	      m[b] = (gen() & ((std::uint32_t{1} << (b + 1)) - 1)) | 1u;
+	  }
+
+	for (int b = 0; b < std::min(s, s_num_bits); ++b)
+	  v[b] = m[b] << (s_num_bits - 1 - b);
+	for (int b = s; b < s_num_bits; ++b)
+	  {
+	    v[b] = v[b - s] ^ (v[b - s] >> s);
+	    for (int k = 1; k < s; ++k)
+	      if ((a >> (s - 1 - k)) & 1u)
+		v[b] ^= v[b - k];
+	  }
+      }
+  }
+
+  /**
+   * The point of Gray code rank @c k is the exclusive or of the direction
+   * numbers of the set bits of @f$ k \oplus (k >> 1) @f$.
+   */
+  inline void
+  sobol_sequence::point(std::uint64_t k, std::uint32_t* x) const
+  {
+    const auto g = std::uint32_t(k ^ (k >> 1));
+    for (std::size_t j = 0; j < this->m_dim; ++j)
+      {
+	const auto* v = this->m_direction.data() + j * s_num_bits;
+	std::uint32_t y = 0;
+	for (int b = 0; b < s_num_bits; ++b)
+	  if ((g >> b) & 1u)
+	    y ^= v[b];
+	x[j] = y;
+      }
+  }
+
+  /**
+   * The Gray codes of @c k and @c k + 1 differ in the bit
+   * of the lowest zero bit of @c k.
+   */
+  inline void
+  sobol_sequence::next(std::uint64_t k, std::uint32_t* x) const
+  {
+    const auto b = std::countr_one(k);
+    for (std::size_t j = 0; j < this->m_dim; ++j)
+      x[j] ^= this->m_direction[j * s_num_bits + b];
+  }
+
+  /**
+   * Search the Korobov candidates for the smallest @f$ P_2 @f$.
+   * The candidates are odd multipliers spread over [1, 2^m)
+   * by the golden ratio.
+   */
+  inline
+  rank1_lattice::rank1_lattice(std::size_t dim, int log2_points)
+  : m_generator(dim)
+  {
+    if (dim == 0)
+      throw std::domain_error("rank1_lattice: Dimension must be positive.");
+    if (log2_points < 1 || log2_points > 24)
+      throw std::domain_error("rank1_lattice: Number of points out of range.");
+
+    const std::uint64_t n = std::uint64_t{1} << log2_points;
+    const double s_golden = 0.6180339887498948482;
+
+    auto korobov = [dim, n](std::uint64_t a)
+      {
+	std::vector<std::uint32_t> z(dim);
+	std::uint64_t p = 1;
+	for (std::size_t j = 0; j < dim; ++j)
+	  {
+	    z[j] = std::uint32_t(p);
+	    p = (p * a) % n;
+	  }
+	return z;
+      };
+
+    auto best = std::numeric_limits<double>::max();
+    for (int c = 0; c < s_num_candidates; ++c)
+      {
+	const auto frac = std::fmod((c + 1) * s_golden, 1.0);
+	const auto a = 2 * std::uint64_t(frac * double(n / 2)) + 1;
+	rank1_lattice trial(korobov(a));
+	const auto merit = trial.figure_of_merit(log2_points);
+	if (merit < best)
+	  {
+	    best = merit;
+	    this->m_generator = std::move(trial.m_generator);
+	  }
+      }
+  }
+
+  inline
+  rank1_lattice::rank1_lattice(std::vector<std::uint32_t> generator)
+  : m_generator(std::move(generator))
+  {
+    if (this->m_generator.empty())
+      throw std::domain_error("rank1_lattice: Dimension must be positive.");
+  }
+
+  inline void
+  rank1_lattice::point(std::uint64_t k, std::uint32_t* x) const
+  {
+    const auto phi = detail::bit_reverse(std::uint32_t(k));
+    for (std::size_t j = 0; j < this->m_generator.size(); ++j)
+      x[j] = phi * this->m_generator[j];
+  }
+
+  /**
+   * @f[
+   *    P_2 = -1 + \frac{1}{n} \sum_{k=0}^{n-1} \prod_{j=1}^{d}
+   *          \left[ 1 + 2\pi^2 \gamma_j B_2(\{k z_j / n\}) \right]
+   * @f]
+   * where @f$ B_2(x) = x^2 - x + 1/6 @f$.
+   */
+  inline double
+  rank1_lattice::figure_of_merit(int log2_points) const
+  {
+    const double s_2pi2 = 19.739208802178717238;
+    const std::uint64_t n = std::uint64_t{1} << log2_points;
+    const auto dim = this->m_generator.size();
+
+    std::vector<double> gamma(dim);
+    for (std::size_t j = 0; j < dim; ++j)
+      gamma[j] = s_2pi2 / double((j + 1) * (j + 1));
+
+    auto sum = 0.0;
+    for (std::uint64_t k = 0; k < n; ++k)
+      {
+	auto prod = 1.0;
+	for (std::size_t j = 0; j < dim; ++j)
+	  {
+	    const auto x = double((k * this->m_generator[j]) & (n - 1))
+			 / double(n);
+	    prod *= 1.0 + gamma[j] * (x * x - x + 1.0 / 6.0);
+	  }
+	sum += prod;
+      }
+    return sum / double(n) - 1.0;
+  }
+
+  /**
+   * The lattices are kept in a process-wide map; the search runs
+   * outside the lock and the first lattice stored for a key wins.
+   */
+  inline std::shared_ptr<const rank1_lattice>
+  cached_rank1_lattice(std::size_t dim, int log2_points)
+  {
+    using key_t = std::pair<std::size_t, int>;
+    static std::mutex s_mutex;
+    static std::map<key_t, std::shared_ptr<const rank1_lattice>> s_cache;
+
+    const key_t key{dim, log2_points};
+    {
+      std::lock_guard<std::mutex> lock(s_mutex);
+      const auto it = s_cache.find(key);
+      if (it != s_cache.end())
+	return it->second;
+    }
+
+    auto lattice = std::make_shared<const rank1_lattice>(dim, log2_points);
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_cache.emplace(key, std::move(lattice)).first->second;
+  }
+
+  template<typename Tp, std::size_t Dim>
+    qmc_integral<Tp, Dim>::
+    qmc_integral(qmc_sequence_kind kind, std::size_t num_shifts,
+		 std::uint64_t seed)
+    : m_kind(kind),
+      m_shift(num_shifts)
+    {
+      if (num_shifts < 2)
+	throw std::domain_error("qmc_integral: At least two shifts"
+				" are needed for an error estimate.");
+
+      if (kind == QMC_Sobol)
+	this->m_sobol = std::make_shared<const sobol_sequence>(Dim);
+      else if (kind == QMC_Lattice)
+	this->m_lattice = cached_rank1_lattice(Dim);
+      else
+	throw std::domain_error("qmc_integral: Unknown sequence kind.");
+
+      std::mt19937_64 gen(seed);
+      for (auto& shift : this->m_shift)
+	for (auto& s : shift)
+	  s = std::uint32_t(gen() >> 32);
+    }
+
+  /**
+   * The top bits of each integer coordinate that fit the mantissa
+   * of Tp are offset by half a unit so no point lies on a face.
+   */
+  template<typename Tp, std::size_t Dim>
+    void
+    qmc_integral<Tp, Dim>::
+    points(std::size_t shift, std::uint64_t first, std::size_t count,
+	   std::array<Tp, Dim>* x) const
+    {
+      constexpr int s_bits = std::min(32, std::numeric_limits<Tp>::digits - 1);
+      const auto s_scale = std::ldexp(Tp{1}, -s_bits);
+      const auto& sh = this->m_shift[shift];
+
+      std::array<std::uint32_t, Dim> u;
+      for (std::size_t i = 0; i < count; ++i)
+	{
+	  if (this->m_kind == QMC_Sobol)
+	    {
+	      if (i == 0)
+		this->m_sobol->point(first, u.data());
+	      else
+		this->m_sobol->next(first + i - 1, u.data());
+	      for (std::size_t j = 0; j < Dim; ++j)
+		x[i][j] = (Tp((u[j] ^ sh[j]) >> (32 - s_bits)) + Tp{0.5L})
+			* s_scale;
+	    }
+	  else
+	    {
+	      this->m_lattice->point(first + i, u.data());
+	      for (std::size_t j = 0; j < Dim; ++j)
+		x[i][j] = (Tp(std::uint32_t(u[j] + sh[j]) >> (32 - s_bits))
+			   + Tp{0.5L}) * s_scale;
+	    }
+	}
+    }
+
+  /**
+   * Add the sums of the function values at the points of indices
+   * [first, last) of each copy to @c sum.  The work is cut into blocks
+   * of s_block_size indices of one copy; the block sums are added
+   * in index order.
+   */
+  template<typename Tp, std::size_t Dim>
+    template<typename FuncTp, typename AreaTp>
+      void
+      qmc_integral<Tp, Dim>::
+      m_accumulate(FuncTp& func,
+		   const std::array<Tp, Dim>& lower,
+		   const std::array<Tp, Dim>& upper,
+		   std::uint64_t first, std::uint64_t last,
+		   std::vector<AreaTp>& sum,
+		   unsigned int num_threads) const
+      {
+	const auto num_shifts = this->m_shift.size();
+	const auto num_blocks = (last - first + s_block_size - 1)
+			      / s_block_size;
+
+	std::vector<AreaTp> partial(num_shifts * num_blocks);
+	parallel_for(0, partial.size(), num_threads,
+	  [&](std::size_t task)
+	  {
+	    const auto shift = task / num_blocks;
+	    const auto beg = first + (task % num_blocks) * s_block_size;
+	    const auto count = std::size_t(std::min<std::uint64_t>(
+					   s_block_size, last - beg));
+
+	    std::vector<std::array<Tp, Dim>> x(count);
+	    this->points(shift, beg, count, x.data());
+	    for (auto& pt : x)
+	      for (std::size_t j = 0; j < Dim; ++j)
+		pt[j] = lower[j] + (upper[j] - lower[j]) * pt[j];
+
+	    auto block_sum = AreaTp{};
+	    if constexpr (std::is_invocable_v<FuncTp,
+					      const std::array<Tp, Dim>&>)
+	      for (const auto& pt : x)
+		block_sum += func(pt);
+	    else
+	      {
+		std::vector<Tp> f(count);
+		func(std::span<const std::array<Tp, Dim>>(x),
+		     std::span<Tp>(f));
+		for (const auto& fi : f)
+		  block_sum += fi;
+	      }
+	    partial[task] = block_sum;
+	  });
+
+	for (std::size_t r = 0; r < num_shifts; ++r)
+	  for (std::size_t b = 0; b < num_blocks; ++b)
+	    sum[r] += partial[r * num_blocks + b];
+      }
+
+  namespace detail
+  {
+    /**
+     * Return the mean of the estimates of the copies
+     * and its standard error.
+     */
+    template<typename Tp, typename RetTp, typename AreaTp>
+      adaptive_integral_t<Tp, RetTp>
+      qmc_estimate(const std::vector<AreaTp>& sum, std::uint64_t num_points,
+		   Tp volume)
+      {
+	const auto num_shifts = sum.size();
+	auto mean = AreaTp{};
+	for (const auto& s : sum)
+	  mean += s;
+	mean *= volume / Tp(num_points) / Tp(num_shifts);
+
+	using AbsAreaTp = typename adaptive_integral_t<Tp, RetTp>::AbsAreaTp;
+	auto var = AbsAreaTp{};
+	for (const auto& s : sum)
+	  {
+	    const auto dev = std::abs(s * (volume / Tp(num_points)) - mean);
+	    var += dev * dev;
+	  }
+	var /= AbsAreaTp(num_shifts * (num_shifts - 1));
+
+	return {mean, std::sqrt(var)};
+      }
+  } // namespace detail
+
+  template<typename Tp, std::size_t Dim>
+    template<typename FuncTp>
+      auto
+      qmc_integral<Tp, Dim>::
+      integrate(FuncTp func,
+		const std::array<Tp, Dim>& lower,
+		const std::array<Tp, Dim>& upper,
+		std::size_t num_points,
+		unsigned int num_threads) const
+      -> adaptive_integral_t<Tp, detail::qmc_value_t<Tp, Dim, FuncTp>>
+      {
+	using RetTp = detail::qmc_value_t<Tp, Dim, FuncTp>;
+	using AreaTp = typename adaptive_integral_t<Tp, RetTp>::AreaTp;
+
+	const auto n = std::bit_ceil(std::max<std::uint64_t>(num_points, 1));
+	if (n > (std::uint64_t{1} << 32))
+	  throw std::domain_error("qmc_integral: Too many points.");
+
+	auto volume = Tp{1};
+	for (std::size_t j = 0; j < Dim; ++j)
+	  volume *= upper[j] - lower[j];
+
+	std::vector<AreaTp> sum(this->m_shift.size());
+	this->m_accumulate(func, lower, upper, 0, n, sum, num_threads);
+	return detail::qmc_estimate<Tp, RetTp>(sum, n, volume);
+      }
+
+  template<typename Tp, std::size_t Dim>
+    template<typename FuncTp>
+      auto
+      qmc_integral<Tp, Dim>::
+      integrate(std::nothrow_t, FuncTp func,
+		const std::array<Tp, Dim>& lower,
+		const std::array<Tp, Dim>& upper,
+		Tp max_abs_err, Tp max_rel_err,
+		std::size_t max_evals,
+		unsigned int num_threads) const
+      -> adaptive_status_t<Tp, detail::qmc_value_t<Tp, Dim, FuncTp>>
+      {
+	using RetTp = detail::qmc_value_t<Tp, Dim, FuncTp>;
+	using AreaTp = typename adaptive_integral_t<Tp, RetTp>::AreaTp;
+
+	if (!valid_tolerances(max_abs_err, max_rel_err))
+	  {
+	    std::ostringstream msg;
+	    msg << "qmc_integral: Tolerance cannot be achieved"
+		   " with given absolute (" << max_abs_err << ") and relative ("
+		<< max_rel_err << ") error limits.";
+	    throw std::runtime_error(msg.str().c_str());
+	  }
+
+	const auto num_shifts = this->m_shift.size();
+	const auto max_points = std::min<std::uint64_t>(
+				  std::max<std::size_t>(max_evals / num_shifts, 1),
+				  std::uint64_t{1} << 32);
+
+	auto volume = Tp{1};
+	for (std::size_t j = 0; j < Dim; ++j)
+	  volume *= upper[j] - lower[j];
+
+	auto n = std::min<std::uint64_t>(s_block_size,
+					 std::bit_floor(max_points));
+	std::vector<AreaTp> sum(num_shifts);
+	this->m_accumulate(func, lower, upper, 0, n, sum, num_threads);
+	auto est = detail::qmc_estimate<Tp, RetTp>(sum, n, volume);
+	while (true)
+	  {
+	    const auto tolerance = std::max(max_abs_err,
+					    max_rel_err * std::abs(est.result));
+	    if (est.abserr <= tolerance)
+	      return {est.result, est.abserr, NO_ERROR, n * num_shifts};
+	    if (2 * n > max_points)
+	      break;
+	    this->m_accumulate(func, lower, upper, n, 2 * n, sum, num_threads);
+	    n *= 2;
+	    est = detail::qmc_estimate<Tp, RetTp>(sum, n, volume);
+	  }
+
+	return {est.result, est.abserr, MAX_ITER_ERROR, n * num_shifts,
+		"qmc_integral: Maximum number of evaluations"
+		" reached before the tolerance was met."};
+      }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_qmc(FuncTp func,
+		  const std::array<Tp, Dim>& lower,
+		  const std::array<Tp, Dim>& upper,
+		  Tp max_abs_err, Tp max_rel_err,
+		  std::size_t max_evals,
+		  qmc_sequence_kind kind,
+		  unsigned int num_threads)
+    -> adaptive_integral_t<Tp, detail::qmc_value_t<Tp, Dim, FuncTp>>
+    {
+      const qmc_integral<Tp, Dim> qmc(kind);
+      return qmc.integrate(func, lower, upper, max_abs_err, max_rel_err,
+			   max_evals, num_threads);
+    }
+
+} // namespace emsr
+
+#endif // QMC_INTEGRAL_TCC
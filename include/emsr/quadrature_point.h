@@ -67,12 +67,35 @@ namespace emsr
     std::vector<QuadraturePoint<Tp>>
     jacobi_zeros(unsigned int n, Tp alpha1, Tp beta1);
 
+  // Parallel versions.
+
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    legendre_zeros(unsigned int l, unsigned int num_threads);
+
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    laguerre_zeros(unsigned int n, Tp alpha1, unsigned int num_threads);
+
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    hermite_zeros(unsigned int n, unsigned int num_threads);
+
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    gegenbauer_zeros(unsigned int n, Tp lambda, unsigned int num_threads);
+
+  template<typename Tp>
+    std::vector<QuadraturePoint<Tp>>
+    jacobi_zeros(unsigned int n, Tp alpha1, Tp beta1,
+		 unsigned int num_threads);
+
 } // namespace emsr
 
 #include <emsr/legendre_zeros.tcc>
 #include <emsr/laguerre_zeros.tcc>
 #include <emsr/hermite_zeros.tcc>
-#include <emsr/gegenbauer_zeros.tcc>
 #include <emsr/jacobi_zeros.tcc>
+#include <emsr/gegenbauer_zeros.tcc> // Uses the Jacobi matrix.
 
 #endif // QUADRATURE_POINT_H
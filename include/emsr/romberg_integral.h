@@ -0,0 +1,220 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements Romberg integration: Richardson extrapolation
+// of successively refined trapezoid sums.
+
+#ifndef ROMBERG_INTEGRAL_H
+#define ROMBERG_INTEGRAL_H 1
+
+#include <cstddef>
+#include <limits>
+#include <new> // For std::nothrow
+#include <type_traits>
+#include <vector>
+
+#include <emsr/integration.h>
+
+namespace emsr
+{
+
+  /**
+   * Romberg integration with a fixed number of levels.
+   *
+   * The trapezoid sums with @f$ 1, 2, 4, \ldots, 2^{L-1} @f$ panels
+   * are extrapolated in @f$ h^2 @f$ to give a rule of degree
+   * @f$ 2L - 1 @f$ on @f$ 2^{L-1} + 1 @f$ equally spaced points.
+   *
+   * If the panels become too small to halve before the last level
+   * the table stops there and converged() returns false;
+   * integrate() then throws an integration_error.
+   */
+  template<typename Tp, typename FuncTp>
+    class composite_romberg_integral
+    {
+    public:
+
+      using RetTp = std::invoke_result_t<FuncTp, Tp>;
+      using AreaTp = decltype(RetTp{} * Tp{});
+      using AbsAreaTp = decltype(std::abs(AreaTp{}));
+
+      composite_romberg_integral(FuncTp fun, Tp a, Tp b,
+				 std::size_t num_levels)
+      : m_trap(fun, a, b, Tp{0}, Tp{0}),
+	m_num_levels(num_levels), m_result()
+      { }
+
+      AreaTp operator()();
+
+      /// Return true if the last integration reached every level.
+      bool converged() const
+      { return this->m_converged; }
+
+      /// Return the number of trapezoid refinements used.
+      std::size_t num_levels() const
+      { return this->m_levels; }
+
+      template<typename FuncTp2>
+	fixed_integral_t<Tp, std::invoke_result_t<FuncTp2, Tp>>
+	integrate(FuncTp2 fun, Tp a, Tp b)
+	{
+	  composite_romberg_integral<Tp, FuncTp2>
+	    rombi(fun, a, b, this->m_num_levels);
+	  const auto result = rombi();
+	  if (!rombi.converged())
+	    throw integration_error("composite_romberg_integral: "
+				    "The panels became too small to halve "
+				    "before the requested level",
+				    MAX_ITER_ERROR, result,
+				    std::numeric_limits<Tp>::quiet_NaN());
+	  return {result};
+	}
+
+    private:
+
+      trapezoid_integral<Tp, FuncTp> m_trap;
+      std::size_t m_num_levels;
+      AreaTp m_result;
+      std::size_t m_levels = 0;
+      bool m_converged = false;
+    };
+
+  /**
+   * A Romberg integrator.
+   *
+   * Each refinement of trapezoid_integral halves the panels reusing
+   * the previous sum; the new sum starts a row of the Richardson table
+   * whose entries eliminate the error terms in @f$ h^2, h^4, \ldots @f$
+   * of the Euler-Maclaurin expansion.  The error estimate is the change
+   * of the diagonal of the table between levels and the refinement stops
+   * once it meets the tolerance.  Smooth integrands converge
+   * in a handful of levels where the trapezoid rule alone needs
+   * of order a million points.
+   *
+   * Integrands with endpoint singularities or kinks do not have
+   * an expansion in even powers of @f$ h @f$; the extrapolation then
+   * gains little and the error estimate stays honest but large.
+   * Integrands that are periodic over the range are already integrated
+   * to high accuracy by the trapezoid rule.
+   */
+  template<typename Tp, typename FuncTp>
+    class romberg_integral
+    {
+    public:
+
+      using RetTp = std::invoke_result_t<FuncTp, Tp>;
+      using AreaTp = decltype(RetTp{} * Tp{});
+      using AbsAreaTp = decltype(std::abs(AreaTp{}));
+
+      /// The default maximum number of levels.
+      static constexpr std::size_t s_max_level
+	= std::numeric_limits<Tp>::digits / 2;
+
+      romberg_integral(FuncTp fun, Tp a, Tp b,
+		       Tp abs_tol, Tp rel_tol,
+		       std::size_t max_level = s_max_level)
+      : m_trap(fun, a, b, abs_tol, rel_tol),
+	m_abs_tol(std::abs(abs_tol)), m_rel_tol(std::abs(rel_tol)),
+	m_max_level(max_level),
+	m_result(), m_abs_error()
+      { }
+
+      AreaTp operator()();
+
+      AbsAreaTp abs_error() const
+      { return this->m_abs_error; }
+
+      /// Return true if the last integration met the tolerance.
+      bool converged() const
+      { return this->m_converged; }
+
+      /// Return the number of trapezoid refinements used.
+      std::size_t num_levels() const
+      { return this->m_row.size(); }
+
+      /// Return the number of function evaluations.
+      std::size_t num_evals() const
+      { return this->m_row.empty() ? 0 : this->m_trap.m_pow2 + 1; }
+
+      template<typename FuncTp2>
+	adaptive_integral_t<Tp, std::invoke_result_t<FuncTp2, Tp>>
+	integrate(FuncTp2 fun, Tp a, Tp b)
+	{
+	  romberg_integral<Tp, FuncTp2>
+	    rombi(fun, a, b, this->m_abs_tol, this->m_rel_tol,
+		  this->m_max_level);
+	  return {rombi(), rombi.abs_error()};
+	}
+
+      template<typename FuncTp2>
+	adaptive_integral_t<Tp, std::invoke_result_t<FuncTp2, Tp>>
+	operator()(FuncTp2 fun, Tp a, Tp b)
+	{ return this->integrate(fun, a, b); }
+
+    private:
+
+      /// Do not trust agreement between the first few coarse levels.
+      static constexpr std::size_t s_min_level = 4;
+
+      trapezoid_integral<Tp, FuncTp> m_trap;
+      AbsAreaTp m_abs_tol;
+      AbsAreaTp m_rel_tol;
+      std::size_t m_max_level;
+      AreaTp m_result;
+      AbsAreaTp m_abs_error;
+      bool m_converged = false;
+      /// The last row of the Richardson table.
+      std::vector<AreaTp> m_row;
+    };
+
+  /**
+   * Integrate a smooth function from a to b by Romberg integration
+   * without throwing when the tolerance is not met.
+   *
+   * @param func The function to be integrated.
+   * @param a The lower limit of integration.
+   * @param b The upper limit of integration.
+   * @param max_abs_err The absolute error limit.
+   * @param max_rel_err The relative error limit.
+   * @param max_level The maximum number of trapezoid refinements;
+   *                  the last uses @f$ 2^{max\_level - 1} + 1 @f$ points.
+   */
+  template<typename Tp, typename FuncTp>
+    adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    integrate_romberg(std::nothrow_t, FuncTp func, Tp a, Tp b,
+		      Tp max_abs_err, Tp max_rel_err,
+		      std::size_t max_level
+			= romberg_integral<Tp, FuncTp>::s_max_level);
+
+  /**
+   * Integrate a smooth function from a to b by Romberg integration.
+   * An integration_error is thrown if the tolerance is not met
+   * within @c max_level refinements.
+   * The arguments are those of the non-throwing overload.
+   */
+  template<typename Tp, typename FuncTp>
+    adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    integrate_romberg(FuncTp func, Tp a, Tp b,
+		      Tp max_abs_err, Tp max_rel_err,
+		      std::size_t max_level
+			= romberg_integral<Tp, FuncTp>::s_max_level);
+
+} // namespace emsr
+
+#include <emsr/romberg_integral.tcc>
+
+#endif // ROMBERG_INTEGRAL_H
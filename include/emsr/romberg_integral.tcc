@@ -0,0 +1,169 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements Romberg integration: Richardson extrapolation
+// of successively refined trapezoid sums.
+
+#ifndef ROMBERG_INTEGRAL_TCC
+#define ROMBERG_INTEGRAL_TCC 1
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace emsr
+{
+
+namespace detail
+{
+  /**
+   * Replace the last row of a Richardson table for the trapezoid rule,
+   * @f$ R(k-1, 0..k-1) @f$, by the next, @f$ R(k, 0..k) @f$,
+   * given the trapezoid sum @f$ R(k, 0) @f$ with twice the panels:
+   * @f[
+   *   R(k, j) = R(k, j-1) + \frac{R(k, j-1) - R(k-1, j-1)}{4^j - 1}
+   * @f]
+   */
+  template<typename Tp, typename AreaTp>
+    void
+    romberg_extend(std::vector<AreaTp>& row, AreaTp trap)
+    {
+      auto next = trap;
+      auto four_j = Tp{1};
+      for (auto& entry : row)
+	{
+	  four_j *= Tp{4};
+	  const auto prev = entry;
+	  entry = next;
+	  next += (next - prev) / (four_j - Tp{1});
+	}
+      row.push_back(next);
+    }
+} // namespace detail
+
+  /**
+   * Integrate the function with a fixed number of Romberg levels.
+   */
+  template<typename Tp, typename FuncTp>
+    typename composite_romberg_integral<Tp, FuncTp>::AreaTp
+    composite_romberg_integral<Tp, FuncTp>::operator()()
+    {
+      // Start the trapezoid refinement over.
+      this->m_trap.m_iter = 0;
+
+      std::vector<AreaTp> row;
+      detail::romberg_extend<Tp>(row, this->m_trap.m_step());
+      for (std::size_t level = 1; level < this->m_num_levels; ++level)
+	{
+	  const auto pow2 = this->m_trap.m_pow2;
+	  const auto trap = this->m_trap.m_step();
+	  // The panels have become too small to halve; extrapolating
+	  // the repeated sum would fake convergence.
+	  if (this->m_trap.m_pow2 == pow2)
+	    break;
+	  detail::romberg_extend<Tp>(row, trap);
+	}
+
+      this->m_levels = row.size();
+      this->m_converged = this->m_levels >= this->m_num_levels;
+      this->m_result = row.back();
+      return this->m_result;
+    }
+
+  /**
+   * Integrate the function refining the trapezoid sums
+   * and extrapolating until the tolerance is met.
+   */
+  template<typename Tp, typename FuncTp>
+    typename romberg_integral<Tp, FuncTp>::AreaTp
+    romberg_integral<Tp, FuncTp>::operator()()
+    {
+      // Start the trapezoid refinement over.
+      this->m_trap.m_iter = 0;
+      this->m_row.clear();
+      this->m_converged = false;
+      this->m_abs_error = std::numeric_limits<AbsAreaTp>::infinity();
+
+      auto diag_prev = AreaTp{};
+      for (std::size_t level = 1; level <= this->m_max_level; ++level)
+	{
+	  const auto pow2 = this->m_trap.m_pow2;
+	  const auto trap = this->m_trap.m_step();
+	  // The panels have become too small to halve.
+	  if (level > 1 && this->m_trap.m_pow2 == pow2)
+	    break;
+
+	  detail::romberg_extend<Tp>(this->m_row, trap);
+	  this->m_result = this->m_row.back();
+	  if (level > 1)
+	    this->m_abs_error = std::abs(this->m_result - diag_prev);
+	  diag_prev = this->m_result;
+
+	  if (level >= s_min_level
+	      && this->m_abs_error <= std::max(this->m_abs_tol,
+				this->m_rel_tol * std::abs(this->m_result)))
+	    {
+	      this->m_converged = true;
+	      break;
+	    }
+	}
+
+      return this->m_result;
+    }
+
+  template<typename Tp, typename FuncTp>
+    adaptive_status_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    integrate_romberg(std::nothrow_t, FuncTp func, Tp a, Tp b,
+		      Tp max_abs_err, Tp max_rel_err,
+		      std::size_t max_level)
+    {
+      if (!valid_tolerances(max_abs_err, max_rel_err))
+	{
+	  std::ostringstream msg;
+	  msg << "integrate_romberg: Tolerance cannot be achieved with given "
+		   "absolute (" << max_abs_err << ") and relative ("
+		<< max_rel_err << ") error limits.";
+	  throw std::runtime_error(msg.str().c_str());
+	}
+
+      romberg_integral<Tp, FuncTp>
+	rombi(func, a, b, max_abs_err, max_rel_err, max_level);
+      const auto result = rombi();
+      if (rombi.converged())
+	return {result, rombi.abs_error(), NO_ERROR, rombi.num_evals()};
+      else
+	return {result, rombi.abs_error(), MAX_ITER_ERROR, rombi.num_evals(),
+		"integrate_romberg: The maximum level was reached "
+		"without meeting the tolerance"};
+    }
+
+  template<typename Tp, typename FuncTp>
+    adaptive_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    integrate_romberg(FuncTp func, Tp a, Tp b,
+		      Tp max_abs_err, Tp max_rel_err,
+		      std::size_t max_level)
+    {
+      return check_status(__func__,
+			  integrate_romberg(std::nothrow, func, a, b,
+					    max_abs_err, max_rel_err,
+					    max_level));
+    }
+
+} // namespace emsr
+
+#endif // ROMBERG_INTEGRAL_TCC
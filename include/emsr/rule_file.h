@@ -0,0 +1,280 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements a versioned binary file of precomputed quadrature rules
+// that is memory-mapped for zero-copy access.
+
+#ifndef RULE_FILE_H
+#define RULE_FILE_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace emsr
+{
+
+  /**
+   * The families of quadrature rules that may be stored in a rule file.
+   * The values are part of the file format and must not change.
+   */
+  enum Rule_File_Family : std::uint32_t
+  {
+    Rule_Gauss_Kronrod = 1,
+    Rule_Gauss_Legendre = 2,
+    Rule_Gauss_Jacobi = 3,
+    Rule_Clenshaw_Curtis = 4,
+    Rule_Fejer_1 = 5,
+    Rule_Fejer_2 = 6
+  };
+
+  /**
+   * The scalar types that may be stored in a rule file.
+   * The values are part of the file format and must not change.
+   */
+  enum Rule_File_Scalar : std::uint32_t
+  {
+    Rule_Float = 1,
+    Rule_Double = 2,
+    Rule_Long_Double = 3,
+    Rule_Float128 = 4
+  };
+
+  template<typename Tp>
+    struct rule_file_scalar;
+
+  template<>
+    struct rule_file_scalar<float>
+    { static constexpr Rule_File_Scalar value = Rule_Float; };
+
+  template<>
+    struct rule_file_scalar<double>
+    { static constexpr Rule_File_Scalar value = Rule_Double; };
+
+  template<>
+    struct rule_file_scalar<long double>
+    { static constexpr Rule_File_Scalar value = Rule_Long_Double; };
+
+#ifdef EMSR_HAVE_FLOAT128
+  template<>
+    struct rule_file_scalar<__float128>
+    { static constexpr Rule_File_Scalar value = Rule_Float128; };
+#endif
+
+  /**
+   * The on-disk header of a rule file.
+   *
+   * A rule file is laid out as the header, the rule data arrays
+   * (each aligned to s_rule_file_align bytes) and finally a directory
+   * of @c num_rules entries starting at @c directory_offset.
+   * All integers are in the byte order of the machine that wrote the file;
+   * a file written on a machine of the other byte order is rejected.
+   */
+  struct rule_file_header
+  {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t num_rules;
+    std::uint64_t directory_offset;
+    std::uint64_t file_size;
+  };
+
+  /**
+   * The on-disk directory entry of a rule.
+   *
+   * Array 0 holds the nodes, array 1 the weights and array 2 any
+   * auxiliary weights (the embedded Gauss weights of a Gauss-Kronrod rule).
+   * Family parameters are stored as double; they are used only as keys.
+   */
+  struct rule_file_entry
+  {
+    std::uint32_t family;
+    std::uint32_t scalar;
+    std::uint32_t scalar_size;
+    std::int32_t order;
+    double alpha;
+    double beta;
+    std::uint64_t offset[3];
+    std::uint64_t count[3];
+  };
+
+  /// The current rule file format version.
+  inline constexpr std::uint32_t s_rule_file_version = 1;
+
+  /// The alignment of the rule data arrays in a rule file.
+  inline constexpr std::size_t s_rule_file_align = 64;
+
+  /**
+   * A zero-copy view of one rule in a rule file.
+   */
+  template<typename Tp>
+    struct rule_view
+    {
+      /// The nodes of the rule.
+      std::span<const Tp> point;
+      /// The weights of the rule.
+      std::span<const Tp> weight;
+      /// Auxiliary weights (e.g. Gauss weights of a Kronrod extension).
+      std::span<const Tp> aux_weight;
+    };
+
+  /**
+   * Accumulate rules in memory and write them out as a rule file.
+   */
+  class rule_file_writer
+  {
+  public:
+
+    /**
+     * Add a rule.  A later rule with the same key replaces an earlier one
+     * when the file is read.
+     */
+    template<typename Tp>
+      void
+      add(Rule_File_Family family, int order, double alpha, double beta,
+	  const std::vector<Tp>& point, const std::vector<Tp>& weight,
+	  const std::vector<Tp>& aux_weight = {});
+
+    /// Return the number of rules added.
+    std::size_t
+    size() const
+    { return this->m_rule.size(); }
+
+    /**
+     * Write the rule file.  The file is written under a temporary name
+     * and renamed into place so readers never see a partial file.
+     */
+    void
+    write(const std::string& path) const;
+
+  private:
+
+    struct rule
+    {
+      rule_file_entry entry;
+      std::vector<unsigned char> data[3];
+    };
+
+    std::vector<rule> m_rule;
+  };
+
+  /**
+   * A read-only, memory-mapped rule file.
+   *
+   * The whole file is mapped on construction and validated;
+   * nodes and weights are then handed out as spans into the mapping
+   * so that loading a rule costs no more than paging it in.
+   * Views remain valid for the lifetime of the rule_file object.
+   */
+  class rule_file
+  {
+  public:
+
+    explicit rule_file(const std::string& path);
+
+    rule_file(const rule_file&) = delete;
+    rule_file& operator=(const rule_file&) = delete;
+
+    rule_file(rule_file&& rf) noexcept;
+    rule_file& operator=(rule_file&& rf) noexcept;
+
+    ~rule_file();
+
+    /// Return the number of rules in the file.
+    std::size_t
+    size() const
+    { return this->m_header->num_rules; }
+
+    /// Return the format version of the file.
+    std::uint32_t
+    version() const
+    { return this->m_header->version; }
+
+    /// Return the directory entries of the file.
+    std::span<const rule_file_entry>
+    entries() const
+    { return {this->m_entry, std::size_t(this->m_header->num_rules)}; }
+
+    /**
+     * Look up a rule by family, order, parameters and scalar type.
+     * Return an empty optional if there is no such rule.
+     * Throw std::runtime_error if the array lengths of the rule
+     * do not match its order or run past the rule data.
+     */
+    template<typename Tp>
+      std::optional<rule_view<Tp>>
+      find(Rule_File_Family family, int order,
+	   double alpha = 0.0, double beta = 0.0) const;
+
+  private:
+
+    void
+    m_unmap() noexcept;
+
+    void* m_addr = nullptr;
+    std::size_t m_size = 0;
+    const rule_file_header* m_header = nullptr;
+    const rule_file_entry* m_entry = nullptr;
+  };
+
+  /**
+   * Map the rule file at @c path and make it the process-wide default
+   * rule file.  The rule constructors that would otherwise compute
+   * an expensive rule - gauss_kronrod_integral and
+   * mapped_gauss_kronrod_integral for orders beyond the tabulated ones,
+   * gauss_legendre_table for orders beyond the precomputed ones
+   * and jac_quadrature - look in the default rule file first.
+   * An empty path drops the default rule file.
+   */
+  void
+  set_default_rule_file(const std::string& path);
+
+  /// Return the default rule file or a null pointer if none is set.
+  std::shared_ptr<const rule_file>
+  default_rule_file();
+
+  /**
+   * A view of a rule in the default rule file
+   * that keeps the file mapped for as long as it is held.
+   */
+  template<typename Tp>
+    struct shared_rule_view : rule_view<Tp>
+    {
+      /// The rule file the views point into.
+      std::shared_ptr<const rule_file> file;
+    };
+
+  /**
+   * Look up a rule in the default rule file without copying it.
+   * Return an empty optional if there is no default rule file,
+   * no such rule or the real type cannot be stored in a rule file.
+   */
+  template<typename Tp>
+    std::optional<shared_rule_view<Tp>>
+    load_default_rule(Rule_File_Family family, int order,
+		      double alpha = 0.0, double beta = 0.0);
+
+} // namespace emsr
+
+#include <emsr/rule_file.tcc>
+
+#endif // RULE_FILE_H
@@ -0,0 +1,405 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef RULE_FILE_TCC
+#define RULE_FILE_TCC 1
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace emsr
+{
+namespace detail
+{
+
+  inline constexpr char s_rule_file_magic[8]
+    = {'E', 'M', 'S', 'R', 'R', 'U', 'L', 'E'};
+
+  inline constexpr std::uint32_t s_rule_file_byte_order = 0x01020304u;
+
+  /// Round an offset up to the rule data alignment.
+  inline constexpr std::uint64_t
+  rule_file_align(std::uint64_t off)
+  { return (off + s_rule_file_align - 1) / s_rule_file_align * s_rule_file_align; }
+
+  /**
+   * Return true if the array lengths of a rule agree with its order.
+   * A Gauss-Kronrod rule of order @f$ 2n + 1 @f$ stores the
+   * @f$ n + 1 @f$ nonnegative nodes and their Kronrod weights and
+   * the @f$ [(n + 1)/2] @f$ Gauss weights; the other known families store
+   * as many nodes and weights as their order.
+   * Rules of unknown families are not checked.
+   */
+  inline bool
+  rule_file_counts_match(const rule_file_entry& e)
+  {
+    if (e.order <= 0)
+      return false;
+    const auto order = std::uint64_t(e.order);
+    switch (e.family)
+      {
+      case Rule_Gauss_Kronrod:
+	{
+	  if (order % 2 == 0)
+	    return false;
+	  const auto n = (order - 1) / 2;
+	  return e.count[0] == n + 1 && e.count[1] == n + 1
+	      && e.count[2] == (n + 1) / 2;
+	}
+      case Rule_Gauss_Legendre:
+      case Rule_Gauss_Jacobi:
+      case Rule_Clenshaw_Curtis:
+      case Rule_Fejer_1:
+      case Rule_Fejer_2:
+	return e.count[0] == order && e.count[1] == order
+	    && e.count[2] == 0;
+      default:
+	return true;
+      }
+  }
+
+  /// The process-wide default rule file.
+  struct default_rule_file_t
+  {
+    std::mutex mutex;
+    std::shared_ptr<const rule_file> file;
+    /// Bumped each time the default rule file changes.
+    std::atomic<std::uint64_t> generation{0};
+  };
+
+  inline default_rule_file_t&
+  default_rule_file_slot()
+  {
+    static default_rule_file_t slot;
+    return slot;
+  }
+
+  /**
+   * Return a counter that changes whenever the default rule file does.
+   * Caches of rules that may have come from the default rule file
+   * compare it to tell whether their entries are stale without locking.
+   */
+  inline std::uint64_t
+  default_rule_file_generation()
+  {
+    return default_rule_file_slot().generation
+				   .load(std::memory_order_acquire);
+  }
+
+} // namespace detail
+
+  template<typename Tp>
+    void
+    rule_file_writer::add(Rule_File_Family family, int order,
+			  double alpha, double beta,
+			  const std::vector<Tp>& point,
+			  const std::vector<Tp>& weight,
+			  const std::vector<Tp>& aux_weight)
+    {
+      rule r{};
+      r.entry.family = family;
+      r.entry.scalar = rule_file_scalar<Tp>::value;
+      r.entry.scalar_size = sizeof(Tp);
+      r.entry.order = order;
+      r.entry.alpha = alpha;
+      r.entry.beta = beta;
+
+      const std::vector<Tp>* array[3] = {&point, &weight, &aux_weight};
+      for (int i = 0; i < 3; ++i)
+	{
+	  r.entry.count[i] = array[i]->size();
+	  r.data[i].resize(array[i]->size() * sizeof(Tp));
+	  if (!array[i]->empty())
+	    std::memcpy(r.data[i].data(), array[i]->data(), r.data[i].size());
+	}
+
+      this->m_rule.push_back(std::move(r));
+    }
+
+  inline void
+  rule_file_writer::write(const std::string& path) const
+  {
+    rule_file_header header{};
+    std::memcpy(header.magic, detail::s_rule_file_magic, sizeof(header.magic));
+    header.version = s_rule_file_version;
+    header.byte_order = detail::s_rule_file_byte_order;
+    header.num_rules = this->m_rule.size();
+
+    // Lay out the data arrays after the header.
+    std::vector<rule_file_entry> directory;
+    directory.reserve(this->m_rule.size());
+    auto off = detail::rule_file_align(sizeof(rule_file_header));
+    for (const auto& r : this->m_rule)
+      {
+	auto entry = r.entry;
+	for (int i = 0; i < 3; ++i)
+	  {
+	    entry.offset[i] = r.data[i].empty() ? 0 : off;
+	    off = detail::rule_file_align(off + r.data[i].size());
+	  }
+	directory.push_back(entry);
+      }
+    header.directory_offset = off;
+    header.file_size = off + directory.size() * sizeof(rule_file_entry);
+
+    const auto tmp_path = path + ".tmp";
+    {
+      std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+      if (!out)
+	throw std::runtime_error("rule_file_writer: unable to open "
+				 + tmp_path);
+
+      const char zero[s_rule_file_align] = {};
+      auto pad_to = [&out, &zero](std::uint64_t pos)
+		    {
+		      const auto here = std::uint64_t(out.tellp());
+		      out.write(zero, std::streamsize(pos - here));
+		    };
+
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      for (std::size_t k = 0; k < this->m_rule.size(); ++k)
+	for (int i = 0; i < 3; ++i)
+	  if (!this->m_rule[k].data[i].empty())
+	    {
+	      pad_to(directory[k].offset[i]);
+	      out.write(reinterpret_cast<const char*>
+			  (this->m_rule[k].data[i].data()),
+			std::streamsize(this->m_rule[k].data[i].size()));
+	    }
+      pad_to(header.directory_offset);
+      out.write(reinterpret_cast<const char*>(directory.data()),
+		std::streamsize(directory.size() * sizeof(rule_file_entry)));
+      if (!out)
+	throw std::runtime_error("rule_file_writer: error writing "
+				 + tmp_path);
+    }
+
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+      {
+	std::remove(tmp_path.c_str());
+	throw std::runtime_error("rule_file_writer: unable to rename "
+				 + tmp_path + " to " + path);
+      }
+  }
+
+  inline
+  rule_file::rule_file(const std::string& path)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("rule_file: unable to open " + path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(rule_file_header)))
+      {
+	::close(fd);
+	throw std::runtime_error("rule_file: " + path + " is too short");
+      }
+
+    this->m_size = std::size_t(st.st_size);
+    this->m_addr = ::mmap(nullptr, this->m_size, PROT_READ, MAP_PRIVATE,
+			  fd, 0);
+    ::close(fd);
+    if (this->m_addr == MAP_FAILED)
+      {
+	this->m_addr = nullptr;
+	throw std::runtime_error("rule_file: unable to map " + path);
+      }
+
+    auto fail = [this, &path](const char* why)
+		{
+		  this->m_unmap();
+		  throw std::runtime_error("rule_file: " + path + ": " + why);
+		};
+
+    const auto base = static_cast<const unsigned char*>(this->m_addr);
+    this->m_header = reinterpret_cast<const rule_file_header*>(base);
+    const auto& hdr = *this->m_header;
+    if (std::memcmp(hdr.magic, detail::s_rule_file_magic,
+		    sizeof(hdr.magic)) != 0)
+      fail("not a rule file");
+    if (hdr.byte_order != detail::s_rule_file_byte_order)
+      fail("byte order mismatch");
+    if (hdr.version != s_rule_file_version)
+      fail("unsupported version");
+    if (hdr.file_size != this->m_size)
+      fail("truncated file");
+    if (hdr.directory_offset % alignof(rule_file_entry) != 0
+	|| hdr.directory_offset > this->m_size
+	|| hdr.num_rules > (this->m_size - hdr.directory_offset)
+			   / sizeof(rule_file_entry))
+      fail("corrupt directory");
+
+    this->m_entry = reinterpret_cast<const rule_file_entry*>
+		      (base + hdr.directory_offset);
+    for (const auto& e : this->entries())
+      for (int i = 0; i < 3; ++i)
+	{
+	  if (e.count[i] == 0)
+	    continue;
+	  if (e.scalar_size == 0
+	      || e.offset[i] % s_rule_file_align != 0
+	      || e.offset[i] > hdr.directory_offset
+	      || e.count[i] > (hdr.directory_offset - e.offset[i])
+			      / e.scalar_size)
+	    fail("corrupt rule entry");
+	}
+  }
+
+  inline
+  rule_file::rule_file(rule_file&& rf) noexcept
+  : m_addr(std::exchange(rf.m_addr, nullptr)),
+    m_size(std::exchange(rf.m_size, 0)),
+    m_header(std::exchange(rf.m_header, nullptr)),
+    m_entry(std::exchange(rf.m_entry, nullptr))
+  { }
+
+  inline rule_file&
+  rule_file::operator=(rule_file&& rf) noexcept
+  {
+    if (this != &rf)
+      {
+	this->m_unmap();
+	this->m_addr = std::exchange(rf.m_addr, nullptr);
+	this->m_size = std::exchange(rf.m_size, 0);
+	this->m_header = std::exchange(rf.m_header, nullptr);
+	this->m_entry = std::exchange(rf.m_entry, nullptr);
+      }
+    return *this;
+  }
+
+  inline
+  rule_file::~rule_file()
+  { this->m_unmap(); }
+
+  inline void
+  rule_file::m_unmap() noexcept
+  {
+    if (this->m_addr != nullptr)
+      ::munmap(this->m_addr, this->m_size);
+    this->m_addr = nullptr;
+    this->m_size = 0;
+    this->m_header = nullptr;
+    this->m_entry = nullptr;
+  }
+
+  /**
+   * The directory is searched from the back so that a rule added later
+   * to the file overrides an earlier one with the same key.
+   * The lengths of the arrays of the rule found are checked against
+   * its order and against the extent of the rule data for this Tp.
+   */
+  template<typename Tp>
+    std::optional<rule_view<Tp>>
+    rule_file::find(Rule_File_Family family, int order,
+		    double alpha, double beta) const
+    {
+      const auto base = static_cast<const unsigned char*>(this->m_addr);
+      const auto end = this->m_header->directory_offset;
+      const auto ents = this->entries();
+      for (auto e = ents.rbegin(); e != ents.rend(); ++e)
+	if (e->family == family && e->order == order
+	    && e->scalar == rule_file_scalar<Tp>::value
+	    && e->scalar_size == sizeof(Tp)
+	    && e->alpha == alpha && e->beta == beta)
+	  {
+	    if (!detail::rule_file_counts_match(*e))
+	      throw std::runtime_error("rule_file: the array lengths of the "
+				       "rule of order "
+				       + std::to_string(order)
+				       + " do not match its order");
+	    for (int i = 0; i < 3; ++i)
+	      if (e->count[i] != 0
+		  && (e->offset[i] % alignof(Tp) != 0
+		      || e->offset[i] > end
+		      || e->count[i] > (end - e->offset[i]) / sizeof(Tp)))
+		throw std::runtime_error("rule_file: the rule of order "
+					 + std::to_string(order)
+					 + " runs past the rule data");
+
+	    auto array = [base, &e](int i)
+	      {
+		return std::span<const Tp>(reinterpret_cast<const Tp*>
+					     (base + e->offset[i]),
+					   std::size_t(e->count[i]));
+	      };
+	    return rule_view<Tp>{array(0), array(1), array(2)};
+	  }
+      return std::nullopt;
+    }
+
+  /**
+   * The file is mapped before the lock is taken and a bad file throws
+   * leaving the previous default in place.
+   */
+  inline void
+  set_default_rule_file(const std::string& path)
+  {
+    std::shared_ptr<const rule_file> file;
+    if (!path.empty())
+      file = std::make_shared<const rule_file>(path);
+    auto& slot = detail::default_rule_file_slot();
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    slot.file = std::move(file);
+    slot.generation.fetch_add(1, std::memory_order_release);
+  }
+
+  inline std::shared_ptr<const rule_file>
+  default_rule_file()
+  {
+    auto& slot = detail::default_rule_file_slot();
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    return slot.file;
+  }
+
+  template<typename Tp>
+    std::optional<shared_rule_view<Tp>>
+    load_default_rule(Rule_File_Family family, int order,
+		      double alpha, double beta)
+    {
+      if constexpr (requires { rule_file_scalar<Tp>::value; })
+	{
+	  auto file = default_rule_file();
+	  if (!file)
+	    return std::nullopt;
+	  const auto rule = file->template find<Tp>(family, order,
+						     alpha, beta);
+	  if (!rule)
+	    return std::nullopt;
+	  shared_rule_view<Tp> view;
+	  static_cast<rule_view<Tp>&>(view) = *rule;
+	  view.file = std::move(file);
+	  return view;
+	}
+      else
+	return std::nullopt;
+    }
+
+} // namespace emsr
+
+#endif // RULE_FILE_TCC
@@ -0,0 +1,175 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements endpoint singularity probing and integrator selection.
+
+#ifndef SINGULARITY_PROBE_H
+#define SINGULARITY_PROBE_H 1
+
+#include <cstddef>
+#include <new> // For std::nothrow
+#include <type_traits>
+
+#include <emsr/integration.h>
+
+namespace emsr
+{
+
+  /**
+   * The integrators among which integrate_probed chooses.
+   */
+  enum integration_engine
+  {
+    /// Adaptive Gauss-Kronrod: integrate.
+    Engine_QAG,
+    /// Algebraic-logarithmic endpoint weights: integrate_singular_endpoints.
+    Engine_QAWS,
+    /// The tanh-sinh double exponential rule: integrate_tanh_sinh.
+    Engine_Tanh_Sinh,
+    /// Adaptive Gauss-Kronrod with extrapolation: integrate_singular.
+    Engine_QAGS
+  };
+
+  /**
+   * The classification of the behavior of an integrand at an endpoint.
+   */
+  enum endpoint_kind
+  {
+    /// Smooth: a nonnegative integer power and smooth corrections.
+    Endpoint_Regular,
+    /// @f$ d^\alpha \log^\mu d @f$ with @f$ \alpha @f$ a fraction
+    /// of small denominator or @f$ \mu = 1 @f$.
+    Endpoint_Algebraic,
+    /// A power law with any other exponent or a singular correction
+    /// to a smooth leading term such as @f$ 1 + \sqrt{d} @f$.
+    Endpoint_Irregular,
+    /// No power law could be fitted: non-finite values,
+    /// sign changes or zeros at the probes.
+    Endpoint_Unknown
+  };
+
+  /**
+   * The estimated behavior @f$ f \sim C d^\alpha \log^\mu d @f$
+   * of an integrand at distance @f$ d @f$ from an endpoint.
+   */
+  template<typename Tp>
+    struct endpoint_behavior_t
+    {
+      /// The classification.
+      endpoint_kind kind = Endpoint_Unknown;
+      /// The algebraic exponent, snapped to a simple fraction if close.
+      Tp alpha = Tp{0};
+      /// The power of the logarithm: 0 or 1.
+      int mu = 0;
+      /// The exponent of the leading singular correction
+      /// of an irregular endpoint with a smooth leading term.
+      Tp correction = Tp{0};
+    };
+
+  /**
+   * The return type of integrate_probed: the result and error estimate,
+   * the engine that produced them, the endpoint behaviors found
+   * and the total number of function evaluations including the probes.
+   */
+  template<typename Tp, typename RetTp>
+    struct probed_integral_t
+    {
+      using AreaTp = decltype(RetTp{} * Tp{});
+      using AbsAreaTp = decltype(std::abs(AreaTp{}));
+
+      /// Result of the integral.
+      AreaTp result = AreaTp{};
+      /// Absolute value of estimated error.
+      AbsAreaTp abserr = AbsAreaTp{};
+      /// The engine that produced the result.
+      integration_engine engine = Engine_QAG;
+      /// The behavior at the lower limit.
+      endpoint_behavior_t<Tp> lower_behavior;
+      /// The behavior at the upper limit.
+      endpoint_behavior_t<Tp> upper_behavior;
+      /// The number of function evaluations.
+      std::size_t num_evals = 0;
+      /// The error code: NO_ERROR if the tolerance was met.
+      int error_code = NO_ERROR;
+      /// A description of the error more specific than the code or null.
+      const char* message = nullptr;
+    };
+
+  /**
+   * Probe @c func at geometrically decreasing distances
+   * from @c endpoint toward @c other and estimate its endpoint behavior.
+   * This costs six evaluations.
+   */
+  template<typename Tp, typename FuncTp>
+    endpoint_behavior_t<Tp>
+    probe_endpoint(FuncTp func, Tp endpoint, Tp other);
+
+  /**
+   * Integrate over a finite interval choosing the integrator from the
+   * behavior of the integrand at the endpoints.
+   *
+   * Each endpoint is probed with a few evaluations
+   * (see probe_endpoint).  Then
+   *  - if both endpoints are regular QAG (integrate) is used;
+   *  - if the endpoint behaviors are simple algebraic-logarithmic
+   *    powers QAWS (integrate_singular_endpoints) is given the weight
+   *    @f$ (x-a)^\alpha (b-x)^\beta \log^\mu(x-a) \log^\nu(b-x) @f$
+   *    and the quotient of the integrand by it;
+   *  - other power-law endpoint singularities go to tanh-sinh
+   *    (integrate_tanh_sinh), which clusters its nodes at both ends;
+   *  - integrands with no power law at an endpoint go to QAGS
+   *    (integrate_singular).
+   * If the chosen engine throws or misses the tolerance QAGS is run
+   * as a fallback.  The engine that produced the result is reported.
+   * An endpoint exponent of -1 or less means the integral diverges
+   * and an integration_error with DIVERGENCE_ERROR is thrown.
+   *
+   * @param func The function to be integrated.
+   * @param lower The lower limit of integration.
+   * @param upper The upper limit of integration.
+   * @param max_abs_err The absolute error limit.
+   * @param max_rel_err The relative error limit.
+   * @param max_iter The maximum number of subintervals of the adaptive
+   *                 engines.
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    integrate_probed(FuncTp func, Tp lower, Tp upper,
+		     Tp max_abs_err, Tp max_rel_err,
+		     std::size_t max_iter = 1024)
+    -> probed_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+  /**
+   * Integrate over a finite interval choosing the integrator from the
+   * behavior of the integrand at the endpoints without throwing
+   * when the QAGS fallback misses the tolerance or the integral diverges.
+   * The error code and message are set in the result instead.
+   * Invalid tolerances still throw.
+   * The arguments are those of the throwing overload.
+   */
+  template<typename Tp, typename FuncTp>
+    auto
+    integrate_probed(std::nothrow_t, FuncTp func, Tp lower, Tp upper,
+		     Tp max_abs_err, Tp max_rel_err,
+		     std::size_t max_iter = 1024)
+    -> probed_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>;
+
+} // namespace emsr
+
+#include <emsr/singularity_probe.tcc>
+
+#endif // SINGULARITY_PROBE_H
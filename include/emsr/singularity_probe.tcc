@@ -0,0 +1,343 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements endpoint singularity probing and integrator selection.
+
+#ifndef SINGULARITY_PROBE_TCC
+#define SINGULARITY_PROBE_TCC 1
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <utility>
+
+#include <emsr/integration_error.h>
+
+namespace emsr
+{
+
+  /**
+   * The integrand is sampled at distances @f$ h 8^{-k} @f$, k = 3, ..., 8,
+   * from the endpoint where @f$ h @f$ is the length of the interval.
+   * A line is fitted by least squares to @f$ \log|f| - \mu \log|\log d| @f$
+   * against @f$ \log d @f$ on the four closest samples for
+   * @f$ \mu = 0 @f$ and @f$ \mu = 1 @f$; the logarithm is taken
+   * when it fits far better.  The slope is the exponent.
+   * For a nonnegative integer exponent without logarithm the differences
+   * of @f$ f / d^\alpha @f$ at successive samples shrink like
+   * @f$ d^\beta @f$ where @f$ \beta @f$ is the exponent
+   * of the leading correction: integral for smooth functions.
+   */
+  template<typename Tp, typename FuncTp>
+    endpoint_behavior_t<Tp>
+    probe_endpoint(FuncTp func, Tp endpoint, Tp other)
+    {
+      using RetTp = std::invoke_result_t<FuncTp, Tp>;
+
+      constexpr int s_num_probes = 6;
+      constexpr int s_num_fit = 4;
+      const auto s_eps = std::numeric_limits<Tp>::epsilon();
+      const auto s_ratio = Tp{8};
+      const auto s_log_ratio = std::log(s_ratio);
+      // Residual of a pure power fit above which a logarithm is tried.
+      const auto s_log_resid = Tp{1.0e-4L};
+      // Distance of an exponent from a simple fraction to snap to it.
+      const auto s_snap_tol = Tp{1.0e-4L};
+
+      endpoint_behavior_t<Tp> out;
+
+      std::array<Tp, s_num_probes> logd;
+      std::array<RetTp, s_num_probes> f;
+      int num_zero = 0;
+      auto d = (other - endpoint) / (s_ratio * s_ratio * s_ratio);
+      for (int k = 0; k < s_num_probes; ++k, d /= s_ratio)
+	{
+	  const auto x = endpoint + d;
+	  const auto dist = std::abs(x - endpoint);
+	  f[k] = func(x);
+	  if (dist == Tp{0} || !std::isfinite(std::abs(f[k])))
+	    return out;
+	  if (f[k] == RetTp{})
+	    ++num_zero;
+	  logd[k] = std::log(dist);
+	}
+      if (num_zero == s_num_probes)
+	{
+	  out.kind = Endpoint_Regular;
+	  return out;
+	}
+      else if (num_zero > 0)
+	return out;
+      for (int k = 0; k + 1 < s_num_probes; ++k)
+	if (std::real(f[k] * std::conj(f[k + 1])) <= 0)
+	  return out;
+
+      // Least squares fit of log|f| - mu log|log d| = c + alpha log d.
+      auto fit = [&f, &logd](int mu)
+	{
+	  auto sx = Tp{0}, sy = Tp{0}, sxx = Tp{0}, sxy = Tp{0};
+	  std::array<Tp, s_num_fit> y;
+	  for (int i = 0; i < s_num_fit; ++i)
+	    {
+	      const auto k = s_num_probes - s_num_fit + i;
+	      y[i] = std::log(std::abs(f[k]))
+		   - Tp(mu) * std::log(std::abs(logd[k]));
+	      sx += logd[k];
+	      sy += y[i];
+	      sxx += logd[k] * logd[k];
+	      sxy += logd[k] * y[i];
+	    }
+	  const auto n = Tp(s_num_fit);
+	  const auto alpha = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+	  const auto c = (sy - alpha * sx) / n;
+	  auto resid = Tp{0};
+	  for (int i = 0; i < s_num_fit; ++i)
+	    {
+	      const auto k = s_num_probes - s_num_fit + i;
+	      const auto r = y[i] - c - alpha * logd[k];
+	      resid += r * r;
+	    }
+	  return std::make_pair(alpha, std::sqrt(resid / n));
+	};
+
+      const auto [alpha0, resid0] = fit(0);
+      out.alpha = alpha0;
+      out.mu = 0;
+      if (resid0 > s_log_resid)
+	{
+	  const auto [alpha1, resid1] = fit(1);
+	  if (std::isfinite(resid1) && resid1 < Tp{0.01L} * resid0)
+	    {
+	      out.alpha = alpha1;
+	      out.mu = 1;
+	    }
+	}
+
+      // Snap the exponent to a fraction with denominator up to four.
+      bool snapped = false;
+      for (int q = 1; q <= 4 && !snapped; ++q)
+	{
+	  const auto p = std::nearbyint(out.alpha * Tp(q));
+	  if (std::abs(out.alpha - p / Tp(q)) < s_snap_tol)
+	    {
+	      out.alpha = p / Tp(q);
+	      snapped = true;
+	    }
+	}
+
+      if (!snapped)
+	out.kind = Endpoint_Irregular;
+      else if (out.mu == 1 || out.alpha != std::nearbyint(out.alpha)
+	       || out.alpha < Tp{0})
+	out.kind = Endpoint_Algebraic;
+      else
+	{
+	  // Look for a singular correction to the smooth leading term.
+	  std::array<RetTp, s_num_probes> g;
+	  auto gmax = Tp{0};
+	  for (int k = 0; k < s_num_probes; ++k)
+	    {
+	      g[k] = f[k] / std::exp(out.alpha * logd[k]);
+	      gmax = std::max(gmax, Tp(std::abs(g[k])));
+	    }
+	  std::array<Tp, s_num_probes - 1> delta;
+	  for (int k = 0; k + 1 < s_num_probes; ++k)
+	    delta[k] = std::abs(g[k] - g[k + 1]);
+
+	  out.kind = Endpoint_Regular;
+	  const auto noise = Tp{1000} * s_eps * gmax;
+	  for (int k = 0; k + 2 < s_num_probes; ++k)
+	    if (delta[k] > noise && delta[k + 1] > noise)
+	      {
+		const auto beta = std::log(delta[k] / delta[k + 1])
+				/ s_log_ratio;
+		if (std::abs(beta - std::nearbyint(beta)) > Tp{0.1L}
+		    || beta < Tp{0.5L})
+		  {
+		    out.kind = Endpoint_Irregular;
+		    out.correction = beta;
+		  }
+		break;
+	      }
+	}
+
+      return out;
+    }
+
+  template<typename Tp, typename FuncTp>
+    auto
+    integrate_probed(std::nothrow_t, FuncTp func, Tp lower, Tp upper,
+		     Tp max_abs_err, Tp max_rel_err,
+		     std::size_t max_iter)
+    -> probed_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      using RetTp = std::invoke_result_t<FuncTp, Tp>;
+      using out_t = probed_integral_t<Tp, RetTp>;
+
+      // Number of halvings of the tanh-sinh step.
+      constexpr int s_tanh_sinh_iter = 6;
+
+      if (lower == upper)
+	return out_t{};
+      else if (upper < lower)
+	{
+	  auto out = integrate_probed(std::nothrow, func, upper, lower,
+				      max_abs_err, max_rel_err, max_iter);
+	  out.result = -out.result;
+	  std::swap(out.lower_behavior, out.upper_behavior);
+	  return out;
+	}
+
+      out_t out;
+      std::size_t count = 0;
+      auto counted = [&func, &count](Tp x) { ++count; return func(x); };
+
+      out.lower_behavior = probe_endpoint(counted, lower, upper);
+      out.upper_behavior = probe_endpoint(counted, upper, lower);
+      const auto& lb = out.lower_behavior;
+      const auto& ub = out.upper_behavior;
+
+      for (const auto& eb : {lb, ub})
+	if (eb.kind != Endpoint_Unknown && eb.alpha <= Tp{-1})
+	  {
+	    out.num_evals = count;
+	    out.error_code = DIVERGENCE_ERROR;
+	    out.message = "integrate_probed: "
+			  "The integral diverges at an endpoint.";
+	    return out;
+	  }
+
+      const bool unknown = lb.kind == Endpoint_Unknown
+			|| ub.kind == Endpoint_Unknown;
+      const bool irregular = lb.kind == Endpoint_Irregular
+			  || ub.kind == Endpoint_Irregular;
+      const bool logs = (lb.kind == Endpoint_Algebraic && lb.mu == 1)
+		     || (ub.kind == Endpoint_Algebraic && ub.mu == 1);
+      if (unknown)
+	out.engine = Engine_QAGS;
+      else if (lb.kind == Endpoint_Regular && ub.kind == Endpoint_Regular)
+	out.engine = Engine_QAG;
+      else if (!irregular && !(logs && upper - lower > Tp{1}))
+	// Over a longer interval the logarithmic weight vanishes inside
+	// and its quotient is ill-conditioned there.
+	out.engine = Engine_QAWS;
+      else
+	out.engine = Engine_Tanh_Sinh;
+
+      auto accept = [&out, max_abs_err, max_rel_err](const auto& res)
+	{
+	  out.result = res.result;
+	  out.abserr = res.abserr;
+	  return res.abserr <= std::max(max_abs_err,
+					max_rel_err * std::abs(res.result));
+	};
+
+      bool done = false;
+      try
+	{
+	  switch (out.engine)
+	    {
+	    case Engine_QAG:
+	      done = accept(integrate(counted, lower, upper,
+				      max_abs_err, max_rel_err, max_iter));
+	      break;
+	    case Engine_QAWS:
+	      {
+		const auto alpha = lb.kind == Endpoint_Algebraic
+				 ? lb.alpha : Tp{0};
+		const auto beta = ub.kind == Endpoint_Algebraic
+				? ub.alpha : Tp{0};
+		const int mu = lb.kind == Endpoint_Algebraic ? lb.mu : 0;
+		const int nu = ub.kind == Endpoint_Algebraic ? ub.mu : 0;
+		// QAWS samples the quotient at the endpoints where
+		// it is indeterminate; move those samples just inside.
+		const auto delta = Tp{8} * std::numeric_limits<Tp>::epsilon()
+				 * std::max({std::abs(lower), std::abs(upper),
+					     upper - lower});
+		auto quotient = [&counted, lower, upper, alpha, beta, mu, nu,
+				 delta](Tp x)
+		  {
+		    x = std::clamp(x, lower + delta, upper - delta);
+		    auto w = std::pow(x - lower, alpha)
+			   * std::pow(upper - x, beta);
+		    if (mu == 1)
+		      w *= std::log(x - lower);
+		    if (nu == 1)
+		      w *= std::log(upper - x);
+		    return counted(x) / w;
+		  };
+		done = accept(integrate_singular_endpoints(quotient,
+				lower, upper, alpha, beta, mu, nu,
+				max_abs_err, max_rel_err, max_iter));
+		break;
+	      }
+	    case Engine_Tanh_Sinh:
+	      done = accept(integrate_tanh_sinh(counted, lower, upper,
+						max_abs_err, max_rel_err,
+						s_tanh_sinh_iter));
+	      break;
+	    case Engine_QAGS:
+	      break;
+	    }
+	}
+      catch (const std::runtime_error&)
+	{
+	  done = false;
+	}
+
+      if (!done)
+	{
+	  out.engine = Engine_QAGS;
+	  integration_workspace<Tp, RetTp> workspace(max_iter);
+	  const auto stat = qags_integrate(std::nothrow, workspace, counted,
+					   lower, upper,
+					   max_abs_err, max_rel_err);
+	  out.result = stat.result;
+	  out.abserr = stat.abserr;
+	  out.error_code = stat.error_code;
+	  out.message = stat.message;
+	}
+
+      out.num_evals = count;
+      return out;
+    }
+
+  template<typename Tp, typename FuncTp>
+    auto
+    integrate_probed(FuncTp func, Tp lower, Tp upper,
+		     Tp max_abs_err, Tp max_rel_err,
+		     std::size_t max_iter)
+    -> probed_integral_t<Tp, std::invoke_result_t<FuncTp, Tp>>
+    {
+      const auto out = integrate_probed(std::nothrow, func, lower, upper,
+					max_abs_err, max_rel_err, max_iter);
+      if (out.error_code != NO_ERROR)
+	{
+	  if (out.message != nullptr)
+	    throw integration_error(out.message, out.error_code,
+				    out.result, out.abserr);
+	  check_error("qags_integrate", out.error_code,
+		      out.result, out.abserr);
+	}
+      return out;
+    }
+
+} // namespace emsr
+
+#endif // SINGULARITY_PROBE_TCC
@@ -0,0 +1,223 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements dimension-adaptive Smolyak sparse grid integration.
+
+#ifndef SPARSE_GRID_INTEGRAL_H
+#define SPARSE_GRID_INTEGRAL_H 1
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new> // For std::nothrow
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <emsr/integration.h>
+
+namespace emsr
+{
+
+  /**
+   * The one-dimensional rule families from which sparse grids are built.
+   */
+  enum sparse_grid_family
+  {
+    /// Clenshaw-Curtis on [-1, 1]: 1, 3, 5, 9, 17, ... points.
+    Sparse_Clenshaw_Curtis,
+    /// Gauss-Patterson on [-1, 1]: 1, 3, 7, 15, ..., 511 points.
+    Sparse_Gauss_Patterson,
+    /// Gauss-Hermite on the real line with weight @f$ e^{-x^2} @f$:
+    /// 1, 3, 5, 7, ... points.  These rules are not nested;
+    /// only the central node is shared between levels.
+    Sparse_Gauss_Hermite
+  };
+
+  /**
+   * The difference rules of a family of one-dimensional rules
+   * @f$ \Delta_l = Q_l - Q_{l-1} @f$, @f$ Q_{-1} = 0 @f$,
+   * on a common table of distinct nodes.
+   * For nested families the nodes of @f$ \Delta_l @f$ are those of @f$ Q_l @f$.
+   */
+  template<typename Tp>
+    struct sparse_grid_rule
+    {
+      /// The distinct nodes of all the levels in order of first appearance.
+      std::vector<Tp> node;
+      /// The (node index, weight) pairs of the difference rule of each level.
+      std::vector<std::vector<std::pair<std::size_t, Tp>>> delta;
+
+      /// Return the highest level.
+      int
+      max_level() const
+      { return int(this->delta.size()) - 1; }
+    };
+
+  /**
+   * Return the difference rules of a family up to @c max_level.
+   */
+  template<typename Tp>
+    sparse_grid_rule<Tp>
+    make_sparse_grid_rule(sparse_grid_family family, int max_level);
+
+  /**
+   * Dimension-adaptive Smolyak sparse grid integration after
+   * T. Gerstner and M. Griebel, Dimension-Adaptive Tensor-Product
+   * Quadrature, Computing 71 (2003), 65-87.
+   *
+   * The integral is the sum of the tensor products of difference rules
+   * @f$ \Delta_{k_1} \otimes \cdots \otimes \Delta_{k_d} @f$ over a set
+   * of multi-indices @f$ k @f$.  The active index with the largest
+   * contribution is retired and those of its forward neighbours whose
+   * backward neighbours are all retired are added.  The sum of the
+   * magnitudes of the active contributions is the error estimate.
+   * Directions along which the integrand does not vary are thus
+   * never refined.
+   *
+   * Every function value is kept by grid point so a point shared
+   * by several tensor products is evaluated once.  The new points
+   * of each step are evaluated on @c num_threads threads
+   * (0 means hardware concurrency) and the results do not depend
+   * on the number of threads.
+   */
+  template<typename Tp>
+    class sparse_grid_integral
+    {
+    public:
+
+      /**
+       * Build the integrator for a family with levels up to @c max_level;
+       * a negative @c max_level means the highest level of the family.
+       * The difference rules are built once per family and level
+       * and shared through the gauss_rule_registry.
+       */
+      explicit sparse_grid_integral(sparse_grid_family family,
+				    int max_level = -1);
+
+      /**
+       * Integrate @c func of the point
+       * @f$ x_i = center_i + scale_i y_i @f$ where the @f$ y_i @f$
+       * are the nodes of the family.  The result is scaled by
+       * @f$ \prod_i scale_i @f$ so, for the families on [-1, 1],
+       * @c center and @c scale are the midpoint and the half-width
+       * of the box.
+       *
+       * @param func The function of a point to be integrated.
+       * @param center The center of the grid.
+       * @param scale The scale of the grid along each axis.
+       * @param max_abs_err The limit on absolute error.
+       * @param max_rel_err The limit on relative error.
+       * @param max_evals The maximum number of function evaluations.
+       * @param num_threads The number of threads.
+       *
+       * This overload does not throw when the tolerance is not met
+       * within the evaluation budget; the error code, the best result
+       * and error estimate found and the number of function evaluations
+       * are returned instead.  Invalid tolerances still throw.
+       */
+      template<typename FuncTp, std::size_t Dim>
+	auto
+	integrate(std::nothrow_t, FuncTp func,
+		  const std::array<Tp, Dim>& center,
+		  const std::array<Tp, Dim>& scale,
+		  Tp max_abs_err, Tp max_rel_err,
+		  std::size_t max_evals = 1000000,
+		  unsigned int num_threads = 1) const
+	-> adaptive_status_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+      /**
+       * Integrate @c func on the sparse grid.
+       * An integration_error is thrown if the tolerance is not met.
+       * The arguments are those of the non-throwing overload.
+       */
+      template<typename FuncTp, std::size_t Dim>
+	auto
+	integrate(FuncTp func,
+		  const std::array<Tp, Dim>& center,
+		  const std::array<Tp, Dim>& scale,
+		  Tp max_abs_err, Tp max_rel_err,
+		  std::size_t max_evals = 1000000,
+		  unsigned int num_threads = 1) const
+	-> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+	{
+	  return check_status(__func__,
+			      this->integrate(std::nothrow, func, center,
+					      scale, max_abs_err, max_rel_err,
+					      max_evals, num_threads));
+	}
+
+      /// Return the rule family.
+      sparse_grid_family
+      family() const
+      { return this->m_family; }
+
+      /// Return the highest level in each direction.
+      int
+      max_level() const
+      { return this->m_rule->max_level(); }
+
+      /// Return the difference rules.
+      const sparse_grid_rule<Tp>&
+      rule() const
+      { return *this->m_rule; }
+
+    private:
+
+      sparse_grid_family m_family;
+      std::shared_ptr<const sparse_grid_rule<Tp>> m_rule;
+    };
+
+  /**
+   * Integrate over a box with a dimension-adaptive sparse grid
+   * of Clenshaw-Curtis or Gauss-Patterson rules.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_sparse_grid(FuncTp func,
+			  const std::array<Tp, Dim>& lower,
+			  const std::array<Tp, Dim>& upper,
+			  Tp max_abs_err, Tp max_rel_err,
+			  sparse_grid_family family = Sparse_Clenshaw_Curtis,
+			  std::size_t max_evals = 1000000,
+			  unsigned int num_threads = 1)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+  /**
+   * Integrate @f$ f(x) \prod_i e^{-((x_i - center_i)/scale_i)^2} @f$
+   * over all space with a dimension-adaptive sparse grid
+   * of Gauss-Hermite rules.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_sparse_grid_hermite(FuncTp func,
+				  const std::array<Tp, Dim>& center,
+				  const std::array<Tp, Dim>& scale,
+				  Tp max_abs_err, Tp max_rel_err,
+				  std::size_t max_evals = 1000000,
+				  unsigned int num_threads = 1)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+} // namespace emsr
+
+#include <emsr/sparse_grid_integral.tcc>
+
+#endif // SPARSE_GRID_INTEGRAL_H
@@ -0,0 +1,394 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements dimension-adaptive Smolyak sparse grid integration.
+
+#ifndef SPARSE_GRID_INTEGRAL_TCC
+#define SPARSE_GRID_INTEGRAL_TCC 1
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include <emsr/gauss_rule_registry.h>
+#include <emsr/integration_error.h>
+#include <emsr/parallel_for.h>
+
+namespace emsr
+{
+
+  /**
+   * Build the rules of each level, give every distinct node an index
+   * and difference the weights of successive levels.
+   * Nodes of different levels closer than a few ulps are taken
+   * to be the same node.
+   */
+  template<typename Tp>
+    sparse_grid_rule<Tp>
+    make_sparse_grid_rule(sparse_grid_family family, int max_level)
+    {
+      const auto s_eps = std::numeric_limits<Tp>::epsilon();
+
+      sparse_grid_rule<Tp> out;
+
+      // The nodes sorted by value with their indices for lookup.
+      std::vector<std::pair<Tp, std::size_t>> sorted;
+      auto node_index = [&out, &sorted, s_eps](Tp x)
+	{
+	  auto it = std::lower_bound(sorted.begin(), sorted.end(),
+				     std::make_pair(x, std::size_t{0}));
+	  const auto tol = Tp{64} * s_eps * std::max(Tp{1}, std::abs(x));
+	  if (it != sorted.end() && std::abs(it->first - x) <= tol)
+	    return it->second;
+	  if (it != sorted.begin() && std::abs(std::prev(it)->first - x) <= tol)
+	    return std::prev(it)->second;
+	  const auto index = out.node.size();
+	  out.node.push_back(x);
+	  sorted.insert(it, {x, index});
+	  return index;
+	};
+
+      // The rule of each level as (node index, weight) pairs.
+      auto level_rule = [&](int level)
+	{
+	  std::vector<std::pair<std::size_t, Tp>> rule;
+	  switch (family)
+	    {
+	    case Sparse_Clenshaw_Curtis:
+	      if (level == 0)
+		rule.emplace_back(node_index(Tp{0}), Tp{2});
+	      else
+		for (const auto& pt
+		     : clenshaw_curtis_rule<Tp>(std::size_t{1} << level))
+		  rule.emplace_back(node_index(pt.point), pt.weight);
+	      break;
+	    case Sparse_Gauss_Patterson:
+	      {
+		const auto gp = gauss_patterson_rules<Tp>(max_level);
+		const auto& w = gp->weight[level];
+		rule.emplace_back(node_index(gp->point[0]), w[0]);
+		for (std::size_t i = 1; i < w.size(); ++i)
+		  {
+		    rule.emplace_back(node_index(-gp->point[i]), w[i]);
+		    rule.emplace_back(node_index(gp->point[i]), w[i]);
+		  }
+	      }
+	      break;
+	    case Sparse_Gauss_Hermite:
+	      {
+		using rule_t = fixed_gauss_hermite_integral<Tp>;
+		const int n = 2 * level + 1;
+		const auto gh = detail::cached_gauss_rule<rule_t, Tp>
+				  ({Gauss_Hermite, n, Tp{0}},
+				   [n](){ return rule_t(n, Tp{0}); });
+		for (int i = 0; i < n; ++i)
+		  rule.emplace_back(node_index(gh->nodes()[i]),
+				    gh->weights()[i]);
+	      }
+	      break;
+	    }
+	  return rule;
+	};
+
+      std::map<std::size_t, Tp> prev;
+      for (int level = 0; level <= max_level; ++level)
+	{
+	  std::map<std::size_t, Tp> curr;
+	  for (const auto& [index, weight] : level_rule(level))
+	    curr[index] += weight;
+	  auto diff = curr;
+	  for (const auto& [index, weight] : prev)
+	    diff[index] -= weight;
+	  out.delta.emplace_back(diff.begin(), diff.end());
+	  prev = std::move(curr);
+	}
+
+      return out;
+    }
+
+  template<typename Tp>
+    sparse_grid_integral<Tp>::
+    sparse_grid_integral(sparse_grid_family family, int max_level)
+    : m_family(family),
+      m_rule()
+    {
+      int top_level = 0;
+      switch (family)
+	{
+	case Sparse_Clenshaw_Curtis:
+	  top_level = 12;
+	  break;
+	case Sparse_Gauss_Patterson:
+	  top_level = gauss_patterson_integral<Tp>::s_max_level;
+	  break;
+	case Sparse_Gauss_Hermite:
+	  top_level = 24;
+	  break;
+	default:
+	  throw std::domain_error("sparse_grid_integral: Unknown family.");
+	}
+      if (max_level < 0)
+	max_level = top_level;
+      else if (max_level > top_level)
+	throw std::domain_error("sparse_grid_integral: "
+				"max_level out of range.");
+      this->m_rule = gauss_rule_registry<Tp>::instance()
+			.template get<sparse_grid_rule<Tp>>
+			({Sparse_Grid, max_level, Tp(family)},
+			 [family, max_level]()
+			 { return make_sparse_grid_rule<Tp>(family, max_level); });
+    }
+
+  template<typename Tp>
+    template<typename FuncTp, std::size_t Dim>
+      auto
+      sparse_grid_integral<Tp>::
+      integrate(std::nothrow_t, FuncTp func,
+		const std::array<Tp, Dim>& center,
+		const std::array<Tp, Dim>& scale,
+		Tp max_abs_err, Tp max_rel_err,
+		std::size_t max_evals,
+		unsigned int num_threads) const
+      -> adaptive_status_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+      {
+	using RetTp = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>;
+	using AreaTp = decltype(RetTp{} * Tp{});
+	using AbsAreaTp = decltype(std::abs(AreaTp{}));
+	// A multi-index of levels and a grid point as indices of nodes.
+	using index_t = std::array<unsigned char, Dim>;
+	using point_t = std::array<std::uint32_t, Dim>;
+
+	if (!valid_tolerances(max_abs_err, max_rel_err))
+	  {
+	    std::ostringstream msg;
+	    msg << "sparse_grid_integral: Tolerance cannot be achieved"
+		   " with given absolute (" << max_abs_err << ") and relative ("
+		<< max_rel_err << ") error limits.";
+	    throw std::runtime_error(msg.str().c_str());
+	  }
+
+	const auto& rule = *this->m_rule;
+	const auto top = rule.max_level();
+	auto jacobian = Tp{1};
+	for (std::size_t i = 0; i < Dim; ++i)
+	  jacobian *= scale[i];
+
+	std::map<point_t, RetTp> fval;
+	std::size_t num_evals = 0;
+
+	// Visit the points and weights of the tensor product
+	// of the difference rules of a multi-index.
+	auto for_each_point = [&rule](const index_t& k, auto visit)
+	  {
+	    std::array<std::size_t, Dim> digit{};
+	    point_t pt;
+	    while (true)
+	      {
+		auto weight = Tp{1};
+		for (std::size_t i = 0; i < Dim; ++i)
+		  {
+		    const auto& [node, w] = rule.delta[k[i]][digit[i]];
+		    pt[i] = std::uint32_t(node);
+		    weight *= w;
+		  }
+		visit(pt, weight);
+		std::size_t i = 0;
+		for (; i < Dim; ++i)
+		  {
+		    if (++digit[i] < rule.delta[k[i]].size())
+		      break;
+		    digit[i] = 0;
+		  }
+		if (i == Dim)
+		  break;
+	      }
+	  };
+
+	// Evaluate the contributions of a set of multi-indices
+	// calling the function once on each new grid point.
+	// Return false, evaluating nothing, if that would
+	// exceed the evaluation budget.
+	std::vector<point_t> fresh;
+	std::vector<RetTp> value;
+	auto contributions = [&](const std::vector<index_t>& idx,
+				 std::vector<AreaTp>& delta)
+	  {
+	    fresh.clear();
+	    std::map<point_t, std::size_t> pending;
+	    for (const auto& k : idx)
+	      for_each_point(k, [&](const point_t& pt, Tp)
+		{
+		  if (fval.find(pt) == fval.end()
+		      && pending.emplace(pt, fresh.size()).second)
+		    fresh.push_back(pt);
+		});
+	    if (num_evals + fresh.size() > max_evals)
+	      return false;
+
+	    value.resize(fresh.size());
+	    parallel_for(0, fresh.size(), num_threads,
+			 [&](std::size_t j)
+			 {
+			   std::array<Tp, Dim> x;
+			   for (std::size_t i = 0; i < Dim; ++i)
+			     x[i] = center[i] + scale[i] * rule.node[fresh[j][i]];
+			   value[j] = func(x);
+			 });
+	    for (std::size_t j = 0; j < fresh.size(); ++j)
+	      fval.emplace(fresh[j], value[j]);
+	    num_evals += fresh.size();
+
+	    delta.assign(idx.size(), AreaTp{0});
+	    for (std::size_t m = 0; m < idx.size(); ++m)
+	      {
+		auto sum = AreaTp{0};
+		for_each_point(idx[m], [&](const point_t& pt, Tp weight)
+		  { sum += weight * fval.find(pt)->second; });
+		delta[m] = jacobian * sum;
+	      }
+	    return true;
+	  };
+
+	std::map<index_t, AreaTp> active;
+	std::map<index_t, AreaTp> retired;
+	std::vector<AreaTp> delta;
+
+	const index_t k0{};
+	if (!contributions({k0}, delta))
+	  return {AreaTp{0}, AbsAreaTp{0}, MAX_ITER_ERROR, num_evals,
+		  "sparse_grid_integral: "
+		  "Evaluation budget too small for one point."};
+	active.emplace(k0, delta[0]);
+	auto result = delta[0];
+	auto errsum = AbsAreaTp(std::abs(delta[0]));
+
+	int error_type = NO_ERROR;
+	std::vector<index_t> forward;
+	while (true)
+	  {
+	    const auto tolerance = std::max(max_abs_err,
+					    max_rel_err * std::abs(result));
+	    if (errsum <= tolerance)
+	      return {result, errsum, NO_ERROR, num_evals};
+	    if (active.empty())
+	      {
+		error_type = MAX_ITER_ERROR;
+		break;
+	      }
+
+	    // Take the active index with the largest contribution.
+	    auto curr = active.begin();
+	    for (auto it = active.begin(); it != active.end(); ++it)
+	      if (std::abs(it->second) > std::abs(curr->second))
+		curr = it;
+	    const auto k = curr->first;
+
+	    // Its admissible forward neighbours once it is retired.
+	    forward.clear();
+	    for (std::size_t j = 0; j < Dim; ++j)
+	      {
+		if (k[j] >= top)
+		  continue;
+		auto kf = k;
+		++kf[j];
+		bool admissible = true;
+		for (std::size_t i = 0; i < Dim && admissible; ++i)
+		  if (i != j && kf[i] > 0)
+		    {
+		      auto kb = kf;
+		      --kb[i];
+		      admissible = retired.count(kb) != 0;
+		    }
+		if (admissible)
+		  forward.push_back(kf);
+	      }
+
+	    if (!contributions(forward, delta))
+	      {
+		error_type = MAX_ITER_ERROR;
+		break;
+	      }
+
+	    errsum -= std::abs(curr->second);
+	    retired.insert(*curr);
+	    active.erase(curr);
+	    for (std::size_t m = 0; m < forward.size(); ++m)
+	      {
+		active.emplace(forward[m], delta[m]);
+		result += delta[m];
+		errsum += std::abs(delta[m]);
+	      }
+	  }
+
+	return {result, errsum, error_type, num_evals};
+      }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_sparse_grid(FuncTp func,
+			  const std::array<Tp, Dim>& lower,
+			  const std::array<Tp, Dim>& upper,
+			  Tp max_abs_err, Tp max_rel_err,
+			  sparse_grid_family family,
+			  std::size_t max_evals,
+			  unsigned int num_threads)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      if (family == Sparse_Gauss_Hermite)
+	throw std::domain_error("integrate_sparse_grid: Use"
+				" integrate_sparse_grid_hermite"
+				" for the Gauss-Hermite family.");
+
+      std::array<Tp, Dim> center, scale;
+      for (std::size_t i = 0; i < Dim; ++i)
+	{
+	  center[i] = (lower[i] + upper[i]) / Tp{2};
+	  scale[i] = (upper[i] - lower[i]) / Tp{2};
+	}
+      const sparse_grid_integral<Tp> grid(family);
+      return grid.integrate(func, center, scale,
+			    max_abs_err, max_rel_err,
+			    max_evals, num_threads);
+    }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_sparse_grid_hermite(FuncTp func,
+				  const std::array<Tp, Dim>& center,
+				  const std::array<Tp, Dim>& scale,
+				  Tp max_abs_err, Tp max_rel_err,
+				  std::size_t max_evals,
+				  unsigned int num_threads)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      const sparse_grid_integral<Tp> grid(Sparse_Gauss_Hermite);
+      return grid.integrate(func, center, scale,
+			    max_abs_err, max_rel_err,
+			    max_evals, num_threads);
+    }
+
+} // namespace emsr
+
+#endif // SPARSE_GRID_INTEGRAL_TCC
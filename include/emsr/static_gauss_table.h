@@ -0,0 +1,100 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements compile-time generation of Gauss-Legendre
+// and Gauss-Kronrod tables.
+
+#ifndef STATIC_GAUSS_TABLE_H
+#define STATIC_GAUSS_TABLE_H 1
+
+#include <array>
+#include <cstddef>
+
+namespace emsr
+{
+
+  /**
+   * A Gauss-Legendre rule of order @c N computed at compile time.
+   *
+   * The layout matches gauss_legendre_table: only the nonnegative
+   * abscissae are stored, in increasing order, so that for odd @c N
+   * the first point is the origin.
+   */
+  template<typename Tp, std::size_t N>
+    struct static_gauss_legendre_table
+    {
+      static_assert(N > 0, "static_gauss_legendre_table: order must be positive");
+
+      static constexpr std::size_t order = N;
+
+      std::array<Tp, (N + 1) / 2> point{};
+      std::array<Tp, (N + 1) / 2> weight{};
+
+      constexpr Tp
+      pt(std::size_t i) const
+      { return this->point[i]; }
+
+      constexpr Tp
+      wt(std::size_t i) const
+      { return this->weight[i]; }
+    };
+
+  /**
+   * A Gauss-Kronrod rule with @c KronrodN points computed at compile time.
+   *
+   * The layout matches that of build_gauss_kronrod and the qk_integrator
+   * tables: abscissae in decreasing order ending with the origin,
+   * the Kronrod weights for each, and the weights of the embedded Gauss rule.
+   */
+  template<typename Tp, std::size_t KronrodN>
+    struct static_gauss_kronrod_table
+    {
+      static_assert(KronrodN % 2 == 1 && KronrodN >= 3,
+		    "static_gauss_kronrod_table: the number of Kronrod points"
+		    " must be odd and at least three");
+
+      /// The order of the embedded Gauss rule.
+      static constexpr std::size_t gauss_order = (KronrodN - 1) / 2;
+
+      std::array<Tp, gauss_order + 1> x_kronrod{};
+      std::array<Tp, (gauss_order + 1) / 2> w_gauss{};
+      std::array<Tp, gauss_order + 1> w_kronrod{};
+    };
+
+  template<typename Tp, std::size_t N>
+    constexpr static_gauss_legendre_table<Tp, N>
+    make_gauss_legendre_table();
+
+  template<typename Tp, std::size_t KronrodN>
+    constexpr static_gauss_kronrod_table<Tp, KronrodN>
+    make_gauss_kronrod_table();
+
+  /// The Gauss-Legendre table of order @c N for type @c Tp.
+  template<typename Tp, std::size_t N>
+    inline constexpr static_gauss_legendre_table<Tp, N>
+    gauss_legendre_table_v = make_gauss_legendre_table<Tp, N>();
+
+  /// The Gauss-Kronrod table with @c KronrodN points for type @c Tp.
+  template<typename Tp, std::size_t KronrodN>
+    inline constexpr static_gauss_kronrod_table<Tp, KronrodN>
+    gauss_kronrod_table_v = make_gauss_kronrod_table<Tp, KronrodN>();
+
+} // namespace emsr
+
+#include <emsr/static_gauss_table.tcc>
+
+#endif // STATIC_GAUSS_TABLE_H
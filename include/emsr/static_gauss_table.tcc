@@ -0,0 +1,418 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef STATIC_GAUSS_TABLE_TCC
+#define STATIC_GAUSS_TABLE_TCC 1
+
+#include <limits>
+#include <stdexcept>
+
+namespace emsr
+{
+namespace detail
+{
+
+  template<typename Tp>
+    constexpr Tp
+    cx_abs(Tp x)
+    { return x < Tp{0} ? -x : x; }
+
+  /**
+   * Square root by Newton iteration for use in constant expressions.
+   */
+  template<typename Tp>
+    constexpr Tp
+    cx_sqrt(Tp x)
+    {
+      if (!(x > Tp{0}))
+	return Tp{0};
+      auto y = x > Tp{1} ? x : Tp{1};
+      auto prev = Tp{0};
+      for (int i = 0; i < 200; ++i)
+	{
+	  const auto next = (y + x / y) / Tp{2};
+	  if (next == y || next == prev)
+	    break;
+	  prev = y;
+	  y = next;
+	}
+      return y;
+    }
+
+  /**
+   * Cosine and sine by Taylor series for use in constant expressions.
+   * These are meant for arguments in @f$ [0, \pi] @f$ where they are
+   * accurate to a few ulps; they only seed Newton iterations here.
+   */
+  template<typename Tp>
+    constexpr Tp
+    cx_cos(Tp x)
+    {
+      const auto xx = x * x;
+      auto term = Tp{1};
+      auto sum = Tp{1};
+      for (int k = 1; k < 100; ++k)
+	{
+	  term *= -xx / Tp((2 * k - 1) * (2 * k));
+	  const auto next = sum + term;
+	  if (next == sum)
+	    break;
+	  sum = next;
+	}
+      return sum;
+    }
+
+  template<typename Tp>
+    constexpr Tp
+    cx_sin(Tp x)
+    {
+      const auto xx = x * x;
+      auto term = x;
+      auto sum = x;
+      for (int k = 1; k < 100; ++k)
+	{
+	  term *= -xx / Tp((2 * k) * (2 * k + 1));
+	  const auto next = sum + term;
+	  if (next == sum)
+	    break;
+	  sum = next;
+	}
+      return sum;
+    }
+
+  template<typename Tp>
+    inline constexpr Tp
+    cx_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+
+  /**
+   * Constant expression version of the Kronrod abscissa and weight
+   * computation in get_kronrod.
+   */
+  template<typename Tp, std::size_t M>
+    constexpr void
+    cx_get_kronrod(int n, Tp eps, Tp coef2,
+		   const std::array<Tp, M>& b,
+		   Tp& x, Tp& wk)
+    {
+      const int max_iter = 100;
+
+      const int m = (n + 1) / 2;
+      const bool even = (2 * m == n);
+
+      int ka = x == Tp{0} ? 1 : 0;
+
+      auto fd = Tp{0};
+      for (int iter = 1; iter <= max_iter; ++iter)
+	{
+	  Tp ai{}, d2{}, dif{};
+	  if (even)
+	    {
+	      ai = Tp(m + m + 1);
+	      d2 = ai * b[m];
+	      dif = Tp{2};
+	    }
+	  else
+	    {
+	      ai = Tp(m + 1);
+	      d2 = Tp{0};
+	      dif = Tp{1};
+	    }
+
+	  auto d1 = Tp{0};
+	  auto b0 = Tp{0};
+	  auto b1 = Tp{0};
+	  auto b2 = b[m];
+	  const auto yy = Tp{4} * x * x - Tp{2};
+	  for (int k = 1; k <= m; ++k)
+	    {
+	      ai -= dif;
+	      int i = m - k + 1;
+	      b0 = b1;
+	      b1 = b2;
+	      auto d0 = d1;
+	      d1 = d2;
+	      b2 = yy * b1 - b0 + b[i - 1];
+	      if (!even)
+		++i;
+	      d2 = yy * d1 - d0 + ai * b[i - 1];
+	    }
+
+	  Tp f{};
+	  if (even)
+	    {
+	      f = x * (b2 - b1);
+	      fd = d2 + d1;
+	    }
+	  else
+	    {
+	      f = Tp{0.5L} * (b2 - b0);
+	      fd = Tp{4} * x * d2;
+	    }
+
+	  const auto delta = f / fd;
+	  x -= delta;
+
+	  if (ka == 1)
+	    break;
+
+	  if (cx_abs(delta) <= eps)
+	    ka = 1;
+	}
+
+      if (ka != 1)
+	throw std::runtime_error("cx_get_kronrod: Iteration limit reached");
+
+      auto d0 = Tp{1};
+      auto d1 = x;
+      auto d2 = Tp{0};
+      auto ai = Tp{0};
+      for (int k = 2; k <= n; ++k)
+	{
+	  ai += Tp{1};
+	  d2 = ((ai + ai + Tp{1}) * x * d1 - ai * d0) / (ai + Tp{1});
+	  d0 = d1;
+	  d1 = d2;
+	}
+
+      wk = coef2 / (fd * d2);
+    }
+
+  /**
+   * Constant expression version of the Gauss abscissa and weights
+   * computation in get_gauss.
+   */
+  template<typename Tp, std::size_t M>
+    constexpr void
+    cx_get_gauss(int n, Tp eps, Tp coef2,
+		 const std::array<Tp, M>& b,
+		 Tp& x, Tp& wk, Tp& wg)
+    {
+      const int max_iter = 100;
+
+      const int m = (n + 1) / 2;
+      const bool even = (2 * m == n);
+
+      int ka = x == Tp{0} ? 1 : 0;
+
+      Tp p0{}, p1{}, p2{}, pd2{};
+      for (int iter = 1; iter <= max_iter; ++iter)
+	{
+	  p0 = Tp{1};
+	  p1 = x;
+	  auto pd0 = Tp{0};
+	  auto pd1 = Tp{1};
+
+	  if (n <= 1)
+	    {
+	      if (std::numeric_limits<Tp>::epsilon() < cx_abs(x))
+		{
+		  p2 = Tp{0.5L} * (Tp{3} * x * x - Tp{1});
+		  pd2 = Tp{3} * x;
+		}
+	      else
+		{
+		  p2 = Tp{3} * x;
+		  pd2 = Tp{3};
+		}
+	    }
+
+	  auto ai = Tp{0};
+	  for (int k = 2; k <= n; ++k)
+	    {
+	      ai += Tp{1};
+	      p2 = ((ai + ai + Tp{1}) * x * p1 - ai * p0) / (ai + Tp{1});
+	      pd2 = ((ai + ai + Tp{1}) * (p1 + x * pd1) - ai * pd0)
+		    / (ai + Tp{1});
+	      p0 = p1;
+	      p1 = p2;
+	      pd0 = pd1;
+	      pd1 = pd2;
+	    }
+
+	  const auto delta = p2 / pd2;
+	  x -= delta;
+
+	  if (ka == 1)
+	    break;
+
+	  if (cx_abs(delta) <= eps)
+	    ka = 1;
+	}
+
+      if (ka != 1)
+	throw std::runtime_error("cx_get_gauss: Iteration limit reached");
+
+      wg = Tp{2} / (Tp(n) * pd2 * p0);
+
+      p1 = Tp{0};
+      p2 = b[m];
+      const auto yy = Tp{4} * x * x - Tp{2};
+      for (int k = 1; k <= m; ++k)
+	{
+	  const auto i = m - k + 1;
+	  p0 = p1;
+	  p1 = p2;
+	  p2 = yy * p1 - p0 + b[i - 1];
+	}
+
+      if (even)
+	wk = wg + coef2 / (pd2 * x * (p2 - p1));
+      else
+	wk = wg + Tp{2} * coef2 / (pd2 * (p2 - p0));
+    }
+
+} // namespace detail
+
+  /**
+   * Build a Gauss-Legendre table of order @c N in a constant expression.
+   *
+   * The roots of @f$ P_N(x) @f$ are found by Newton iteration from
+   * the asymptotic estimates @f$ \cos(\pi(i + 3/4)/(N + 1/2)) @f$.
+   */
+  template<typename Tp, std::size_t N>
+    constexpr static_gauss_legendre_table<Tp, N>
+    make_gauss_legendre_table()
+    {
+      constexpr auto m = (N + 1) / 2;
+      const auto eps = Tp{4} * std::numeric_limits<Tp>::epsilon();
+
+      static_gauss_legendre_table<Tp, N> table;
+      for (std::size_t i = 0; i < m; ++i)
+	{
+	  auto z = 2 * i + 1 == N
+		 ? Tp{0}
+		 : detail::cx_cos(detail::cx_pi<Tp> * (Tp(i) + Tp{0.75L})
+				  / (Tp(N) + Tp{0.5L}));
+	  auto pp = Tp{0};
+	  for (int iter = 0; iter < 100; ++iter)
+	    {
+	      auto p1 = Tp{1};
+	      auto p2 = Tp{0};
+	      for (std::size_t j = 1; j <= N; ++j)
+		{
+		  const auto p3 = p2;
+		  p2 = p1;
+		  p1 = (Tp(2 * j - 1) * z * p2 - Tp(j - 1) * p3) / Tp(j);
+		}
+	      pp = Tp(N) * (z * p1 - p2) / (z * z - Tp{1});
+	      const auto dz = p1 / pp;
+	      z -= dz;
+	      if (detail::cx_abs(dz) <= eps)
+		break;
+	    }
+	  table.point[m - 1 - i] = z;
+	  table.weight[m - 1 - i] = Tp{2} / ((Tp{1} - z * z) * pp * pp);
+	}
+
+      return table;
+    }
+
+  /**
+   * Build a Gauss-Kronrod table with @c KronrodN points
+   * in a constant expression.
+   *
+   * This follows build_gauss_kronrod step for step.
+   *
+   * @see Robert Piessens, Maria Branders,
+   * 	  A Note on the Optimal Addition of Abscissas to Quadrature Formulas
+   * 	  of Gauss and Lobatto, Mathematics of Computation,
+   * 	  Volume 28, Number 125, January 1974, pages 135-139.
+   */
+  template<typename Tp, std::size_t KronrodN>
+    constexpr static_gauss_kronrod_table<Tp, KronrodN>
+    make_gauss_kronrod_table()
+    {
+      constexpr int n = int(KronrodN - 1) / 2;
+      constexpr int m = (n + 1) / 2;
+      constexpr bool even = (2 * m == n);
+      const auto eps = Tp{4} * std::numeric_limits<Tp>::epsilon();
+
+      static_gauss_kronrod_table<Tp, KronrodN> table;
+      auto& x = table.x_kronrod;
+      auto& wk = table.w_kronrod;
+      auto& wg = table.w_gauss;
+
+      std::array<Tp, m + 1> b{};
+      std::array<Tp, m> tau{};
+
+      auto an = Tp{0};
+      for (int k = 1; k <= n; ++k)
+	an += Tp{1};
+
+      // Calculation of the Chebyshev coefficients of the orthogonal polynomial.
+      tau[0] = (an + Tp{2}) / (an + an + Tp{3});
+      b[m - 1] = tau[0] - Tp{1};
+      auto ak = an;
+      for (int l = 1; l < m; ++l)
+	{
+	  ak += Tp{2};
+	  tau[l] = ((ak - Tp{1}) * ak
+		    - an * (an + Tp{1})) * (ak + Tp{2}) * tau[l - 1]
+		    / (ak * ((ak + Tp{3}) * (ak + Tp{2})
+		    - an * (an + Tp{1})));
+	  b[m - l - 1] = tau[l];
+	  for (int ll = 1; ll <= l; ++ll)
+	    b[m - l - 1] += tau[ll - 1] * b[m - l + ll - 1];
+	}
+      b[m] = Tp{1};
+
+      // Calculation of approximate values for the abscissas.
+      auto bb = detail::cx_sin(detail::cx_pi<Tp> / Tp{2} / (an + an + Tp{1}));
+      auto x1 = detail::cx_sqrt(Tp{1} - bb * bb);
+      const auto s = Tp{2} * bb * x1;
+      const auto c = detail::cx_sqrt(Tp{1} - s * s);
+      const auto coef = Tp{1} - (Tp{1} - Tp{1} / an) / (Tp{8} * an * an);
+      auto xx = coef * x1;
+
+      // Coefficient needed for weights.
+      auto coef2 = Tp{2} / Tp(2 * n + 1);
+      for (int i = 1; i <= n; ++i)
+	coef2 *= Tp{4} * Tp(i) / Tp(n + i);
+
+      for (int k = 1; k <= n; k += 2)
+	{
+	  detail::cx_get_kronrod(n, eps, coef2, b, xx, wk[k - 1]);
+	  x[k - 1] = xx;
+	  auto aa = x1;
+	  x1 = aa * c - bb * s;
+	  bb = aa * s + bb * c;
+
+	  xx = k == n ? Tp{0} : coef * x1;
+
+	  detail::cx_get_gauss(n, eps, coef2, b, xx, wk[k], wg[k / 2]);
+
+	  x[k] = xx;
+	  aa = x1;
+	  x1 = aa * c - bb * s;
+	  bb = aa * s + bb * c;
+	  xx = coef * x1;
+	}
+
+      // If n is even we must compute the Kronrod abscissa for the origin.
+      if (even)
+	{
+	  xx = Tp{0};
+	  detail::cx_get_kronrod(n, eps, coef2, b, xx, wk[n]);
+	  x[n] = xx;
+	}
+
+      return table;
+    }
+
+} // namespace emsr
+
+#endif // STATIC_GAUSS_TABLE_TCC
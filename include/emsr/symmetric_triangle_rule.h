@@ -0,0 +1,171 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements high degree fully symmetric triangle rules
+// in structure-of-arrays layout.
+
+#ifndef SYMMETRIC_TRIANGLE_RULE_H
+#define SYMMETRIC_TRIANGLE_RULE_H 1
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <emsr/triangle_integral.h>
+
+namespace emsr
+{
+
+  /**
+   * A fully symmetric triangle rule of degree 10 through 20
+   * with positive weights and interior points in the manner of
+   * D. A. Dunavant, High degree efficient symmetrical Gaussian quadrature
+   * rules for the triangle, Int. J. Numer. Meth. Eng. 21 (1985), 1129-1148
+   * and H. Xiao and Z. Gimbutas, A numerical algorithm for the construction
+   * of efficient quadrature rules in two and higher dimensions,
+   * Comput. Math. Appl. 59 (2010), 663-676.
+   *
+   * The barycentric coordinates and the weights are stored as four
+   * contiguous arrays rather than as an array of points so that
+   * the mapping of all the points to a triangle - or of one point
+   * to many triangles - is a straight loop the compiler can vectorize.
+   * The weights sum to one; the integral is the area times the weighted sum.
+   */
+  template<typename Tp>
+    class symmetric_triangle_rule
+    {
+    public:
+
+      static constexpr int s_min_degree = 10;
+      static constexpr int s_max_degree = 20;
+
+      /// The number of triangles mapped together by the batched integrate.
+      static constexpr std::size_t s_block_size = 64;
+
+      /**
+       * Build the rule of the given polynomial degree,
+       * s_min_degree <= degree <= s_max_degree.
+       * There is no separate rule of degree 19; the rule of degree 20
+       * is built instead and degree() reports 20.
+       */
+      explicit symmetric_triangle_rule(int degree);
+
+      /// Return the polynomial degree of the rule.
+      int
+      degree() const
+      { return this->m_degree; }
+
+      /// Return the number of points in the rule.
+      std::size_t
+      size() const
+      { return this->m_weight.size(); }
+
+      /// Return the first barycentric coordinate of all the points.
+      std::span<const Tp>
+      lambda0() const
+      { return this->m_lambda0; }
+
+      /// Return the second barycentric coordinate of all the points.
+      std::span<const Tp>
+      lambda1() const
+      { return this->m_lambda1; }
+
+      /// Return the third barycentric coordinate of all the points.
+      std::span<const Tp>
+      lambda2() const
+      { return this->m_lambda2; }
+
+      /// Return the weights of all the points.
+      std::span<const Tp>
+      weight() const
+      { return this->m_weight; }
+
+      /**
+       * Integrate over one triangle.
+       */
+      template<typename FuncTp, std::size_t Dim>
+	auto
+	integrate(FuncTp func, const triangle<Tp, Dim>& tri) const
+	-> decltype(std::invoke_result_t<FuncTp,
+				const std::array<Tp, Dim>&>{} * Tp{});
+
+      /**
+       * Integrate over each of many triangles with a batched integrand.
+       *
+       * The vertex coordinates are given structure-of-arrays fashion:
+       * @c vert[k][d][e] is coordinate d of vertex k of element e.
+       * The elements are taken in blocks of s_block_size and the rule
+       * points are the outer loop; for each point the mapped coordinates
+       * of the whole block are computed in contiguous loops over
+       * the elements which the compiler can vectorize.
+       *
+       * The integrand is called once per rule point and block of elements
+       * as @c func(x, f) where @c x is an array of Dim spans holding
+       * the coordinates of the mapped points, one span per coordinate,
+       * and the values are to be written to the span @c f of the same length.
+       * The loop over the elements is then inside the integrand
+       * where the compiler can see it too.
+       */
+      template<typename FuncTp, std::size_t Dim>
+	std::vector<Tp>
+	integrate_batch(FuncTp func,
+		const std::array<std::array<std::span<const Tp>, Dim>, 3>& vert)
+	const;
+
+      /**
+       * Integrate over each of many triangles with a batched integrand.
+       * The vertex coordinates are first gathered into contiguous arrays.
+       */
+      template<typename FuncTp, std::size_t Dim>
+	std::vector<Tp>
+	integrate_batch(FuncTp func,
+			std::span<const triangle<Tp, Dim>> tris) const;
+
+      template<typename FuncTp, std::size_t Dim>
+	std::vector<Tp>
+	integrate_batch(FuncTp func,
+			const std::vector<triangle<Tp, Dim>>& tris) const
+	{
+	  return this->integrate_batch(func,
+			std::span<const triangle<Tp, Dim>>(tris));
+	}
+
+    private:
+
+      int m_degree;
+      std::vector<Tp> m_lambda0;
+      std::vector<Tp> m_lambda1;
+      std::vector<Tp> m_lambda2;
+      std::vector<Tp> m_weight;
+    };
+
+  /**
+   * Return the symmetric triangle rule of the given degree
+   * from the process-wide rule registry.
+   */
+  template<typename Tp>
+    std::shared_ptr<const symmetric_triangle_rule<Tp>>
+    cached_symmetric_triangle_rule(int degree);
+
+} // namespace emsr
+
+#include <emsr/symmetric_triangle_rule.tcc>
+
+#endif // SYMMETRIC_TRIANGLE_RULE_H
@@ -0,0 +1,619 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements high degree fully symmetric triangle rules
+// in structure-of-arrays layout.
+
+#ifndef SYMMETRIC_TRIANGLE_RULE_TCC
+#define SYMMETRIC_TRIANGLE_RULE_TCC 1
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include <emsr/gauss_rule_registry.h>
+
+namespace emsr
+{
+namespace detail
+{
+
+  /**
+   * The orbits of a fully symmetric triangle rule: the number of centroid
+   * orbits (zero or one), of three-point orbits @f$ (a, b, b) @f$
+   * with @f$ b = (1 - a)/2 @f$ and of six-point orbits @f$ (a, b, c) @f$
+   * with @f$ c = 1 - a - b @f$.
+   * The parameters are the centroid weight, then a and the weight of each
+   * three-point orbit, then a, b and the weight of each six-point orbit.
+   *
+   * The rules were computed by solving the moment equations
+   * of the symmetric polynomials by Levenberg-Marquardt from random starts
+   * and keeping the first solution with positive weights and interior
+   * points; the solutions were polished in quadruple precision.
+   */
+  struct symmetric_triangle_orbits
+  {
+    int num_centroid;
+    int num_21;
+    int num_111;
+    const long double* param;
+  };
+
+  // Degree 10, 25 points.
+  inline constexpr long double s_symmetric_triangle_10[]
+  {
+    9.081799038275358009528659510002545213e-02L,
+    2.884473323268524526498493558374834731e-02L,
+    3.672595775646670471700607189136746282e-02L,
+    7.810368490299258904090827373189468066e-01L,
+    4.532105943552793478260564473859666223e-02L,
+    6.680325101220026577354021276202517383e-02L,
+    9.540815400299457580152809622889580969e-03L,
+    9.421666963732823459927470966887578261e-03L,
+    2.500353476268638607398848100774557736e-02L,
+    7.283239045974109200087350535810785104e-01L,
+    2.832724253105748483673706158209999393e-02L,
+    3.079398387641209501651550229306328296e-01L,
+    5.503529418209990950781617265930048665e-01L,
+    7.275791684542010860431517661935947114e-02L
+  };
+
+  // Degree 11, 31 points.
+  inline constexpr long double s_symmetric_triangle_11[]
+  {
+    3.194835147714894404392949056280330769e-02L,
+    5.537574714800751367348475902411650858e-01L,
+    5.174133583539732349363576629934722245e-02L,
+    7.340775988370455986076034879754274869e-01L,
+    4.200194656068086400126664033298600268e-02L,
+    1.915382666323558553440483959151702825e-01L,
+    5.339572179834034170253172640945172935e-02L,
+    9.345515186206890472378969412239115072e-01L,
+    1.385373574076588413725175412555633555e-02L,
+    8.075968094204957346205040813212008939e-01L,
+    2.516059098373334628147007031499516949e-02L,
+    2.314773004158382486291298320586405064e-02L,
+    3.920257933997954379026270570746291213e-01L,
+    6.079647334610546330805559388434551600e-01L,
+    8.422570247155982077592993028131878014e-03L,
+    6.722249786685924250225932064213580854e-02L,
+    5.853557861888675502558840144206090684e-01L,
+    4.927527116414316238482949842186618305e-02L
+  };
+
+  // Degree 12, 36 points.
+  inline constexpr long double s_symmetric_triangle_12[]
+  {
+    1.408499714513010246861080752225755372e-01L,
+    5.672183595012716636610807938331100656e-02L,
+    2.943950425830690189280617631591590025e-02L,
+    2.803100881860275073294366805734250499e-02L,
+    7.851774987340110466237807299844705854e-01L,
+    3.147400912103545143816309645274911307e-02L,
+    5.652486114246799585243745591099039850e-01L,
+    5.806657796251179316837190168314936656e-02L,
+    2.892874384007659621801142050125005736e-01L,
+    2.694887006229244506751235623514551004e-02L,
+    9.466897145477971018311863379222232978e-01L,
+    9.177072382660398974978100965077726232e-03L,
+    1.361915878677440354158206852109840899e-01L,
+    1.820674001653591371535625128126886002e-02L,
+    1.407030765717734651455062192163943253e-02L,
+    2.731756892328020966680244277937346560e-01L,
+    6.561334933132448085588582967786648348e-01L,
+    3.892343123369487890285091560411718836e-02L,
+    6.823861161779760927398846662589585667e-01L,
+    3.135019277901219905577524186261912605e-01L,
+    8.463240627179438375226527752522438317e-03L
+  };
+
+  // Degree 13, 40 points.
+  inline constexpr long double s_symmetric_triangle_13[]
+  {
+    9.501855591792544804809099761960409162e-03L,
+    9.494557119793574032113747789926829360e-01L,
+    8.297005193095264867299603745893950419e-03L,
+    7.922051394212847706211659705954847352e-01L,
+    2.697363885293146563466200758441731075e-02L,
+    2.275795886515137903675225671828039621e-01L,
+    4.287978178082333723312267324618804060e-02L,
+    6.721579674856309660025405273999369173e-02L,
+    4.324562183125143835404015078819141797e-02L,
+    7.342570914880712739640195756858604885e-04L,
+    7.551658580604464712716578711530197898e-03L,
+    5.336940040563698008007760632218193049e-01L,
+    2.939822766090901459701390406972761465e-01L,
+    3.380674181078878476473177751692509114e-02L,
+    8.505006096707154061702506426761029542e-01L,
+    1.303950265327864004545574929922547654e-01L,
+    1.400104680927958547769161421004246430e-02L,
+    2.363531559408922922400775919047086139e-02L,
+    6.802838049356392617672522449896186078e-01L,
+    2.192858396780805675518695270712547737e-02L,
+    1.053989733063073918949830452712430337e-01L,
+    6.565550972906414208063308929306427823e-01L,
+    3.087279836080516346733429856746981915e-02L
+  };
+
+  // Degree 14, 51 points.
+  inline constexpr long double s_symmetric_triangle_14[]
+  {
+    2.421163859180514592283983369785319322e-01L,
+    3.378357073067573990919986471731949811e-02L,
+    1.359073080310876284632906589166019496e-01L,
+    2.833231178123413232615150060660831346e-02L,
+    5.168177434637586017572182070953554007e-01L,
+    1.490311693003036656042368797196535795e-02L,
+    5.104014267248932294015712586115392366e-01L,
+    2.535759614460227633738349993250470862e-02L,
+    6.761190927197557306034763253290991052e-01L,
+    3.551602979850630416905672823959832809e-02L,
+    8.699725104705820499098316230535640205e-01L,
+    1.577143913983617315822875615600845958e-02L,
+    9.604390122192475319989053726141627701e-01L,
+    5.109075708615540596519479347178259380e-03L,
+    9.108357879702966939656032598119890518e-02L,
+    5.835696600124234402077182559328633326e-01L,
+    3.606007250073410598256548788218366058e-02L,
+    1.773016333577207575873514976901916737e-01L,
+    7.723238369243544752466936445113430639e-01L,
+    2.192513950671615372949971372959656705e-02L,
+    1.153954610880620892138754564985226797e-01L,
+    8.830929886139841801209423387360500789e-01L,
+    4.790878088775297700852649199154613207e-03L,
+    1.259191186390621096832763685412138923e-02L,
+    2.986977114169848318736313552635152382e-01L,
+    1.238253018979800177251060386875443184e-02L,
+    4.567177944353602747956920949965891856e-01L,
+    5.203492263102348781676497781581808167e-01L,
+    1.212147626389284095275645350138593540e-02L
+  };
+
+  // Degree 15, 58 points.
+  inline constexpr long double s_symmetric_triangle_15[]
+  {
+    5.129139581793124075839860185436036163e-03L,
+    1.021275334478755284790519373977748867e-02L,
+    9.572865606711254357280150073539813941e-03L,
+    1.597792217319443230665207133847971501e-01L,
+    3.853211815018155004064018644497652871e-02L,
+    4.125872393981056070204527438151874764e-01L,
+    2.813707247325673633943264739650949981e-02L,
+    9.611569181717889882017588953709526255e-01L,
+    4.877121285090280360934713261090233192e-03L,
+    5.443528538457659812533868071521287229e-01L,
+    2.688678576013018652330033518972513623e-02L,
+    5.651171671514323676080994576464991955e-01L,
+    1.456393732266217122309718560617689190e-01L,
+    1.940516568671895806084384484829703048e-02L,
+    3.755546542448838658180770872557031035e-01L,
+    5.963880531135845379530893462146463877e-02L,
+    2.745254480860760155489669749503168697e-02L,
+    1.309075418188083513185670044587457112e-02L,
+    9.890133574115660188993379003229379380e-02L,
+    7.352807808348535695347988895048826190e-03L,
+    8.182943066568662125319260507593861843e-02L,
+    7.773111177368386140097781561178120123e-02L,
+    9.194504265010608142269024171641734660e-03L,
+    1.988661493924500888202714086257121516e-01L,
+    7.028285310493457140722690716900017707e-01L,
+    2.743478592003122512736312457846128338e-02L,
+    3.306380310751704259401644245867116789e-01L,
+    9.392197808195420605641765501516208133e-03L,
+    7.430669440101972538299994598177643384e-03L,
+    7.665385919424464835184428742711624225e-01L,
+    2.308006670755421768541610925232985040e-02L,
+    1.353835050319724105754533253284850727e-02L
+  };
+
+  // Degree 16, 64 points.
+  inline constexpr long double s_symmetric_triangle_16[]
+  {
+    3.997232909850918804851087514724722213e-02L,
+    1.385130741139224222563461935704474095e-01L,
+    1.808335564632737292822466486578145412e-02L,
+    5.009090040124167597794288317514070273e-01L,
+    1.780541641245690929888950258584955169e-02L,
+    8.921296650726280830514784667857723019e-01L,
+    1.052115533566130540889408716554608872e-02L,
+    6.630271070048142059240224307924384857e-01L,
+    2.590935053337343580034924689187925973e-02L,
+    6.655760692973497327215353113934010765e-02L,
+    2.386520473941468126768638704422771971e-02L,
+    7.769267513307256426528638029787121113e-01L,
+    1.547976931429515421861538059621594024e-01L,
+    1.979904949248641342026789935564667201e-02L,
+    1.323325582941320762593686266133331131e-02L,
+    4.054459460559244134234147567703255373e-01L,
+    1.169636529567408697458186527983451443e-02L,
+    1.374669644196898985924477785632753454e-02L,
+    2.418864316660767930497023879908318133e-01L,
+    1.035849830595288519684950461180522379e-02L,
+    2.837937608737589299501072533028318453e-01L,
+    1.356449537849719475723201987955450253e-01L,
+    1.846902507206637935102457939778173474e-02L,
+    9.643806103035117813548269185215338861e-01L,
+    6.015152363287555600232492714397151768e-03L,
+    2.091027855507460014927594446740404475e-03L,
+    2.011901352449763965783590895144702749e-01L,
+    4.644868398556342766409378133078846110e-01L,
+    2.156446583299509646129286372121128209e-02L,
+    1.130041817036662768571001629936845920e-01L,
+    8.756320794596645861027426696619244779e-01L,
+    6.464780243045018957732027353756531813e-03L,
+    3.014596381400685016125952149424708390e-01L,
+    6.640204859459209281848650272518790843e-02L,
+    2.146915838557094259654990903204044375e-02L
+  };
+
+  // Degree 17, 69 points.
+  inline constexpr long double s_symmetric_triangle_17[]
+  {
+    9.674874395743073687215375430179108195e-01L,
+    3.433680086832761694283603639876206630e-03L,
+    2.631757417734685561864010136440079238e-01L,
+    2.309075559168793084679223184975642921e-02L,
+    1.737354821838081858865262653021384847e-01L,
+    1.674965223437045384259318916653586068e-02L,
+    1.416189784494882974110235930924845327e-02L,
+    1.120197541428920758436964413099136049e-02L,
+    6.832366115431685003223620028410009555e-02L,
+    2.247298966182158719890850969549962415e-02L,
+    4.915482565731328903447569005262126793e-01L,
+    2.847420045957370691175548317991101092e-02L,
+    7.651939775630803201262594318802673894e-01L,
+    1.035449135608469190016073044340796429e-02L,
+    4.665669309249955139769147765456871271e-02L,
+    8.392616075154594755361876800491718254e-02L,
+    7.644602499822100580831885273544034249e-03L,
+    1.404216047946194937648858299388122924e-01L,
+    3.370870248696330427829210742576095529e-01L,
+    2.272528203798934256782789961237187715e-02L,
+    6.774936030855906102267484162411219562e-02L,
+    1.776205459026344077452310258420541651e-01L,
+    1.550180248992847290929725044222019173e-02L,
+    1.377442764247163307337408987117920155e-02L,
+    7.910801117560761288521585916608195709e-01L,
+    9.077200818659765514898633971228341380e-03L,
+    3.396206909062461488027832883261670405e-01L,
+    9.923230278965868580780961807835503505e-03L,
+    7.993391816396924757556780585105608297e-03L,
+    5.671060120236530727812599936836352729e-02L,
+    6.286365063327000851556643596168722739e-01L,
+    2.007626812896835537199128272564478975e-02L,
+    6.347258444171839499369257165033411347e-01L,
+    1.437832377207896840953174376856305274e-01L,
+    2.125717291401435081003918994196842096e-02L,
+    8.309132742686398836703695240357671307e-02L,
+    9.629124709723952712225676248425392418e-03L,
+    4.502073558557184164792048061594176349e-03L
+  };
+
+  // Degree 18, 79 points.
+  inline constexpr long double s_symmetric_triangle_18[]
+  {
+    3.736664768800529658587574273638549279e-03L,
+    9.374045858251389222945740952623009648e-01L,
+    4.939674171045059471453547864671605251e-03L,
+    2.637574136493421617960369063313278495e-01L,
+    2.113725459012002877454680656103013162e-02L,
+    1.749962334438191337143539700265607748e-01L,
+    2.017224752943232297137040847871488692e-02L,
+    1.322947757041249142436700254988207573e-02L,
+    9.644959914470719125827714841274545362e-03L,
+    6.686191875573680363948422759551102365e-02L,
+    2.002335561438940453886999988342480523e-02L,
+    4.965625170654441049828925172055924735e-01L,
+    3.034671018296792936479255334113341254e-02L,
+    7.646142825946701303791876182926754765e-01L,
+    1.686040005774744680249471276633049467e-02L,
+    9.856845148582335411685483411658298476e-01L,
+    8.570603177806018426719290399707645300e-04L,
+    4.184835091054664139346275940359316459e-02L,
+    1.002672626147454983410357433196487254e-01L,
+    9.534007825393764531881404747593970398e-03L,
+    1.354431908852455405849150333347260123e-01L,
+    3.391077654952963257325837810290088240e-01L,
+    2.116825220967560225972987351026866804e-02L,
+    5.810805806408634445022013274787159328e-02L,
+    2.064638015771500232144847830963118324e-01L,
+    1.525457072826236951912712221049284997e-02L,
+    1.119907440476035779976853365145672038e-02L,
+    7.610584501722607672779105616765758315e-01L,
+    6.447238959520061871813609027942764811e-03L,
+    3.537306363259260046148681827123736278e-01L,
+    1.065297954633443856658069645745807878e-02L,
+    7.442185896278728130010154014338681553e-03L,
+    5.607830263690003754733127333578045946e-02L,
+    6.107518604175719744206902126174245021e-01L,
+    1.695745917720465151993998688464564651e-02L,
+    6.347512666771193892267917558103956606e-01L,
+    1.400336606788699843826457059403518612e-01L,
+    2.190749673645505491010709461452935945e-02L,
+    1.331928727749189640402544289748180467e-01L,
+    9.404429919000821646608648846527270801e-03L,
+    3.770407565542633665697609928020705106e-03L,
+    9.386928308546695271280464268673828247e-01L,
+    5.940603664465524974527548055616380857e-02L,
+    1.571438917890288869248046294952288449e-03L
+  };
+
+  // Degree 20, 88 points.
+  inline constexpr long double s_symmetric_triangle_20[]
+  {
+    1.422661107486518860423425012349240313e-02L,
+    9.244074127292393206755090180210857562e-01L,
+    4.083542622445204609417428803572812236e-03L,
+    2.459499774715749243751742607040623606e-01L,
+    2.078874401691356542119100901331429784e-02L,
+    2.086616341331771777511488684145277245e-01L,
+    8.831333872012711822778712383657831102e-03L,
+    5.235694215016489985901475797076149662e-03L,
+    3.403275369170558135840660538560531824e-03L,
+    7.566296501814516313791214148916248398e-02L,
+    1.598512466511980825447254909978059842e-02L,
+    5.054143135811967499940260639363340959e-01L,
+    2.987223899597617304205507989399538288e-02L,
+    7.620528455578481700940039000090936562e-01L,
+    1.616797841772674975275025988996756477e-02L,
+    9.789796331521029737358226177889891678e-01L,
+    1.488917172037153661275988989067511368e-03L,
+    8.022461051749065551657180227772731660e-01L,
+    1.391957782822260832098312163258172436e-04L,
+    4.453074819490569450735638406061539573e-02L,
+    1.006742550559875904772758493071749318e-01L,
+    8.726697440776029488892316785506664890e-03L,
+    1.403807400038003293644949524982056423e-01L,
+    3.525327724753631930665714430862786734e-01L,
+    2.459570984043723735356975987065388069e-02L,
+    5.497916263516612628077776599030614889e-02L,
+    1.994900604563684591557178190817129190e-01L,
+    1.402772146301141237192907948681885779e-02L,
+    1.129489324333993799083210918252379948e-02L,
+    7.304574809844932221461003308580260032e-01L,
+    6.720066170851283770330613636025699328e-03L,
+    3.758717998142340814945332020185355070e-01L,
+    1.053937985535505494910152007657325733e-02L,
+    6.245989318812494598541652160223787270e-03L,
+    5.913483771735819146689200764504216727e-02L,
+    6.170161829374577612872775713372979564e-01L,
+    1.741779660862459193955291056601192034e-02L,
+    6.378437719971795946037194300973242815e-01L,
+    1.360634927917647257254023755224627922e-01L,
+    2.276270461772524723237841125484944088e-02L,
+    1.486588009120147586092096161251310004e-01L,
+    9.382650300229436272720879523052684271e-03L,
+    4.861936566819067252885495009190710656e-03L,
+    9.318347894500124179418089801620529830e-01L,
+    6.147666592116577655369869018584742917e-02L,
+    2.573160561193986019731574810219285632e-03L,
+    3.214524638417979619443767198788550610e-02L,
+    5.241068199143320720787298007012445624e-01L,
+    5.983606777762376479986718152463192744e-03L
+  };
+
+  inline constexpr symmetric_triangle_orbits
+  s_symmetric_triangle_orbits[]
+  {
+    {1, 2, 3, s_symmetric_triangle_10},
+    {1, 4, 3, s_symmetric_triangle_11},
+    {0, 6, 3, s_symmetric_triangle_12},
+    {1, 5, 4, s_symmetric_triangle_13},
+    {0, 7, 5, s_symmetric_triangle_14},
+    {1, 5, 7, s_symmetric_triangle_15},
+    {1, 5, 8, s_symmetric_triangle_16},
+    {0, 7, 8, s_symmetric_triangle_17},
+    {1, 8, 9, s_symmetric_triangle_18},
+    // Degree 19: no rule with fewer points than that of degree 20 was found.
+    {1, 9, 10, s_symmetric_triangle_20},
+    {1, 9, 10, s_symmetric_triangle_20}
+  };
+
+} // namespace detail
+
+  template<typename Tp>
+    symmetric_triangle_rule<Tp>::symmetric_triangle_rule(int degree)
+    : m_degree(degree),
+      m_lambda0{}, m_lambda1{}, m_lambda2{}, m_weight{}
+    {
+      if (degree < s_min_degree || degree > s_max_degree)
+	throw std::domain_error("symmetric_triangle_rule: "
+				"Degree out of range.");
+      if (degree == 19)
+	this->m_degree = 20;
+
+      const auto& orb = detail::s_symmetric_triangle_orbits
+				[degree - s_min_degree];
+      const auto num_points = std::size_t(orb.num_centroid
+				+ 3 * orb.num_21 + 6 * orb.num_111);
+      this->m_lambda0.reserve(num_points);
+      this->m_lambda1.reserve(num_points);
+      this->m_lambda2.reserve(num_points);
+      this->m_weight.reserve(num_points);
+
+      auto add = [this](Tp l0, Tp l1, Tp l2, Tp w)
+	{
+	  this->m_lambda0.push_back(l0);
+	  this->m_lambda1.push_back(l1);
+	  this->m_lambda2.push_back(l2);
+	  this->m_weight.push_back(w);
+	};
+
+      const long double* p = orb.param;
+      if (orb.num_centroid != 0)
+	{
+	  const auto third = Tp{1} / Tp{3};
+	  add(third, third, third, Tp(*p++));
+	}
+      for (int o = 0; o < orb.num_21; ++o)
+	{
+	  const auto a = Tp(*p++);
+	  const auto w = Tp(*p++);
+	  const auto b = (Tp{1} - a) / Tp{2};
+	  add(a, b, b, w);
+	  add(b, a, b, w);
+	  add(b, b, a, w);
+	}
+      for (int o = 0; o < orb.num_111; ++o)
+	{
+	  const auto a = Tp(*p++);
+	  const auto b = Tp(*p++);
+	  const auto w = Tp(*p++);
+	  const auto c = Tp{1} - a - b;
+	  add(a, b, c, w);
+	  add(a, c, b, w);
+	  add(b, a, c, w);
+	  add(b, c, a, w);
+	  add(c, a, b, w);
+	  add(c, b, a, w);
+	}
+    }
+
+  template<typename Tp>
+    template<typename FuncTp, std::size_t Dim>
+      auto
+      symmetric_triangle_rule<Tp>::integrate(FuncTp func,
+					     const triangle<Tp, Dim>& tri) const
+      -> decltype(std::invoke_result_t<FuncTp,
+				const std::array<Tp, Dim>&>{} * Tp{})
+      {
+	using RetTp = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>;
+	using AreaTp = decltype(RetTp{} * Tp{});
+
+	const auto& v = tri.vertex;
+	auto sum = AreaTp{0};
+	std::array<Tp, Dim> pt;
+	for (std::size_t i = 0; i < this->size(); ++i)
+	  {
+	    for (std::size_t d = 0; d < Dim; ++d)
+	      pt[d] = this->m_lambda0[i] * v[0][d]
+		    + this->m_lambda1[i] * v[1][d]
+		    + this->m_lambda2[i] * v[2][d];
+	    sum += this->m_weight[i] * func(pt);
+	  }
+	return triangle_area(tri) * sum;
+      }
+
+  template<typename Tp>
+    template<typename FuncTp, std::size_t Dim>
+      std::vector<Tp>
+      symmetric_triangle_rule<Tp>::
+      integrate_batch(FuncTp func,
+		const std::array<std::array<std::span<const Tp>, Dim>, 3>& vert)
+      const
+      {
+	static_assert(Dim == 2 || Dim == 3,
+		      "integrate_batch: Triangles must be in the plane"
+		      " or in space.");
+	using block_t = std::array<Tp, s_block_size>;
+
+	const auto num_elems = vert[0][0].size();
+	std::vector<Tp> result(num_elems);
+
+	std::array<block_t, Dim> coord;
+	block_t sum;
+	block_t val;
+
+	for (std::size_t start = 0; start < num_elems; start += s_block_size)
+	  {
+	    const auto num = std::min(s_block_size, num_elems - start);
+
+	    std::array<std::span<const Tp>, Dim> x;
+	    for (std::size_t d = 0; d < Dim; ++d)
+	      x[d] = std::span<const Tp>(coord[d].data(), num);
+	    const std::span<Tp> f(val.data(), num);
+
+	    std::fill_n(sum.begin(), num, Tp{0});
+	    for (std::size_t i = 0; i < this->size(); ++i)
+	      {
+		const auto l0 = this->m_lambda0[i];
+		const auto l1 = this->m_lambda1[i];
+		const auto l2 = this->m_lambda2[i];
+		for (std::size_t d = 0; d < Dim; ++d)
+		  {
+		    const auto v0 = vert[0][d].data() + start;
+		    const auto v1 = vert[1][d].data() + start;
+		    const auto v2 = vert[2][d].data() + start;
+		    auto c = coord[d].data();
+		    for (std::size_t e = 0; e < num; ++e)
+		      c[e] = l0 * v0[e] + l1 * v1[e] + l2 * v2[e];
+		  }
+
+		func(std::as_const(x), f);
+
+		const auto w = this->m_weight[i];
+		for (std::size_t e = 0; e < num; ++e)
+		  sum[e] += w * val[e];
+	      }
+
+	    // The areas from the edge vectors, again one loop per block.
+	    for (std::size_t e = 0; e < num; ++e)
+	      {
+		std::array<Tp, 3> u{}, v{};
+		for (std::size_t d = 0; d < Dim; ++d)
+		  {
+		    u[d] = vert[1][d][start + e] - vert[0][d][start + e];
+		    v[d] = vert[2][d][start + e] - vert[0][d][start + e];
+		  }
+		const auto cx = u[1] * v[2] - u[2] * v[1];
+		const auto cy = u[2] * v[0] - u[0] * v[2];
+		const auto cz = u[0] * v[1] - u[1] * v[0];
+		const auto area = std::sqrt(cx * cx + cy * cy + cz * cz) / Tp{2};
+		result[start + e] = area * sum[e];
+	      }
+	  }
+
+	return result;
+      }
+
+  template<typename Tp>
+    template<typename FuncTp, std::size_t Dim>
+      std::vector<Tp>
+      symmetric_triangle_rule<Tp>::
+      integrate_batch(FuncTp func,
+		      std::span<const triangle<Tp, Dim>> tris) const
+      {
+	// vert_data[k][d][e] is coordinate d of vertex k of element e.
+	std::array<std::array<std::vector<Tp>, Dim>, 3> vert_data;
+	std::array<std::array<std::span<const Tp>, Dim>, 3> vert;
+	for (std::size_t k = 0; k < 3; ++k)
+	  for (std::size_t d = 0; d < Dim; ++d)
+	    {
+	      auto& vd = vert_data[k][d];
+	      vd.resize(tris.size());
+	      for (std::size_t e = 0; e < tris.size(); ++e)
+		vd[e] = tris[e].vertex[k][d];
+	      vert[k][d] = vd;
+	    }
+
+	return this->integrate_batch(func, vert);
+      }
+
+  template<typename Tp>
+    std::shared_ptr<const symmetric_triangle_rule<Tp>>
+    cached_symmetric_triangle_rule(int degree)
+    {
+      using rule_t = symmetric_triangle_rule<Tp>;
+      return gauss_rule_registry<Tp>::instance().template get<rule_t>
+	({Triangle_Symmetric, degree},
+	 [degree](){ return rule_t(degree); });
+    }
+
+} // namespace emsr
+
+#endif // SYMMETRIC_TRIANGLE_RULE_TCC
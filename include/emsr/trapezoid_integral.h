@@ -107,6 +107,12 @@ namespace emsr
 
     private:
 
+      // Romberg integration extrapolates the refinements of m_step.
+      template<typename Tp2, typename FuncTp2>
+	friend class romberg_integral;
+      template<typename Tp2, typename FuncTp2>
+	friend class composite_romberg_integral;
+
       static constexpr auto s_max_iter = std::numeric_limits<Tp>::digits / 2;
       static constexpr auto s_min_delta
 			   = std::sqrt(std::numeric_limits<Tp>::epsilon());
@@ -0,0 +1,302 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+//
+// Implements adaptive cubature over triangles and triangle meshes.
+
+#ifndef TRIANGLE_INTEGRAL_H
+#define TRIANGLE_INTEGRAL_H 1
+
+#include <array>
+#include <cstddef>
+#include <new> // For std::nothrow
+#include <type_traits>
+#include <vector>
+
+#include <emsr/integration.h>
+#include <emsr/triangle_rules.h>
+#include <emsr/triangle_workspace.h>
+
+namespace emsr
+{
+
+  /**
+   * Return the point with barycentric coordinates @c bary in a triangle.
+   */
+  template<typename Tp, std::size_t Dim>
+    std::array<Tp, Dim>
+    barycentric_point(const triangle<Tp, Dim>& tri,
+		      const std::array<Tp, 3>& bary);
+
+  /**
+   * Return the area of a triangle in the plane or in space.
+   */
+  template<typename Tp, std::size_t Dim>
+    Tp
+    triangle_area(const triangle<Tp, Dim>& tri);
+
+  /**
+   * Return the four triangles of the red (regular) refinement of a triangle:
+   * the three corner triangles and the middle triangle cut by the edge
+   * midpoints.  All four have a quarter of the area and the shape
+   * of the parent.
+   */
+  template<typename Tp, std::size_t Dim>
+    std::array<triangle<Tp, Dim>, 4>
+    red_refine(const triangle<Tp, Dim>& tri);
+
+  /**
+   * An embedded pair of symmetric triangle rules with positive weights
+   * and interior points: Radon's 7-point rule of degree 5 inside
+   * a 19-point rule of degree 8 after D. P. Laurie,
+   * Algorithm 584 CUBTRI: Automatic Cubature over a Triangle,
+   * ACM TOMS 8 (1982), 210-218.
+   *
+   * The result is that of the degree 8 rule and the error estimate
+   * is its difference from the degree 5 rule, which costs
+   * no extra evaluations.
+   */
+  template<typename Tp>
+    class triangle_integral
+    {
+    public:
+
+      triangle_integral();
+
+      /**
+       * Integrate over a triangle returning the result of the higher
+       * rule and the difference with the lower rule as error estimate.
+       */
+      template<typename FuncTp, std::size_t Dim>
+	auto
+	integrate(FuncTp func, const triangle<Tp, Dim>& tri) const
+	-> gauss_kronrod_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+      template<typename FuncTp, std::size_t Dim>
+	auto
+	operator()(FuncTp func, const triangle<Tp, Dim>& tri) const
+	-> gauss_kronrod_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+	{ return this->integrate(func, tri); }
+
+      /// Return the number of points (function evaluations) of the pair.
+      std::size_t
+      size() const
+      { return this->m_point.size(); }
+
+      /// Return the polynomial degree of the higher rule.
+      static constexpr int
+      degree()
+      { return 8; }
+
+      /// Return the polynomial degree of the embedded lower rule.
+      static constexpr int
+      embedded_degree()
+      { return 5; }
+
+      /// Return the barycentric coordinates of point @c i.
+      const std::array<Tp, 3>&
+      point(std::size_t i) const
+      { return this->m_point[i]; }
+
+      /// Return the weight of point @c i in the higher rule.
+      Tp
+      weight(std::size_t i) const
+      { return this->m_weight[i]; }
+
+      /// Return the weight of point @c i in the lower rule.
+      Tp
+      embedded_weight(std::size_t i) const
+      { return this->m_embedded_weight[i]; }
+
+    private:
+
+      std::vector<std::array<Tp, 3>> m_point;
+      std::vector<Tp> m_weight;
+      std::vector<Tp> m_embedded_weight;
+    };
+
+  /**
+   * Adaptively integrate over a triangle.
+   *
+   * The region with the largest error estimate is taken from the
+   * workspace heap and replaced by its four red refinement children
+   * until the total error meets the tolerance or the workspace is full.
+   * This overload does not throw when the tolerance is not met;
+   * the error code, the best result and error estimate found and
+   * the number of function evaluations are returned instead.
+   * Invalid tolerances still throw.
+   *
+   * @param workspace The workspace that manages the triangle heap.
+   * @param func The function of a point to be integrated.
+   * @param tri The triangle.
+   * @param max_abs_err The limit on absolute error.
+   * @param max_rel_err The limit on relative error.
+   * @param rule The embedded pair used on each triangle.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    adaptive_triangle_integrate(std::nothrow_t,
+		triangle_workspace<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>, Dim>&
+		  workspace,
+		FuncTp func, const triangle<Tp, Dim>& tri,
+		Tp max_abs_err, Tp max_rel_err,
+		const triangle_integral<Tp>& rule = triangle_integral<Tp>())
+    -> adaptive_status_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+  /**
+   * Adaptively integrate over a triangle.
+   * An integration_error is thrown if the tolerance is not met.
+   * The arguments are those of the non-throwing overload.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    adaptive_triangle_integrate(triangle_workspace<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>, Dim>&
+		  workspace,
+		FuncTp func, const triangle<Tp, Dim>& tri,
+		Tp max_abs_err, Tp max_rel_err,
+		const triangle_integral<Tp>& rule = triangle_integral<Tp>())
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+  /**
+   * Adaptively integrate over a triangle
+   * with at most @c max_iter refinements.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_triangle(FuncTp func, const triangle<Tp, Dim>& tri,
+		       Tp max_abs_err, Tp max_rel_err,
+		       std::size_t max_iter = 1024)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+  /**
+   * The return type for integration over a mesh of triangles.
+   */
+  template<typename Tp, typename RetTp>
+    struct mesh_integral_t
+    {
+      using AreaTp = decltype(RetTp{} * Tp{});
+      using AbsAreaTp = decltype(std::abs(AreaTp{}));
+
+      /// Sum of the element integrals.
+      AreaTp result = AreaTp{};
+      /// Sum of the element error estimates.
+      AbsAreaTp abserr = AbsAreaTp{};
+      /// The result and error estimate for each element.
+      std::vector<adaptive_integral_t<Tp, RetTp>> element;
+      /// The error code for each element, NO_ERROR on success.
+      std::vector<int> status;
+      /// The number of elements that failed to reach their tolerance.
+      std::size_t num_failed = 0;
+    };
+
+  /**
+   * Adaptively integrate over each triangle of a mesh.
+   *
+   * Each element gets the relative tolerance and its share of the
+   * absolute tolerance in proportion to its area.  An element that fails
+   * does not stop the others: its best estimate is kept and its error code
+   * is recorded in the status vector.  Since missed tolerances are
+   * reported per element this never throws integration_error
+   * and there is no std::nothrow overload; invalid tolerances still throw.
+   * The elements are spread over @c num_threads threads
+   * (0 means hardware concurrency), each thread with its own workspace;
+   * the results do not depend on the number of threads.
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_mesh(FuncTp func, const std::vector<triangle<Tp, Dim>>& mesh,
+		   Tp max_abs_err, Tp max_rel_err,
+		   std::size_t max_iter = 1024,
+		   unsigned int num_threads = 1)
+    -> mesh_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+  /**
+   * A conforming mesh of triangles given by the vertex coordinates
+   * and, for each element, the indices of its three vertices.
+   * Neighbouring elements share the indices of their common vertices.
+   */
+  template<typename Tp, std::size_t Dim = 2>
+    struct triangle_mesh
+    {
+      std::vector<std::array<Tp, Dim>> vertex;
+      std::vector<std::array<std::size_t, 3>> element;
+
+      /// Return the number of elements.
+      std::size_t
+      size() const
+      { return this->element.size(); }
+
+      /// Return element @c e as a triangle.
+      triangle<Tp, Dim>
+      element_triangle(std::size_t e) const
+      {
+	const auto& el = this->element[e];
+	return {{this->vertex[el[0]], this->vertex[el[1]],
+		 this->vertex[el[2]]}};
+      }
+    };
+
+  /**
+   * The return type for integration over a mesh with a fixed rule.
+   */
+  template<typename Tp, typename RetTp>
+    struct fixed_mesh_integral_t
+    {
+      using AreaTp = decltype(RetTp{} * Tp{});
+
+      /// Sum of the element integrals.
+      AreaTp result = AreaTp{};
+      /// The integral over each element.
+      std::vector<AreaTp> element;
+      /// The number of function evaluations.
+      std::size_t num_evals = 0;
+    };
+
+  /**
+   * Integrate over each element of a mesh with a fixed triangle rule
+   * evaluating every shared point once.
+   *
+   * Vertex points of the rule are evaluated once per mesh vertex
+   * and edge points once per mesh edge, keyed by the vertex indices
+   * of the edge, and the values are reused by all the elements around
+   * the vertex or along the edge.  Only interior points are evaluated
+   * per element.  For a rule with points on vertices and edges such as
+   * the 7-point rule this saves over half the evaluations of a large mesh.
+   *
+   * The evaluations are spread over @c num_threads threads
+   * (0 means hardware concurrency).
+   */
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_mesh(FuncTp func, const triangle_mesh<Tp, Dim>& mesh,
+		   const triangle_rule<Tp>& rule,
+		   unsigned int num_threads = 1)
+    -> fixed_mesh_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>;
+
+} // namespace emsr
+
+#include <emsr/triangle_integral.tcc>
+
+#endif // TRIANGLE_INTEGRAL_H
@@ -0,0 +1,539 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef TRIANGLE_INTEGRAL_TCC
+#define TRIANGLE_INTEGRAL_TCC 1
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <emsr/integration_error.h>
+#include <emsr/parallel_for.h>
+
+namespace emsr
+{
+
+  template<typename Tp, std::size_t Dim>
+    std::array<Tp, Dim>
+    barycentric_point(const triangle<Tp, Dim>& tri,
+		      const std::array<Tp, 3>& bary)
+    {
+      std::array<Tp, Dim> pt;
+      for (std::size_t d = 0; d < Dim; ++d)
+	pt[d] = bary[0] * tri.vertex[0][d]
+	      + bary[1] * tri.vertex[1][d]
+	      + bary[2] * tri.vertex[2][d];
+      return pt;
+    }
+
+  template<typename Tp, std::size_t Dim>
+    Tp
+    triangle_area(const triangle<Tp, Dim>& tri)
+    {
+      static_assert(Dim == 2 || Dim == 3,
+		    "triangle_area: Triangles must be in the plane or in space.");
+      std::array<Tp, 3> u{}, v{};
+      for (std::size_t d = 0; d < Dim; ++d)
+	{
+	  u[d] = tri.vertex[1][d] - tri.vertex[0][d];
+	  v[d] = tri.vertex[2][d] - tri.vertex[0][d];
+	}
+      const auto cx = u[1] * v[2] - u[2] * v[1];
+      const auto cy = u[2] * v[0] - u[0] * v[2];
+      const auto cz = u[0] * v[1] - u[1] * v[0];
+      return std::sqrt(cx * cx + cy * cy + cz * cz) / Tp{2};
+    }
+
+  template<typename Tp, std::size_t Dim>
+    std::array<triangle<Tp, Dim>, 4>
+    red_refine(const triangle<Tp, Dim>& tri)
+    {
+      const auto& v = tri.vertex;
+      auto mid = [](const std::array<Tp, Dim>& a, const std::array<Tp, Dim>& b)
+	{
+	  std::array<Tp, Dim> m;
+	  for (std::size_t d = 0; d < Dim; ++d)
+	    m[d] = (a[d] + b[d]) / Tp{2};
+	  return m;
+	};
+      const auto m01 = mid(v[0], v[1]);
+      const auto m12 = mid(v[1], v[2]);
+      const auto m20 = mid(v[2], v[0]);
+      return {triangle<Tp, Dim>{{v[0], m01, m20}},
+	      triangle<Tp, Dim>{{m01, v[1], m12}},
+	      triangle<Tp, Dim>{{m20, m12, v[2]}},
+	      triangle<Tp, Dim>{{m12, m20, m01}}};
+    }
+
+  /**
+   * Build the point and weight tables from the symmetric orbits:
+   * the centroid, three points @f$ (a, b, b) @f$ with @f$ b = (1 - a)/2 @f$
+   * and six points @f$ (a, b, c) @f$.
+   * The first seven points are those of Radon's rule.
+   */
+  template<typename Tp>
+    triangle_integral<Tp>::triangle_integral()
+    : m_point{}, m_weight{}, m_embedded_weight{}
+    {
+      const auto s15 = std::sqrt(Tp{15});
+
+      auto add_21 = [this](Tp a, Tp w, Tp we)
+	{
+	  const auto b = (Tp{1} - a) / Tp{2};
+	  this->m_point.push_back({a, b, b});
+	  this->m_point.push_back({b, a, b});
+	  this->m_point.push_back({b, b, a});
+	  for (int i = 0; i < 3; ++i)
+	    {
+	      this->m_weight.push_back(w);
+	      this->m_embedded_weight.push_back(we);
+	    }
+	};
+
+      auto add_111 = [this](Tp a, Tp b, Tp w)
+	{
+	  const auto c = Tp{1} - a - b;
+	  this->m_point.push_back({a, b, c});
+	  this->m_point.push_back({a, c, b});
+	  this->m_point.push_back({b, a, c});
+	  this->m_point.push_back({b, c, a});
+	  this->m_point.push_back({c, a, b});
+	  this->m_point.push_back({c, b, a});
+	  for (int i = 0; i < 6; ++i)
+	    {
+	      this->m_weight.push_back(w);
+	      this->m_embedded_weight.push_back(Tp{0});
+	    }
+	};
+
+      this->m_point.push_back({Tp{1} / Tp{3}, Tp{1} / Tp{3}, Tp{1} / Tp{3}});
+      this->m_weight.push_back(Tp{3.786109120031468330830822135601612298660e-02L});
+      this->m_embedded_weight.push_back(Tp{9} / Tp{40});
+
+      add_21((Tp{9} + Tp{2} * s15) / Tp{21},
+	     Tp{3.762042541318297214431400521316767990820e-02L},
+	     (Tp{155} - s15) / Tp{1200});
+      add_21((Tp{9} - Tp{2} * s15) / Tp{21},
+	     Tp{7.835735224411733755544600089424618005140e-02L},
+	     (Tp{155} + s15) / Tp{1200});
+
+      add_21(Tp{9.410382782311208665596303797019388487107e-01L},
+	     Tp{1.344426737516540189811106505318111350250e-02L}, Tp{0});
+      add_21(Tp{5.357953464498992646629508988845634681138e-01L},
+	     Tp{1.162714796569658963947487056549844525557e-01L}, Tp{0});
+
+      add_111(Tp{2.948086088443956672018481014903057564470e-02L},
+	      Tp{2.321023267750503676685245505577182659431e-01L},
+	      Tp{3.750972245523174878563874136620759982670e-02L});
+    }
+
+  template<typename Tp>
+    template<typename FuncTp, std::size_t Dim>
+      auto
+      triangle_integral<Tp>::integrate(FuncTp func,
+				       const triangle<Tp, Dim>& tri) const
+      -> gauss_kronrod_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+      {
+	using RetTp = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>;
+	using AreaTp = decltype(RetTp{} * Tp{});
+	using AbsAreaTp = decltype(std::abs(AreaTp{}));
+	const auto s_eps = std::numeric_limits<AbsAreaTp>::epsilon();
+
+	const auto area = triangle_area(tri);
+	auto res_hi = AreaTp{0};
+	auto res_lo = AreaTp{0};
+	auto resabs = AbsAreaTp{0};
+	std::array<RetTp, 19> fval;
+	for (std::size_t i = 0; i < this->m_point.size(); ++i)
+	  {
+	    fval[i] = func(barycentric_point(tri, this->m_point[i]));
+	    res_hi += this->m_weight[i] * fval[i];
+	    res_lo += this->m_embedded_weight[i] * fval[i];
+	    resabs += this->m_weight[i] * std::abs(fval[i]);
+	  }
+	auto resasc = AbsAreaTp{0};
+	for (std::size_t i = 0; i < this->m_point.size(); ++i)
+	  resasc += this->m_weight[i] * std::abs(fval[i] - res_hi);
+
+	gauss_kronrod_integral_t<Tp, RetTp> out;
+	out.result = area * res_hi;
+	out.resabs = area * resabs;
+	out.resasc = area * resasc;
+	out.abserr = std::max(area * std::abs(res_hi - res_lo),
+			      AbsAreaTp{50} * s_eps * out.resabs);
+	return out;
+      }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    adaptive_triangle_integrate(std::nothrow_t,
+		triangle_workspace<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>, Dim>&
+		  workspace,
+		FuncTp func, const triangle<Tp, Dim>& tri,
+		Tp max_abs_err, Tp max_rel_err,
+		const triangle_integral<Tp>& rule)
+    -> adaptive_status_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      std::size_t num_evals = 0;
+      auto counted_func = [&func, &num_evals](const std::array<Tp, Dim>& pt)
+			  { ++num_evals; return func(pt); };
+
+      // Try to adjust tests for varing precision.
+      const auto s_rel_err = std::pow(Tp{10},
+				 -std::numeric_limits<Tp>::digits / Tp{10});
+      const auto s_min_area = Tp{100} * std::numeric_limits<Tp>::epsilon();
+
+      if (!valid_tolerances(max_abs_err, max_rel_err))
+	{
+	  std::ostringstream msg;
+	  msg << "adaptive_triangle_integrate: Tolerance cannot be achieved"
+		 " with given absolute (" << max_abs_err << ") and relative ("
+	      << max_rel_err << ") error limits.";
+	  throw std::runtime_error(msg.str().c_str());
+	}
+
+      const auto [result0, abserr0, resabs0, resasc0]
+	= rule(counted_func, tri);
+
+      auto tolerance = std::max(max_abs_err, max_rel_err * std::abs(result0));
+      if (abserr0 <= tolerance || abserr0 == Tp{0})
+	return {result0, abserr0, NO_ERROR, num_evals};
+      else if (workspace.max_size() < 4)
+	return {result0, abserr0, MAX_ITER_ERROR, num_evals,
+		"adaptive_triangle_integrate: "
+		"A maximum of one iteration was insufficient"};
+
+      workspace.clear();
+      workspace.push({tri, result0, abserr0, 0});
+
+      const auto area0 = triangle_area(tri);
+      auto area = result0;
+      auto errsum = abserr0;
+      int error_type = NO_ERROR;
+      int roundoff_type = 0;
+      while (errsum > tolerance && workspace.size() + 3 <= workspace.max_size())
+	{
+	  // Refine the triangle with the largest error estimate.
+	  const auto curr = workspace.pop();
+	  const auto child = red_refine(curr.tri);
+
+	  std::array<decltype(rule(counted_func, tri)), 4> res;
+	  auto area4 = decltype(area){0};
+	  auto error4 = decltype(errsum){0};
+	  for (int c = 0; c < 4; ++c)
+	    {
+	      res[c] = rule(counted_func, child[c]);
+	      area4 += res[c].result;
+	      error4 += res[c].abserr;
+	    }
+	  for (int c = 0; c < 4; ++c)
+	    workspace.push({child[c], res[c].result, res[c].abserr,
+			    curr.depth + 1});
+
+	  const auto delta = area4 - curr.result;
+	  area += delta;
+	  errsum += error4 - curr.abs_error;
+	  tolerance = std::max(max_abs_err, max_rel_err * std::abs(area));
+
+	  if (std::abs(delta) <= s_rel_err * std::abs(area4)
+	      && error4 >= Tp{0.99} * curr.abs_error)
+	    ++roundoff_type;
+
+	  if (errsum > tolerance)
+	    {
+	      if (roundoff_type >= 6)
+		error_type = ROUNDOFF_ERROR;
+	      // Set error flag in the case of bad integrand behaviour
+	      // at a point of the triangle.
+	      if (triangle_area(child[0]) <= s_min_area * area0)
+		error_type = SINGULAR_ERROR;
+	      if (error_type != NO_ERROR)
+		break;
+	    }
+	}
+
+      const auto result = workspace.total_integral();
+      const auto abserr = workspace.total_error();
+
+      if (abserr <= tolerance)
+	return {result, abserr, NO_ERROR, num_evals};
+
+      if (error_type == NO_ERROR)
+	error_type = MAX_ITER_ERROR;
+
+      return {result, abserr, error_type, num_evals};
+    }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    adaptive_triangle_integrate(triangle_workspace<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>, Dim>&
+		  workspace,
+		FuncTp func, const triangle<Tp, Dim>& tri,
+		Tp max_abs_err, Tp max_rel_err,
+		const triangle_integral<Tp>& rule)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      return check_status(__func__,
+			  adaptive_triangle_integrate(std::nothrow, workspace,
+						      func, tri, max_abs_err,
+						      max_rel_err, rule));
+    }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_triangle(FuncTp func, const triangle<Tp, Dim>& tri,
+		       Tp max_abs_err, Tp max_rel_err,
+		       std::size_t max_iter)
+    -> adaptive_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      using RetTp = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>;
+      triangle_workspace<Tp, RetTp, Dim> workspace(3 * max_iter + 1);
+      return adaptive_triangle_integrate(workspace, func, tri,
+					 max_abs_err, max_rel_err);
+    }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_mesh(FuncTp func, const std::vector<triangle<Tp, Dim>>& mesh,
+		   Tp max_abs_err, Tp max_rel_err,
+		   std::size_t max_iter, unsigned int num_threads)
+    -> mesh_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      using RetTp = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>;
+
+      if (!valid_tolerances(max_abs_err, max_rel_err))
+	{
+	  std::ostringstream msg;
+	  msg << "integrate_mesh: Tolerance cannot be achieved"
+		 " with given absolute (" << max_abs_err << ") and relative ("
+	      << max_rel_err << ") error limits.";
+	  throw std::runtime_error(msg.str().c_str());
+	}
+
+      const auto num_elems = mesh.size();
+      mesh_integral_t<Tp, RetTp> out;
+      out.element.resize(num_elems);
+      out.status.assign(num_elems, NO_ERROR);
+      if (num_elems == 0)
+	return out;
+
+      std::vector<Tp> elem_area(num_elems);
+      auto total_area = Tp{0};
+      for (std::size_t e = 0; e < num_elems; ++e)
+	total_area += (elem_area[e] = triangle_area(mesh[e]));
+
+      const triangle_integral<Tp> rule;
+      const auto nt = std::min<std::size_t>(resolve_num_threads(num_threads),
+					    num_elems);
+      parallel_for(0, nt, unsigned(nt),
+	[&](std::size_t t)
+	{
+	  triangle_workspace<Tp, RetTp, Dim> workspace(3 * max_iter + 1);
+	  const auto beg = t * num_elems / nt;
+	  const auto end = (t + 1) * num_elems / nt;
+	  for (auto e = beg; e < end; ++e)
+	    {
+	      const auto abs_err = total_area > Tp{0}
+				 ? max_abs_err * elem_area[e] / total_area
+				 : max_abs_err;
+	      const auto stat = adaptive_triangle_integrate(std::nothrow,
+					workspace, func, mesh[e], abs_err,
+					max_rel_err, rule);
+	      out.element[e] = {stat.result, stat.abserr};
+	      out.status[e] = stat.error_code;
+	    }
+	});
+
+      for (std::size_t e = 0; e < num_elems; ++e)
+	{
+	  out.result += out.element[e].result;
+	  out.abserr += out.element[e].abserr;
+	  if (out.status[e] != NO_ERROR)
+	    ++out.num_failed;
+	}
+
+      return out;
+    }
+
+  template<typename Tp, std::size_t Dim, typename FuncTp>
+    auto
+    integrate_mesh(FuncTp func, const triangle_mesh<Tp, Dim>& mesh,
+		   const triangle_rule<Tp>& rule,
+		   unsigned int num_threads)
+    -> fixed_mesh_integral_t<Tp,
+		std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>>
+    {
+      using RetTp = std::invoke_result_t<FuncTp, const std::array<Tp, Dim>&>;
+      using AreaTp = typename fixed_mesh_integral_t<Tp, RetTp>::AreaTp;
+      const auto s_eps = Tp{16} * std::numeric_limits<Tp>::epsilon();
+
+      const auto num_elems = mesh.element.size();
+      const auto num_pts = rule.size();
+
+      // Classify the rule points.  A vertex point is keyed by its local
+      // vertex and an edge point by the local index of the opposite vertex
+      // and its barycentric coordinate s at the next vertex.
+      std::vector<Tp> weight(num_pts);
+      std::vector<std::array<Tp, 3>> bary(num_pts);
+      std::vector<triangle_point_location> loc(num_pts);
+      std::vector<std::size_t> local(num_pts);
+      std::vector<Tp> edge_pos;
+      std::size_t num_interior = 0;
+      for (std::size_t i = 0; i < num_pts; ++i)
+	{
+	  rule.point(i, weight[i], bary[i]);
+	  loc[i] = rule.location(i);
+	  if (loc[i] == Vertex_Point)
+	    local[i] = std::max_element(bary[i].begin(), bary[i].end())
+		     - bary[i].begin();
+	  else if (loc[i] == Edge_Point)
+	    {
+	      local[i] = std::find(bary[i].begin(), bary[i].end(), Tp{0})
+		       - bary[i].begin();
+	      const auto s = bary[i][(local[i] + 1) % 3];
+	      edge_pos.push_back(s);
+	      edge_pos.push_back(Tp{1} - s);
+	    }
+	  else
+	    ++num_interior;
+	}
+
+      // The distinct positions along an edge measured from either end.
+      std::sort(edge_pos.begin(), edge_pos.end());
+      edge_pos.erase(std::unique(edge_pos.begin(), edge_pos.end(),
+				 [s_eps](Tp a, Tp b)
+				 { return std::abs(a - b) <= s_eps; }),
+		     edge_pos.end());
+      const auto num_pos = edge_pos.size();
+      auto pos_index = [&edge_pos, s_eps](Tp s)
+	{
+	  return std::size_t(std::lower_bound(edge_pos.begin(), edge_pos.end(),
+					      s - s_eps) - edge_pos.begin());
+	};
+
+      // Number the edges of the mesh by their sorted vertex indices.
+      // The local edge z of an element is opposite its vertex z.
+      std::vector<std::array<std::size_t, 3>> elem_edge(num_elems);
+      std::vector<std::array<std::size_t, 2>> edge;
+      if (num_pos > 0)
+	{
+	  std::vector<std::array<std::size_t, 3>> half;
+	  half.reserve(3 * num_elems);
+	  for (std::size_t e = 0; e < num_elems; ++e)
+	    for (std::size_t z = 0; z < 3; ++z)
+	      {
+		const auto a = mesh.element[e][(z + 1) % 3];
+		const auto b = mesh.element[e][(z + 2) % 3];
+		half.push_back({std::min(a, b), std::max(a, b), 3 * e + z});
+	      }
+	  std::sort(half.begin(), half.end());
+	  for (std::size_t h = 0; h < half.size(); ++h)
+	    {
+	      if (h == 0 || half[h][0] != half[h - 1][0]
+			 || half[h][1] != half[h - 1][1])
+		edge.push_back({half[h][0], half[h][1]});
+	      elem_edge[half[h][2] / 3][half[h][2] % 3] = edge.size() - 1;
+	    }
+	}
+
+      // Evaluate the shared vertex and edge values once.
+      const bool has_vertex_pts = rule.num_points(Vertex_Point) > 0;
+      std::vector<RetTp> vertex_val;
+      std::size_t num_vertex_evals = 0;
+      if (has_vertex_pts)
+	{
+	  std::vector<char> used(mesh.vertex.size(), 0);
+	  for (const auto& el : mesh.element)
+	    for (auto v : el)
+	      used[v] = 1;
+	  vertex_val.resize(mesh.vertex.size());
+	  parallel_for(0, mesh.vertex.size(), num_threads,
+		       [&](std::size_t v)
+		       {
+			 if (used[v])
+			   vertex_val[v] = func(mesh.vertex[v]);
+		       });
+	  for (auto u : used)
+	    num_vertex_evals += u;
+	}
+
+      std::vector<RetTp> edge_val(edge.size() * num_pos);
+      parallel_for(0, edge.size(), num_threads,
+	[&](std::size_t g)
+	{
+	  const auto& lo = mesh.vertex[edge[g][0]];
+	  const auto& hi = mesh.vertex[edge[g][1]];
+	  for (std::size_t k = 0; k < num_pos; ++k)
+	    {
+	      std::array<Tp, Dim> pt;
+	      for (std::size_t d = 0; d < Dim; ++d)
+		pt[d] = edge_pos[k] * lo[d] + (Tp{1} - edge_pos[k]) * hi[d];
+	      edge_val[g * num_pos + k] = func(pt);
+	    }
+	});
+
+      // Sum over the elements evaluating only the interior points.
+      fixed_mesh_integral_t<Tp, RetTp> out;
+      out.element.resize(num_elems);
+      parallel_for(0, num_elems, num_threads,
+	[&](std::size_t e)
+	{
+	  const auto& el = mesh.element[e];
+	  const auto tri = mesh.element_triangle(e);
+	  auto sum = AreaTp{0};
+	  for (std::size_t i = 0; i < num_pts; ++i)
+	    {
+	      RetTp val;
+	      if (loc[i] == Vertex_Point)
+		val = vertex_val[el[local[i]]];
+	      else if (loc[i] == Edge_Point)
+		{
+		  const auto z = local[i];
+		  const auto g = elem_edge[e][z];
+		  const auto s = el[(z + 1) % 3] == edge[g][0]
+			       ? bary[i][(z + 1) % 3]
+			       : Tp{1} - bary[i][(z + 1) % 3];
+		  val = edge_val[g * num_pos + pos_index(s)];
+		}
+	      else
+		val = func(barycentric_point(tri, bary[i]));
+	      sum += weight[i] * val;
+	    }
+	  out.element[e] = triangle_area(tri) * sum;
+	});
+
+      for (const auto& res : out.element)
+	out.result += res;
+      out.num_evals = num_vertex_evals + edge_val.size()
+		    + num_elems * num_interior;
+
+      return out;
+    }
+
+} // namespace emsr
+
+#endif // TRIANGLE_INTEGRAL_TCC
@@ -22,9 +22,22 @@
 
 #include <vector>
 #include <array>
+#include <stdexcept>
 
 namespace emsr
 {
+  /**
+   * The location of a point of a triangle rule.
+   * Vertex and edge points are shared by the neighbouring triangles
+   * of a mesh.
+   */
+  enum triangle_point_location
+  {
+    Interior_Point,
+    Edge_Point,
+    Vertex_Point
+  };
+
   /**
    * A generic class for a triangle integration rule.
    */
@@ -35,9 +48,27 @@ namespace emsr
     public:
 
       triangle_rule()
-      : m_order{0}, m_point{}, m_weight{}
+      : m_order{0}, m_weight{}, m_point{}
       { }
 
+      /**
+       * Build the canned rule number @c index, 0 <= index < s_num_tri_rules.
+       */
+      explicit triangle_rule(int index)
+      : m_order{0}, m_weight{}, m_point{}
+      {
+	if (index < 0 || index >= s_num_tri_rules)
+	  throw std::domain_error("triangle_rule: Invalid canned rule index.");
+	this->m_order = s_tri_order[index];
+	for (std::size_t i = 0; i < this->m_order; ++i)
+	  {
+	    this->m_weight.push_back(s_tri_weight[index][i]);
+	    this->m_point.push_back({s_tri_point[index][i][0],
+				     s_tri_point[index][i][1],
+				     s_tri_point[index][i][2]});
+	  }
+      }
+
       triangle_rule(const std::size_t order,
 		    const std::vector<Tp>& weight,
 		    const std::vector<std::array<Tp, 3>>& point)
@@ -48,6 +79,11 @@ namespace emsr
       order() const
       { return this->m_order; }
 
+      /// Return the number of points in the rule.
+      std::size_t
+      size() const
+      { return this->m_weight.size(); }
+
       void
       point(const std::size_t index, Tp& weight,
 	    std::array<Tp,3>& point) const
@@ -56,6 +92,33 @@ namespace emsr
 	point = this->m_point[index];
       }
 
+      /**
+       * Return the location of the point at @c index: a vertex point
+       * has two zero barycentric coordinates and an edge point one.
+       */
+      triangle_point_location
+      location(const std::size_t index) const
+      {
+	int num_zero = 0;
+	for (const auto& l : this->m_point[index])
+	  if (l == Tp{0})
+	    ++num_zero;
+	return num_zero >= 2 ? Vertex_Point
+	     : num_zero == 1 ? Edge_Point
+	     : Interior_Point;
+      }
+
+      /// Return the number of points at the given location.
+      std::size_t
+      num_points(triangle_point_location loc) const
+      {
+	std::size_t num = 0;
+	for (std::size_t i = 0; i < this->size(); ++i)
+	  if (this->location(i) == loc)
+	    ++num;
+	return num;
+      }
+
       static const int s_num_tri_rules = 6;
       static const int s_max_tri_order = 10;
 
@@ -71,13 +134,6 @@ namespace emsr
 
     };
 
-  /**
-   * @todo Figure out a way to mark wich rules are interior and which
-   * rules have points at vertices or edges.  One would be able easily
-   * and significantly to reduce the number of function evaluations
-   * over a triangulated domain.
-   */
-
   /**
    * An array indicating the order of the canned rules.
    * This is the number of the weights and the barycenters for the rule.
@@ -135,12 +191,12 @@ namespace emsr
 	{ Tp{0}, Tp{0}, Tp{1} }
       },
 
-      // One point at center and three near vertices.
+      // One point at center and three near vertices (Strang and Fix).
       {
 	{ Tp{1} / Tp{3}, Tp{1} / Tp{3}, Tp{1} / Tp{3} },
-	{ Tp{11} / Tp{15}, Tp{2} / Tp{15}, Tp{2} / Tp{15} },
-	{ Tp{2} / Tp{15}, Tp{11} / Tp{15}, Tp{2} / Tp{15} },
-	{ Tp{2} / Tp{15}, Tp{2} / Tp{15}, Tp{11} / Tp{15} }
+	{ Tp{3} / Tp{5}, Tp{1} / Tp{5}, Tp{1} / Tp{5} },
+	{ Tp{1} / Tp{5}, Tp{3} / Tp{5}, Tp{1} / Tp{5} },
+	{ Tp{1} / Tp{5}, Tp{1} / Tp{5}, Tp{3} / Tp{5} }
       },
 
       // One point at center, three points on edges, three points at vertices.
@@ -0,0 +1,175 @@
+//
+// Copyright (C) 2021-2022 Edward M. Smith-Rowland
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or (at
+// your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef TRIANGLE_WORKSPACE_H
+#define TRIANGLE_WORKSPACE_H 1
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace emsr
+{
+
+  /**
+   * A triangle in the plane (Dim = 2) or in space (Dim = 3)
+   * given by its vertices.
+   */
+  template<typename Tp, std::size_t Dim = 2>
+    struct triangle
+    {
+      using point_type = std::array<Tp, Dim>;
+
+      std::array<point_type, 3> vertex;
+    };
+
+  /**
+   * A workspace for adaptive cubature over a triangle.
+   * The triangles are kept in a heap ordered by absolute error
+   * as the intervals of integration_workspace.
+   */
+  template<typename Tp, typename RetTp, std::size_t Dim = 2>
+    class triangle_workspace
+    {
+    public:
+
+      using AreaTp = decltype(RetTp{} * Tp{});
+      using ErrorTp = decltype(std::abs(AreaTp{}));
+
+      struct region
+      {
+	triangle<Tp, Dim> tri;
+	AreaTp result;
+	ErrorTp abs_error;
+	std::size_t depth;
+      };
+
+    private:
+
+      /**
+       * Comparison of triangle regions by absolute error.
+       */
+      struct region_comp
+      {
+	bool
+	operator()(const region& rl, const region& rr) const
+	{ return rl.abs_error < rr.abs_error; }
+      };
+
+      // The maximum size of the workspace.
+      std::size_t m_max_size;
+
+      // The current maximum depth.
+      std::size_t m_max_depth;
+
+      std::vector<region> m_region;
+
+    public:
+
+      explicit triangle_workspace(std::size_t cap)
+      : m_max_size(cap),
+	m_max_depth{0},
+	m_region{}
+      { this->m_region.reserve(cap); }
+
+      std::size_t
+      size() const
+      { return this->m_region.size(); }
+
+      std::size_t
+      max_size() const
+      { return this->m_max_size; }
+
+      std::size_t
+      capacity() const
+      { return this->m_region.capacity(); }
+
+      std::size_t
+      max_depth() const
+      { return this->m_max_depth; }
+
+      void
+      clear()
+      {
+	this->m_max_depth = 0;
+	this->m_region.clear();
+      }
+
+      /**
+       * Return the region with the largest error - the top of the heap.
+       */
+      const region&
+      top() const
+      { return this->m_region.front(); }
+
+      /**
+       * Push a new region into the heap.
+       */
+      void
+      push(const region& reg)
+      {
+	this->m_region.push_back(reg);
+	std::push_heap(this->m_region.begin(), this->m_region.end(),
+		       region_comp{});
+	this->m_max_depth = std::max(this->m_max_depth, reg.depth);
+      }
+
+      /**
+       * Remove and return the region with the largest error.
+       */
+      region
+      pop()
+      {
+	std::pop_heap(this->m_region.begin(), this->m_region.end(),
+		      region_comp{});
+	auto reg = this->m_region.back();
+	this->m_region.pop_back();
+	return reg;
+      }
+
+      /// Return the total integral:
+      /// the sum of the results over all regions.
+      AreaTp
+      total_integral() const
+      {
+	auto result_sum = AreaTp{0};
+	for (const auto& reg : this->m_region)
+	  result_sum += reg.result;
+	return result_sum;
+      }
+
+      /// Return the sum of the absolute errors over all regions.
+      ErrorTp
+      total_error() const
+      {
+	auto tot_error = ErrorTp{0};
+	for (const auto& reg : this->m_region)
+	  tot_error += reg.abs_error;
+	return tot_error;
+      }
+
+      /// Return the vector of regions in heap order.
+      const std::vector<region>&
+      regions() const
+      { return this->m_region; }
+    };
+
+} // namespace emsr
+
+#endif // TRIANGLE_WORKSPACE_H
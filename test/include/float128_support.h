@@ -0,0 +1,110 @@
+#ifndef FLOAT128_SUPPORT_H
+#define FLOAT128_SUPPORT_H 1
+
+/**
+ * Just enough of <cmath>, <limits> and <ostream> for __float128 that
+ * std::complex<__float128> and std::uniform_real_distribution<__float128>
+ * can be instantiated with a standard library that lacks them.
+ *
+ * The math overloads must be declared before the definitions
+ * of the templates that call them so include this before
+ * <complex> and <random>.
+ */
+#ifdef EMSR_HAVE_FLOAT128
+
+#include <quadmath.h>
+
+#include <cmath>
+#include <limits>
+#include <ostream>
+
+namespace std
+{
+
+  inline __float128
+  cos(__float128 x)
+  { return cosq(x); }
+
+  inline __float128
+  sin(__float128 x)
+  { return sinq(x); }
+
+  inline __float128
+  sqrt(__float128 x)
+  { return sqrtq(x); }
+
+  inline __float128
+  atan2(__float128 y, __float128 x)
+  { return atan2q(y, x); }
+
+  inline __float128
+  hypot(__float128 x, __float128 y)
+  { return hypotq(x, y); }
+
+  inline __float128
+  log(__float128 x)
+  { return logq(x); }
+
+  inline __float128
+  nextafter(__float128 x, __float128 y)
+  { return nextafterq(x, y); }
+
+  template<>
+    struct numeric_limits<__float128>
+    {
+      static constexpr bool is_specialized = true;
+      static constexpr bool is_signed = true;
+      static constexpr bool is_integer = false;
+      static constexpr bool is_exact = false;
+      static constexpr bool has_infinity = true;
+      static constexpr bool has_quiet_NaN = true;
+      static constexpr bool is_iec559 = true;
+      static constexpr int radix = 2;
+      static constexpr int digits = FLT128_MANT_DIG;
+      static constexpr int digits10 = FLT128_DIG;
+      static constexpr int max_digits10 = 36;
+      static constexpr int min_exponent = FLT128_MIN_EXP;
+      static constexpr int max_exponent = FLT128_MAX_EXP;
+
+      static constexpr __float128
+      min() noexcept
+      { return FLT128_MIN; }
+
+      static constexpr __float128
+      max() noexcept
+      { return FLT128_MAX; }
+
+      static constexpr __float128
+      lowest() noexcept
+      { return -FLT128_MAX; }
+
+      static constexpr __float128
+      epsilon() noexcept
+      { return FLT128_EPSILON; }
+
+      static constexpr __float128
+      denorm_min() noexcept
+      { return FLT128_DENORM_MIN; }
+
+      static constexpr __float128
+      infinity() noexcept
+      { return __builtin_huge_valq(); }
+
+      static constexpr __float128
+      quiet_NaN() noexcept
+      { return __builtin_nanq(""); }
+    };
+
+  inline ostream&
+  operator<<(ostream& os, __float128 x)
+  {
+    char buf[64];
+    quadmath_snprintf(buf, sizeof(buf), "%.*Qg", int(os.precision()), x);
+    return os << buf;
+  }
+
+} // namespace std
+
+#endif // EMSR_HAVE_FLOAT128
+
+#endif // FLOAT128_SUPPORT_H
@@ -0,0 +1,265 @@
+
+// Pre-populate a rule file with expensive quadrature rules.
+//
+// Usage: build_rule_file [output_file]
+//
+// The default output file is emsr_rules.bin.
+//
+// The rules are built for float, double and long double.  Where
+// EMSR_HAVE_FLOAT128 is defined the Clenshaw-Curtis rules, which need only
+// cosines, are also built for __float128 with libquadmath.
+// The Gauss rule builders call std math functions that have no __float128
+// overloads so the __float128 Gauss-Legendre and Gauss-Jacobi rules are
+// the long double rules polished by Newton's method in __float128.
+// There are no __float128 Gauss-Kronrod rules.
+
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <emsr/gauss_kronrod_integral.h>
+#include <emsr/gauss_kronrod_integral.tcc>
+#include <emsr/quadrature_point.h>
+#include <emsr/rule_file.h>
+
+#ifdef EMSR_HAVE_FLOAT128
+#  include <quadmath.h>
+#endif
+
+template<typename Tp>
+  Tp
+  rule_pi()
+  { return Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L}; }
+
+template<typename Tp>
+  Tp
+  rule_cos(Tp x)
+  { return std::cos(x); }
+
+#ifdef EMSR_HAVE_FLOAT128
+template<>
+  __float128
+  rule_pi<__float128>()
+  { return M_PIq; }
+
+template<>
+  __float128
+  rule_cos<__float128>(__float128 x)
+  { return cosq(x); }
+#endif
+
+/**
+ * Build the Clenshaw-Curtis rule with @c n + 1 points by direct summation.
+ *
+ * @f[
+ *    w_k = \frac{c_k}{n}\left[1-\sum_{j=1}^{[n/2]}\frac{b_j}{4j^2-1}
+ *            \cos\left(\frac{2jk\pi}{n}\right)\right]
+ *    \mbox{   } k = 0, 1, ..., n
+ * @f]
+ */
+template<typename Tp>
+  void
+  build_clenshaw_curtis(unsigned int n,
+			std::vector<Tp>& point, std::vector<Tp>& weight)
+  {
+    const auto s_pi = rule_pi<Tp>();
+    point.assign(n + 1, Tp{0});
+    weight.assign(n + 1, Tp{0});
+    if (n == 0)
+      {
+	weight[0] = Tp{2};
+	return;
+      }
+    for (auto k = 0u; k <= n; ++k)
+      {
+	point[k] = 2 * k == n ? Tp{0} : rule_cos(Tp(k) * s_pi / Tp(n));
+	auto sum = Tp{0};
+	for (auto j = 1u; j <= n / 2; ++j)
+	  {
+	    const auto b = Tp(2 * j == n ? 1 : 2);
+	    sum += b * rule_cos(Tp(2 * j * k) * s_pi / Tp(n))
+		 / Tp(4 * j * j - 1);
+	  }
+	const auto c = Tp(k == 0 || k == n ? 1 : 2);
+	weight[k] = c * (Tp{1} - sum) / Tp(n);
+      }
+  }
+
+template<typename Tp>
+  void
+  split(const std::vector<emsr::QuadraturePoint<Tp>>& rule,
+	std::vector<Tp>& point, std::vector<Tp>& weight)
+  {
+    point.resize(rule.size());
+    weight.resize(rule.size());
+    for (std::size_t i = 0; i < rule.size(); ++i)
+      {
+	point[i] = rule[i].point;
+	weight[i] = rule[i].weight;
+      }
+  }
+
+template<typename Tp>
+  void
+  add_clenshaw_curtis_rules(emsr::rule_file_writer& writer)
+  {
+    std::vector<Tp> x, w;
+
+    // Clenshaw-Curtis rules of the nested sequence 2^k + 1.
+    for (unsigned n = 2; n <= 1024; n *= 2)
+      {
+	build_clenshaw_curtis<Tp>(n, x, w);
+	writer.add(emsr::Rule_Clenshaw_Curtis, int(n + 1), 0.0, 0.0, x, w);
+      }
+  }
+
+#ifdef EMSR_HAVE_FLOAT128
+/**
+ * Return the Jacobi polynomial @f$ P_n^{(\alpha,\beta)}(x) @f$
+ * and its derivative by the three-term recursion.
+ */
+std::pair<__float128, __float128>
+jacobi_poly(unsigned n, __float128 alpha, __float128 beta, __float128 x)
+{
+  const auto ab = alpha + beta;
+  auto p0 = __float128{1};
+  if (n == 0)
+    return {p0, __float128{0}};
+  auto p1 = (alpha + 1) + (ab + 2) * (x - 1) / 2;
+  for (unsigned k = 2; k <= n; ++k)
+    {
+      const auto c = 2 * k + ab;
+      const auto p2 = ((c - 1) * (c * (c - 2) * x + alpha * alpha - beta * beta)
+		       * p1
+		     - 2 * (k + alpha - 1) * (k + beta - 1) * c * p0)
+		    / (2 * k * (k + ab) * (c - 2));
+      p0 = p1;
+      p1 = p2;
+    }
+  const auto c = 2 * n + ab;
+  const auto dp = (n * (alpha - beta - c * x) * p1
+		 + 2 * (n + alpha) * (n + beta) * p0)
+		/ (c * (1 - x * x));
+  return {p1, dp};
+}
+
+/**
+ * Build the __float128 Gauss-Jacobi rule of order @c n from
+ * the long double rule by Newton's method on the recursion.
+ * The weights are
+ * @f[
+ *    w_i = \frac{2^{\alpha+\beta+1}\Gamma(n+\alpha+1)\Gamma(n+\beta+1)}
+ *               {\Gamma(n+\alpha+\beta+1)\, n!}
+ *          \frac{1}{(1-x_i^2)[P_n^{(\alpha,\beta)\prime}(x_i)]^2}
+ * @f]
+ */
+void
+build_jacobi_float128(unsigned n, double alpha, double beta,
+		      std::vector<__float128>& point,
+		      std::vector<__float128>& weight)
+{
+  const auto rule = emsr::jacobi_zeros<long double>(n, alpha, beta, 0u);
+  const __float128 a = alpha, b = beta;
+  const auto lnorm = (a + b + 1) * logq(__float128{2})
+		   + lgammaq(n + a + 1) + lgammaq(n + b + 1)
+		   - lgammaq(n + a + b + 1) - lgammaq(__float128(n + 1));
+  point.resize(n);
+  weight.resize(n);
+  for (unsigned i = 0; i < n; ++i)
+    {
+      __float128 x = rule[i].point;
+      for (int iter = 0; iter < 4; ++iter)
+	{
+	  const auto [p, dp] = jacobi_poly(n, a, b, x);
+	  x -= p / dp;
+	}
+      const auto dp = jacobi_poly(n, a, b, x).second;
+      point[i] = x;
+      weight[i] = expq(lnorm) / ((1 - x * x) * dp * dp);
+    }
+}
+
+void
+add_float128_rules(emsr::rule_file_writer& writer)
+{
+  std::vector<__float128> x, w;
+
+  // Gauss-Legendre rules.
+  for (unsigned n : {128u, 256u, 512u, 1024u})
+    {
+      build_jacobi_float128(n, 0.0, 0.0, x, w);
+      writer.add(emsr::Rule_Gauss_Legendre, int(n), 0.0, 0.0, x, w);
+    }
+
+  // Gauss-Jacobi rules for the common endpoint singularities.
+  for (double alpha : {-0.5, 0.0, 0.5})
+    for (double beta : {-0.5, 0.0, 0.5})
+      for (unsigned n : {64u, 128u, 256u})
+	{
+	  build_jacobi_float128(n, alpha, beta, x, w);
+	  writer.add(emsr::Rule_Gauss_Jacobi, int(n), alpha, beta, x, w);
+	}
+
+  add_clenshaw_curtis_rules<__float128>(writer);
+}
+#endif
+
+template<typename Tp>
+  void
+  add_rules(emsr::rule_file_writer& writer)
+  {
+    std::vector<Tp> x, w, wg;
+
+    // Gauss-Kronrod extensions beyond the tabulated 15...61 point rules.
+    for (int n : {40, 50, 60, 75, 100, 150, 200})
+      {
+	const auto eps = 4 * std::numeric_limits<Tp>::epsilon();
+	emsr::build_gauss_kronrod(n, eps, x, wg, w);
+	writer.add(emsr::Rule_Gauss_Kronrod, 2 * n + 1, 0.0, 0.0, x, w, wg);
+      }
+
+    // Gauss-Legendre rules.
+    for (unsigned n : {128u, 256u, 512u, 1024u})
+      {
+	split(emsr::legendre_zeros<Tp>(n, 0u), x, w);
+	writer.add(emsr::Rule_Gauss_Legendre, int(n), 0.0, 0.0, x, w);
+      }
+
+    // Gauss-Jacobi rules for the common endpoint singularities.
+    for (double alpha : {-0.5, 0.0, 0.5})
+      for (double beta : {-0.5, 0.0, 0.5})
+	for (unsigned n : {64u, 128u, 256u})
+	  {
+	    split(emsr::jacobi_zeros<Tp>(n, Tp(alpha), Tp(beta), 0u), x, w);
+	    writer.add(emsr::Rule_Gauss_Jacobi, int(n), alpha, beta, x, w);
+	  }
+
+    add_clenshaw_curtis_rules<Tp>(writer);
+  }
+
+int
+main(int n_app_args, char** arg)
+{
+  const std::string path = n_app_args > 1 ? arg[1] : "emsr_rules.bin";
+
+  auto start = std::chrono::steady_clock::now();
+
+  emsr::rule_file_writer writer;
+  add_rules<float>(writer);
+  add_rules<double>(writer);
+  add_rules<long double>(writer);
+#ifdef EMSR_HAVE_FLOAT128
+  add_float128_rules(writer);
+#endif
+  writer.write(path);
+
+  auto stop = std::chrono::steady_clock::now();
+  std::chrono::duration<double> dt = stop - start;
+
+  emsr::rule_file rf(path);
+  std::cout << "wrote " << rf.size() << " rules to " << path
+	    << " in " << dt.count() << " s\n";
+}
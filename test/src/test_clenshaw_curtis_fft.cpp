@@ -0,0 +1,160 @@
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <emsr/integration.h>
+
+/**
+ * The Clenshaw-Curtis weights by the direct cosine sum.
+ */
+template<typename Tp>
+  std::vector<Tp>
+  clenshaw_curtis_sum(std::size_t n)
+  {
+    const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+    std::vector<Tp> w(n + 1);
+    for (std::size_t k = 0; k <= n; ++k)
+      {
+	auto sum = Tp{0};
+	for (std::size_t j = 1; j <= n / 2; ++j)
+	  {
+	    const auto b = Tp(2 * j == n ? 1 : 2);
+	    sum += b * std::cos(Tp(2 * j * k) * s_pi / Tp(n))
+		 / Tp(4 * j * j - 1);
+	  }
+	const auto c = Tp(k == 0 || k == n ? 1 : 2);
+	w[k] = c * (Tp{1} - sum) / Tp(n);
+      }
+    return w;
+  }
+
+/**
+ * Return the largest error of a rule on the even monomials up to degree.
+ */
+template<typename Tp>
+  Tp
+  monomial_error(const std::vector<emsr::QuadraturePoint<Tp>>& rule,
+		 std::size_t degree)
+  {
+    auto err = Tp{0};
+    for (std::size_t d = 0; d <= degree; d += 2)
+      {
+	auto sum = Tp{0};
+	for (const auto& pt : rule)
+	  sum += pt.weight * std::pow(pt.point, Tp(d));
+	err = std::max(err, std::abs(sum - Tp{2} / Tp(d + 1)));
+      }
+    return err;
+  }
+
+template<typename Tp>
+  void
+  test_clenshaw_curtis_fft()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    std::cout << "\nFFT weights vs. cosine sum and monomial exactness\n";
+    for (std::size_t n : {2, 3, 4, 5, 8, 17, 64, 100, 243})
+      {
+	const auto cc = emsr::clenshaw_curtis_rule<Tp>(n);
+	const auto sum = clenshaw_curtis_sum<Tp>(n);
+	auto d = Tp{0};
+	for (std::size_t k = 0; k <= n; ++k)
+	  d = std::max(d, std::abs(cc[k].weight - sum[k]));
+	const auto f1 = emsr::fejer_1_rule<Tp>(n);
+	const auto f2 = emsr::fejer_2_rule<Tp>(n);
+	std::cout << ' ' << std::setw(4) << n
+		  << "  CC vs. sum " << std::setw(w) << d
+		  << "  CC " << std::setw(w) << monomial_error(cc, n)
+		  << "  Fejer 1 " << std::setw(w) << monomial_error(f1, n - 1)
+		  << "  Fejer 2 " << std::setw(w) << monomial_error(f2, n - 2)
+		  << '\n';
+      }
+
+    std::cout << "\nTime to build large rules\n";
+    for (std::size_t n : {1000, 1 << 16, 1 << 20})
+      {
+	auto start = std::chrono::steady_clock::now();
+	const auto cc = emsr::clenshaw_curtis_rule<Tp>(n);
+	auto stop = std::chrono::steady_clock::now();
+	std::chrono::duration<double> dt = stop - start;
+	auto sum = Tp{0};
+	for (const auto& pt : cc)
+	  sum += pt.weight;
+	std::cout << ' ' << std::setw(8) << n << "  " << dt.count() << " s"
+		  << "  sum of weights - 2 = " << sum - Tp{2} << '\n';
+      }
+
+    // A smooth but oscillatory integrand needing thousands of points.
+    int count = 0;
+    auto f = [&count](Tp x) -> Tp
+	     {
+	       ++count;
+	       return std::exp(-x * x / Tp{16}) * (Tp{2} + std::cos(Tp{100} * x));
+	     };
+    const auto a = Tp{-8}, b = Tp{8};
+
+    auto report = [&count, w](const char* name, auto integ)
+      {
+	count = 0;
+	try
+	  {
+	    const auto res = integ();
+	    std::cout << "   " << std::setw(12) << std::left << name << std::right
+		      << std::setw(w) << res.result
+		      << "  err " << std::setw(w) << res.abserr
+		      << "  evals " << count << '\n';
+	  }
+	catch (const emsr::integration_error<Tp, Tp>& err)
+	  {
+	    std::cout << "   " << std::setw(12) << std::left << name << std::right
+		      << std::setw(w) << err.result()
+		      << "  err " << std::setw(w) << err.abserr()
+		      << "  evals " << count << "  (" << err.what() << ")\n";
+	  }
+      };
+
+    std::cout << "\nNested Clenshaw-Curtis vs. CQUAD and QAG\n";
+    for (Tp tol : {Tp{1.0e-6L}, Tp{1.0e-10L}})
+      {
+	std::cout << " tol = " << tol << '\n';
+	report("nested CC",
+	       [&]
+	       {
+		 return emsr::clenshaw_curtis_integral<Tp>()
+			  .integrate(f, a, b, Tp{0}, tol);
+	       });
+	report("cquad",
+	       [&]{ return emsr::integrate_clenshaw_curtis(f, a, b, Tp{0}, tol); });
+	report("qag",
+	       [&]{ return emsr::integrate(f, a, b, Tp{0}, tol); });
+      }
+
+    // As a local rule the climb stops at max_local_level
+    // even where the integrand never settles.
+    std::cout << "\nLocal rule on a kink\n";
+    auto g = [&count](Tp x) -> Tp { ++count; return std::abs(x - Tp{0.3L}); };
+    for (int local : {8, 16})
+      {
+	const emsr::clenshaw_curtis_integral<Tp> cc(16, 3, local);
+	count = 0;
+	const auto res = cc(g, Tp{-1}, Tp{1});
+	std::cout << "  max_local_level " << std::setw(2) << cc.max_local_level()
+		  << "  error " << std::setw(w) << res.result - Tp{1.09L}
+		  << "  evals " << count << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_clenshaw_curtis_fft<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_clenshaw_curtis_fft<long double>();
+}
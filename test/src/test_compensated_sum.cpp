@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include <emsr/integration.h>
+#include <emsr/compensated_sum.h>
+
+template<typename Tp>
+  void
+  test_compensated_sum()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    // Cancelling pairs over a wide range of magnitudes
+    // and small terms of both signs.
+    std::mt19937_64 gen(12345);
+    std::uniform_real_distribution<Tp> mant(Tp{-1}, Tp{1});
+    std::uniform_int_distribution<int> expo(-60, 60);
+    auto terms = [&gen, &mant, &expo](std::size_t n)
+      {
+	std::vector<Tp> term;
+	for (std::size_t i = 0; i < n / 4; ++i)
+	  {
+	    const auto t = std::ldexp(mant(gen), expo(gen));
+	    term.push_back(t);
+	    term.push_back(-t);
+	    term.push_back(mant(gen));
+	    term.push_back(mant(gen));
+	  }
+	return term;
+      };
+    auto term = terms(10000);
+
+    std::cout << "\nSums of " << term.size() << " terms in 20 orders\n";
+    Tp naive0{}, comp0{}, exact0{};
+    bool naive_same = true, comp_same = true, exact_same = true;
+    for (int perm = 0; perm < 20; ++perm)
+      {
+	auto naive = Tp{0};
+	emsr::compensated_sum<Tp> comp;
+	emsr::exact_sum<Tp> exact;
+	for (auto t : term)
+	  {
+	    naive += t;
+	    comp += t;
+	    exact += t;
+	  }
+	if (perm == 0)
+	  {
+	    naive0 = naive;
+	    comp0 = comp.value();
+	    exact0 = exact.value();
+	  }
+	naive_same = naive_same && naive == naive0;
+	comp_same = comp_same && comp.value() == comp0;
+	exact_same = exact_same && exact.value() == exact0;
+	std::shuffle(term.begin(), term.end(), gen);
+      }
+    std::cout << "  naive        " << std::setw(w) << naive0
+	      << "  error " << std::setw(w) << naive0 - exact0
+	      << "  order independent: " << std::boolalpha << naive_same << '\n'
+	      << "  compensated  " << std::setw(w) << comp0
+	      << "  error " << std::setw(w) << comp0 - exact0
+	      << "  order independent: " << comp_same << '\n'
+	      << "  exact        " << std::setw(w) << exact0
+	      << "                           order independent: "
+	      << exact_same << '\n';
+
+    // Removing terms leaves the exact sum of the rest.
+    emsr::exact_sum<Tp> all, half;
+    for (std::size_t i = 0; i < term.size(); ++i)
+      {
+	all += term[i];
+	if (i % 2 == 0)
+	  half += term[i];
+      }
+    for (std::size_t i = 1; i < term.size(); i += 2)
+      all -= term[i];
+    std::cout << "  exact removal identical: " << (all.value() == half.value())
+	      << '\n';
+
+    // Cancellation that defeats plain summation.
+    const auto big = std::ldexp(Tp{1}, std::numeric_limits<Tp>::digits + 2);
+    const std::vector<Tp> cancel{big, Tp{1}, Tp{-1} / Tp{3}, -big, Tp{1} / Tp{3}};
+    auto naive = Tp{0};
+    emsr::compensated_sum<Tp> comp;
+    emsr::exact_sum<Tp> exact;
+    for (auto t : cancel)
+      {
+	naive += t;
+	comp += t;
+	exact += t;
+      }
+    std::cout << "\n2^(p+2) + 1 - 1/3 - 2^(p+2) + 1/3\n"
+	      << "  naive " << naive << "  compensated " << comp.value()
+	      << "  exact " << exact.value() << '\n';
+
+    // Infinities and the range extremes.
+    const auto inf = std::numeric_limits<Tp>::infinity();
+    const auto tiny = std::numeric_limits<Tp>::denorm_min();
+    const auto huge = std::numeric_limits<Tp>::max();
+    emsr::exact_sum<Tp> edge;
+    edge += huge;
+    edge += tiny;
+    edge += inf;
+    std::cout << "\nmax + denorm_min + inf = " << edge.value();
+    edge -= inf;
+    edge -= huge;
+    std::cout << "  then - inf - max = " << edge.value()
+	      << "  (denorm_min " << tiny << ")\n";
+    edge += huge;
+    edge += huge;
+    std::cout << "  + max + max = " << edge.value() << '\n';
+
+    emsr::exact_sum<std::complex<Tp>> csum;
+    csum += std::complex<Tp>{big, Tp{1}};
+    csum += std::complex<Tp>{Tp{1}, -big};
+    csum -= std::complex<Tp>{big, -big};
+    std::cout << "  complex exact " << csum.value() << '\n';
+
+    // Workspace totals: the same intervals added in different orders.
+    std::cout << "\nWorkspace totals over shuffled intervals\n";
+    const std::size_t num_ival = 2000;
+    const auto area = terms(num_ival);
+    std::vector<std::array<Tp, 2>> ival(num_ival);
+    for (std::size_t i = 0; i < num_ival; ++i)
+      ival[i] = {area[i], std::abs(std::ldexp(mant(gen), -30))};
+    for (auto mode : {emsr::Summation_Compensated,
+		      emsr::Summation_Reproducible})
+      {
+	emsr::integration_workspace<Tp, Tp> ws(num_ival, mode);
+	Tp total0{}, error0{};
+	bool same = true;
+	for (int perm = 0; perm < 10; ++perm)
+	  {
+	    ws.clear();
+	    for (std::size_t i = 0; i < num_ival; ++i)
+	      ws.append(Tp(i), Tp(i + 1), ival[i][0], ival[i][1]);
+	    if (perm == 0)
+	      {
+		total0 = ws.total_integral();
+		error0 = ws.total_error();
+	      }
+	    same = same && ws.total_integral() == total0
+			&& ws.total_error() == error0;
+	    std::shuffle(ival.begin(), ival.end(), gen);
+	  }
+	std::cout << "  " << (mode == emsr::Summation_Compensated
+			      ? "compensated " : "reproducible")
+		  << "  total " << std::setw(w) << total0
+		  << "  order independent: " << same << '\n';
+      }
+
+    // Adaptive integrals in both modes.
+    std::cout << "\nqag_integrate of sin(200 x) over [0, 3]\n";
+    auto func = [](Tp x) { return std::sin(Tp{200} * x); };
+    const auto exact_int = (Tp{1} - std::cos(Tp{600})) / Tp{200};
+    for (auto mode : {emsr::Summation_Compensated,
+		      emsr::Summation_Reproducible})
+      {
+	emsr::integration_workspace<Tp, Tp> ws(1000, mode);
+	const auto res = emsr::qag_integrate(std::nothrow, ws, func,
+					     Tp{0}, Tp{3}, Tp{0}, Tp{1.0e-12L});
+	std::cout << "  " << (mode == emsr::Summation_Compensated
+			      ? "compensated " : "reproducible")
+		  << "  result " << std::setw(w) << res.result
+		  << "  err " << std::setw(w) << res.abserr
+		  << "  actual " << std::setw(w) << res.result - exact_int
+		  << "  code " << res.error_code
+		  << "  intervals " << ws.size() << '\n';
+      }
+    std::cout << "\ncquad_integrate of 1/sqrt(x) + sin(30 x) over [0, 1]\n";
+    auto cfunc = [](Tp x) { return Tp{1} / std::sqrt(x) + std::sin(Tp{30} * x); };
+    const auto cexact_int = Tp{2} + (Tp{1} - std::cos(Tp{30})) / Tp{30};
+    for (auto mode : {emsr::Summation_Compensated,
+		      emsr::Summation_Reproducible})
+      {
+	emsr::cquad_workspace<Tp, Tp> ws(200, mode);
+	const auto res = emsr::cquad_integrate(std::nothrow, ws, cfunc,
+					       Tp{0}, Tp{1}, Tp{0}, Tp{1.0e-12L});
+	std::cout << "  " << (mode == emsr::Summation_Compensated
+				    ? "compensated " : "reproducible")
+		  << "  result " << std::setw(w) << res.result
+		  << "  err " << std::setw(w) << res.abserr
+		  << "  actual " << std::setw(w) << res.result - cexact_int
+		  << "  code " << res.error_code << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_compensated_sum<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_compensated_sum<long double>();
+}
@@ -0,0 +1,219 @@
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include <emsr/integration.h>
+#include <emsr/fourier_transform.h>
+
+/**
+ * The real-to-real transforms by direct summation in long double.
+ */
+template<typename Tp>
+  std::vector<Tp>
+  direct_transform(const std::vector<Tp>& x, int kind)
+  {
+    const auto s_pi = 3.1415'92653'58979'32384'62643'38327'95028'84195e+0L;
+    const auto len = x.size();
+    const auto N = static_cast<long double>(len);
+    std::vector<Tp> y(len);
+    for (std::size_t k = 0; k < len; ++k)
+      {
+	auto sum = 0.0L;
+	for (std::size_t j = 0; j < len; ++j)
+	  {
+	    const auto xj = static_cast<long double>(x[j]);
+	    const auto J = static_cast<long double>(j);
+	    const auto K = static_cast<long double>(k);
+	    switch (kind)
+	      {
+	      case 1: // DCT-I
+		sum += (j == 0 || j == len - 1 ? 0.5L : 1.0L)
+		     * xj * std::cos(s_pi * J * K / (N - 1));
+		break;
+	      case 2: // DCT-II
+		sum += xj * std::cos(s_pi * (J + 0.5L) * K / N);
+		break;
+	      case 3: // DCT-III
+		sum += (j == 0 ? 0.5L : 1.0L)
+		     * xj * std::cos(s_pi * J * (K + 0.5L) / N);
+		break;
+	      case 4: // DST-I
+		sum += xj * std::sin(s_pi * (J + 1) * (K + 1) / (N + 1));
+		break;
+	      case 5: // DST-II
+		sum += xj * std::sin(s_pi * (J + 0.5L) * (K + 1) / N);
+		break;
+	      case 6: // DST-III
+		sum += (j == len - 1 ? 0.5L : 1.0L)
+		     * xj * std::sin(s_pi * (J + 1) * (K + 0.5L) / N);
+		break;
+	      }
+	  }
+	y[k] = Tp(sum);
+      }
+    return y;
+  }
+
+template<typename Tp>
+  std::vector<Tp>
+  random_data(std::size_t len)
+  {
+    std::default_random_engine re;
+    std::uniform_real_distribution<Tp> ud(Tp{-1}, Tp{+1});
+    std::vector<Tp> x(len);
+    for (auto& xi : x)
+      xi = ud(re);
+    return x;
+  }
+
+template<typename Tp>
+  void
+  test_cosine_transform()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    using xform_t = std::function<void(std::vector<Tp>&)>;
+    const char* name[6]{"DCT-I", "DCT-II", "DCT-III",
+			"DST-I", "DST-II", "DST-III"};
+    const xform_t xform[6]
+    {
+      emsr::fast_cosine_transform_1<Tp>,
+      emsr::fast_cosine_transform_2<Tp>,
+      emsr::fast_cosine_transform_3<Tp>,
+      emsr::fast_sine_transform_1<Tp>,
+      emsr::fast_sine_transform_2<Tp>,
+      emsr::fast_sine_transform_3<Tp>,
+    };
+
+    std::cout << "\nFast transforms vs. direct sums\n";
+    for (std::size_t len : {2, 3, 4, 5, 8, 13, 16, 25, 100, 257})
+      {
+	const auto x = random_data<Tp>(len);
+	std::cout << ' ' << std::setw(4) << len;
+	for (int kind = 1; kind <= 6; ++kind)
+	  {
+	    auto y = x;
+	    xform[kind - 1](y);
+	    const auto z = direct_transform(x, kind);
+	    auto d = Tp{0};
+	    for (std::size_t k = 0; k < len; ++k)
+	      d = std::max(d, std::abs(y[k] - z[k]));
+	    std::cout << "  " << name[kind - 1] << ' ' << std::setw(w) << d;
+	  }
+	std::cout << '\n';
+      }
+
+    std::cout << "\nRound trips\n";
+    for (std::size_t len : {7, 64, 1000})
+      {
+	const auto x = random_data<Tp>(len);
+	auto c1 = x, c2 = x, s1 = x, s2 = x, st = x;
+	emsr::fast_cosine_transform_1(c1);
+	emsr::fast_cosine_transform_1(c1);
+	emsr::fast_cosine_transform_2(c2);
+	emsr::fast_cosine_transform_3(c2);
+	emsr::fast_sine_transform_1(s1);
+	emsr::fast_sine_transform_1(s1);
+	emsr::fast_sine_transform_2(s2);
+	emsr::fast_sine_transform_3(s2);
+	st[0] = Tp{0};
+	emsr::fast_sine_transform(st);
+	emsr::inv_fast_sine_transform(st);
+	auto e = Tp{0};
+	for (std::size_t i = 0; i < len; ++i)
+	  {
+	    e = std::max(e, std::abs(c1[i] * Tp{2} / Tp(len - 1) - x[i]));
+	    e = std::max(e, std::abs(c2[i] * Tp{2} / Tp(len) - x[i]));
+	    e = std::max(e, std::abs(s1[i] * Tp{2} / Tp(len + 1) - x[i]));
+	    e = std::max(e, std::abs(s2[i] * Tp{2} / Tp(len) - x[i]));
+	    if (i > 0)
+	      e = std::max(e, std::abs(st[i] - x[i]));
+	  }
+	std::cout << ' ' << std::setw(6) << len
+		  << "  max round trip error " << std::setw(w) << e << '\n';
+      }
+
+    // Chebyshev coefficients against the unrolled QUADPACK sums.
+    auto f = [](Tp x) -> Tp { return std::exp(x) * std::sin(Tp{3} * x); };
+    const auto a = Tp{-0.5L}, b = Tp{2};
+    const auto cheb = emsr::qcheb_integrate(f, a, b);
+    const auto c12 = emsr::chebyshev_coefficients(f, a, b, 12);
+    const auto c24 = emsr::chebyshev_coefficients(f, a, b, 24);
+    auto d12 = Tp{0}, d24 = Tp{0};
+    for (std::size_t k = 0; k <= 12; ++k)
+      d12 = std::max(d12, std::abs(c12[k] - cheb.cheb12[k]));
+    for (std::size_t k = 0; k <= 24; ++k)
+      d24 = std::max(d24, std::abs(c24[k] - cheb.cheb24[k]));
+    std::cout << "\nChebyshev coefficients vs. qcheb_integrate\n"
+	      << "  cheb12 " << std::setw(w) << d12
+	      << "  cheb24 " << std::setw(w) << d24 << '\n';
+
+    // A high degree interpolant evaluated by Clenshaw's recurrence.
+    std::cout << "\nHigh degree Chebyshev interpolants\n";
+    auto g = [](Tp x) -> Tp { return std::cos(Tp{40} * x) / (Tp{1} + x * x); };
+    for (std::size_t n : {32, 64, 128, 256})
+      {
+	const auto c = emsr::chebyshev_coefficients(g, Tp{-1}, Tp{1}, n);
+	auto err = Tp{0};
+	for (int i = 0; i <= 100; ++i)
+	  {
+	    const auto t = Tp{-1} + Tp(i) / Tp{50};
+	    auto b1 = Tp{0}, b2 = Tp{0};
+	    for (std::size_t k = n; k > 0; --k)
+	      b2 = std::exchange(b1, Tp{2} * t * b1 - b2 + c[k]);
+	    const auto p = t * b1 - b2 + c[0];
+	    err = std::max(err, std::abs(p - g(t)));
+	  }
+	std::cout << ' ' << std::setw(4) << n
+		  << "  max error " << std::setw(w) << err << '\n';
+      }
+  }
+
+/**
+ * Time the fast DCT-II against the direct sum.
+ */
+template<typename Tp>
+  void
+  bench_cosine_transform()
+  {
+    std::cout << "\nDCT-II timing\n";
+    for (std::size_t len : {256, 1000, 4096, 1 << 16})
+      {
+	auto x = random_data<Tp>(len);
+	auto start = std::chrono::steady_clock::now();
+	emsr::fast_cosine_transform_2(x);
+	auto stop = std::chrono::steady_clock::now();
+	std::chrono::duration<double> dt_fast = stop - start;
+	std::cout << ' ' << std::setw(8) << len
+		  << "  fast " << std::setw(12) << dt_fast.count() << " s";
+	if (len <= 4096)
+	  {
+	    start = std::chrono::steady_clock::now();
+	    const auto y = direct_transform(x, 2);
+	    stop = std::chrono::steady_clock::now();
+	    std::chrono::duration<double> dt_direct = stop - start;
+	    std::cout << "  direct " << std::setw(12) << dt_direct.count() << " s";
+	  }
+	std::cout << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_cosine_transform<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_cosine_transform<long double>();
+
+  std::cout.precision(4);
+  std::cout << "\n\ndouble\n";
+  bench_cosine_transform<double>();
+}
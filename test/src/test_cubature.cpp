@@ -0,0 +1,207 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <iomanip>
+
+#include <emsr/cubature_integral.h>
+
+/**
+ * Return the largest error of the pair on the monomials
+ * @f$ x_i^p x_j^q @f$, p + q <= 7, over the cube [-1,1]^Dim.
+ */
+template<typename Tp, std::size_t Dim>
+  std::array<Tp, 2>
+  monomial_error()
+  {
+    // The mean of x^p over [-1,1].
+    auto mean = [](int p){ return p % 2 ? Tp{0} : Tp{1} / Tp(p + 1); };
+    const emsr::genz_malik_integral<Tp, Dim> rule;
+    emsr::hyper_rectangle<Tp, Dim> cube;
+    cube.center.fill(Tp{0});
+    cube.halfwidth.fill(Tp{1});
+    std::array<Tp, 2> err{};
+    for (int p = 0; p <= 7; ++p)
+      for (int q = 0; p + q <= 7; ++q)
+	{
+	  auto mono = [p, q](const std::array<Tp, Dim>& x) -> Tp
+		      { return std::pow(x[0], Tp(p)) * std::pow(x[Dim - 1], Tp(q)); };
+	  const auto exact = cube.volume() * mean(p) * mean(q);
+	  const auto res = rule(mono, cube);
+	  const auto e = std::abs(res.result - exact);
+	  // The embedded rule is exact to degree 5 so its difference
+	  // is the error estimate.
+	  err[0] = std::max(err[0], e);
+	  if (p + q <= 5)
+	    err[1] = std::max(err[1], res.abserr);
+	}
+    return err;
+  }
+
+/**
+ * Run the Genz test integrands over the unit cube in Dim dimensions.
+ */
+template<typename Tp, std::size_t Dim>
+  void
+  test_genz(Tp tol)
+  {
+    const auto w = 8 + std::cout.precision();
+    const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+
+    std::array<Tp, Dim> lower, upper, a, u;
+    lower.fill(Tp{0});
+    upper.fill(Tp{1});
+    for (std::size_t i = 0; i < Dim; ++i)
+      {
+	a[i] = Tp{1} + Tp(i % 3) / Tp{2};
+	u[i] = Tp{0.3L} + Tp{0.4L} * Tp(i) / Tp(Dim);
+      }
+
+    std::atomic<std::size_t> count{0};
+
+    // Oscillatory: cos(2 pi u_0 + sum a_i x_i).
+    auto osc = [&](const std::array<Tp, Dim>& x) -> Tp
+	       {
+		 ++count;
+		 auto arg = Tp{2} * s_pi * u[0];
+		 for (std::size_t i = 0; i < Dim; ++i)
+		   arg += a[i] * x[i];
+		 return std::cos(arg);
+	       };
+    std::complex<Tp> osc_exact = std::polar(Tp{1}, Tp{2} * s_pi * u[0]);
+    for (std::size_t i = 0; i < Dim; ++i)
+      osc_exact *= (std::polar(Tp{1}, a[i]) - Tp{1})
+		 / std::complex<Tp>(Tp{0}, a[i]);
+
+    // Product peak: prod 1 / (a_i^-2 + (x_i - u_i)^2).
+    auto peak = [&](const std::array<Tp, Dim>& x) -> Tp
+		{
+		  ++count;
+		  auto prod = Tp{1};
+		  for (std::size_t i = 0; i < Dim; ++i)
+		    prod /= Tp{1} / (a[i] * a[i]) + (x[i] - u[i]) * (x[i] - u[i]);
+		  return prod;
+		};
+    auto peak_exact = Tp{1};
+    for (std::size_t i = 0; i < Dim; ++i)
+      peak_exact *= a[i] * (std::atan(a[i] * (Tp{1} - u[i]))
+			   + std::atan(a[i] * u[i]));
+
+    // Gaussian: exp(-sum a_i^2 (x_i - u_i)^2).
+    auto gauss = [&](const std::array<Tp, Dim>& x) -> Tp
+		 {
+		   ++count;
+		   auto sum = Tp{0};
+		   for (std::size_t i = 0; i < Dim; ++i)
+		     sum += a[i] * a[i] * (x[i] - u[i]) * (x[i] - u[i]);
+		   return std::exp(-sum);
+		 };
+    auto gauss_exact = Tp{1};
+    for (std::size_t i = 0; i < Dim; ++i)
+      gauss_exact *= std::sqrt(s_pi) / (Tp{2} * a[i])
+		   * (std::erf(a[i] * (Tp{1} - u[i])) + std::erf(a[i] * u[i]));
+
+    auto report = [&](const char* name, auto func, Tp exact,
+		      unsigned int num_threads)
+      {
+	count = 0;
+	auto start = std::chrono::steady_clock::now();
+	try
+	  {
+	    const auto res = emsr::integrate_cubature(func, lower, upper,
+						Tp{0}, tol, 100000,
+						num_threads);
+	    std::chrono::duration<double> dt
+	      = std::chrono::steady_clock::now() - start;
+	    std::cout << "  " << Dim << "D " << std::setw(12) << std::left
+		      << name << std::right << " threads " << num_threads
+		      << "  result " << std::setw(w) << res.result
+		      << "  err " << std::setw(w) << res.abserr
+		      << "  actual " << std::setw(w) << res.result - exact
+		      << "  evals " << std::setw(8) << count
+		      << "  " << dt.count() << " s\n";
+	    return res.result;
+	  }
+	catch (const emsr::integration_error<Tp, Tp>& err)
+	  {
+	    std::cout << "  " << Dim << "D " << std::setw(12) << std::left
+		      << name << std::right << " threads " << num_threads
+		      << "  result " << std::setw(w) << err.result()
+		      << "  err " << std::setw(w) << err.abserr()
+		      << "  actual " << std::setw(w) << err.result() - exact
+		      << "  evals " << std::setw(8) << count
+		      << "  (" << err.what() << ")\n";
+	    return err.result();
+	  }
+      };
+
+    report("oscillatory", osc, osc_exact.real(), 1);
+    report("peak", peak, peak_exact, 1);
+    const auto r1 = report("gaussian", gauss, gauss_exact, 1);
+    const auto r4 = report("gaussian", gauss, gauss_exact, 4);
+    std::cout << "  " << Dim << "D 1 vs. 4 threads identical: "
+	      << std::boolalpha << (r1 == r4) << '\n';
+  }
+
+template<typename Tp>
+  void
+  test_cubature()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    std::cout << "\nDegree 7 exactness and degree 5 error estimate\n";
+    auto show = [w](std::size_t dim, std::size_t size, std::array<Tp, 2> err)
+      {
+	std::cout << "  " << dim << "D  points " << std::setw(4) << size
+		  << "  degree 7 err " << std::setw(w) << err[0]
+		  << "  degree 5 estimate " << std::setw(w) << err[1] << '\n';
+      };
+    show(2, emsr::genz_malik_integral<Tp, 2>::size(), monomial_error<Tp, 2>());
+    show(3, emsr::genz_malik_integral<Tp, 3>::size(), monomial_error<Tp, 3>());
+    show(5, emsr::genz_malik_integral<Tp, 5>::size(), monomial_error<Tp, 5>());
+    show(8, emsr::genz_malik_integral<Tp, 8>::size(), monomial_error<Tp, 8>());
+
+    std::cout << "\nGenz test integrands over the unit cube\n";
+    test_genz<Tp, 2>(Tp{1.0e-10L});
+    test_genz<Tp, 3>(Tp{1.0e-8L});
+    test_genz<Tp, 5>(Tp{1.0e-6L});
+    test_genz<Tp, 8>(Tp{1.0e-3L});
+
+    // Nested one-dimensional integration for comparison.
+    std::cout << "\nNested QAG vs. cubature in 3D\n";
+    std::size_t count = 0;
+    auto f3 = [&count](Tp x, Tp y, Tp z) -> Tp
+	      { ++count; return std::exp(-(x * x + Tp{2} * y * y + Tp{3} * z * z)); };
+    const auto tol = Tp{1.0e-8L};
+    const auto nested
+      = emsr::integrate([&](Tp x)
+	  {
+	    return emsr::integrate([&](Tp y)
+	      {
+		return emsr::integrate([&](Tp z){ return f3(x, y, z); },
+				       Tp{0}, Tp{1}, Tp{0}, tol / Tp{100}).result;
+	      }, Tp{0}, Tp{1}, Tp{0}, tol / Tp{10}).result;
+	  }, Tp{0}, Tp{1}, Tp{0}, tol).result;
+    std::cout << "  nested    " << std::setw(w) << nested
+	      << "  evals " << count << '\n';
+    count = 0;
+    const auto cub = emsr::integrate_cubature(
+			[&](const std::array<Tp, 3>& x)
+			{ return f3(x[0], x[1], x[2]); },
+			std::array<Tp, 3>{0, 0, 0}, std::array<Tp, 3>{1, 1, 1},
+			Tp{0}, tol);
+    std::cout << "  cubature  " << std::setw(w) << cub.result
+	      << "  evals " << count << '\n';
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_cubature<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_cubature<long double>();
+}
@@ -0,0 +1,74 @@
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <numbers>
+
+#include <emsr/integration.h>
+
+/**
+ * Integrate with a tolerance and with no tolerance at all.
+ * The second runs every level so a converging integrand
+ * must use fewer evaluations with the tolerance.
+ */
+template<typename Integ>
+  bool
+  test_early_exit(const char* name, Integ integ, double exact)
+  {
+    const auto rel_err = 1.0e-10;
+    const int max_iter = 8;
+
+    int num_evals = 0;
+    const auto tol = integ(num_evals, rel_err, max_iter);
+    int max_evals = 0;
+    const auto all = integ(max_evals, 0.0, max_iter);
+
+    const bool early = num_evals < max_evals;
+    const bool accurate = std::abs(tol.result - exact)
+			<= 100 * rel_err * std::abs(exact);
+    std::cout << std::setw(10) << name
+	      << "  result: " << std::setprecision(15) << std::setw(20)
+	      << tol.result
+	      << "  error: " << std::setprecision(3) << std::setw(10)
+	      << std::abs(tol.result - exact)
+	      << "  evals: " << std::setw(5) << num_evals
+	      << "  max level evals: " << std::setw(5) << max_evals
+	      << "  early exit: " << std::boolalpha << early
+	      << "  " << (early && accurate && all.result == all.result
+			  ? "PASS" : "FAIL") << '\n';
+    return early && accurate;
+  }
+
+int
+main()
+{
+  constexpr auto pi = std::numbers::pi;
+  int num_fail = 0;
+
+  auto tanh_sinh = [](int& count, double rel_err, int max_iter)
+  {
+    auto func = [&count](double x) { ++count; return std::exp(x); };
+    return emsr::integrate_tanh_sinh(func, 0.0, 1.0,
+				     0.0, rel_err, max_iter);
+  };
+  if (!test_early_exit("tanh-sinh", tanh_sinh, std::exp(1.0) - 1.0))
+    ++num_fail;
+
+  auto sinh_sinh = [](int& count, double rel_err, int max_iter)
+  {
+    auto func = [&count](double x) { ++count; return 1.0 / (1.0 + x * x); };
+    return emsr::integrate_sinh_sinh(func, 0.0, rel_err, max_iter);
+  };
+  if (!test_early_exit("sinh-sinh", sinh_sinh, pi))
+    ++num_fail;
+
+  auto exp_sinh = [](int& count, double rel_err, int max_iter)
+  {
+    auto func = [&count](double x) { ++count; return std::exp(-x); };
+    return emsr::integrate_exp_sinh(func, 0.0, 0.0, rel_err, max_iter);
+  };
+  if (!test_early_exit("exp-sinh", exp_sinh, 1.0))
+    ++num_fail;
+
+  return num_fail;
+}
@@ -1,4 +1,6 @@
 
+#include <float128_support.h> // Must precede <complex> and <random>.
+
 #include <iostream>
 #include <iomanip>
 #include <random>
@@ -29,7 +31,7 @@ template<typename Tp>
     auto diff = xform[0] - Cmplx(len * (len - 1) / Tp{2});
     auto abs_diff = std::abs(diff);
     mean_abs_diff += abs_diff;
-    emsr::__phase_iterator omega_k(Tp{-1}, 1, len);
+    emsr::phase_iterator omega_k(Tp{-1}, 1, len);
     ++omega_k;
     for (auto k = 1u; k < len; ++k, ++omega_k)
       {
@@ -118,9 +120,13 @@ template<typename Tp>
     std::cout << '\n';
     for (auto i = 0u; i < len; ++i)
       {
-	auto xf = i < len / 2
-		? std::complex(xform[2 * i], xform[2 * i + 1])
-		: std::complex(xform[2 * len - 2 * i - 2], -xform[2 * len - 2 * i - 1]);
+	auto xf = i == 0
+		? std::complex<Tp>(xform[0])
+		: 2 * i == len
+		? std::complex<Tp>(xform[len - 1])
+		: 2 * i < len
+		? std::complex(xform[2 * i - 1], xform[2 * i])
+		: std::complex(xform[2 * (len - i) - 1], -xform[2 * (len - i)]);
 	auto diff = vec[i] - iform[i];
 	auto abs_diff = std::abs(diff);
 	mean_abs_diff += abs_diff;
@@ -151,6 +157,8 @@ template<typename Tp>
     vec.reserve(len);
     for (auto i = 0u; i < len; ++i)
       vec.push_back(gen());
+    // The sine transform ignores the first value.
+    vec[0] = Tp{0};
 
     auto xform = vec;
     emsr::fast_sine_transform(xform);
@@ -189,7 +197,9 @@ main()
 
   test_fft<long double>();
 
+#ifdef EMSR_HAVE_FLOAT128
   test_fft<__float128>();
+#endif
 
   test_real_fft<double>();
 
@@ -0,0 +1,312 @@
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <emsr/fourier_transform.h>
+
+/**
+ * The forward transform by direct summation in long double.
+ */
+template<typename Tp>
+  std::vector<std::complex<Tp>>
+  direct_transform(const std::vector<std::complex<Tp>>& z)
+  {
+    using Cmplx = std::complex<long double>;
+    const auto s_2pi = 2 * 3.1415'92653'58979'32384'62643'38327'95028'84195e+0L;
+    const auto len = z.size();
+    std::vector<std::complex<Tp>> result(len);
+    for (std::size_t j = 0; j < len; ++j)
+      {
+	Cmplx sum{};
+	for (std::size_t k = 0; k < len; ++k)
+	  sum += Cmplx(z[k])
+	       * std::polar(1.0L, -s_2pi * ((j * k) % len) / len);
+	result[j] = std::complex<Tp>(sum / static_cast<long double>(len));
+      }
+    return result;
+  }
+
+template<typename Tp>
+  std::vector<std::complex<Tp>>
+  random_data(std::size_t len)
+  {
+    std::default_random_engine re;
+    std::uniform_real_distribution<Tp> ud(Tp{-1}, Tp{+1});
+    std::vector<std::complex<Tp>> z;
+    z.reserve(len);
+    for (std::size_t i = 0; i < len; ++i)
+      z.emplace_back(ud(re), ud(re));
+    return z;
+  }
+
+template<typename Tp>
+  Tp
+  max_diff(const std::vector<std::complex<Tp>>& a,
+	   const std::vector<std::complex<Tp>>& b)
+  {
+    auto d = Tp{0};
+    for (std::size_t i = 0; i < a.size(); ++i)
+      d = std::max(d, std::abs(a[i] - b[i]));
+    return d;
+  }
+
+template<typename Tp>
+  void
+  test_fft_plan()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    std::cout << "\nPlan vs. direct summation and round trip\n";
+    for (std::size_t len = 1; len <= 2048; len *= 2)
+      {
+	const auto z = random_data<Tp>(len);
+	emsr::fft_plan<Tp> plan(len);
+
+	auto xform = z;
+	plan.forward(xform);
+	auto iform = xform;
+	plan.inverse(iform);
+
+	auto rform = z;
+	emsr::detail::recursive_fast_fourier_transform(rform);
+
+	std::cout << ' ' << std::setw(6) << len
+		  << "  direct " << std::setw(w) << max_diff(xform, direct_transform(z))
+		  << "  recursive " << std::setw(w) << max_diff(xform, rform)
+		  << "  round trip " << std::setw(w) << max_diff(iform, z)
+		  << '\n';
+      }
+
+    std::cout << "\nfourier_transform_t\n";
+    {
+      const std::size_t len = 256;
+      const auto z = random_data<Tp>(len);
+      emsr::fft_plan<Tp> plan(len);
+      emsr::fourier_transform_t<std::complex<Tp>> cxform(z, plan);
+      const auto exact = direct_transform(z);
+      auto d = Tp{0};
+      for (std::size_t k = 0; k < cxform.size(); ++k)
+	d = std::max(d, std::abs(cxform[k] - exact[k]));
+      std::cout << "  complex data " << std::setw(w) << d << '\n';
+
+      std::vector<Tp> x(len);
+      std::vector<std::complex<Tp>> zx(len);
+      for (std::size_t i = 0; i < len; ++i)
+	zx[i] = x[i] = z[i].real();
+      emsr::fourier_transform_t<Tp> rxform(x, plan);
+      const auto rexact = direct_transform(zx);
+      d = Tp{0};
+      for (std::size_t k = 0; k < rxform.size(); ++k)
+	d = std::max(d, std::abs(rxform[k] - rexact[k]));
+      std::cout << "  real data    " << std::setw(w) << d << '\n';
+    }
+  }
+
+/**
+ * Mixed-radix and Bluestein lengths.
+ */
+template<typename Tp>
+  void
+  test_fft_any_length()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    std::cout << "\nMixed-radix and Bluestein vs. direct summation\n";
+    for (std::size_t len : {3, 5, 6, 7, 9, 10, 12, 14, 15, 21, 25, 35, 49, 60,
+			    97, 100, 210, 343, 1000, 1155, 1009, 2018, 2047})
+      {
+	const auto z = random_data<Tp>(len);
+	emsr::fft_plan<Tp> plan(len);
+
+	auto xform = z;
+	plan.forward(xform);
+	auto iform = xform;
+	plan.inverse(iform);
+
+	std::cout << ' ' << std::setw(6) << len
+		  << "  direct " << std::setw(w) << max_diff(xform, direct_transform(z))
+		  << "  round trip " << std::setw(w) << max_diff(iform, z)
+		  << "  ";
+	if (plan.is_bluestein())
+	  std::cout << "Bluestein";
+	else
+	  for (auto r : plan.radices())
+	    std::cout << ' ' << r;
+	std::cout << '\n';
+      }
+
+    // A cached Bluestein plan shared by several threads.
+    const auto plan = emsr::cached_fft_plan<Tp>(1009);
+    const auto z = random_data<Tp>(1009);
+    auto serial = z;
+    plan->forward(serial);
+    std::vector<std::vector<std::complex<Tp>>> result(4);
+    std::vector<std::thread> pool;
+    for (auto& res : result)
+      pool.emplace_back([&plan, &z, &res]()
+	{
+	  for (int rep = 0; rep < 20; ++rep)
+	    {
+	      res = z;
+	      plan->forward(res);
+	    }
+	});
+    for (auto& th : pool)
+      th.join();
+    bool agree = plan == emsr::cached_fft_plan<Tp>(1009);
+    for (const auto& res : result)
+      agree = agree && res == serial;
+    std::cout << "\nCached plan shared by threads agrees: "
+	      << std::boolalpha << agree << '\n';
+
+    std::cout << "\nReal data vs. direct summation\n";
+    for (std::size_t len : {1, 2, 3, 4, 5, 8, 11, 16, 17, 30, 31, 100, 101, 1000})
+      {
+	const auto z = random_data<Tp>(len);
+	std::vector<Tp> x(len);
+	std::vector<std::complex<Tp>> zx(len);
+	for (std::size_t i = 0; i < len; ++i)
+	  zx[i] = x[i] = z[i].real();
+	const auto exact = direct_transform(zx);
+
+	auto xform = x;
+	emsr::fast_fourier_transform(xform);
+	auto d = std::abs(xform[0] - exact[0].real());
+	for (std::size_t k = 1; 2 * k < len; ++k)
+	  d = std::max(d, std::abs(std::complex<Tp>(xform[2 * k - 1], xform[2 * k])
+				   - exact[k]));
+	if (len % 2 == 0)
+	  d = std::max(d, std::abs(xform[len - 1] - exact[len / 2].real()));
+
+	auto iform = xform;
+	emsr::inv_fast_fourier_transform(iform);
+	auto e = Tp{0};
+	for (std::size_t i = 0; i < len; ++i)
+	  e = std::max(e, std::abs(iform[i] - x[i]));
+
+	std::cout << ' ' << std::setw(6) << len
+		  << "  direct " << std::setw(w) << d
+		  << "  round trip " << std::setw(w) << e << '\n';
+      }
+  }
+
+/**
+ * Time the plan against the recursion at lengths of 2 * prime
+ * where the recursion falls back to the quadratic transform.
+ */
+template<typename Tp>
+  void
+  bench_fft_any_length()
+  {
+    std::cout << "\nPlan vs. recursion timing at 2 * prime (seconds per transform)\n";
+    for (std::size_t len : {2 * 251, 2 * 1021, 2 * 4099})
+      {
+	const auto z = random_data<Tp>(len);
+	emsr::fft_plan<Tp> plan(len);
+
+	auto work = z;
+	auto start = std::chrono::steady_clock::now();
+	emsr::detail::recursive_fast_fourier_transform(work);
+	auto stop = std::chrono::steady_clock::now();
+	std::chrono::duration<double> t_rec = stop - start;
+
+	const int reps = 100;
+	start = std::chrono::steady_clock::now();
+	for (int r = 0; r < reps; ++r)
+	  {
+	    work = z;
+	    plan.forward(work);
+	  }
+	stop = std::chrono::steady_clock::now();
+	std::chrono::duration<double> t_plan = stop - start;
+
+	std::cout << ' ' << std::setw(8) << len
+		  << "  recursive " << std::setw(12) << t_rec.count()
+		  << "  plan " << std::setw(12) << t_plan.count() / reps << '\n';
+      }
+  }
+
+/**
+ * Time the plan against the recursive transform.
+ */
+template<typename Tp>
+  void
+  bench_fft_plan()
+  {
+    std::cout << "\nPlan vs. recursion timing (seconds per transform)\n";
+    std::cout << ' ' << std::setw(8) << "len"
+	      << ' ' << std::setw(12) << "recursive"
+	      << ' ' << std::setw(12) << "plan"
+	      << ' ' << std::setw(12) << "cached"
+	      << ' ' << std::setw(8) << "speedup" << '\n';
+    for (std::size_t len = 1024; len <= (std::size_t{1} << 20); len *= 4)
+      {
+	const auto z = random_data<Tp>(len);
+	const int reps = int(std::max(std::size_t{2}, (std::size_t{1} << 22) / len));
+
+	auto time = [reps](auto transform)
+	  {
+	    auto start = std::chrono::steady_clock::now();
+	    for (int r = 0; r < reps; ++r)
+	      transform();
+	    auto stop = std::chrono::steady_clock::now();
+	    std::chrono::duration<double> dt = stop - start;
+	    return dt.count() / reps;
+	  };
+
+	auto work = z;
+	const auto t_rec = time([&]
+	  {
+	    work = z;
+	    emsr::detail::recursive_fast_fourier_transform(work);
+	  });
+
+	emsr::fft_plan<Tp> plan(len);
+	const auto t_plan = time([&]
+	  {
+	    work = z;
+	    plan.forward(work);
+	  });
+
+	const auto t_cached = time([&]
+	  {
+	    work = z;
+	    emsr::fast_fourier_transform(work);
+	  });
+
+	std::cout << ' ' << std::setw(8) << len
+		  << ' ' << std::setw(12) << t_rec
+		  << ' ' << std::setw(12) << t_plan
+		  << ' ' << std::setw(12) << t_cached
+		  << ' ' << std::setw(8) << t_rec / t_plan << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\nfloat\n";
+  test_fft_plan<float>();
+  test_fft_any_length<float>();
+
+  std::cout << "\n\ndouble\n";
+  test_fft_plan<double>();
+  test_fft_any_length<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_fft_plan<long double>();
+  test_fft_any_length<long double>();
+
+  std::cout.precision(4);
+  std::cout << "\n\ndouble\n";
+  bench_fft_plan<double>();
+  bench_fft_any_length<double>();
+}
@@ -5,6 +5,8 @@
 #include <cstdlib>
 #include <cmath>
 #include <vector>
+#include <chrono>
+#include <algorithm>
 
 #include <emsr/jacobi.h>
 
@@ -27,6 +29,84 @@ template<typename Tp>
     std::cout << "Error: " << integr - exact << '\n';
   }
 
+/**
+ * Differentiate and interpolate a block of fields cos(k x), k = 1, 2, ...
+ * on Gauss-Lobatto points and compare with the single field operators.
+ */
+template<typename Tp>
+  void
+  test_field_block(int Q, int nfields)
+  {
+    jac_quadrature<Tp> quad(Gauss_Lobatto, Q, Tp{0}, Tp{0});
+    const auto& x = quad.nodes();
+
+    const int np = 7;
+    std::vector<Tp> xp(np);
+    for (int i = 0; i < np; ++i)
+      xp[i] = Tp{-1} + Tp{2} * Tp(i) / Tp(np - 1);
+    quad.interpmat_alloc(np, xp.data());
+
+    // Fields stored point by point.
+    const auto freq = [](int k) { return Tp(1 + k % 3); };
+    std::vector<Tp> f(Q * nfields), d(Q * nfields), fi(np * nfields);
+    for (int j = 0; j < Q; ++j)
+      for (int k = 0; k < nfields; ++k)
+	f[j * nfields + k] = std::cos(freq(k) * x[j]);
+
+    quad.differentiate(nfields, f.data(), nfields, d.data(), nfields);
+    quad.interpolate(nfields, f.data(), nfields, fi.data(), nfields);
+
+    Tp derr = 0, ierr = 0, berr = 0;
+    std::vector<Tp> f1(Q), d1(Q), i1(np);
+    for (int k = 0; k < nfields; ++k)
+      {
+	for (int j = 0; j < Q; ++j)
+	  f1[j] = f[j * nfields + k];
+	quad.differentiate(f1.data(), d1.data());
+	quad.interpolate(f1.data(), i1.data());
+	for (int j = 0; j < Q; ++j)
+	  {
+	    const auto exact = -freq(k) * std::sin(freq(k) * x[j]);
+	    derr = std::max(derr, std::abs(d[j * nfields + k] - exact));
+	    berr = std::max(berr, std::abs(d[j * nfields + k] - d1[j]));
+	  }
+	for (int i = 0; i < np; ++i)
+	  {
+	    ierr = std::max(ierr, std::abs(fi[i * nfields + k]
+					   - std::cos(freq(k) * xp[i])));
+	    berr = std::max(berr, std::abs(fi[i * nfields + k] - i1[i]));
+	  }
+      }
+    std::cout << "\nBlock of " << nfields << " fields on " << Q
+	      << " Gauss-Lobatto points\n";
+    std::cout << "  max derivative error:      " << derr << '\n';
+    std::cout << "  max interpolation error:   " << ierr << '\n';
+    std::cout << "  max block vs. single diff: " << berr << '\n';
+
+    // Timing of the block operator against one field at a time.
+    const int reps = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r)
+      quad.differentiate(nfields, f.data(), nfields, d.data(), nfields);
+    auto stop = std::chrono::steady_clock::now();
+    const auto t_block = std::chrono::duration<double>(stop - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r)
+      for (int k = 0; k < nfields; ++k)
+	{
+	  for (int j = 0; j < Q; ++j)
+	    f1[j] = f[j * nfields + k];
+	  quad.differentiate(f1.data(), d1.data());
+	  for (int j = 0; j < Q; ++j)
+	    d[j * nfields + k] = d1[j];
+	}
+    stop = std::chrono::steady_clock::now();
+    const auto t_single = std::chrono::duration<double>(stop - start).count();
+    std::cout << "  block: " << t_block / reps << " s  one at a time: "
+	      << t_single / reps << " s\n";
+  }
+
 
 int 
 main(int n_app_args, char **app_arg)
@@ -50,7 +130,7 @@ main(int n_app_args, char **app_arg)
 	}
       if (n_app_args == 3)
 	beta = alpha = strtod(app_arg[2], nullptr);
-      else
+      else if (n_app_args > 3)
 	{
 	  alpha = strtod(app_arg[2], nullptr);
 	  beta = strtod(app_arg[3], nullptr);
@@ -59,5 +139,7 @@ main(int n_app_args, char **app_arg)
 
   test_gauss_jacobi(Q, alpha, beta);
 
+  test_field_block<double>(std::max(Q, 2), 4000);
+
   return 0;
 }
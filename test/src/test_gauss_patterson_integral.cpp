@@ -0,0 +1,115 @@
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include <emsr/integration.h>
+
+template<typename Tp>
+  void
+  test_gauss_patterson_rule()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    auto rule = emsr::gauss_patterson_rules<Tp>(emsr::gauss_patterson_integral<Tp>::s_max_level);
+
+    // The 3-point rule is the 3-point Gauss rule.
+    std::cout << "\n3-point rule vs. Gauss-Legendre\n";
+    std::cout << "  node   " << std::setw(w)
+	      << rule->point[1] - std::sqrt(Tp{3} / Tp{5}) << '\n';
+    std::cout << "  weight " << std::setw(w)
+	      << rule->weight[1][1] - Tp{5} / Tp{9} << '\n';
+
+    std::cout << "\nExactness of the Gauss-Patterson rules\n";
+    for (int level = 0; level <= rule->max_level(); ++level)
+      {
+	const auto num = rule->num_abscissae(level);
+	const int degree = level == 0 ? 1 : 3 * (1 << level) - 1;
+	auto err = Tp{0};
+	for (int d = 0; d <= degree; d += 2)
+	  {
+	    auto sum = d == 0 ? rule->weight[level][0] : Tp{0};
+	    for (std::size_t i = 1; i < num; ++i)
+	      sum += Tp{2} * rule->weight[level][i]
+		   * std::pow(rule->point[i], Tp(d));
+	    err = std::max(err, std::abs(sum - Tp{2} / Tp(d + 1)));
+	  }
+	std::cout << ' ' << std::setw(4) << rule->num_points(level)
+		  << " points  degree " << std::setw(4) << degree
+		  << "  max monomial error " << std::setw(w) << err << '\n';
+      }
+
+    // An expensive smooth integrand.
+    int count = 0;
+    auto f = [&count](Tp x) -> Tp
+	     {
+	       ++count;
+	       return std::exp(-x * x / Tp{4}) * (Tp{2} + std::cos(Tp{3} * x));
+	     };
+    const auto a = Tp{-3}, b = Tp{3};
+
+    auto report = [&count, w](const char* name, auto integ)
+      {
+	count = 0;
+	try
+	  {
+	    const auto res = integ();
+	    std::cout << "   " << std::setw(12) << std::left << name << std::right
+		      << std::setw(w) << res.result
+		      << "  err " << std::setw(w) << res.abserr
+		      << "  evals " << count << '\n';
+	  }
+	catch (const emsr::integration_error<Tp, Tp>& err)
+	  {
+	    std::cout << "   " << std::setw(12) << std::left << name << std::right
+		      << std::setw(w) << err.result()
+		      << "  err " << std::setw(w) << err.abserr()
+		      << "  evals " << count << "  (" << err.what() << ")\n";
+	  }
+      };
+
+    std::cout << "\nNested Patterson vs. QAG\n";
+    for (Tp tol : {Tp{1.0e-6L}, Tp{1.0e-9L}, Tp{1.0e-12L}})
+      {
+	std::cout << " tol = " << tol << '\n';
+	report("patterson",
+	       [&]{ return emsr::integrate_patterson(f, a, b, Tp{0}, tol); });
+	report("qag+GP",
+	       [&]
+	       {
+		 emsr::integration_workspace<Tp, Tp> ws(100);
+		 return emsr::qag_integrate(ws, f, a, b, Tp{0}, tol,
+					    emsr::gauss_patterson_integral<Tp>());
+	       });
+	report("qag",
+	       [&]{ return emsr::integrate(f, a, b, Tp{0}, tol); });
+      }
+
+    // As a local rule the climb stops at max_local_level
+    // even where the integrand never settles.
+    std::cout << "\nLocal rule on a kink\n";
+    auto g = [&count](Tp x) -> Tp { ++count; return std::abs(x - Tp{0.3L}); };
+    for (int local : {6, 8})
+      {
+	const emsr::gauss_patterson_integral<Tp> gp(8, 2, local);
+	count = 0;
+	const auto res = gp(g, Tp{-1}, Tp{1});
+	std::cout << "  max_local_level " << gp.max_local_level()
+		  << "  error " << std::setw(w) << res.result - Tp{1.09L}
+		  << "  evals " << count << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_gauss_patterson_rule<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_gauss_patterson_rule<long double>();
+}
@@ -0,0 +1,116 @@
+
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <emsr/integration.h>
+
+template<typename Tp>
+  void
+  print_stats(const char* what)
+  {
+    const auto st = emsr::gauss_rule_registry<Tp>::instance().stats();
+    std::cout << std::setw(24) << what
+	      << "  hits = " << std::setw(6) << st.hits
+	      << "  misses = " << std::setw(4) << st.misses
+	      << "  evictions = " << std::setw(4) << st.evictions
+	      << "  size = " << std::setw(3) << st.size
+	      << "  capacity = " << st.capacity << '\n';
+  }
+
+template<typename Tp>
+  void
+  test_gauss_rule_registry()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    auto& reg = emsr::gauss_rule_registry<Tp>::instance();
+    reg.clear();
+
+    auto f = [](Tp x) -> Tp { return std::cos(x); };
+    const auto exact = std::sin(Tp{1}) - std::sin(Tp{-1});
+
+    // Repeated calls reuse one rule.
+    const int n = 200;
+    auto start = std::chrono::steady_clock::now();
+    auto first = emsr::integrate_fixed_gauss_legendre(n, f, Tp{-1}, Tp{1});
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; ++i)
+      emsr::integrate_fixed_gauss_legendre(n, f, Tp{-1}, Tp{1});
+    auto stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double> cold = mid - start;
+    std::chrono::duration<double> warm = stop - mid;
+    std::cout << "legendre(" << n << ") error = "
+	      << std::abs(first.result - exact) << '\n';
+    std::cout << "cold call = " << cold.count() << " s"
+	      << "  warm call = " << warm.count() / 1000 << " s\n";
+    print_stats<Tp>("after legendre");
+
+    // Family parameters are part of the key.
+    emsr::integrate_fixed_gauss_jacobi(n, Tp{0.5L}, Tp{1.5L}, f, Tp{-1}, Tp{1});
+    emsr::integrate_fixed_gauss_jacobi(n, Tp{0.5L}, Tp{2.5L}, f, Tp{-1}, Tp{1});
+    emsr::integrate_fixed_gauss_jacobi(n, Tp{0.5L}, Tp{1.5L}, f, Tp{-1}, Tp{1});
+    print_stats<Tp>("after jacobi");
+
+    // Concurrent lookups agree with the serial answer.
+    std::vector<std::thread> pool;
+    std::vector<Tp> result(8);
+    for (int t = 0; t < 8; ++t)
+      pool.emplace_back([&result, f, t]()
+	{
+	  result[t] = emsr::integrate_fixed_gauss_gegenbauer(64 + t % 2,
+						Tp{0.25L}, f, Tp{-1}, Tp{1}).result;
+	});
+    for (auto& th : pool)
+      th.join();
+    bool agree = true;
+    for (int t = 2; t < 8; ++t)
+      agree = agree && result[t] == result[t % 2];
+    std::cout << "threads agree: " << std::boolalpha << agree << '\n';
+    print_stats<Tp>("after threads");
+
+    // Shrinking the capacity evicts least recently used rules.
+    reg.set_capacity(2);
+    print_stats<Tp>("after set_capacity(2)");
+    for (int m = 2; m < 10; ++m)
+      emsr::integrate_fixed_gauss_legendre(m, f, Tp{-1}, Tp{1});
+    print_stats<Tp>("after sweep");
+    reg.set_capacity(emsr::gauss_rule_registry<Tp>::s_default_capacity);
+
+    // The rule type is part of the key.
+    const typename emsr::gauss_rule_registry<Tp>::key_type
+      key{emsr::Gauss_Legendre, 3};
+    auto vec = reg.template get<std::vector<Tp>>(key,
+			[]{ return std::vector<Tp>{Tp{1}, Tp{2}}; });
+    auto num = reg.template get<int>(key, []{ return 42; });
+    std::cout << "rule types kept apart: " << std::boolalpha
+	      << (vec->size() == 2 && *num == 42) << '\n';
+
+    // NaN parameters are rejected.
+    try
+      {
+	const auto nan = std::numeric_limits<Tp>::quiet_NaN();
+	reg.template get<int>({emsr::Gauss_Jacobi, 3, nan, Tp{0.5L}},
+			      []{ return 0; });
+	std::cout << "NaN parameter rejected: false\n";
+      }
+    catch (const std::domain_error&)
+      {
+	std::cout << "NaN parameter rejected: true\n";
+      }
+    print_stats<Tp>("after NaN");
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_gauss_rule_registry<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_gauss_rule_registry<long double>();
+}
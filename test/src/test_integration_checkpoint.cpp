@@ -0,0 +1,162 @@
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include <emsr/integration.h>
+
+/// Thrown by the integrand to simulate a killed run.
+struct interrupted
+{ };
+
+/**
+ * Interrupt a run after @c stop_after evaluations, restore the last
+ * checkpoint into fresh objects and finish the run.
+ * Compare with an uninterrupted run.
+ */
+template<typename Tp, typename Workspace, typename State, typename Run>
+  void
+  interrupt_and_resume(const char* name, std::size_t capacity,
+		       std::size_t stop_after, Run run)
+  {
+    const auto w = 8 + std::cout.precision();
+
+    // The uninterrupted run.
+    Workspace ws0(capacity);
+    State st0;
+    const auto full = run(ws0, st0, std::size_t(-1),
+			  [](const Workspace&, const State&){});
+
+    // The interrupted run saves a snapshot at each checkpoint.
+    std::string snapshot;
+    std::size_t num_checkpoints = 0;
+    auto save = [&snapshot, &num_checkpoints](const Workspace& ws,
+					      const State& st)
+		{
+		  std::ostringstream out;
+		  ws.save(out);
+		  st.save(out);
+		  snapshot = out.str();
+		  ++num_checkpoints;
+		};
+    Workspace ws1(capacity);
+    State st1;
+    std::size_t paid = 0;
+    try
+      {
+	run(ws1, st1, stop_after, save);
+	std::cout << "  " << name << ": not interrupted after "
+		  << full.num_evals << " evaluations\n";
+	return;
+      }
+    catch (const interrupted&)
+      {
+	paid = stop_after;
+      }
+
+    // Resume into fresh objects from the last snapshot.
+    Workspace ws2(1);
+    State st2;
+    std::istringstream in(snapshot);
+    ws2.restore(in);
+    st2.restore(in);
+    const auto saved_evals = st2.num_evals;
+    const auto resumed = run(ws2, st2, std::size_t(-1),
+			     [](const Workspace&, const State&){});
+
+    std::cout << "  " << name << '\n'
+	      << "    uninterrupted  result " << std::setw(w) << full.result
+	      << "  err " << std::setw(w) << full.abserr
+	      << "  evals " << full.num_evals << '\n'
+	      << "    resumed        result " << std::setw(w) << resumed.result
+	      << "  err " << std::setw(w) << resumed.abserr
+	      << "  evals " << resumed.num_evals << '\n'
+	      << "    identical: " << std::boolalpha
+	      << (full.result == resumed.result
+		  && full.abserr == resumed.abserr
+		  && full.error_code == resumed.error_code
+		  && full.num_evals == resumed.num_evals)
+	      << "  checkpoints " << num_checkpoints
+	      << "  snapshot bytes " << snapshot.size()
+	      << "  evals paid " << paid
+	      << "  lost " << paid - saved_evals << '\n';
+  }
+
+template<typename Tp>
+  void
+  test_integration_checkpoint()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+
+    using qags_ws_t = emsr::integration_workspace<Tp, Tp>;
+    using qags_st_t = emsr::qags_state<Tp, Tp>;
+    using cquad_ws_t = emsr::cquad_workspace<Tp, Tp>;
+    using cquad_st_t = emsr::cquad_state<Tp, Tp>;
+
+    const auto tol = Tp{1.0e-12L};
+
+    std::cout << "\nInterrupted and resumed integrations\n";
+
+    // A log singularity and an oscillation: extrapolation is used.
+    auto qags_run = [tol](qags_ws_t& ws, qags_st_t& st, std::size_t stop,
+			  auto checkpoint)
+      {
+	std::size_t count = 0;
+	auto func = [&count, stop](Tp x)
+		    {
+		      if (count++ == stop)
+			throw interrupted{};
+		      return std::log(x) * std::cos(Tp{20} * x);
+		    };
+	return emsr::qags_integrate(std::nothrow, ws, func, Tp{0}, Tp{1},
+				    Tp{0}, tol,
+				    emsr::gauss_kronrod_integral<Tp>(emsr::Kronrod_21),
+				    st, checkpoint);
+      };
+    interrupt_and_resume<Tp, qags_ws_t, qags_st_t>("qags log(x)cos(20x)",
+						   1000, 300, qags_run);
+
+    auto cquad_run = [tol](cquad_ws_t& ws, cquad_st_t& st, std::size_t stop,
+			   auto checkpoint)
+      {
+	std::size_t count = 0;
+	auto func = [&count, stop](Tp x)
+		    {
+		      if (count++ == stop)
+			throw interrupted{};
+		      return Tp{1} / std::sqrt(x) + std::sin(Tp{30} * x);
+		    };
+	return emsr::cquad_integrate(std::nothrow, ws, func, Tp{0}, Tp{1},
+				     Tp{0}, tol, st, checkpoint);
+      };
+    interrupt_and_resume<Tp, cquad_ws_t, cquad_st_t>("cquad 1/sqrt(x)+sin(30x)",
+						     200, 600, cquad_run);
+
+    // A snapshot of one kind cannot be restored into another.
+    std::ostringstream out;
+    qags_ws_t ws(10);
+    ws.append(Tp{0}, Tp{1}, Tp{1}, Tp{0});
+    ws.save(out);
+    try
+      {
+	std::istringstream in(out.str());
+	cquad_ws_t cws;
+	cws.restore(in);
+	std::cout << "\nWrong kind: no exception\n";
+      }
+    catch (const std::runtime_error& err)
+      {
+	std::cout << "\nWrong kind: " << err.what() << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_integration_checkpoint<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_integration_checkpoint<long double>();
+}
@@ -0,0 +1,246 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <numbers>
+#include <vector>
+
+#include <emsr/integration.h>
+#include <emsr/triangle_integral.h>
+#include <emsr/cubature_integral.h>
+#include <emsr/sparse_grid_integral.h>
+#include <emsr/qmc_integral.h>
+#include <emsr/singularity_probe.h>
+
+template<typename Status>
+  void
+  show(const char* name, const Status& st)
+  {
+    const auto w = 8 + std::cout.precision();
+    std::cout << "  " << std::setw(16) << std::left << name << std::right
+	      << "  result " << std::setw(w) << st.result
+	      << "  err " << std::setw(w) << st.abserr
+	      << "  code " << st.error_code
+	      << "  evals " << std::setw(5) << st.num_evals;
+    if (st.message != nullptr)
+      std::cout << "  (" << st.message << ')';
+    std::cout << '\n';
+  }
+
+/**
+ * Check that the throwing overload gives the same result
+ * or throws with the code of the status.
+ */
+template<typename Tp, typename Status, typename Call>
+  void
+  agree(const Status& st, Call call)
+  {
+    try
+      {
+	const auto res = call();
+	std::cout << "    throwing overload agrees: " << std::boolalpha
+		  << (st.error_code == emsr::NO_ERROR
+		      && res.result == st.result && res.abserr == st.abserr)
+		  << '\n';
+      }
+    catch (const emsr::integration_error<Tp, Tp>& err)
+      {
+	std::cout << "    throwing overload agrees: " << std::boolalpha
+		  << (st.error_code != emsr::NO_ERROR
+		      && err.result() == st.result && err.abserr() == st.abserr)
+		  << "  (" << err.what() << ")\n";
+      }
+  }
+
+template<typename Tp>
+  void
+  test_integration_status()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto pi = std::numbers::pi_v<Tp>;
+    const auto tol = Tp{1.0e-10L};
+
+    emsr::integration_workspace<Tp, Tp> wk(1000), wk_small(20), wk_cycle(1000);
+
+    auto smooth = [](Tp x) { return std::exp(x); };
+    auto rsqrt = [](Tp x) { return Tp{1} / std::sqrt(x); };
+    auto recip = [](Tp x) { return Tp{1} / x; };
+
+    std::cout << "\nConverged and failing integrations\n";
+    auto st = emsr::qag_integrate(std::nothrow, wk, smooth,
+				  Tp{0}, Tp{1}, Tp{0}, tol);
+    show("qag exp", st);
+    agree<Tp>(st, [&]{ return emsr::qag_integrate(wk, smooth,
+						  Tp{0}, Tp{1}, Tp{0}, tol); });
+
+    st = emsr::qag_integrate(std::nothrow, wk_small, rsqrt,
+			     Tp{0}, Tp{1}, Tp{0}, tol);
+    show("qag 1/sqrt(x)", st);
+    agree<Tp>(st, [&]{ return emsr::qag_integrate(wk_small, rsqrt,
+						  Tp{0}, Tp{1}, Tp{0}, tol); });
+
+    st = emsr::qags_integrate(std::nothrow, wk, rsqrt,
+			      Tp{0}, Tp{1}, Tp{0}, tol);
+    show("qags 1/sqrt(x)", st);
+    agree<Tp>(st, [&]{ return emsr::qags_integrate(wk, rsqrt,
+						   Tp{0}, Tp{1}, Tp{0}, tol); });
+
+    st = emsr::qags_integrate(std::nothrow, wk, recip,
+			      Tp{0}, Tp{1}, Tp{0}, tol);
+    show("qags 1/x", st);
+    agree<Tp>(st, [&]{ return emsr::qags_integrate(wk, recip,
+						   Tp{0}, Tp{1}, Tp{0}, tol); });
+
+    auto gauss = [](Tp x) { return std::exp(-x * x); };
+    st = emsr::qagi_integrate(std::nothrow, wk, gauss, Tp{0}, tol);
+    show("qagi exp(-x^2)", st);
+    std::cout << "    actual error " << st.result - std::sqrt(pi) << '\n';
+
+    auto step = [](Tp x) { return x < Tp{0.3L} ? Tp{1} : Tp{2}; };
+    st = emsr::qagp_integrate(std::nothrow, wk, step,
+			      std::vector<Tp>{Tp{0}, Tp{0.3L}, Tp{1}},
+			      Tp{0}, tol);
+    show("qagp step", st);
+
+    emsr::qaws_integration_table<Tp> tab(Tp{-0.5L}, Tp{0}, 0, 0);
+    auto one_plus = [](Tp x) { return Tp{1} / (Tp{1} + x); };
+    st = emsr::qaws_integrate(std::nothrow, wk, tab, one_plus,
+			      Tp{0}, Tp{1}, Tp{0}, tol);
+    show("qaws", st);
+    std::cout << "    actual error " << st.result - pi / Tp{2} << '\n';
+
+    st = emsr::qawc_integrate(std::nothrow, wk, smooth,
+			      Tp{-1}, Tp{2}, Tp{0.5L}, Tp{0}, tol);
+    show("qawc", st);
+
+    emsr::oscillatory_integration_table<Tp>
+      wo(Tp{10} * pi, Tp{1},
+	 emsr::oscillatory_integration_table<Tp>::INTEG_SINE, 100);
+    st = emsr::qawo_integrate(std::nothrow, wk, wo, smooth,
+			      Tp{0}, Tp{0}, tol);
+    show("qawo", st);
+
+    emsr::oscillatory_integration_table<Tp>
+      wf(pi / Tp{2}, Tp{1},
+	 emsr::oscillatory_integration_table<Tp>::INTEG_COSINE, 100);
+    auto decay = [](Tp x) { return std::exp(-x); };
+    st = emsr::qawf_integrate(std::nothrow, wk, wk_cycle, wf, decay,
+			      Tp{0}, tol);
+    show("qawf", st);
+    std::cout << "    actual error "
+	      << st.result - Tp{1} / (Tp{1} + pi * pi / Tp{4}) << '\n';
+
+    emsr::cquad_workspace<Tp, Tp> cw;
+    st = emsr::cquad_integrate(std::nothrow, cw, rsqrt,
+			       Tp{0}, Tp{1}, Tp{0}, tol);
+    show("cquad 1/sqrt(x)", st);
+    emsr::cquad_workspace<Tp, Tp> cw_small(10);
+    st = emsr::cquad_integrate(std::nothrow, cw_small, rsqrt,
+			       Tp{0}, Tp{1}, Tp{0}, Tp{1.0e-14L});
+    show("cquad small ws", st);
+    agree<Tp>(st, [&]{ return emsr::cquad_integrate(cw_small, rsqrt,
+						    Tp{0}, Tp{1}, Tp{0},
+						    Tp{1.0e-14L}); });
+
+    std::cout << "\nNested rules and other engines\n";
+    const emsr::gauss_patterson_integral<Tp> gp;
+    st = gp.integrate(std::nothrow, smooth, Tp{0}, Tp{1}, Tp{0}, tol);
+    show("patterson exp", st);
+    st = gp.integrate(std::nothrow, rsqrt, Tp{0}, Tp{1}, Tp{0}, tol);
+    show("patterson rsqrt", st);
+    agree<Tp>(st, [&]{ const auto r = gp.integrate(rsqrt, Tp{0}, Tp{1},
+						   Tp{0}, tol);
+		       return emsr::adaptive_integral_t<Tp, Tp>{r.result,
+								 r.abserr}; });
+
+    const emsr::clenshaw_curtis_integral<Tp> cc;
+    auto kink = [](Tp x) { return std::sqrt(std::abs(x - Tp{0.3L})); };
+    st = cc.integrate(std::nothrow, kink, Tp{0}, Tp{1}, Tp{0}, tol);
+    show("cc sqrt|x-0.3|", st);
+
+    using point2_t = std::array<Tp, 2>;
+    auto corner = [](const point2_t& x)
+		  { return Tp{1} / std::sqrt(x[0] + x[1]); };
+    const emsr::triangle<Tp> tri{{{{Tp{0}, Tp{0}}, {Tp{1}, Tp{0}},
+				   {Tp{0}, Tp{1}}}}};
+    emsr::triangle_workspace<Tp, Tp, 2> tw(31);
+    st = emsr::adaptive_triangle_integrate(std::nothrow, tw, corner, tri,
+					   Tp{0}, tol);
+    show("triangle corner", st);
+    agree<Tp>(st, [&]{ return emsr::adaptive_triangle_integrate(tw, corner,
+						tri, Tp{0}, tol); });
+
+    emsr::cubature_workspace<Tp, Tp, 2> cub(20);
+    st = emsr::adaptive_cubature_integrate(std::nothrow, cub, corner,
+					   point2_t{Tp{0}, Tp{0}},
+					   point2_t{Tp{1}, Tp{1}}, Tp{0}, tol);
+    show("cubature corner", st);
+    agree<Tp>(st, [&]{ return emsr::adaptive_cubature_integrate(cub, corner,
+					point2_t{Tp{0}, Tp{0}},
+					point2_t{Tp{1}, Tp{1}}, Tp{0}, tol); });
+
+    auto smooth2 = [](const point2_t& x) { return std::exp(x[0] + x[1]); };
+    const emsr::sparse_grid_integral<Tp>
+      sg(emsr::Sparse_Clenshaw_Curtis);
+    st = sg.integrate(std::nothrow, smooth2, point2_t{Tp{0.5L}, Tp{0.5L}},
+		      point2_t{Tp{0.5L}, Tp{0.5L}}, Tp{0}, tol, 100);
+    show("sparse grid", st);
+
+    const emsr::qmc_integral<Tp, 2> qmc;
+    st = qmc.integrate(std::nothrow, smooth2, point2_t{Tp{0}, Tp{0}},
+		       point2_t{Tp{1}, Tp{1}}, Tp{0}, tol, 1 << 12);
+    show("qmc", st);
+
+    const auto pr = emsr::integrate_probed(std::nothrow, recip,
+					   Tp{0}, Tp{1}, Tp{0}, tol);
+    show("probed 1/x", pr);
+
+    // A parameter sweep in which some points fail to converge.
+    std::cout << "\nSweep of x^p over [0,1] with 20 subintervals\n";
+    const int num_points = 2000;
+    auto start = std::chrono::steady_clock::now();
+    int num_failed = 0;
+    auto sum = Tp{0};
+    for (int i = 0; i < num_points; ++i)
+      {
+	const auto p = Tp{-0.2L} + Tp(i) / Tp(num_points);
+	auto power = [p](Tp x) { return std::pow(x, p); };
+	const auto res = emsr::qag_integrate(std::nothrow, wk_small, power,
+					     Tp{0}, Tp{1}, Tp{0}, tol);
+	num_failed += !res;
+	sum += res.result;
+      }
+    std::chrono::duration<double> dt1 = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    int num_thrown = 0;
+    for (int i = 0; i < num_points; ++i)
+      {
+	const auto p = Tp{-0.2L} + Tp(i) / Tp(num_points);
+	auto power = [p](Tp x) { return std::pow(x, p); };
+	try
+	  {
+	    sum -= emsr::qag_integrate(wk_small, power,
+				       Tp{0}, Tp{1}, Tp{0}, tol).result;
+	  }
+	catch (const emsr::integration_error<Tp, Tp>& err)
+	  {
+	    ++num_thrown;
+	    sum -= err.result();
+	  }
+      }
+    std::chrono::duration<double> dt2 = std::chrono::steady_clock::now() - start;
+    std::cout << "  status: " << num_failed << " failed in " << dt1.count()
+	      << " s\n  throwing: " << num_thrown << " thrown in " << dt2.count()
+	      << " s\n  sum difference " << sum << '\n';
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_integration_status<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_integration_status<long double>();
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+#include <emsr/integration.h>
+
+/**
+ * Compare the pre-mapped rule with the rule applied to the mapping
+ * functor on a few intervals of (0,1) and time the two.
+ */
+template<typename Tp, typename MapTp, typename FuncMapTp, typename FuncTp>
+  void
+  compare(const char* name, MapTp map, FuncMapTp wrapped, FuncTp func)
+  {
+    const auto w = 8 + std::cout.precision();
+    std::cout << "  " << name << '\n';
+    for (unsigned rule : {15u, 21u, 31u, 41u, 51u, 61u, 81u})
+      {
+	const emsr::gauss_kronrod_integral<Tp> gk(rule);
+	const emsr::mapped_gauss_kronrod_integral<Tp, MapTp> mgk(rule, map);
+	auto maxdiff = Tp{0};
+	for (auto [a, b] : {std::pair{Tp{0}, Tp{1}}, {Tp{0}, Tp{0.125L}},
+			    {Tp{0.25L}, Tp{0.75L}}, {Tp{0.875L}, Tp{1}}})
+	  {
+	    const auto r1 = gk(wrapped, a, b);
+	    const auto r2 = mgk(func, a, b);
+	    const auto scale = std::max(Tp{1}, std::abs(r1.result));
+	    maxdiff = std::max({maxdiff, std::abs(r1.result - r2.result) / scale,
+				std::abs(r1.abserr - r2.abserr) / scale,
+				std::abs(r1.resabs - r2.resabs) / scale,
+				std::abs(r1.resasc - r2.resasc) / scale});
+	  }
+	std::cout << "    rule " << std::setw(2) << rule
+		  << "  max difference " << std::setw(w) << maxdiff << '\n';
+      }
+
+    const int num_reps = 20000;
+    const emsr::gauss_kronrod_integral<Tp> gk(emsr::Kronrod_21);
+    const emsr::mapped_gauss_kronrod_integral<Tp, MapTp>
+      mgk(emsr::Kronrod_21, map);
+    auto sum = Tp{0};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_reps; ++i)
+      sum += gk(wrapped, Tp{0}, Tp(i + 1) / Tp(num_reps)).result;
+    std::chrono::duration<double> dt1 = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_reps; ++i)
+      sum -= mgk(func, Tp{0}, Tp(i + 1) / Tp(num_reps)).result;
+    std::chrono::duration<double> dt2 = std::chrono::steady_clock::now() - start;
+    std::cout << "    " << num_reps << " 21-point intervals: wrapped "
+	      << dt1.count() << " s  mapped " << dt2.count() << " s"
+	      << "  sum difference " << sum << '\n';
+  }
+
+template<typename Tp>
+  void
+  test_mapped_gauss_kronrod()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    auto func = [](Tp x) -> Tp { return std::exp(-x * x / Tp{2}) / (Tp{1} + x * x); };
+    const auto a = Tp{-0.5L}, b = Tp{1.5L};
+
+    std::cout << "\nMapped rules vs. rules on mapped functions\n";
+    compare<Tp>("(-inf, +inf)", emsr::coord_map_minf_pinf<Tp>{},
+		emsr::map_minf_pinf<Tp, decltype(func)>(func), func);
+    compare<Tp>("(-inf, b]", emsr::coord_map_minf_b<Tp>{b},
+		emsr::map_minf_b<Tp, decltype(func)>(func, b), func);
+    compare<Tp>("[a, +inf)", emsr::coord_map_a_pinf<Tp>{a},
+		emsr::map_a_pinf<Tp, decltype(func)>(func, a), func);
+
+    std::cout << "\nAdaptive infinite-range integrals\n";
+    int count = 0;
+    auto counted = [&count, func](Tp x) { ++count; return func(x); };
+    auto show = [w, &count](const char* name, auto res)
+      {
+	std::cout << "  " << std::setw(22) << std::left << name << std::right
+		  << "  result " << std::setw(w) << res.result
+		  << "  err " << std::setw(w) << res.abserr
+		  << "  evals " << count << '\n';
+	count = 0;
+      };
+    const auto tol = Tp{1.0e-12L};
+    show("integrate_minf_pinf",
+	 emsr::integrate_minf_pinf(counted, Tp{0}, tol));
+    show("integrate_minf_upper",
+	 emsr::integrate_minf_upper(counted, b, Tp{0}, tol));
+    show("integrate_lower_pinf",
+	 emsr::integrate_lower_pinf(counted, a, Tp{0}, tol));
+    show("integrate_singular_minf_pinf",
+	 emsr::integrate_singular_minf_pinf(counted, Tp{0}, tol, 1024));
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_mapped_gauss_kronrod<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_mapped_gauss_kronrod<long double>();
+}
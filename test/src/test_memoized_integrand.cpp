@@ -0,0 +1,142 @@
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+#include <emsr/integration.h>
+#include <emsr/memoized_integrand.h>
+
+template<typename Tp>
+  void
+  show_stats(const char* name, const emsr::memoization_stats& stats,
+	     std::size_t evals)
+  {
+    std::cout << "  " << std::setw(24) << std::left << name << std::right
+	      << "  hits " << std::setw(6) << stats.hits
+	      << "  misses " << std::setw(6) << stats.misses
+	      << "  evictions " << std::setw(6) << stats.evictions
+	      << "  size " << std::setw(6) << stats.size
+	      << "  hit rate " << std::setw(8) << std::setprecision(4)
+	      << stats.hit_rate()
+	      << std::setprecision(std::numeric_limits<Tp>::digits10)
+	      << "  evals " << evals << '\n';
+  }
+
+template<typename Tp>
+  void
+  test_memoized_integrand()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    std::atomic<std::size_t> evals{0};
+    auto func = [&evals](Tp x)
+		{
+		  ++evals;
+		  return std::cos(Tp{10} * x) / std::sqrt(std::abs(x - Tp{0.3L}));
+		};
+    using memo_t = emsr::memoized_integrand<Tp, decltype(func)>;
+
+    const auto tol = Tp{1.0e-10L};
+    const std::vector<Tp> pts{Tp{0}, Tp{0.3L}, Tp{1}};
+
+    std::cout << "\nRepeated calls with the same break points\n";
+    const auto plain = emsr::integrate_multisingular(func,
+				pts.begin(), pts.end(), Tp{0}, tol);
+    evals = 0;
+    memo_t memo(func);
+    for (int rep = 0; rep < 3; ++rep)
+      {
+	const auto res = emsr::integrate_multisingular(memo,
+				pts.begin(), pts.end(), Tp{0}, tol);
+	std::cout << "  call " << rep
+		  << "  result " << std::setw(w) << res.result
+		  << "  err " << std::setw(w) << res.abserr
+		  << "  identical: " << std::boolalpha
+		  << (res.result == plain.result && res.abserr == plain.abserr)
+		  << '\n';
+      }
+    show_stats<Tp>("qagp x 3", memo.stats(), evals);
+
+    // A cumulative table that re-integrates the lower panels each time.
+    std::cout << "\nCumulative integrals over revisited panels\n";
+    const int num_panels = 10;
+    auto cumulative = [num_panels, tol](auto f)
+      {
+	std::vector<Tp> table;
+	for (int k = 1; k <= num_panels; ++k)
+	  {
+	    auto sum = Tp{0};
+	    for (int j = 0; j < k; ++j)
+	      sum += emsr::integrate(f, Tp(j) / num_panels,
+				     Tp(j + 1) / num_panels, Tp{0}, tol).result;
+	    table.push_back(sum);
+	  }
+	return table;
+      };
+    evals = 0;
+    const auto table0 = cumulative(func);
+    const std::size_t plain_evals = evals;
+    evals = 0;
+    memo.clear();
+    const auto table1 = cumulative(memo);
+    std::cout << "  identical: " << (table0 == table1)
+	      << "  uncached evals " << plain_evals << '\n';
+    show_stats<Tp>("cumulative", memo.stats(), evals);
+
+    // A small cache drops old values but stays correct.
+    evals = 0;
+    memo_t small(func, 64, 2);
+    const auto table2 = cumulative(small);
+    std::cout << "  small cache identical: " << (table0 == table2) << '\n';
+    show_stats<Tp>("cumulative, capacity 64", small.stats(), evals);
+
+    // Several threads share one cache through copies of the wrapper.
+    std::cout << "\nFour threads sharing one cache\n";
+    evals = 0;
+    memo_t shared(func);
+    std::vector<std::vector<Tp>> tables(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+      threads.emplace_back([&tables, &cumulative, t, shared]()
+			   { tables[t] = cumulative(shared); });
+    for (auto& th : threads)
+      th.join();
+    bool same = true;
+    for (const auto& tab : tables)
+      same = same && tab == table0;
+    const auto stats = shared.stats();
+    std::cout << "  identical: " << same
+	      << "  calls accounted: "
+	      << (stats.hits + stats.misses == 4 * plain_evals) << '\n';
+    show_stats<Tp>("threads", stats, evals);
+
+    // Keys are bit patterns: signed zeros are distinct.
+    auto inv = [](Tp x) { return Tp{1} / x; };
+    emsr::memoized_integrand<Tp, decltype(inv)> memo_inv(inv);
+    std::cout << "\nSigned zeros: 1/(+0) = " << memo_inv(Tp{+0.0})
+	      << "  1/(-0) = " << memo_inv(Tp{-0.0})
+	      << "  1/(+0) = " << memo_inv(Tp{+0.0}) << '\n';
+
+    try
+      {
+	memo_t bad(func, 0);
+	std::cout << "Zero capacity: no exception\n";
+      }
+    catch (const std::domain_error& err)
+      {
+	std::cout << "Zero capacity: " << err.what() << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_memoized_integrand<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_memoized_integrand<long double>();
+}
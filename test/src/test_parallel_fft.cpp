@@ -0,0 +1,151 @@
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <emsr/fourier_transform.h>
+
+template<typename Tp>
+  std::vector<std::complex<Tp>>
+  random_data(std::size_t len)
+  {
+    std::default_random_engine re;
+    std::uniform_real_distribution<Tp> ud(Tp{-1}, Tp{+1});
+    std::vector<std::complex<Tp>> z;
+    z.reserve(len);
+    for (std::size_t i = 0; i < len; ++i)
+      z.emplace_back(ud(re), ud(re));
+    return z;
+  }
+
+template<typename Tp>
+  void
+  test_parallel_fft()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    std::cout << "\nFour-step vs. serial plan\n";
+    for (std::size_t len : {1009, 2 * 1009, 1 << 16, 3 << 14, 100000, 1 << 19})
+      {
+	const auto z = random_data<Tp>(len);
+	auto serial = z;
+	emsr::fft_plan<Tp>(len).forward(serial);
+
+	for (unsigned nt : {1u, 3u, 8u})
+	  {
+	    emsr::parallel_fft_plan<Tp> plan(len, nt);
+	    auto xform = z;
+	    plan.forward(xform);
+	    auto iform = xform;
+	    plan.inverse(iform);
+
+	    auto d = Tp{0}, e = Tp{0};
+	    for (std::size_t i = 0; i < len; ++i)
+	      {
+		d = std::max(d, std::abs(xform[i] - serial[i]));
+		e = std::max(e, std::abs(iform[i] - z[i]));
+	      }
+	    std::cout << ' ' << std::setw(8) << len
+		      << " = " << std::setw(4) << plan.num_columns()
+		      << " x " << std::setw(6) << plan.num_rows()
+		      << "  threads " << nt
+		      << "  vs. serial " << std::setw(w) << d
+		      << "  round trip " << std::setw(w) << e << '\n';
+	  }
+      }
+
+    std::cout << "\nMultithreaded real data vs. serial\n";
+    for (std::size_t len : {1001, 1 << 16, 100000})
+      {
+	const auto z = random_data<Tp>(len);
+	std::vector<Tp> x(len);
+	for (std::size_t i = 0; i < len; ++i)
+	  x[i] = z[i].real();
+	auto serial = x;
+	emsr::fast_fourier_transform(serial);
+	auto xform = x;
+	emsr::fast_fourier_transform(xform, 4);
+	auto iform = xform;
+	emsr::inv_fast_fourier_transform(iform, 4);
+
+	auto d = Tp{0}, e = Tp{0};
+	for (std::size_t i = 0; i < len; ++i)
+	  {
+	    d = std::max(d, std::abs(xform[i] - serial[i]));
+	    e = std::max(e, std::abs(iform[i] - x[i]));
+	  }
+	std::cout << ' ' << std::setw(8) << len
+		  << "  vs. serial " << std::setw(w) << d
+		  << "  round trip " << std::setw(w) << e << '\n';
+      }
+  }
+
+/**
+ * Thread scaling of the four-step transform at large N.
+ */
+template<typename Tp>
+  void
+  bench_parallel_fft(std::size_t len)
+  {
+    std::cout << "\nThread scaling at N = " << len
+	      << " (hardware concurrency "
+	      << std::thread::hardware_concurrency() << ")\n";
+
+    const auto z = random_data<Tp>(len);
+    std::vector<Tp> x(len);
+    for (std::size_t i = 0; i < len; ++i)
+      x[i] = z[i].real();
+
+    auto time = [](auto transform)
+      {
+	auto start = std::chrono::steady_clock::now();
+	transform();
+	auto stop = std::chrono::steady_clock::now();
+	std::chrono::duration<double> dt = stop - start;
+	return dt.count();
+      };
+
+    auto work = z;
+    emsr::fft_plan<Tp> serial(len);
+    const auto t_serial = time([&]{ serial.forward(work); });
+    std::cout << "  serial plan: " << t_serial << " s\n";
+
+    std::cout << ' ' << std::setw(8) << "threads"
+	      << ' ' << std::setw(12) << "complex"
+	      << ' ' << std::setw(8) << "speedup"
+	      << ' ' << std::setw(12) << "real"
+	      << '\n';
+    for (unsigned nt : {1u, 2u, 4u, 8u, 16u, 32u, 64u})
+      {
+	emsr::parallel_fft_plan<Tp> plan(len, nt);
+	work = z;
+	const auto t_cmplx = time([&]{ plan.forward(work); });
+	auto xwork = x;
+	const auto t_real = time([&]{ emsr::fast_fourier_transform(xwork, nt); });
+	std::cout << ' ' << std::setw(8) << nt
+		  << ' ' << std::setw(12) << t_cmplx
+		  << ' ' << std::setw(8) << t_serial / t_cmplx
+		  << ' ' << std::setw(12) << t_real
+		  << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_parallel_fft<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_parallel_fft<long double>();
+
+  std::cout.precision(4);
+  std::cout << "\n\ndouble\n";
+  bench_parallel_fft<double>(std::size_t{1} << 22);
+}
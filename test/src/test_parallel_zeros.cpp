@@ -0,0 +1,142 @@
+
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <emsr/quadrature_point.h>
+
+template<typename Tp>
+  Tp
+  max_diff(const std::vector<emsr::QuadraturePoint<Tp>>& a,
+	   const std::vector<emsr::QuadraturePoint<Tp>>& b)
+  {
+    // The Laguerre and Hermite zeros grow with the degree
+    // so compare relative to the larger of one and the value.
+    auto diff = Tp{0};
+    for (std::size_t i = 0; i < a.size(); ++i)
+      {
+	diff = std::max(diff, std::abs(a[i].point - b[i].point)
+			    / std::max(Tp{1}, std::abs(a[i].point)));
+	diff = std::max(diff, std::abs(a[i].weight - b[i].weight)
+			    / std::max(Tp{1}, std::abs(a[i].weight)));
+      }
+    return diff;
+  }
+
+template<typename Tp>
+  bool
+  identical(const std::vector<emsr::QuadraturePoint<Tp>>& a,
+	    const std::vector<emsr::QuadraturePoint<Tp>>& b)
+  {
+    if (a.size() != b.size())
+      return false;
+    for (std::size_t i = 0; i < a.size(); ++i)
+      if (a[i].point != b[i].point || a[i].weight != b[i].weight)
+	return false;
+    return true;
+  }
+
+/**
+ * Check that the parallel rule does not depend on the thread count,
+ * that its weights integrate the weight function exactly
+ * and, if match_serial, that it agrees with the serial rule.
+ */
+template<typename Tp, typename Func>
+  int
+  compare(const char* name, Func zeros,
+	  const std::vector<emsr::QuadraturePoint<Tp>>& serial,
+	  Tp mass, bool match_serial = true)
+  {
+    const auto tol = Tp{256} * std::numeric_limits<Tp>::epsilon();
+
+    std::cout << std::setw(12) << name;
+    auto prev = zeros(1u);
+    const auto diff = max_diff(serial, prev);
+    std::cout << "  serial vs parallel: " << std::setw(14) << diff;
+    auto sum = Tp{0};
+    for (const auto& pt : prev)
+      sum += pt.weight;
+    const auto mass_err = std::abs(sum - mass) / mass;
+    std::cout << "  mass error: " << std::setw(14) << mass_err;
+    bool det = true;
+    for (auto nt : {2u, 3u, 8u})
+      det = det && identical(prev, zeros(nt));
+    std::cout << "  deterministic: " << std::boolalpha << det;
+    const bool ok = det && prev.size() == serial.size() && mass_err <= tol
+		 && (!match_serial || diff <= tol);
+    std::cout << (ok ? "  PASS" : "  FAIL") << '\n';
+    return ok ? 0 : 1;
+  }
+
+template<typename Tp>
+  int
+  test_parallel_zeros()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+
+    const unsigned n = 20;
+    const Tp alpha = Tp{0.5L};
+    const Tp beta = Tp{1.5L};
+
+    // The integrals of the weight functions.
+    const auto sqrt_pi = std::sqrt(std::acos(Tp{-1}));
+    const auto mass_legendre = Tp{2};
+    const auto mass_laguerre = std::tgamma(alpha + Tp{1});
+    const auto mass_hermite = sqrt_pi;
+    // gegenbauer_zeros integrates the weight (1 - x^2)^lambda.
+    const auto mass_gegenbauer = std::pow(Tp{2}, Tp{2} * alpha + Tp{1})
+			       * std::tgamma(alpha + Tp{1})
+			       * std::tgamma(alpha + Tp{1})
+			       / std::tgamma(Tp{2} * alpha + Tp{2});
+    const auto mass_jacobi = std::pow(Tp{2}, alpha + beta + Tp{1})
+			   * std::tgamma(alpha + Tp{1})
+			   * std::tgamma(beta + Tp{1})
+			   / std::tgamma(alpha + beta + Tp{2});
+
+    int num_fail = 0;
+    num_fail += compare<Tp>("legendre",
+			    [n](unsigned nt){ return emsr::legendre_zeros<Tp>(n, nt); },
+			    emsr::legendre_zeros<Tp>(n), mass_legendre);
+    num_fail += compare<Tp>("laguerre",
+			    [n, alpha](unsigned nt){ return emsr::laguerre_zeros(n, alpha, nt); },
+			    emsr::laguerre_zeros(n, alpha), mass_laguerre);
+    num_fail += compare<Tp>("hermite",
+			    [n](unsigned nt){ return emsr::hermite_zeros<Tp>(n, nt); },
+			    emsr::hermite_zeros<Tp>(n), mass_hermite);
+    num_fail += compare<Tp>("gegenbauer",
+			    [n, alpha](unsigned nt){ return emsr::gegenbauer_zeros(n, alpha, nt); },
+			    emsr::gegenbauer_zeros(n, alpha), mass_gegenbauer);
+    num_fail += compare<Tp>("jacobi",
+			    [n, alpha, beta](unsigned nt){ return emsr::jacobi_zeros(n, alpha, beta, nt); },
+			    emsr::jacobi_zeros(n, alpha, beta), mass_jacobi);
+
+    // Timing for a mid-size rule.
+    const unsigned big = 2000;
+    for (auto nt : {1u, 2u, 4u, 8u})
+      {
+	auto start = std::chrono::steady_clock::now();
+	auto rule = emsr::jacobi_zeros(big, alpha, beta, nt);
+	auto stop = std::chrono::steady_clock::now();
+	std::chrono::duration<double> dt = stop - start;
+	std::cout << "jacobi_zeros(" << big << ") threads = " << nt
+		  << "  time = " << dt.count() << " s\n";
+      }
+
+    return num_fail;
+  }
+
+int
+main()
+{
+  int num_fail = 0;
+
+  std::cout << "\n\ndouble\n";
+  num_fail += test_parallel_zeros<double>();
+
+  std::cout << "\n\nlong double\n";
+  num_fail += test_parallel_zeros<long double>();
+
+  return num_fail == 0 ? 0 : 1;
+}
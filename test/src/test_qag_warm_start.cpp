@@ -0,0 +1,140 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <emsr/integration.h>
+
+/**
+ * Integrate a peak of width eps that moves across [0, 1] cold and warm
+ * started from the partition of the previous parameter.
+ */
+template<typename Tp>
+  void
+  sweep(Tp eps)
+  {
+    const auto w = 8 + std::cout.precision();
+    const auto tol = Tp{1.0e-10L};
+    // The integral of 1/((x-p)^2 + eps^2) over [0, 1].
+    auto exact = [eps](Tp p)
+		 {
+		   return (std::atan((Tp{1} - p) / eps)
+			 + std::atan(p / eps)) / eps;
+		 };
+
+    emsr::integration_workspace<Tp, Tp> cold_ws(1000), warm_ws(1000);
+
+    const int num_steps = 200;
+    std::size_t cold_evals = 0, warm_evals = 0, coarse_evals = 0;
+    std::size_t max_panels = 0, max_coarse_panels = 0;
+    auto max_cold_err = Tp{0}, max_warm_err = Tp{0}, max_coarse_err = Tp{0};
+    std::vector<Tp> partition{Tp{0}, Tp{1}};
+    std::vector<Tp> coarse_partition{Tp{0}, Tp{1}};
+    emsr::integration_workspace<Tp, Tp> coarse_ws(1000);
+    for (int i = 0; i < num_steps; ++i)
+      {
+	const auto p = Tp{0.2L} + Tp{0.6L} * Tp(i) / Tp(num_steps);
+	auto peak = [p, eps](Tp x)
+		    { return Tp{1} / ((x - p) * (x - p) + eps * eps); };
+
+	const auto cold = emsr::qag_integrate(std::nothrow, cold_ws, peak,
+					      Tp{0}, Tp{1}, Tp{0}, tol);
+	cold_evals += cold.num_evals;
+	max_cold_err = std::max(max_cold_err,
+				std::abs(cold.result / exact(p) - Tp{1}));
+
+	const auto warm = emsr::qag_integrate(std::nothrow, warm_ws, peak,
+					      partition, Tp{0}, tol);
+	warm_evals += warm.num_evals;
+	max_warm_err = std::max(max_warm_err,
+				std::abs(warm.result / exact(p) - Tp{1}));
+	partition = warm_ws.partition();
+	max_panels = std::max(max_panels, partition.size() - 1);
+
+	const auto coarse = emsr::qag_integrate(std::nothrow, coarse_ws, peak,
+						coarse_partition, Tp{0}, tol);
+	coarse_evals += coarse.num_evals;
+	max_coarse_err = std::max(max_coarse_err,
+				  std::abs(coarse.result / exact(p) - Tp{1}));
+	coarse_partition = coarse_ws.partition(Tp{1.0e-3L} * tol
+					       * std::abs(coarse.result)
+					       / Tp(coarse_ws.size()));
+	max_coarse_panels = std::max(max_coarse_panels,
+				     coarse_partition.size() - 1);
+      }
+
+    std::cout << "\nSweep of a peak of width " << eps << " over "
+	      << num_steps << " steps\n"
+	      << "  cold start     evals " << std::setw(7) << cold_evals
+	      << "  max rel error " << std::setw(w) << max_cold_err << '\n'
+	      << "  warm start     evals " << std::setw(7) << warm_evals
+	      << "  max rel error " << std::setw(w) << max_warm_err
+	      << "  max panels " << max_panels << '\n'
+	      << "  warm, coarsen  evals " << std::setw(7) << coarse_evals
+	      << "  max rel error " << std::setw(w) << max_coarse_err
+	      << "  max panels " << max_coarse_panels << '\n'
+	      << "  warm start cheaper than cold: " << std::boolalpha
+	      << (warm_evals < cold_evals) << '\n';
+  }
+
+template<typename Tp>
+  void
+  test_qag_warm_start()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    sweep(Tp{1.0e-2L});
+    sweep(Tp{1.0e-3L});
+
+    const auto eps = Tp{1.0e-3L};
+    const auto tol = Tp{1.0e-10L};
+    std::vector<Tp> partition{Tp{0}, Tp{0.25L}, Tp{0.5L}, Tp{0.75L}, Tp{1}};
+    emsr::integration_workspace<Tp, Tp> warm_ws(1000);
+
+    // The initial panels on several threads.
+    const auto p = Tp{0.5L};
+    auto peak = [p, eps](Tp x)
+		{ return Tp{1} / ((x - p) * (x - p) + eps * eps); };
+    const auto r1 = emsr::qag_integrate(warm_ws, peak, partition, Tp{0}, tol,
+					emsr::gauss_kronrod_integral<Tp>(emsr::Kronrod_21), 1);
+    const auto r4 = emsr::qag_integrate(warm_ws, peak, partition, Tp{0}, tol,
+					emsr::gauss_kronrod_integral<Tp>(emsr::Kronrod_21), 4);
+    std::cout << "\n1 vs. 4 threads identical: " << std::boolalpha
+	      << (r1.result == r4.result && r1.abserr == r4.abserr) << '\n';
+
+    // A descending partition integrates from the first point to the last.
+    emsr::integration_workspace<Tp, Tp> rev_ws(1000);
+    const auto rev = emsr::qag_integrate(rev_ws, peak, Tp{1}, Tp{0},
+					 Tp{0}, tol);
+    const auto rev_part = rev_ws.partition();
+    const auto rev_warm = emsr::qag_integrate(rev_ws, peak, rev_part,
+					      Tp{0}, tol);
+    std::cout << "Reversed limits: partition from " << rev_part.front()
+	      << " to " << rev_part.back()
+	      << "  result " << std::setw(w) << rev_warm.result
+	      << "  cold " << std::setw(w) << rev.result << '\n';
+
+    try
+      {
+	emsr::qag_integrate(warm_ws, peak, std::vector<Tp>{Tp{0}, Tp{0.5L},
+							  Tp{0.25L}, Tp{1}},
+			    Tp{0}, tol);
+	std::cout << "Unsorted partition: no exception\n";
+      }
+    catch (const std::runtime_error& err)
+      {
+	std::cout << "Unsorted partition: " << err.what() << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_qag_warm_start<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_qag_warm_start<long double>();
+}
@@ -0,0 +1,250 @@
+#include <chrono>
+#include <complex>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <emsr/qmc_integral.h>
+
+/**
+ * Return the smallest t for which the first @f$ 2^m @f$ points
+ * of the Sobol sequence in coordinates (i, j) form a (t,m,2)-net:
+ * every elementary interval of volume @f$ 2^{t-m} @f$
+ * holds @f$ 2^t @f$ points.
+ */
+int
+net_quality(const emsr::sobol_sequence& sobol, std::size_t i, std::size_t j,
+	    int m)
+{
+  const std::size_t n = std::size_t{1} << m;
+  std::vector<std::uint32_t> x(sobol.dim());
+  std::vector<std::array<std::uint32_t, 2>> pt(n);
+  for (std::size_t k = 0; k < n; ++k)
+    {
+      if (k == 0)
+	sobol.point(0, x.data());
+      else
+	sobol.next(k - 1, x.data());
+      pt[k] = {x[i], x[j]};
+    }
+
+  for (int t = 0; t < m; ++t)
+    {
+      bool net = true;
+      for (int mi = 0; mi <= m - t && net; ++mi)
+	{
+	  const int mj = m - t - mi;
+	  std::vector<int> count(std::size_t{1} << (m - t), 0);
+	  for (const auto& p : pt)
+	    {
+	      const auto bi = mi == 0 ? 0u : p[0] >> (32 - mi);
+	      const auto bj = mj == 0 ? 0u : p[1] >> (32 - mj);
+	      ++count[(std::size_t(bi) << mj) | bj];
+	    }
+	  for (auto c : count)
+	    if (c != (1 << t))
+	      net = false;
+	}
+      if (net)
+	return t;
+    }
+  return m;
+}
+
+/**
+ * Integrate exp(sum c_i x_i), c_i = 1/(i+1)^2, over the unit cube.
+ */
+template<typename Tp, std::size_t Dim>
+  void
+  test_exp(emsr::qmc_sequence_kind kind, const char* name)
+  {
+    const auto w = 8 + std::cout.precision();
+
+    std::array<Tp, Dim> lower, upper, c;
+    lower.fill(Tp{0});
+    upper.fill(Tp{1});
+    auto exact = Tp{1};
+    for (std::size_t i = 0; i < Dim; ++i)
+      {
+	c[i] = Tp{1} / Tp((i + 1) * (i + 1));
+	exact *= std::expm1(c[i]) / c[i];
+      }
+
+    auto func = [&c](const std::array<Tp, Dim>& x) -> Tp
+		{
+		  auto arg = Tp{0};
+		  for (std::size_t i = 0; i < Dim; ++i)
+		    arg += c[i] * x[i];
+		  return std::exp(arg);
+		};
+    auto batch = [&func](std::span<const std::array<Tp, Dim>> x,
+			 std::span<Tp> f)
+		 {
+		   for (std::size_t i = 0; i < x.size(); ++i)
+		     f[i] = func(x[i]);
+		 };
+
+    const emsr::qmc_integral<Tp, Dim> qmc(kind);
+    std::cout << "  " << std::setw(3) << Dim << "D " << name << '\n';
+    for (std::size_t n : {1u << 10, 1u << 13, 1u << 16})
+      {
+	const auto res = qmc.integrate(func, lower, upper, n);
+	std::cout << "    points " << std::setw(7) << n
+		  << "  result " << std::setw(w) << res.result
+		  << "  err " << std::setw(w) << res.abserr
+		  << "  actual " << std::setw(w) << res.result - exact << '\n';
+      }
+
+    const auto n = std::size_t{1} << 14;
+    auto start = std::chrono::steady_clock::now();
+    const auto r1 = qmc.integrate(func, lower, upper, n, 1);
+    std::chrono::duration<double> dt1 = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    const auto r4 = qmc.integrate(func, lower, upper, n, 4);
+    std::chrono::duration<double> dt4 = std::chrono::steady_clock::now() - start;
+    const auto rb = qmc.integrate(batch, lower, upper, n, 4);
+    std::cout << "    1 vs. 4 threads identical: " << std::boolalpha
+	      << (r1.result == r4.result && r1.abserr == r4.abserr)
+	      << "  (" << dt1.count() << " s, " << dt4.count() << " s)"
+	      << "  batched identical: "
+	      << (rb.result == r1.result && rb.abserr == r1.abserr) << '\n';
+
+    const auto tol = Tp{1.0e-6L};
+    try
+      {
+	const auto ra = emsr::integrate_qmc(func, lower, upper, Tp{0}, tol,
+					    std::size_t{1} << 22, kind, 0);
+	std::cout << "    rel tol " << tol
+		  << "  result " << std::setw(w) << ra.result
+		  << "  err " << std::setw(w) << ra.abserr
+		  << "  actual " << std::setw(w) << ra.result - exact << '\n';
+      }
+    catch (const emsr::integration_error<Tp, Tp>& err)
+      {
+	std::cout << "    rel tol " << tol
+		  << "  result " << std::setw(w) << err.result()
+		  << "  err " << std::setw(w) << err.abserr()
+		  << "  (" << err.what() << ")\n";
+      }
+  }
+
+template<typename Tp>
+  void
+  test_qmc()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    std::cout << "\nExponential over the unit cube\n";
+    test_exp<Tp, 10>(emsr::QMC_Sobol, "Sobol");
+    test_exp<Tp, 10>(emsr::QMC_Lattice, "lattice");
+    test_exp<Tp, 40>(emsr::QMC_Sobol, "Sobol");
+    test_exp<Tp, 40>(emsr::QMC_Lattice, "lattice");
+    test_exp<Tp, 100>(emsr::QMC_Sobol, "Sobol");
+
+    // A complex integrand: exp(i sum x_j / j) over the unit cube.
+    constexpr std::size_t dim = 8;
+    std::array<Tp, dim> lower, upper;
+    lower.fill(Tp{0});
+    upper.fill(Tp{1});
+    std::complex<Tp> exact{1};
+    for (std::size_t j = 0; j < dim; ++j)
+      {
+	const auto a = Tp{1} / Tp(j + 1);
+	exact *= (std::polar(Tp{1}, a) - Tp{1}) / std::complex<Tp>(Tp{0}, a);
+      }
+    auto cfunc = [](const std::array<Tp, dim>& x)
+		 {
+		   auto arg = Tp{0};
+		   for (std::size_t j = 0; j < dim; ++j)
+		     arg += x[j] / Tp(j + 1);
+		   return std::polar(Tp{1}, arg);
+		 };
+    const auto cres = emsr::integrate_qmc(cfunc, lower, upper,
+					  Tp{0}, Tp{1.0e-6L});
+    std::cout << "\nComplex oscillatory in " << dim << "D\n"
+	      << "  result " << std::setw(2 * w) << cres.result
+	      << "  err " << std::setw(w) << cres.abserr
+	      << "  actual " << std::setw(w) << std::abs(cres.result - exact)
+	      << '\n';
+
+    // The budget is too small for the tolerance.
+    try
+      {
+	emsr::integrate_qmc(cfunc, lower, upper, Tp{0}, Tp{1.0e-12L},
+			    std::size_t{1} << 18);
+	std::cout << "  budget exceeded: no exception\n";
+      }
+    catch (const emsr::integration_error<std::complex<Tp>, Tp>& err)
+      {
+	std::cout << "  budget exceeded: " << err.what()
+		  << "  err " << err.abserr() << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "Sobol points 0-4 in 3D\n";
+  const emsr::sobol_sequence sobol(3);
+  std::uint32_t x[3];
+  for (std::uint64_t k = 0; k < 5; ++k)
+    {
+      if (k == 0)
+	sobol.point(0, x);
+      else
+	sobol.next(k - 1, x);
+      std::cout << "  " << k;
+      for (auto xj : x)
+	std::cout << ' ' << std::setw(8) << std::ldexp(double(xj), -32);
+      std::cout << '\n';
+    }
+
+  std::cout << "\nSobol one-dimensional stratification of 2^10 points"
+	       " in 1000D\n";
+  const emsr::sobol_sequence sobol1000(1000);
+  int bad = 0;
+  std::vector<std::uint32_t> y(sobol1000.dim());
+  for (std::size_t j = 0; j < sobol1000.dim(); ++j)
+    {
+      std::vector<int> count(1024, 0);
+      for (std::uint64_t k = 0; k < 1024; ++k)
+	{
+	  if (k == 0)
+	    sobol1000.point(0, y.data());
+	  else
+	    sobol1000.next(k - 1, y.data());
+	  ++count[y[j] >> 22];
+	}
+      for (auto ct : count)
+	bad += ct != 1;
+    }
+  std::cout << "  defects " << bad << '\n';
+
+  std::cout << "\nSobol t of the (t,12,2)-nets of pairs of coordinates\n";
+  for (std::size_t j : {1u, 2u, 5u, 19u, 36u, 100u, 999u})
+    std::cout << "  coordinates 0," << j << ": t = "
+	      << net_quality(sobol1000, 0, j, 12) << '\n';
+
+  std::cout << "\nRank-1 lattice generating vector in 10D\n";
+  const emsr::rank1_lattice lattice(10);
+  std::cout << "  z =";
+  for (auto z : lattice.generator())
+    std::cout << ' ' << z;
+  std::cout << "\n  P_2 = " << lattice.figure_of_merit(14)
+	    << "  vs. Korobov a = 3: "
+	    << emsr::rank1_lattice({1, 3, 9, 27, 81, 243, 729, 2187, 6561,
+				    3299}).figure_of_merit(14) << '\n';
+  const auto cached = emsr::cached_rank1_lattice(10);
+  std::cout << "  cached lattice is shared and agrees: " << std::boolalpha
+	    << (cached == emsr::cached_rank1_lattice(10)
+		&& cached->generator() == lattice.generator()) << '\n';
+
+  std::cout << "\n\ndouble\n";
+  test_qmc<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_qmc<long double>();
+}
@@ -0,0 +1,126 @@
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+#include <emsr/romberg_integral.h>
+
+template<typename Tp, typename FuncTp>
+  void
+  compare(const char* name, FuncTp func, Tp a, Tp b, Tp exact)
+  {
+    const auto w = 8 + std::cout.precision();
+    const auto tol = Tp{1.0e-10L};
+
+    std::size_t count = 0;
+    auto counted = [&count, func](Tp x) { ++count; return func(x); };
+
+    emsr::trapezoid_integral<Tp, decltype(counted)>
+      trapi(counted, a, b, Tp{0}, tol);
+    const auto trap = trapi();
+    const auto trap_evals = count;
+
+    count = 0;
+    emsr::romberg_integral<Tp, decltype(counted)>
+      rombi(counted, a, b, Tp{0}, tol);
+    const auto romb = rombi();
+
+    std::cout << "  " << name << '\n'
+	      << "    trapezoid  evals " << std::setw(8) << trap_evals
+	      << "  result " << std::setw(w) << trap
+	      << "  err " << std::setw(w) << trapi.abs_error()
+	      << "  actual " << std::setw(w) << trap - exact << '\n'
+	      << "    Romberg    evals " << std::setw(8) << count
+	      << "  result " << std::setw(w) << romb
+	      << "  err " << std::setw(w) << rombi.abs_error()
+	      << "  actual " << std::setw(w) << romb - exact
+	      << "  levels " << rombi.num_levels()
+	      << "  converged " << std::boolalpha << rombi.converged()
+	      << "  evals reported " << rombi.num_evals() << '\n';
+  }
+
+template<typename Tp>
+  void
+  test_romberg_integral()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+
+    std::cout << "\nTrapezoid vs. Romberg at relative tolerance 1e-10\n";
+    compare("exp(x) on [0, 1]", [](Tp x) { return std::exp(x); },
+	    Tp{0}, Tp{1}, std::expm1(Tp{1}));
+    compare("1/(1+x^2) on [0, 1]", [](Tp x) { return Tp{1} / (Tp{1} + x * x); },
+	    Tp{0}, Tp{1}, s_pi / Tp{4});
+    compare("x^7 - 2x^3 on [0, 2]",
+	    [](Tp x) { return std::pow(x, 7) - Tp{2} * x * x * x; },
+	    Tp{0}, Tp{2}, Tp{32 - 8});
+    compare("1/(1+25x^2) on [-1, 1]",
+	    [](Tp x) { return Tp{1} / (Tp{1} + Tp{25} * x * x); },
+	    Tp{-1}, Tp{1}, Tp{2} * std::atan(Tp{5}) / Tp{5});
+    compare("sqrt(x) on [0, 1]", [](Tp x) { return std::sqrt(x); },
+	    Tp{0}, Tp{1}, Tp{2} / Tp{3});
+
+    std::cout << "\nFixed Romberg levels for exp(x) on [0, 1]\n";
+    auto ex = [](Tp x) { return std::exp(x); };
+    for (std::size_t levels = 1; levels <= 8; ++levels)
+      {
+	emsr::composite_romberg_integral<Tp, decltype(ex)>
+	  rombi(ex, Tp{0}, Tp{1}, levels);
+	const auto result = rombi();
+	std::cout << "  levels " << levels
+		  << "  points " << std::setw(4) << (1u << (levels - 1)) + 1
+		  << "  result " << std::setw(w) << result
+		  << "  actual " << std::setw(w) << result - std::expm1(Tp{1})
+		  << '\n';
+      }
+
+    // The panels on a short range soon become too small to halve.
+    emsr::composite_romberg_integral<Tp, decltype(ex)>
+      tiny(ex, Tp{0}, Tp{1.0e-6L}, 40);
+    tiny();
+    std::cout << "  short range  levels " << tiny.num_levels()
+	      << "  converged " << std::boolalpha << tiny.converged() << '\n';
+    try
+      {
+	tiny.integrate(ex, Tp{0}, Tp{1.0e-6L});
+	std::cout << "  short range  no error\n";
+      }
+    catch (const emsr::integration_error<Tp, Tp>& err)
+      {
+	std::cout << "  short range  " << err.what() << '\n';
+      }
+
+    std::cout << "\nintegrate_romberg\n";
+    const auto res = emsr::integrate_romberg(ex, Tp{0}, Tp{1},
+					     Tp{0}, Tp{1.0e-12L});
+    std::cout << "  exp(x)     result " << std::setw(w) << res.result
+	      << "  err " << std::setw(w) << res.abserr << '\n';
+
+    auto rt = [](Tp x) { return std::sqrt(x); };
+    const auto stat = emsr::integrate_romberg(std::nothrow, rt, Tp{0}, Tp{1},
+					      Tp{0}, Tp{1.0e-13L}, 12);
+    std::cout << "  sqrt(x)    result " << std::setw(w) << stat.result
+	      << "  err " << std::setw(w) << stat.abserr
+	      << "  code " << stat.error_code
+	      << "  evals " << stat.num_evals << '\n';
+    try
+      {
+	emsr::integrate_romberg(rt, Tp{0}, Tp{1}, Tp{0}, Tp{1.0e-13L}, 12);
+	std::cout << "  throwing overload: no exception\n";
+      }
+    catch (const emsr::integration_error<Tp, Tp>& err)
+      {
+	std::cout << "  throwing overload: " << err.what() << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_romberg_integral<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_romberg_integral<long double>();
+}
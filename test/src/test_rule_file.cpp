@@ -0,0 +1,186 @@
+
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <emsr/integration.h>
+#include <emsr/rule_file.h>
+
+template<typename Tp>
+  void
+  test_rule_file(const std::string& path)
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+
+    const int n = 100;
+    const auto eps = 4 * std::numeric_limits<Tp>::epsilon();
+
+    // Build the rule the slow way and store it.
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Tp> x, wg, wk;
+    emsr::build_gauss_kronrod(n, eps, x, wg, wk);
+    auto stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double> build_time = stop - start;
+
+    emsr::rule_file_writer writer;
+    writer.add(emsr::Rule_Gauss_Kronrod, 2 * n + 1, 0.0, 0.0, x, wk, wg);
+    writer.write(path);
+
+    // Map it back.
+    start = std::chrono::steady_clock::now();
+    emsr::rule_file rf(path);
+    auto rule = rf.find<Tp>(emsr::Rule_Gauss_Kronrod, 2 * n + 1);
+    stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double> load_time = stop - start;
+
+    std::cout << "build time = " << build_time.count() << " s"
+	      << "  load time = " << load_time.count() << " s\n";
+
+    if (!rule)
+      {
+	std::cout << "rule not found\n";
+	return;
+      }
+
+    bool same = rule->point.size() == x.size()
+	     && rule->weight.size() == wk.size()
+	     && rule->aux_weight.size() == wg.size();
+    for (std::size_t i = 0; same && i < x.size(); ++i)
+      same = rule->point[i] == x[i] && rule->weight[i] == wk[i];
+    for (std::size_t i = 0; same && i < wg.size(); ++i)
+      same = rule->aux_weight[i] == wg[i];
+    std::cout << "round trip exact: " << std::boolalpha << same << '\n';
+
+    // Integrate straight out of the mapping.
+    auto f = [](Tp x) -> Tp { return std::exp(x) * std::cos(Tp{20} * x); };
+    auto gk = emsr::gauss_kronrod_integral<Tp>::s_integrate(rule->point,
+			rule->aux_weight, rule->weight, f, Tp{-1}, Tp{1});
+    std::cout << "GK" << 2 * n + 1 << " result = " << gk.result
+	      << "  abserr = " << gk.abserr << '\n';
+
+    // Let the rule constructor pick the rule out of the file.
+    emsr::set_default_rule_file(path);
+    start = std::chrono::steady_clock::now();
+    const emsr::gauss_kronrod_integral<Tp> gk_file(2 * n + 1);
+    stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double> ctor_file_time = stop - start;
+    emsr::set_default_rule_file("");
+    start = std::chrono::steady_clock::now();
+    const emsr::gauss_kronrod_integral<Tp> gk_built(2 * n + 1);
+    stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double> ctor_built_time = stop - start;
+    const auto res_file = gk_file(f, Tp{-1}, Tp{1});
+    const auto res_built = gk_built(f, Tp{-1}, Tp{1});
+    std::cout << "constructor with rule file = " << ctor_file_time.count()
+	      << " s  without = " << ctor_built_time.count() << " s"
+	      << "  same result: "
+	      << (res_file.result == res_built.result
+		  && res_file.result == gk.result) << '\n';
+
+    // Integrators of the same rule share one copy of it.
+    emsr::set_default_rule_file(path);
+    const emsr::gauss_kronrod_integral<Tp> gk_again(2 * n + 1);
+    const auto res_again = gk_again(f, Tp{-1}, Tp{1});
+    emsr::set_default_rule_file("");
+    std::cout << "reloaded after a change of rule file, same result: "
+	      << (res_again.result == res_file.result) << '\n';
+
+    // Keys that are not there.
+    std::cout << "other order found: "
+	      << bool(rf.find<Tp>(emsr::Rule_Gauss_Kronrod, 2 * n + 3)) << '\n';
+    std::cout << "other type found:  "
+	      << bool(rf.find<float>(emsr::Rule_Gauss_Kronrod, 2 * n + 1)) << '\n';
+  }
+
+#ifdef EMSR_HAVE_FLOAT128
+void
+test_float128_rule_file(const std::string& path)
+{
+  std::vector<__float128> x, w;
+  for (int i = 0; i <= 16; ++i)
+    {
+      x.push_back(__float128(i) / 17);
+      w.push_back(__float128(1) / (i + 3));
+    }
+  emsr::rule_file_writer writer;
+  writer.add(emsr::Rule_Clenshaw_Curtis, 17, 0.0, 0.0, x, w);
+  writer.write(path);
+
+  emsr::rule_file rf(path);
+  const auto rule = rf.find<__float128>(emsr::Rule_Clenshaw_Curtis, 17);
+  bool same = rule && rule->point.size() == x.size()
+	   && rule->weight.size() == w.size();
+  for (std::size_t i = 0; same && i < x.size(); ++i)
+    same = rule->point[i] == x[i] && rule->weight[i] == w[i];
+  std::cout << "__float128 round trip exact: " << std::boolalpha << same
+	    << "  long double found: "
+	    << bool(rf.find<long double>(emsr::Rule_Clenshaw_Curtis, 17))
+	    << '\n';
+}
+#endif
+
+void
+test_bad_file(const std::string& path)
+{
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "This is not a rule file but it is long enough to have a header.";
+  }
+  try
+    {
+      emsr::rule_file rf(path);
+      std::cout << "bad file accepted\n";
+    }
+  catch (const std::runtime_error& err)
+    {
+      std::cout << "bad file rejected: " << err.what() << '\n';
+    }
+}
+
+void
+test_bad_rule(const std::string& path)
+{
+  // A 21-point Gauss-Kronrod rule has 11 nodes and 5 Gauss weights.
+  const std::vector<double> x(10, 0.5), wk(10, 0.1), wg(5, 0.2);
+  emsr::rule_file_writer writer;
+  writer.add(emsr::Rule_Gauss_Kronrod, 21, 0.0, 0.0, x, wk, wg);
+  writer.write(path);
+
+  emsr::rule_file rf(path);
+  try
+    {
+      rf.find<double>(emsr::Rule_Gauss_Kronrod, 21);
+      std::cout << "bad rule accepted\n";
+    }
+  catch (const std::runtime_error& err)
+    {
+      std::cout << "bad rule rejected: " << err.what() << '\n';
+    }
+}
+
+int
+main()
+{
+  const std::string path = "test_rule_file.bin";
+
+  std::cout << "\n\ndouble\n";
+  test_rule_file<double>(path);
+
+  std::cout << "\n\nlong double\n";
+  test_rule_file<long double>(path);
+
+#ifdef EMSR_HAVE_FLOAT128
+  std::cout << "\n\n__float128\n";
+  test_float128_rule_file(path);
+#endif
+
+  std::cout << "\n\n";
+  test_bad_file(path);
+  test_bad_rule(path);
+
+  std::remove(path.c_str());
+}
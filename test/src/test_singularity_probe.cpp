@@ -0,0 +1,148 @@
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <numbers>
+
+#include <emsr/singularity_probe.h>
+
+const char*
+engine_name(emsr::integration_engine engine)
+{
+  switch (engine)
+    {
+    case emsr::Engine_QAG: return "QAG";
+    case emsr::Engine_QAWS: return "QAWS";
+    case emsr::Engine_Tanh_Sinh: return "tanh-sinh";
+    case emsr::Engine_QAGS: return "QAGS";
+    }
+  return "?";
+}
+
+const char*
+kind_name(emsr::endpoint_kind kind)
+{
+  switch (kind)
+    {
+    case emsr::Endpoint_Regular: return "regular";
+    case emsr::Endpoint_Algebraic: return "algebraic";
+    case emsr::Endpoint_Irregular: return "irregular";
+    case emsr::Endpoint_Unknown: return "unknown";
+    }
+  return "?";
+}
+
+template<typename Tp>
+  std::ostream&
+  operator<<(std::ostream& os, const emsr::endpoint_behavior_t<Tp>& eb)
+  {
+    os << kind_name(eb.kind);
+    if (eb.kind != emsr::Endpoint_Unknown)
+      os << " (" << std::setprecision(4) << eb.alpha << ", " << eb.mu << ')';
+    return os;
+  }
+
+/**
+ * Integrate over [0,1] with integrate_probed, integrate
+ * and integrate_singular and compare errors and evaluation counts.
+ */
+template<typename Tp, typename FuncTp>
+  void
+  compare(const char* name, FuncTp func, Tp exact)
+  {
+    const auto prec = std::cout.precision();
+    const auto tol = Tp{1.0e-10L};
+    int count = 0;
+    auto counted = [&count, func](Tp x) { ++count; return func(x); };
+
+    const auto res = emsr::integrate_probed(func, Tp{0}, Tp{1}, Tp{0}, tol);
+    std::cout << "  " << std::setw(22) << std::left << name << std::right
+	      << "  " << std::setw(9) << engine_name(res.engine)
+	      << "  lower " << std::setw(20) << std::left << res.lower_behavior
+	      << "  upper " << std::setw(20) << res.upper_behavior << std::right
+	      << std::setprecision(prec)
+	      << "\n    probed:  evals " << std::setw(5) << res.num_evals
+	      << "  error " << std::setw(prec + 8) << res.result - exact << '\n';
+
+    try
+      {
+	const auto r = emsr::integrate(counted, Tp{0}, Tp{1}, Tp{0}, tol);
+	std::cout << "    QAG:     evals " << std::setw(5) << count
+		  << "  error " << std::setw(prec + 8) << r.result - exact << '\n';
+      }
+    catch (const emsr::integration_error<Tp, Tp>& err)
+      {
+	std::cout << "    QAG:     evals " << std::setw(5) << count
+		  << "  error " << std::setw(prec + 8) << err.result() - exact
+		  << "  (" << err.what() << ")\n";
+      }
+    count = 0;
+
+    try
+      {
+	const auto r = emsr::integrate_singular(counted, Tp{0}, Tp{1},
+						Tp{0}, tol);
+	std::cout << "    QAGS:    evals " << std::setw(5) << count
+		  << "  error " << std::setw(prec + 8) << r.result - exact << '\n';
+      }
+    catch (const emsr::integration_error<Tp, Tp>& err)
+      {
+	std::cout << "    QAGS:    evals " << std::setw(5) << count
+		  << "  error " << std::setw(prec + 8) << err.result() - exact
+		  << "  (" << err.what() << ")\n";
+      }
+  }
+
+template<typename Tp>
+  void
+  test_singularity_probe()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto pi = std::numbers::pi_v<Tp>;
+    const auto ln2 = std::numbers::ln2_v<Tp>;
+
+    compare<Tp>("exp(x)", [](Tp x) { return std::exp(x); },
+		std::numbers::e_v<Tp> - Tp{1});
+    compare<Tp>("1/(sqrt(x)(1+x))",
+		[](Tp x) { return Tp{1} / (std::sqrt(x) * (Tp{1} + x)); },
+		pi / Tp{2});
+    compare<Tp>("cbrt(x)(1+x)",
+		[](Tp x) { return std::cbrt(x) * (Tp{1} + x); },
+		Tp{3} / Tp{4} + Tp{3} / Tp{7});
+    compare<Tp>("log(x)", [](Tp x) { return std::log(x); }, Tp{-1});
+    compare<Tp>("log(x)/sqrt(x)",
+		[](Tp x) { return std::log(x) / std::sqrt(x); }, Tp{-4});
+    compare<Tp>("(2-x)/(1-x)^(3/4)",
+		[](Tp x) { return (Tp{2} - x) / std::pow(Tp{1} - x, Tp{0.75L}); },
+		Tp{4.8L});
+    compare<Tp>("sqrt(x)+1", [](Tp x) { return std::sqrt(x) + Tp{1}; },
+		Tp{5} / Tp{3});
+    compare<Tp>("x^(-1/pi)",
+		[pi](Tp x) { return std::pow(x, -Tp{1} / pi); },
+		Tp{1} / (Tp{1} - Tp{1} / pi));
+    compare<Tp>("1/sqrt(x(1-x))",
+		[](Tp x) { return Tp{1} / std::sqrt(x * (Tp{1} - x)); }, pi);
+    compare<Tp>("log(1-x)/sqrt(x)",
+		[](Tp x) { return std::log1p(-x) / std::sqrt(x); },
+		Tp{-4} + Tp{4} * ln2);
+
+    try
+      {
+	emsr::integrate_probed([](Tp x) { return Tp{1} / x; },
+			       Tp{0}, Tp{1}, Tp{0}, Tp{1.0e-10L});
+	std::cout << "  1/x: no exception\n";
+      }
+    catch (const emsr::integration_error<Tp, Tp>& err)
+      {
+	std::cout << "  1/x: " << err.what() << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_singularity_probe<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_singularity_probe<long double>();
+}
@@ -0,0 +1,189 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+#include <emsr/sparse_grid_integral.h>
+
+/**
+ * Check that the difference rules of each level add up to the rule
+ * of that level: the sum of the weights and the number of distinct nodes.
+ */
+template<typename Tp>
+  void
+  test_rules()
+  {
+    const auto w = 8 + std::cout.precision();
+    const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+
+    std::cout << "\nDifference rules: level, nodes, sum of weights - exact\n";
+    for (auto [family, name, exact]
+	   : {std::tuple{emsr::Sparse_Clenshaw_Curtis, "Clenshaw-Curtis", Tp{2}},
+	      std::tuple{emsr::Sparse_Gauss_Patterson, "Gauss-Patterson", Tp{2}},
+	      std::tuple{emsr::Sparse_Gauss_Hermite, "Gauss-Hermite",
+			 std::sqrt(s_pi)}})
+      {
+	const emsr::sparse_grid_integral<Tp> grid(family, 5);
+	const auto& rule = grid.rule();
+	std::cout << ' ' << name << '\n';
+	auto sum = Tp{0};
+	std::size_t max_node = 0;
+	for (int l = 0; l <= rule.max_level(); ++l)
+	  {
+	    for (const auto& [node, weight] : rule.delta[l])
+	      {
+		sum += weight;
+		max_node = std::max(max_node, node + 1);
+	      }
+	    std::cout << "  " << l << "  " << std::setw(4) << max_node
+		      << "  " << std::setw(w) << sum - exact << '\n';
+	  }
+      }
+
+    const emsr::sparse_grid_integral<Tp> g1(emsr::Sparse_Gauss_Patterson);
+    const emsr::sparse_grid_integral<Tp> g2(emsr::Sparse_Gauss_Patterson);
+    std::cout << "\nIntegrators share the rules: " << std::boolalpha
+	      << (&g1.rule() == &g2.rule()) << '\n';
+  }
+
+template<typename Tp, std::size_t Dim>
+  void
+  test_box(Tp tol)
+  {
+    const auto w = 8 + std::cout.precision();
+
+    // Anisotropic weights: the later coordinates matter less and less.
+    std::array<Tp, Dim> lower, upper, c;
+    lower.fill(Tp{0});
+    upper.fill(Tp{1});
+    for (std::size_t i = 0; i < Dim; ++i)
+      c[i] = Tp{1} / Tp((i + 1) * (i + 1));
+
+    std::atomic<std::size_t> count{0};
+    // The integral of exp(c.x) is the product of (exp(c_i) - 1) / c_i.
+    auto f = [&](const std::array<Tp, Dim>& x) -> Tp
+	     {
+	       ++count;
+	       auto s = Tp{0};
+	       for (std::size_t i = 0; i < Dim; ++i)
+		 s += c[i] * x[i];
+	       return std::exp(s);
+	     };
+    auto exact = Tp{1};
+    for (std::size_t i = 0; i < Dim; ++i)
+      exact *= std::expm1(c[i]) / c[i];
+
+    for (auto [family, name]
+	   : {std::pair{emsr::Sparse_Clenshaw_Curtis, "Clenshaw-Curtis"},
+	      std::pair{emsr::Sparse_Gauss_Patterson, "Gauss-Patterson"}})
+      for (unsigned int num_threads : {1u, 4u})
+	{
+	  count = 0;
+	  auto start = std::chrono::steady_clock::now();
+	  const auto res = emsr::integrate_sparse_grid(f, lower, upper,
+						Tp{0}, tol, family,
+						1000000, num_threads);
+	  std::chrono::duration<double> dt
+	    = std::chrono::steady_clock::now() - start;
+	  std::cout << "  " << std::setw(2) << Dim << "D "
+		    << std::setw(16) << std::left << name << std::right
+		    << " threads " << num_threads
+		    << "  result " << std::setw(w) << res.result
+		    << "  err " << std::setw(w) << res.abserr
+		    << "  actual " << std::setw(w) << res.result - exact
+		    << "  evals " << std::setw(7) << count
+		    << "  " << dt.count() << " s\n";
+	}
+  }
+
+template<typename Tp, std::size_t Dim>
+  void
+  test_hermite(Tp tol)
+  {
+    const auto w = 8 + std::cout.precision();
+    const auto s_pi = Tp{3.1415'92653'58979'32384'62643'38327'95028'84195e+0L};
+
+    std::array<Tp, Dim> center, scale, a;
+    center.fill(Tp{0});
+    scale.fill(Tp{1});
+    for (std::size_t i = 0; i < Dim; ++i)
+      a[i] = Tp{1} / Tp(i + 1);
+
+    std::atomic<std::size_t> count{0};
+    // The integral of cos(a.x) exp(-x.x) is pi^{d/2} exp(-a.a/4).
+    auto f = [&](const std::array<Tp, Dim>& x) -> Tp
+	     {
+	       ++count;
+	       auto s = Tp{0};
+	       for (std::size_t i = 0; i < Dim; ++i)
+		 s += a[i] * x[i];
+	       return std::cos(s);
+	     };
+    auto aa = Tp{0};
+    for (std::size_t i = 0; i < Dim; ++i)
+      aa += a[i] * a[i];
+    const auto exact = std::pow(s_pi, Tp(Dim) / Tp{2}) * std::exp(-aa / Tp{4});
+
+    count = 0;
+    const auto res = emsr::integrate_sparse_grid_hermite(f, center, scale,
+							  Tp{0}, tol);
+    std::cout << "  " << std::setw(2) << Dim << "D Gauss-Hermite   "
+	      << "  result " << std::setw(w) << res.result
+	      << "  err " << std::setw(w) << res.abserr
+	      << "  actual " << std::setw(w) << res.result - exact
+	      << "  evals " << std::setw(7) << count << '\n';
+  }
+
+template<typename Tp>
+  void
+  test_sparse_grid()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    test_rules<Tp>();
+
+    std::cout << "\nexp(sum x_i / (i+1)^2) over the unit cube\n";
+    test_box<Tp, 10>(Tp{1.0e-10L});
+    test_box<Tp, 20>(Tp{1.0e-10L});
+    test_box<Tp, 30>(Tp{1.0e-8L});
+
+    std::cout << "\ncos(sum x_i / (i+1)) exp(-x.x) over all space\n";
+    test_hermite<Tp, 10>(Tp{1.0e-8L});
+    test_hermite<Tp, 20>(Tp{1.0e-6L});
+
+    std::cout << "\nEvaluation budget exhausted\n";
+    try
+      {
+	std::array<Tp, 12> lower, upper;
+	lower.fill(Tp{0});
+	upper.fill(Tp{1});
+	auto g = [](const std::array<Tp, 12>& x) -> Tp
+		 {
+		   auto s = Tp{0};
+		   for (auto xi : x)
+		     s += xi;
+		   return Tp{1} / (Tp{0.01L} + std::abs(s - Tp{6}));
+		 };
+	emsr::integrate_sparse_grid(g, lower, upper, Tp{0}, Tp{1.0e-12L},
+				    emsr::Sparse_Clenshaw_Curtis, 20000);
+	std::cout << "  ERROR: no exception\n";
+      }
+    catch (const emsr::integration_error<Tp, Tp>& err)
+      {
+	std::cout << "  result " << std::setw(w) << err.result()
+		  << "  err " << std::setw(w) << err.abserr()
+		  << "  (" << err.what() << ")\n";
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_sparse_grid<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_sparse_grid<long double>();
+}
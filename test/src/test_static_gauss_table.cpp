@@ -0,0 +1,92 @@
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <emsr/integration.h>
+
+// The tables are constant expressions.
+static_assert(emsr::gauss_legendre_table_v<double, 3>.point[0] == 0.0);
+static_assert(emsr::gauss_kronrod_table_v<double, 15>.x_kronrod[7] == 0.0);
+
+template<typename Tp>
+  void
+  test_legendre()
+  {
+    std::cout << "\nGauss-Legendre compile-time vs tabulated\n";
+    auto diff = [](const auto& ct, std::size_t n)
+      {
+	emsr::gauss_legendre_table<Tp> rt(n);
+	auto d = Tp{0};
+	for (std::size_t i = 0; i < (n + 1) / 2; ++i)
+	  {
+	    d = std::max(d, std::abs(ct.pt(i) - rt.pt(i)));
+	    d = std::max(d, std::abs(ct.wt(i) - rt.wt(i)));
+	  }
+	return d;
+      };
+    std::cout << "  n =    5: " << diff(emsr::gauss_legendre_table_v<Tp, 5>, 5) << '\n';
+    std::cout << "  n =   20: " << diff(emsr::gauss_legendre_table_v<Tp, 20>, 20) << '\n';
+    std::cout << "  n =   64: " << diff(emsr::gauss_legendre_table_v<Tp, 64>, 64) << '\n';
+    std::cout << "  n =  100: " << diff(emsr::gauss_legendre_table_v<Tp, 100>, 100) << '\n';
+
+    auto f = [](Tp x) -> Tp { return std::exp(x); };
+    const auto exact = std::exp(Tp{2}) - std::exp(Tp{-1});
+    std::cout << "  exp on [-1,2] with n = 23: "
+	      << emsr::glfixed_integrate<23>(f, Tp{-1}, Tp{2}) - exact << '\n';
+  }
+
+template<typename Tp>
+  void
+  test_kronrod()
+  {
+    std::cout << "\nGauss-Kronrod compile-time vs run-time\n";
+    auto diff = [](const auto& ct, int n)
+      {
+	std::vector<Tp> x, wg, wk;
+	emsr::build_gauss_kronrod(n, 4 * std::numeric_limits<Tp>::epsilon(),
+				  x, wg, wk);
+	auto d = Tp{0};
+	for (std::size_t i = 0; i < x.size(); ++i)
+	  {
+	    d = std::max(d, std::abs(ct.x_kronrod[i] - x[i]));
+	    d = std::max(d, std::abs(ct.w_kronrod[i] - wk[i]));
+	  }
+	for (std::size_t i = 0; i < wg.size(); ++i)
+	  d = std::max(d, std::abs(ct.w_gauss[i] - wg[i]));
+	return d;
+      };
+    std::cout << "  15 points: " << diff(emsr::gauss_kronrod_table_v<Tp, 15>, 7) << '\n';
+    std::cout << "  21 points: " << diff(emsr::gauss_kronrod_table_v<Tp, 21>, 10) << '\n';
+    std::cout << "  61 points: " << diff(emsr::gauss_kronrod_table_v<Tp, 61>, 30) << '\n';
+    std::cout << " 101 points: " << diff(emsr::gauss_kronrod_table_v<Tp, 101>, 50) << '\n';
+
+    auto f = [](Tp x) -> Tp { return std::cos(Tp{30} * x) / (Tp{1} + x * x); };
+    const auto gk61 = emsr::gauss_kronrod_integral<Tp>(emsr::Kronrod_61)(f, Tp{-1}, Tp{1});
+    const auto ct61 = emsr::gauss_kronrod_integral<Tp, 61>{}(f, Tp{-1}, Tp{1});
+    const auto ct101 = emsr::gauss_kronrod_integral<Tp, 101>{}(f, Tp{-1}, Tp{1});
+    std::cout << "  GK61 tabulated:     " << gk61.result << " +- " << gk61.abserr << '\n';
+    std::cout << "  GK61 compile-time:  " << ct61.result << " +- " << ct61.abserr << '\n';
+    std::cout << "  GK101 compile-time: " << ct101.result << " +- " << ct101.abserr << '\n';
+
+    // As the local rule of an adaptive integrator.
+    emsr::integration_workspace<Tp, Tp> ws(100);
+    auto ad = emsr::qag_integrate(ws, f, Tp{-1}, Tp{1}, Tp{0}, Tp{1.0e-10L},
+				  emsr::gauss_kronrod_integral<Tp, 41>{});
+    std::cout << "  qag with GK41:      " << ad.result << " +- " << ad.abserr << '\n';
+  }
+
+int
+main()
+{
+  std::cout.precision(std::numeric_limits<double>::digits10);
+  std::cout << "\n\ndouble\n";
+  test_legendre<double>();
+  test_kronrod<double>();
+
+  std::cout.precision(std::numeric_limits<long double>::digits10);
+  std::cout << "\n\nlong double\n";
+  test_legendre<long double>();
+  test_kronrod<long double>();
+}
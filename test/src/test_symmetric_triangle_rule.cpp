@@ -0,0 +1,187 @@
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <span>
+#include <vector>
+
+#include <emsr/symmetric_triangle_rule.h>
+
+/**
+ * Return the integral of x^p y^q over the unit triangle
+ * (0,0), (1,0), (0,1): p! q! / (p + q + 2)!.
+ */
+template<typename Tp>
+  Tp
+  monomial_integral(int p, int q)
+  {
+    auto r = Tp{1};
+    for (int i = 1; i <= q; ++i)
+      r *= Tp(i) / Tp(p + i);
+    for (int i = p + q + 1; i <= p + q + 2; ++i)
+      r /= Tp(i);
+    return r;
+  }
+
+/**
+ * Return the largest relative error of a rule on the monomials
+ * of total degree d.
+ */
+template<typename Tp>
+  Tp
+  monomial_error(const emsr::symmetric_triangle_rule<Tp>& rule, int d)
+  {
+    const emsr::triangle<Tp> unit{{{{Tp{0}, Tp{0}}, {Tp{1}, Tp{0}},
+				    {Tp{0}, Tp{1}}}}};
+    auto err = Tp{0};
+    for (int p = 0; p <= d; ++p)
+      {
+	const int q = d - p;
+	auto mono = [p, q](const std::array<Tp, 2>& x) -> Tp
+		    { return std::pow(x[0], Tp(p)) * std::pow(x[1], Tp(q)); };
+	const auto exact = monomial_integral<Tp>(p, q);
+	err = std::max(err, std::abs(rule.integrate(mono, unit) - exact) / exact);
+      }
+    return err;
+  }
+
+template<typename Tp>
+  void
+  test_symmetric_triangle_rule()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    using rule_t = emsr::symmetric_triangle_rule<Tp>;
+
+    std::cout << "\nPoints, positivity and monomial exactness\n";
+    for (int deg = rule_t::s_min_degree; deg <= rule_t::s_max_degree; ++deg)
+      {
+	const rule_t rule(deg);
+	auto min_w = Tp{1}, min_l = Tp{1}, sum = Tp{0};
+	for (std::size_t i = 0; i < rule.size(); ++i)
+	  {
+	    min_w = std::min(min_w, rule.weight()[i]);
+	    min_l = std::min({min_l, rule.lambda0()[i],
+			      rule.lambda1()[i], rule.lambda2()[i]});
+	    sum += rule.weight()[i];
+	  }
+	auto err = Tp{0};
+	for (int d = 0; d <= rule.degree(); ++d)
+	  err = std::max(err, monomial_error(rule, d));
+	std::cout << ' ' << std::setw(2) << deg
+		  << "  degree " << std::setw(2) << rule.degree()
+		  << "  points " << std::setw(3) << rule.size()
+		  << "  min weight " << std::setw(w) << min_w
+		  << "  min lambda " << std::setw(w) << min_l
+		  << "  sum - 1 " << std::setw(w) << sum - Tp{1}
+		  << "  exact err " << std::setw(w) << err
+		  << "  degree + 1 err " << std::setw(w)
+		  << monomial_error(rule, rule.degree() + 1) << '\n';
+      }
+
+    try
+      {
+	rule_t bad(rule_t::s_max_degree + 1);
+	std::cout << "ERROR: no exception for degree out of range\n";
+      }
+    catch (const std::domain_error& err)
+      {
+	std::cout << "\nDegree out of range: " << err.what() << '\n';
+      }
+
+    // A mesh of the square [0,1]^2 cut into 2 n^2 triangles.
+    auto square_mesh = [](std::size_t n)
+      {
+	std::vector<emsr::triangle<Tp>> mesh;
+	mesh.reserve(2 * n * n);
+	const auto h = Tp{1} / Tp(n);
+	for (std::size_t i = 0; i < n; ++i)
+	  for (std::size_t j = 0; j < n; ++j)
+	    {
+	      const auto x0 = Tp(i) * h, x1 = Tp(i + 1) * h;
+	      const auto y0 = Tp(j) * h, y1 = Tp(j + 1) * h;
+	      mesh.push_back({{{{x0, y0}, {x1, y0}, {x1, y1}}}});
+	      mesh.push_back({{{{x0, y0}, {x1, y1}, {x0, y1}}}});
+	    }
+	return mesh;
+      };
+
+    auto f = [](const std::array<Tp, 2>& x) -> Tp
+	     { return std::exp(x[0]) * std::cos(Tp{3} * x[1]); };
+    // The same integrand over a block of points.
+    auto f_batch = [](const std::array<std::span<const Tp>, 2>& x,
+		      std::span<Tp> val)
+		   {
+		     for (std::size_t t = 0; t < val.size(); ++t)
+		       val[t] = std::exp(x[0][t]) * std::cos(Tp{3} * x[1][t]);
+		   };
+    // The integral of f over the unit square.
+    const auto exact = (std::exp(Tp{1}) - Tp{1}) * std::sin(Tp{3}) / Tp{3};
+
+    std::cout << "\nBatched vs. one triangle at a time on a mesh of the square\n";
+    for (int deg : {10, 13, 16, 20})
+      {
+	const auto rule = emsr::cached_symmetric_triangle_rule<Tp>(deg);
+	for (std::size_t n : {4, 128})
+	  {
+	    const auto mesh = square_mesh(n);
+
+	    // The vertex coordinates as contiguous arrays.
+	    std::array<std::array<std::vector<Tp>, 2>, 3> vert_data;
+	    std::array<std::array<std::span<const Tp>, 2>, 3> vert;
+	    for (std::size_t k = 0; k < 3; ++k)
+	      for (std::size_t d = 0; d < 2; ++d)
+		{
+		  for (const auto& tri : mesh)
+		    vert_data[k][d].push_back(tri.vertex[k][d]);
+		  vert[k][d] = vert_data[k][d];
+		}
+
+	    auto start = std::chrono::steady_clock::now();
+	    auto max_diff = Tp{0};
+	    std::vector<Tp> one(mesh.size());
+	    for (std::size_t e = 0; e < mesh.size(); ++e)
+	      one[e] = rule->integrate(f, mesh[e]);
+	    auto mid = std::chrono::steady_clock::now();
+	    const auto batch = rule->integrate_batch(f_batch, mesh);
+	    auto mid2 = std::chrono::steady_clock::now();
+	    const auto soa = rule->integrate_batch(f_batch, vert);
+	    auto stop = std::chrono::steady_clock::now();
+
+	    auto total = Tp{0};
+	    for (std::size_t e = 0; e < mesh.size(); ++e)
+	      {
+		total += soa[e];
+		max_diff = std::max({max_diff, std::abs(batch[e] - one[e]),
+				     std::abs(soa[e] - one[e])});
+	      }
+	    std::chrono::duration<double> dt_one = mid - start;
+	    std::chrono::duration<double> dt_batch = mid2 - mid;
+	    std::chrono::duration<double> dt_soa = stop - mid2;
+	    std::cout << ' ' << std::setw(2) << deg
+		      << "  elements " << std::setw(6) << mesh.size()
+		      << "  error " << std::setw(w) << total - exact
+		      << "  max diff " << std::setw(w) << max_diff
+		      << "  single " << dt_one.count() << " s"
+		      << "  batched " << dt_batch.count() << " s"
+		      << "  batched arrays " << dt_soa.count() << " s\n";
+	  }
+      }
+
+    const auto r1 = emsr::cached_symmetric_triangle_rule<Tp>(12);
+    const auto r2 = emsr::cached_symmetric_triangle_rule<Tp>(12);
+    std::cout << "\nRegistry returns the same rule: "
+	      << std::boolalpha << (r1 == r2) << '\n';
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_symmetric_triangle_rule<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_symmetric_triangle_rule<long double>();
+}
@@ -0,0 +1,304 @@
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <emsr/triangle_integral.h>
+
+/**
+ * Return the largest error of the pair on the barycentric monomials
+ * of the given degree over the reference triangle.
+ * The average of @f$ l_1^i l_2^j l_3^k @f$ is @f$ 2 i! j! k! / (i+j+k+2)! @f$.
+ */
+template<typename Tp>
+  std::array<Tp, 2>
+  monomial_error(const emsr::triangle_integral<Tp>& rule, int degree)
+  {
+    auto fact = [](int n){ auto f = Tp{1}; for (int i = 2; i <= n; ++i) f *= i; return f; };
+    std::array<Tp, 2> err{};
+    for (int i = 0; i <= degree; ++i)
+      for (int j = 0; i + j <= degree; ++j)
+	{
+	  const int k = degree - i - j;
+	  const auto exact = Tp{2} * fact(i) * fact(j) * fact(k)
+			   / fact(degree + 2);
+	  auto hi = Tp{0}, lo = Tp{0};
+	  for (std::size_t p = 0; p < rule.size(); ++p)
+	    {
+	      const auto& l = rule.point(p);
+	      const auto m = std::pow(l[0], Tp(i)) * std::pow(l[1], Tp(j))
+			   * std::pow(l[2], Tp(k));
+	      hi += rule.weight(p) * m;
+	      lo += rule.embedded_weight(p) * m;
+	    }
+	  err[0] = std::max(err[0], std::abs(hi - exact));
+	  err[1] = std::max(err[1], std::abs(lo - exact));
+	}
+    return err;
+  }
+
+/**
+ * A mesh of the unit square with 2 n^2 right triangles.
+ */
+template<typename Tp>
+  std::vector<emsr::triangle<Tp>>
+  square_mesh(std::size_t n)
+  {
+    std::vector<emsr::triangle<Tp>> mesh;
+    mesh.reserve(2 * n * n);
+    const auto h = Tp{1} / Tp(n);
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < n; ++j)
+	{
+	  const auto x0 = i * h, y0 = j * h, x1 = x0 + h, y1 = y0 + h;
+	  mesh.push_back({{{{x0, y0}, {x1, y0}, {x1, y1}}}});
+	  mesh.push_back({{{{x0, y0}, {x1, y1}, {x0, y1}}}});
+	}
+    return mesh;
+  }
+
+/**
+ * The same mesh with shared vertex indices.
+ */
+template<typename Tp>
+  emsr::triangle_mesh<Tp>
+  square_indexed_mesh(std::size_t n)
+  {
+    emsr::triangle_mesh<Tp> mesh;
+    const auto h = Tp{1} / Tp(n);
+    for (std::size_t i = 0; i <= n; ++i)
+      for (std::size_t j = 0; j <= n; ++j)
+	mesh.vertex.push_back({i * h, j * h});
+    auto id = [n](std::size_t i, std::size_t j){ return i * (n + 1) + j; };
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < n; ++j)
+	{
+	  mesh.element.push_back({id(i, j), id(i + 1, j), id(i + 1, j + 1)});
+	  mesh.element.push_back({id(i, j), id(i + 1, j + 1), id(i, j + 1)});
+	}
+    return mesh;
+  }
+
+/**
+ * Compare the shared evaluation mesh driver with rules applied
+ * element by element.
+ */
+template<typename Tp>
+  void
+  test_shared_mesh()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    std::atomic<std::size_t> count = 0;
+    auto f = [&count](const std::array<Tp, 2>& p) -> Tp
+      { ++count; return std::exp(p[0] + p[1]); };
+
+    const auto mesh = square_indexed_mesh<Tp>(100);
+    std::cout << "\nShared vertex and edge evaluations on "
+	      << mesh.size() << " elements\n";
+    for (int r = 0; r < emsr::triangle_rule<Tp>::s_num_tri_rules; ++r)
+      {
+	const emsr::triangle_rule<Tp> rule(r);
+
+	std::size_t count_elem = 0;
+	auto sum = Tp{0};
+	auto diff = Tp{0};
+	count = 0;
+	const auto shared = emsr::integrate_mesh(f, mesh, rule, 4);
+	const std::size_t count_shared = count;
+	count = 0;
+	for (std::size_t e = 0; e < mesh.size(); ++e)
+	  {
+	    const auto tri = mesh.element_triangle(e);
+	    auto elem = Tp{0};
+	    for (std::size_t p = 0; p < rule.size(); ++p)
+	      {
+		Tp wt;
+		std::array<Tp, 3> l;
+		rule.point(p, wt, l);
+		elem += wt * f(emsr::barycentric_point(tri, l));
+	      }
+	    elem *= emsr::triangle_area(tri);
+	    sum += elem;
+	    diff = std::max(diff, std::abs(elem - shared.element[e]));
+	  }
+	count_elem = count;
+
+	std::cout << "  rule " << r
+		  << "  vertex " << rule.num_points(emsr::Vertex_Point)
+		  << "  edge " << rule.num_points(emsr::Edge_Point)
+		  << "  interior " << rule.num_points(emsr::Interior_Point)
+		  << "  evals " << std::setw(7) << shared.num_evals
+		  << " (" << std::setw(7) << count_shared << ")"
+		  << " vs. " << std::setw(7) << count_elem
+		  << "  saved " << std::setw(3)
+		  << 100 * (count_elem - shared.num_evals) / count_elem << '%'
+		  << "  max element diff " << std::setw(w) << diff
+		  << "  total diff " << std::setw(w) << shared.result - sum
+		  << '\n';
+      }
+  }
+
+template<typename Tp>
+  void
+  test_triangle_integral()
+  {
+    std::cout.precision(std::numeric_limits<Tp>::digits10);
+    const auto w = 8 + std::cout.precision();
+
+    const emsr::triangle_integral<Tp> rule;
+    std::cout << "\nMonomial errors of the embedded pair ("
+	      << rule.size() << " points)\n";
+    for (int d = 0; d <= 10; ++d)
+      {
+	const auto err = monomial_error(rule, d);
+	std::cout << "  degree " << std::setw(2) << d
+		  << "  high " << std::setw(w) << err[0]
+		  << "  low " << std::setw(w) << err[1] << '\n';
+      }
+
+    // The canned rules must integrate the linear functions at least.
+    std::cout << "\nCanned rules on x^2 over the reference triangle (1/6)\n";
+    for (int r = 0; r < emsr::triangle_rule<Tp>::s_num_tri_rules; ++r)
+      {
+	const emsr::triangle_rule<Tp> tr(r);
+	auto sum = Tp{0};
+	for (std::size_t p = 0; p < tr.size(); ++p)
+	  {
+	    Tp wt;
+	    std::array<Tp, 3> l;
+	    tr.point(p, wt, l);
+	    sum += wt * l[0] * l[0];
+	  }
+	std::cout << "  rule " << r << "  points " << tr.order()
+		  << "  error " << std::setw(w) << sum - Tp{1} / Tp{6} << '\n';
+      }
+
+    const emsr::triangle<Tp> ref{{{{Tp{0}, Tp{0}}, {Tp{1}, Tp{0}},
+				   {Tp{0}, Tp{1}}}}};
+    int count = 0;
+    auto report = [&count, w](const char* name, Tp exact, auto integ)
+      {
+	count = 0;
+	try
+	  {
+	    const auto res = integ();
+	    std::cout << "  " << std::setw(14) << std::left << name << std::right
+		      << std::setw(w) << res.result
+		      << "  err " << std::setw(w) << res.abserr;
+	    if (!std::isnan(exact))
+	      std::cout << "  actual " << std::setw(w) << res.result - exact;
+	    std::cout << "  evals " << count << '\n';
+	  }
+	catch (const emsr::integration_error<Tp, Tp>& err)
+	  {
+	    std::cout << "  " << std::setw(14) << std::left << name << std::right
+		      << std::setw(w) << err.result()
+		      << "  err " << std::setw(w) << err.abserr()
+		      << "  evals " << count << "  (" << err.what() << ")\n";
+	  }
+      };
+
+    auto f_exp = [&count](const std::array<Tp, 2>& p) -> Tp
+      { ++count; return std::exp(p[0] + p[1]); };
+    auto f_sing = [&count](const std::array<Tp, 2>& p) -> Tp
+      { ++count; return Tp{1} / std::hypot(p[0], p[1]); };
+    auto f_peak = [&count](const std::array<Tp, 2>& p) -> Tp
+      {
+	++count;
+	const auto dx = p[0] - Tp{0.3L}, dy = p[1] - Tp{0.2L};
+	return Tp{1} / (Tp{1.0e-3L} + dx * dx + dy * dy);
+      };
+
+    const auto sqrt2 = std::sqrt(Tp{2});
+    std::cout << "\nAdaptive cubature over the reference triangle\n";
+    for (Tp tol : {Tp{1.0e-6L}, Tp{1.0e-10L}})
+      {
+	std::cout << " tol = " << tol << '\n';
+	report("exp(x+y)", Tp{1},
+	       [&]{ return emsr::integrate_triangle(f_exp, ref, Tp{0}, tol); });
+	report("1/r", sqrt2 * std::log(Tp{1} + sqrt2),
+	       [&]{ return emsr::integrate_triangle(f_sing, ref, Tp{0}, tol,
+						    4096); });
+	report("peak", std::numeric_limits<Tp>::quiet_NaN(),
+	       [&]{ return emsr::integrate_triangle(f_peak, ref, Tp{0}, tol,
+						    4096); });
+      }
+
+    // The same triangle tilted into space has the same integral
+    // of a function of the in-plane coordinates.
+    const auto c = Tp{0.6L}, s = Tp{0.8L};
+    const emsr::triangle<Tp, 3> tilt{{{{Tp{0}, Tp{0}, Tp{0}},
+				       {c, Tp{0}, s}, {Tp{0}, Tp{1}, Tp{0}}}}};
+    auto f_exp3 = [&count, c, s](const std::array<Tp, 3>& p) -> Tp
+      { ++count; return std::exp((c * p[0] + s * p[2]) + p[1]); };
+    std::cout << "\nTriangle in space\n";
+    report("exp(u+v)", Tp{1},
+	   [&]{ return emsr::integrate_triangle(f_exp3, tilt,
+						Tp{0}, Tp{1.0e-10L}); });
+
+    std::cout << "\nMesh of the unit square, exact (e - 1)^2\n";
+    const auto exact = (std::exp(Tp{1}) - Tp{1}) * (std::exp(Tp{1}) - Tp{1});
+    for (std::size_t n : {1, 8, 64})
+      {
+	const auto mesh = square_mesh<Tp>(n);
+	for (unsigned nt : {1u, 4u})
+	  {
+	    count = 0;
+	    const auto res = emsr::integrate_mesh(f_exp, mesh,
+					Tp{1.0e-12L}, Tp{1.0e-12L}, 1024, nt);
+	    std::cout << "  elements " << std::setw(6) << mesh.size()
+		      << "  threads " << nt
+		      << "  result " << std::setw(w) << res.result
+		      << "  err " << std::setw(w) << res.abserr
+		      << "  actual " << std::setw(w) << res.result - exact
+		      << "  failed " << res.num_failed << '\n';
+	  }
+      }
+  }
+
+/**
+ * Time a large mesh with a peaked integrand over threads.
+ */
+template<typename Tp>
+  void
+  bench_mesh(std::size_t n)
+  {
+    const auto mesh = square_mesh<Tp>(n);
+    auto f = [](const std::array<Tp, 2>& p) -> Tp
+      {
+	const auto dx = p[0] - Tp{0.3L}, dy = p[1] - Tp{0.2L};
+	return std::exp(-Tp{100} * (dx * dx + dy * dy));
+      };
+    std::cout << "\nMesh of " << mesh.size() << " triangles\n";
+    for (unsigned nt : {1u, 2u, 4u, 8u})
+      {
+	auto start = std::chrono::steady_clock::now();
+	const auto res = emsr::integrate_mesh(f, mesh, Tp{1.0e-10L},
+					      Tp{1.0e-10L}, 1024, nt);
+	auto stop = std::chrono::steady_clock::now();
+	std::chrono::duration<double> dt = stop - start;
+	std::cout << "  threads " << nt << "  " << dt.count() << " s"
+		  << "  result " << res.result << '\n';
+      }
+  }
+
+int
+main()
+{
+  std::cout << "\n\ndouble\n";
+  test_triangle_integral<double>();
+
+  std::cout << "\n\nlong double\n";
+  test_triangle_integral<long double>();
+
+  std::cout << "\n\ndouble\n";
+  test_shared_mesh<double>();
+
+  std::cout.precision(12);
+  bench_mesh<double>(300);
+}